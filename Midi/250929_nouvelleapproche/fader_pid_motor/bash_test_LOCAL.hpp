@@ -1,9 +1,10 @@
 // bash_test.hpp
 #pragma once
 #include <Arduino.h>
-#include "fader_filtre_adc.h" // pour setPosition[] et ADC_MAX
+#include "hal.h"
+#include "fader_bank.h"       // pour gBank.setpoint[] et ADC_MAX
 #include "pid.h"   // pour kp_python, ki_python, kd_python, ts_python, fc_python
-#include "motor.h" // pour NUM_MOTOR
+#include "motor.h" // pour NUM_FADERS
 #include "debug.h" // pour on_debug, on_debug_python, on_debug_monitorarduino
 
 // === Position injectée par Python ===
@@ -31,11 +32,11 @@ namespace BashTestLocal {
 void loop_test_bash_local() {
   if (bash_test_mode != 1) return;
 
-  const uint32_t now = millis();
+  const uint32_t now = HALTime::millis();
 
   // si c'est l'heure de passer à l'étape suivante
   if ((int32_t)(now - BashTestLocal::nextAtMs) >= 0) {
-    setPosition[BashTestLocal::currentMotor] =
+    gBank.setpoint[BashTestLocal::currentMotor] =
         BashTestLocal::kStepsADC[BashTestLocal::stepIndex];
 
     // étape suivante
@@ -46,7 +47,7 @@ void loop_test_bash_local() {
       BashTestLocal::stepIndex = 0;
       BashTestLocal::currentMotor++;
 
-      if (BashTestLocal::currentMotor >= NUM_MOTOR) {
+      if (BashTestLocal::currentMotor >= NUM_FADERS) {
         // tous les moteurs ont été testés → on arrête
         bash_test_mode = 0;
         return;
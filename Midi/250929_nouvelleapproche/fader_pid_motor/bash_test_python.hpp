@@ -1,22 +1,21 @@
 // ========================== bash_tets_python.hpp ==========================
 #pragma once
 #include <Arduino.h>
+#include "hal.h"
 #include <cstdint>
 #include <string.h>     // memcpy
 #include <ctype.h>      // isdigit
 
 #include "fader_filtre_adc.h"  // <-- pour MAX_FADERS / NUM_FADERS
-#include "motor.h"             // <-- pour NUM_MOTOR (dépend de fader_filtre_adc.h)
-#include "pid.h"               // <-- pour gPid[] et la classe PID (méthodes visibles ici
+#include "motor.h"             // <-- pour NUM_FADERS (dépend de fader_filtre_adc.h)
+#include "fader_bank.h"        // <-- gBank : PID, consignes, positions, sorties par fader
 
 #include "debug.h"            // <-- pour on_debug, on_debug_python, on_debug_monitorarduino
+#include "telemetry.h"        // <-- slipEncode() (écriture SLIP en bloc)
+#include "host_protocol.h"    // <-- protocole binaire versionné (trames HP_MAGIC)
+#include "host_link.h"        // <-- HostLink : CDC USB ou UDP (W5500), interface de HALSerial
 
 // ---------- Externs (définis ailleurs dans ton projet) ----------
-extern PID*     gPid[NUM_MOTOR];
-extern uint16_t setPosition[NUM_MOTOR];
-extern uint16_t gFaderADC[MAX_FADERS];
-extern int16_t  Dirmotor[NUM_MOTOR];
-
 extern uint8_t fader_idx; // fader/moteur sélectionné par Python (bash_test_mode==2)
 extern float kp_python, ki_python, kd_python, ts_python, fc_python;
 extern void  initial_PIDv(bool use_python);
@@ -29,27 +28,15 @@ static constexpr uint8_t SLIP_ESC     = 0xDB;
 static constexpr uint8_t SLIP_ESC_END = 0xDC;
 static constexpr uint8_t SLIP_ESC_ESC = 0xDD;
 
-inline void slipWriteByte(uint8_t b) {
-  if (b == SLIP_END)      { Serial.write(SLIP_ESC); Serial.write(SLIP_ESC_END); }
-  else if (b == SLIP_ESC) { Serial.write(SLIP_ESC); Serial.write(SLIP_ESC_ESC); }
-  else                    { Serial.write(b); }
-}
-
+// Trame échappée d'un bloc puis 1 seul HostLink::write (en UDP : 1 datagramme) ;
+// pendant l'envoi morcelé d'une trame 'T' : mise en file entière (telemWriteFrame, telemetry.h)
 inline void slipWrite(const uint8_t* data, size_t len) {
-  Serial.write(SLIP_END);
-  for (size_t i = 0; i < len; ++i) slipWriteByte(data[i]);
-  Serial.write(SLIP_END);
+  telemWriteFrame(data, len);
 }
 
 // Envoie un tableau de float32 en SLIP
 inline void slipWriteFloats(const float* f, size_t n) {
-  Serial.write(SLIP_END);
-  for (size_t i = 0; i < n; ++i) {
-    uint8_t b[4];
-    memcpy(b, &f[i], 4);    // RP2040 = little-endian → direct
-    for (uint8_t k : b) slipWriteByte(k);
-  }
-  Serial.write(SLIP_END);
+  slipWrite((const uint8_t*)f, n * sizeof(float));   // RP2040 = little-endian → direct
 }
 
 // RX buffer
@@ -72,8 +59,8 @@ inline void slipFeed(uint8_t b, void (*onPacket)(const uint8_t*, uint16_t)) {
 }
 
 // ======================== Commandes Python =====================
-// Format: b'<cmd><idx_ascii><float32>'
-// cmd ∈ { 'p','i','d','t','c','s' }
+// Protocole binaire (host_protocol.h) : trames HP_MAGIC + CRC + ACK/NACK
+// Ancien format (conservé) : b'<cmd><idx_ascii><float32>', cmd ∈ { 'p','i','d','t','c','s' }
 inline bool parseIdxAndValue(const uint8_t* data, uint16_t len, uint8_t& idx, float& val) {
   if (len < 2) return false;
   uint16_t p = 1;
@@ -89,30 +76,31 @@ inline bool parseIdxAndValue(const uint8_t* data, uint16_t len, uint8_t& idx, fl
 }
 
 inline void onSlipPacket(const uint8_t* data, uint16_t len) {
+  if (hostProtoIsFrame(data, len)) { hostProtoHandle(data, len); return; }
   if (len < 2) return;
   const char cmd = (char)data[0];
   uint8_t idx = 0;
   float   v   = 0.f;
   if (!parseIdxAndValue(data, len, idx, v)) return;
+  if (idx >= NUM_FADERS) return;   // fader_idx indexe gBank sans autre contrôle
   fader_idx = idx; // pour bash_test_mode==2  
-  if (idx >= NUM_MOTOR) return;
 
   switch (cmd) {
     case 'p':
       kp_python = v;
-      if (gPid[idx]) gPid[idx]->setKp(kp_python);
+      gBank.pid[idx].setKp(kp_python);
       break;
     case 'i':
       ki_python = v;
-      if (gPid[idx]) gPid[idx]->setKi(ki_python);
+      gBank.pid[idx].setKi(ki_python);
       break;
     case 'd':
       kd_python = v;
-      if (gPid[idx]) gPid[idx]->setKd(kd_python);
+      gBank.pid[idx].setKd(kd_python);
       break;
     case 'c':
       fc_python = v;
-      if (gPid[idx]) gPid[idx]->setEMACutoff(fc_python);
+      gBank.pid[idx].setEMACutoff(fc_python);
       break;
     case 't':
       ts_python = v;
@@ -127,15 +115,13 @@ inline void onSlipPacket(const uint8_t* data, uint16_t len) {
 
 // ============================ API côté sketch ========================
 inline void tuningBegin(unsigned long baud = 1000000) {
-  Serial.begin(baud);
-  unsigned long t0 = millis();
-  while (!Serial && (millis() - t0) < 1500) {}
+  HostLink::begin(baud, 1500);
 }
 
 // À appeler souvent dans loop() pour traiter les commandes Python
 inline void tuningHandle() {
-  while (Serial.available()) {
-    slipFeed((uint8_t)Serial.read(), onSlipPacket);
+  while (HostLink::available()) {
+    slipFeed((uint8_t)HostLink::read(), onSlipPacket);
   }
 }
 
@@ -0,0 +1,64 @@
+#include "clock_sync.h"
+
+void ClockSync::reset() {
+  nWin = 0;
+  nPoints = 0;
+  offset = 0;
+  rate = 0;
+  lastErr = 0;
+  lockCount = 0;
+}
+
+void ClockSync::sample(uint32_t t1, uint32_t t2, uint32_t t3, uint32_t t4) {
+  ++samples;
+  const int32_t out = (int32_t)(t2 - t1);            // décalage + aller (modulo 2^32)
+  const int32_t rtt = (int32_t)(t4 - t1) - (int32_t)(t3 - t2);
+  if (rtt < 0 || (uint32_t)rtt > CLKSYNC_MAX_RTT_US) { ++rejected; return; }
+
+  // dans la fenêtre : l'échange le plus court est le moins retardé
+  if (nWin == 0) winStart = t2;
+  if (nWin == 0 || (uint32_t)rtt < bestRtt) {
+    bestRtt   = (uint32_t)rtt;
+    bestLocal = t2 + (t3 - t2) / 2;
+    bestTheta = (double)out - (double)rtt / 2.0;     // = (aller + retour) / 2, sans rebouclage
+  }
+  if (++nWin < CLKSYNC_WINDOW && t2 - winStart < CLKSYNC_WINDOW_US) return;
+  nWin = 0;
+  lastRttUs = bestRtt;
+  addPoint(bestLocal, bestTheta);
+}
+
+void ClockSync::addPoint(uint32_t local, double theta) {
+  ++points;
+  if (nPoints == 0) {                                // 1er point : décalage
+    offset = theta; rate = 0; refLocal = local; nPoints = 1;
+    return;
+  }
+  const int32_t dt = (int32_t)(local - refLocal);
+  if (dt <= 0) return;
+
+  const double pred = offset + (double)rate * dt;
+  double err = theta - pred;
+  if (err >  2147483648.0) err -= 4294967296.0;      // θ a franchi ±2^31 : même instant modulo 2^32
+  if (err < -2147483648.0) err += 4294967296.0;
+  lastErr = (int32_t)(err < 0 ? err - 0.5 : err + 0.5);
+  if (lastErr > (int32_t)CLKSYNC_STEP_US || lastErr < -(int32_t)CLKSYNC_STEP_US) {
+    ++resets;
+    reset();
+    addPoint(local, theta);
+    return;
+  }
+  offset   = pred + CLKSYNC_KP * err;
+  rate    += (float)(CLKSYNC_KI * err / dt);
+  refLocal = local;
+
+  const uint32_t a = (uint32_t)(lastErr < 0 ? -lastErr : lastErr);
+  if (a <= CLKSYNC_LOCK_US) { if (lockCount < CLKSYNC_LOCK_COUNT) ++lockCount; }
+  else                      lockCount = 0;
+}
+
+uint32_t ClockSync::toMaster(uint32_t local) const {
+  if (!nPoints) return local;
+  const double off = offset + (double)rate * (int32_t)(local - refLocal);
+  return local - (uint32_t)(int64_t)(off < 0 ? off - 0.5 : off + 0.5);   // modulo 2^32
+}
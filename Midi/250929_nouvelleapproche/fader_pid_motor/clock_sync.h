@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+
+/*
+  Synchronisation d'horloge "PTP léger" : l'horloge locale (micros() d'un module) suit
+  celle d'un maître (le hub), décalage ET dérive des quartz (±50 ppm = 3 ms / minute)
+  Code portable (pas d'Arduino) : les instants sont fournis par l'appelant
+  (modlink.cpp : échanges POLL / réponse ; host/modlink_loopback.cpp : bus simulé).
+
+  Un échange = 4 instants, comme PTP (t1, t4 horloge maître ; t2, t3 horloge locale) :
+    t1 maître émet → t2 local reçoit ; t3 local répond → t4 maître reçoit
+    décalage θ = ((t2 - t1) + (t3 - t4)) / 2      (local - maître, aller = retour supposés)
+    aller-retour δ = (t4 - t1) - (t3 - t2)
+  Le retard de prise d'un instant (interruption, tâche) ne fait que RALLONGER δ :
+    - fenêtre de CLKSYNC_WINDOW échanges (ou CLKSYNC_WINDOW_US si le bus perd beaucoup
+      de trames) → on ne garde que celui au δ le plus court
+    - 1 point par fenêtre → boucle PI : décalage corrigé de CLKSYNC_KP × erreur,
+      dérive (pente) de CLKSYNC_KI × erreur / durée de la fenêtre ; le 1er point fixe le
+      décalage, la pente part de 0 (une pente tirée de 2 points voisins serait faussée de
+      ±100 ppm par quelques µs de gigue)
+    - verrouillé après CLKSYNC_LOCK_COUNT fenêtres d'affilée sous CLKSYNC_LOCK_US ;
+      erreur > CLKSYNC_STEP_US (maître redémarré, ...) → on repart de zéro
+  toMaster(local) = local - (décalage + pente × (local - point de référence))
+*/
+
+// ===================== RÉGLAGES =====================
+constexpr uint8_t  CLKSYNC_WINDOW     = 32;      // échanges par point (≈ 24 ms : 2 modules, 1 POLL / 750 µs)
+constexpr uint32_t CLKSYNC_WINDOW_US  = 50000;   // fenêtre close au plus tard (échanges rares)
+constexpr uint32_t CLKSYNC_MAX_RTT_US = 3000;    // échange rejeté au-delà (réponse en retard)
+constexpr float    CLKSYNC_KP         = 0.3f;
+constexpr float    CLKSYNC_KI         = 0.02f;
+constexpr uint32_t CLKSYNC_LOCK_US    = 10;
+constexpr uint8_t  CLKSYNC_LOCK_COUNT = 4;
+constexpr uint32_t CLKSYNC_STEP_US    = 1000;
+
+class ClockSync {
+ public:
+  void reset();
+  void sample(uint32_t t1, uint32_t t2, uint32_t t3, uint32_t t4);
+  uint32_t toMaster(uint32_t local) const;
+  bool     locked() const { return lockCount >= CLKSYNC_LOCK_COUNT; }
+  float    ppm() const { return rate * 1e6f; }        // dérive locale / maître estimée
+  int32_t  lastErrorUs() const { return lastErr; }    // écart du dernier point à la prévision
+
+  // Statistiques
+  uint32_t samples = 0, rejected = 0, points = 0, resets = 0;
+  uint32_t lastRttUs = 0;                             // δ du dernier point retenu
+
+ private:
+  void addPoint(uint32_t local, double theta);
+
+  // fenêtre en cours : meilleur échange
+  uint8_t  nWin = 0;
+  uint32_t winStart = 0;
+  uint32_t bestRtt = 0, bestLocal = 0;
+  double   bestTheta = 0;
+
+  // boucle : décalage au point de référence + pente
+  uint8_t  nPoints = 0;
+  uint32_t refLocal = 0;
+  double   offset = 0;
+  float    rate = 0;
+  int32_t  lastErr = 0;
+  uint8_t  lockCount = 0;
+};
@@ -0,0 +1,13 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, sans réflexion) — "123456789" → 0x29B1
+// Utilisé par le protocole hôte (host_protocol.h) ; même calcul côté Python (hostproto.py)
+inline uint16_t crc16_ccitt(const uint8_t* p, size_t n, uint16_t crc = 0xFFFF) {
+  while (n--) {
+    crc ^= (uint16_t)(*p++) << 8;
+    for (uint8_t k = 0; k < 8; ++k) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  }
+  return crc;
+}
@@ -8,8 +8,16 @@ bool on_debug = true;  // active ou non les print dans pid.cpp
 bool on_debug_python = true; // active ou non les print dans motor.cpp
 bool on_debug_monitorarduino = false; // active ou non les print dans bash_test.cpp
 
+// ======================== benchmark latence MIDI (mode NORMAL) =========================
+// true = sondes RX→consigne→PWM et ADC→CC + rapports SysEx (outil host/midi_latency)
+bool on_bench_latency = false;
+
+// ======================== télémétrie SLIP par blocs (telemetry.h) =========================
+// true = trames 'T' int16 groupées (mode PYTHON : fader choisi ; mode NORMAL : tous les faders)
+bool on_telemetry = true;
+
 // ======================== variable pour le mode test =========================
-// 0 = OFF (rien), 1 = TEST LOCAL (séquence 5-50-25-95-75-0), 2 = PYTHON (réglages via série)
+// 0 = NORMAL (surface MIDI), 1 = TEST LOCAL (séquence 5-50-25-95-75-0), 2 = PYTHON (réglages via série)
 uint8_t bash_test_mode = 2; 
 
 //====================== DEBUG FADER ADC =====================
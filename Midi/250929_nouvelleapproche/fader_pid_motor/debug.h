@@ -4,6 +4,8 @@
 extern bool on_debug;
 extern bool on_debug_python;
 extern bool on_debug_monitorarduino;
+extern bool on_bench_latency;
+extern bool on_telemetry;
 extern uint8_t bash_test_mode;
 extern int debugOLED_fader;
 extern int debug_fadermoniteur;
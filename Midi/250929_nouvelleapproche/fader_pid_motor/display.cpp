@@ -1,5 +1,8 @@
 #include <Arduino.h>
+#include "hal.h"
 #include "display.h"
+#include "pin_int.h"
+#include "fader_bank.h"
 
 #include <Wire.h>
 #include <Adafruit_GFX.h>
@@ -8,13 +11,13 @@
 
 
 
-static Adafruit_SSD1306 oled(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+static Adafruit_SSD1306 oled(SCREEN_WIDTH, SCREEN_HEIGHT, &HALI2C::bus(), OLED_RESET);
+static bool     oledOk   = false;
+static int16_t  pushPos  = -1;      // -1 : rien à envoyer ; 0 : adressage ; > 0 : octet suivant + 1
 
 void setupOLED() {
     //set up écran oled 
-  Wire.setSDA(4);                 // SDA
-  Wire.setSCL(5);                 // SCL
-  Wire.begin();
+  HALI2C::begin(PicoBoard::OLED_SDA, PicoBoard::OLED_SCL);
   if (!oled.begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
     Serial.println("[OLED] Échec init SSD1306 @0x3C — vérifie SDA=4 SCL=5 et l'alim.");
     return;
@@ -33,7 +36,9 @@ void setupOLED() {
   else if (bash_test_mode == 1) oled.println("MONITOR");
   else if (bash_test_mode == 2) oled.println("PYTHON");
   else                          oled.println("UNKNOWN");
-  oled.display();
+  oled.display();                        // setup : avant l'ordonnanceur, bloquant sans gêne
+  HALI2C::bus().setClock(OLED_I2C_HZ);   // envois par morceaux : hors display(), horloge à fixer
+  oledOk = true;
 }
 
 
@@ -49,6 +54,36 @@ void drawOLED(int value) {
   int barLength = map(value, 0, 4095, 0, SCREEN_WIDTH);
   oled.fillRect(0, 20, barLength, 10, SSD1306_WHITE);
 
-  oled.display();
+  if (oledOk) pushPos = 0;               // envoi par loopOLEDPush()
 }
 
+bool oledBusy() { return pushPos >= 0; }
+
+void loopOLEDPush() {
+  if (pushPos < 0 || !oledOk) return;
+  TwoWire& w = HALI2C::bus();
+  if (pushPos == 0) {
+    // fenêtre = écran entier (adressage horizontal réglé par oled.begin)
+    static const uint8_t addr[] = { 0x00, 0x21, 0, SCREEN_WIDTH - 1, 0x22, 0, SCREEN_HEIGHT / 8 - 1 };
+    w.beginTransmission(OLED_I2C_ADDR);
+    w.write(addr, sizeof addr);
+    w.endTransmission();
+    pushPos = 1;
+    return;
+  }
+  const uint16_t at = (uint16_t)(pushPos - 1);
+  w.beginTransmission(OLED_I2C_ADDR);
+  w.write((uint8_t)0x40);                // octets de données
+  w.write(oled.getBuffer() + at, OLED_CHUNK_BYTES);
+  w.endTransmission();
+  pushPos = at + OLED_CHUNK_BYTES >= OLED_FRAME_BYTES ? -1 : (int16_t)(pushPos + OLED_CHUNK_BYTES);
+}
+
+void loopUI() {
+  if (debugOLED_fader != 1) return;
+  if (oledBusy()) return;                // trame précédente pas finie : pas de déchirure
+  // NORMAL : tous les faders ; PYTHON / TEST LOCAL : le fader choisi
+  if (bash_test_mode == 0) { for (uint8_t i = 0; i < NUM_FADERS; ++i) printFaderDebug(i); }
+  else                     printFaderDebug(fader_idx);
+  drawOLED(gBank.position[0]);
+}
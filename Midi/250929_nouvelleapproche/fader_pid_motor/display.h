@@ -1,13 +1,28 @@
 #pragma once
+#include <cstdint>
 
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 #define OLED_RESET -1
 
+// Envoi de la trame par morceaux : un display() complet (1 Kio en I2C ≈ 23 ms à 400 kHz)
+// bloquerait la boucle 1 kHz ; la tâche ui compose la trame en RAM, la tâche oled en
+// envoie OLED_CHUNK_BYTES à chaque passage (1 trame ≈ 65 ms, ~0,4 ms par passage)
+constexpr uint8_t  OLED_I2C_ADDR    = 0x3C;
+constexpr uint32_t OLED_I2C_HZ      = 400000;
+constexpr uint16_t OLED_CHUNK_BYTES = 16;
+constexpr uint16_t OLED_FRAME_BYTES = SCREEN_WIDTH * SCREEN_HEIGHT / 8;
+constexpr uint32_t OLED_CHUNK_US    = (OLED_CHUNK_BYTES + 2) * 9 * 1000000ULL / OLED_I2C_HZ;  // adresse + 0x40 + données, 9 bits/octet
+static_assert(OLED_FRAME_BYTES % OLED_CHUNK_BYTES == 0, "OLED_CHUNK_BYTES : diviseur de la trame");
+static_assert(OLED_CHUNK_US <= 500, "morceau OLED : ≤ 1/2 période de la boucle 1 kHz");
+
 
 //===================== setup et loop OLED  =========
 void setupOLED();
-void drawOLED(int value);
+void drawOLED(int value);   // compose la trame en RAM ; envoyée par loopOLEDPush()
+void loopUI();          // tâche ui (20 Hz) : trame OLED + moniteur série si debugOLED_fader
+void loopOLEDPush();    // tâche oled : 1 morceau de la trame en cours (rien si à jour)
+bool oledBusy();        // trame en cours d'envoi
 
 
 
@@ -0,0 +1,163 @@
+#include "dmx.h"
+#include <cstring>
+
+static const uint8_t ARTNET_ID[8] = { 'A', 'r', 't', '-', 'N', 'e', 't', 0 };
+static const uint8_t ACN_ID[12]   = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0 };
+
+static inline void wr16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)(v >> 8); p[1] = (uint8_t)v; }
+static inline void wr32(uint8_t* p, uint32_t v) { wr16(p, (uint16_t)(v >> 16)); wr16(p + 2, (uint16_t)v); }
+static inline uint16_t rd16(const uint8_t* p) { return (uint16_t)((p[0] << 8) | p[1]); }
+static inline uint32_t rd32(const uint8_t* p) { return ((uint32_t)rd16(p) << 16) | rd16(p + 2); }
+
+// E1.31 : positions dans le paquet de données (root 38, framing 77, DMP 11 octets)
+enum : size_t {
+  SACN_ROOT_FL = 16, SACN_ROOT_VEC = 18, SACN_CID = 22,
+  SACN_FRAME_FL = 38, SACN_FRAME_VEC = 40, SACN_SOURCE = 44, SACN_PRIO = 108,
+  SACN_SYNC = 109, SACN_SEQ = 111, SACN_OPTS = 112, SACN_UNIV = 113,
+  SACN_DMP_FL = 115, SACN_DMP_VEC = 117, SACN_DMP_TYPE = 118, SACN_DMP_FIRST = 119,
+  SACN_DMP_INC = 121, SACN_DMP_COUNT = 123, SACN_START = 125,
+};
+constexpr uint8_t SACN_OPT_TERMINATED = 0x40;
+
+static inline uint16_t flagsLength(size_t from) {   // PDU : 0x7 + longueur jusqu'à la fin
+  return (uint16_t)(0x7000 | (SACN_HDR + DMX_SLOTS - from));
+}
+
+// ===================== Émission =====================
+void DmxOutput::begin(DmxProtocol proto, uint16_t universe0, uint8_t count, uint32_t keepaliveUs,
+                      const uint8_t cid[16], const char* source, uint8_t priority,
+                      SendFn send, void* ctx) {
+  proto_       = proto;
+  hdr_         = proto == DMX_ARTNET ? ARTNET_HDR : SACN_HDR;
+  u0_          = universe0;
+  n_           = count > DMX_MAX_UNIVERSES ? DMX_MAX_UNIVERSES : count;
+  keepaliveUs_ = keepaliveUs;
+  send_        = send;
+  ctx_         = ctx;
+  dirty_ = sent_ = 0;
+  txFrames = txKeepalive = 0;
+
+  for (uint8_t u = 0; u < n_; ++u) {
+    uint8_t* p = pkt_[u];
+    memset(p, 0, sizeof pkt_[u]);
+    seq_[u] = 0;
+    const uint16_t univ = universe(u);
+    if (proto == DMX_ARTNET) {
+      memcpy(p, ARTNET_ID, sizeof ARTNET_ID);
+      p[8]  = 0x00; p[9] = 0x50;                       // OpDmx (LE)
+      wr16(p + 10, 14);                                // ProtVer
+      p[14] = (uint8_t)univ;                           // SubUni
+      p[15] = (uint8_t)((univ >> 8) & 0x7F);           // Net
+      wr16(p + 16, DMX_SLOTS);
+    } else {
+      wr16(p, 0x0010);                                 // préambule ; postambule 0
+      memcpy(p + 4, ACN_ID, sizeof ACN_ID);
+      wr16(p + SACN_ROOT_FL, flagsLength(SACN_ROOT_FL));
+      wr32(p + SACN_ROOT_VEC, 0x00000004);             // VECTOR_ROOT_E131_DATA
+      memcpy(p + SACN_CID, cid, 16);
+      wr16(p + SACN_FRAME_FL, flagsLength(SACN_FRAME_FL));
+      wr32(p + SACN_FRAME_VEC, 0x00000002);            // VECTOR_E131_DATA_PACKET
+      strncpy((char*)p + SACN_SOURCE, source, SACN_NAME_LEN - 1);
+      p[SACN_PRIO] = priority;
+      wr16(p + SACN_SYNC, 0);
+      wr16(p + SACN_UNIV, univ);
+      wr16(p + SACN_DMP_FL, flagsLength(SACN_DMP_FL));
+      p[SACN_DMP_VEC]  = 0x02;                         // VECTOR_DMP_SET_PROPERTY
+      p[SACN_DMP_TYPE] = 0xA1;
+      wr16(p + SACN_DMP_FIRST, 0);
+      wr16(p + SACN_DMP_INC, 1);
+      wr16(p + SACN_DMP_COUNT, DMX_SLOTS + 1);         // code de départ + canaux
+      p[SACN_START] = 0;
+    }
+  }
+  dirty_ = (uint8_t)((1u << n_) - 1);
+}
+
+bool DmxOutput::set8(uint16_t addr, uint8_t v) {
+  const uint8_t u = (uint8_t)(addr / DMX_SLOTS);
+  if (u >= n_) return false;
+  uint8_t& slot = data(u)[addr % DMX_SLOTS];
+  if (slot == v) return false;
+  slot = v;
+  dirty_ |= (uint8_t)(1u << u);
+  return true;
+}
+
+bool DmxOutput::set16(uint16_t addr, uint16_t v) {
+  const bool hi = set8(addr, (uint8_t)(v >> 8));
+  const bool lo = set8((uint16_t)(addr + 1), (uint8_t)v);
+  return hi || lo;
+}
+
+uint8_t DmxOutput::get(uint16_t addr) const {
+  const uint8_t u = (uint8_t)(addr / DMX_SLOTS);
+  return u < n_ ? pkt_[u][hdr_ + addr % DMX_SLOTS] : 0;
+}
+
+void DmxOutput::send(uint8_t u) {
+  uint8_t* p = pkt_[u];
+  if (proto_ == DMX_ARTNET) {
+    if (++seq_[u] == 0) seq_[u] = 1;                   // 0 = séquence désactivée
+    p[12] = seq_[u];
+  } else {
+    p[SACN_SEQ] = seq_[u]++;
+  }
+  if (send_) send_(ctx_, u, universe(u), p, hdr_ + DMX_SLOTS);
+}
+
+uint8_t DmxOutput::poll(uint32_t now_us) {
+  uint8_t sent = 0;
+  for (uint8_t u = 0; u < n_; ++u) {
+    const uint8_t bit = (uint8_t)(1u << u);
+    const bool changed = dirty_ & bit;
+    if (!changed && (sent_ & bit) && now_us - lastUs_[u] < keepaliveUs_) continue;
+    send(u);
+    if (changed) ++txFrames; else ++txKeepalive;
+    dirty_ &= (uint8_t)~bit;
+    sent_  |= bit;
+    lastUs_[u] = now_us;
+    ++sent;
+  }
+  return sent;
+}
+
+void DmxOutput::stop() {
+  if (proto_ != DMX_SACN) return;
+  for (uint8_t u = 0; u < n_; ++u) {
+    pkt_[u][SACN_OPTS] |= SACN_OPT_TERMINATED;
+    for (uint8_t k = 0; k < 3; ++k) send(u);
+    pkt_[u][SACN_OPTS] &= (uint8_t)~SACN_OPT_TERMINATED;
+  }
+  sent_ = 0;
+  dirty_ = (uint8_t)((1u << n_) - 1);
+}
+
+// ===================== Lecture =====================
+bool dmxParse(const uint8_t* buf, size_t len, DmxFrame& out) {
+  if (len >= ARTNET_HDR && !memcmp(buf, ARTNET_ID, sizeof ARTNET_ID)) {
+    if (buf[8] != 0x00 || buf[9] != 0x50) return false;       // autre OpCode (ArtPoll, ...)
+    const uint16_t n = rd16(buf + 16);
+    if (n > DMX_SLOTS || ARTNET_HDR + n > len) return false;
+    out.proto      = DMX_ARTNET;
+    out.universe   = (uint16_t)(((buf[15] & 0x7F) << 8) | buf[14]);
+    out.seq        = buf[12];
+    out.terminated = false;
+    out.count      = n;
+    out.data       = buf + ARTNET_HDR;
+    return true;
+  }
+  if (len > SACN_START && rd16(buf) == 0x0010 && !memcmp(buf + 4, ACN_ID, sizeof ACN_ID)) {
+    if (rd32(buf + SACN_ROOT_VEC) != 0x00000004 || rd32(buf + SACN_FRAME_VEC) != 0x00000002) return false;
+    if (buf[SACN_DMP_VEC] != 0x02 || buf[SACN_START] != 0) return false;   // code de départ DMX
+    const uint16_t n = rd16(buf + SACN_DMP_COUNT);
+    if (n < 1 || n > DMX_SLOTS + 1 || SACN_START + n > len) return false;
+    out.proto      = DMX_SACN;
+    out.universe   = rd16(buf + SACN_UNIV);
+    out.seq        = buf[SACN_SEQ];
+    out.terminated = buf[SACN_OPTS] & SACN_OPT_TERMINATED;
+    out.count      = (uint16_t)(n - 1);
+    out.data       = buf + SACN_HDR;
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+/*
+  Sortie DMX sur réseau : Art-Net (ArtDmx) ou sACN (E1.31) — nœuds Cerise du README
+  Code portable (pas d'Arduino) : le transport UDP est fourni par l'appelant
+  (dmx_eth.cpp sur W5500, host/dmx_peer.cpp sur Linux).
+
+  Univers : 512 canaux, rangés DIRECTEMENT dans le paquet prêt à partir (un tampon fixe
+  par univers, en-tête écrit une fois par begin()) → pas d'allocation ni de recopie ;
+  à l'envoi seuls la séquence (et les options sACN) sont mis à jour.
+  Adresse d'un canal : dmxAddr(univers local 0.., canal 1..512).
+    set8()  : 1 canal ; set16() : 2 canaux (gros / fin, comme les projecteurs 16 bits)
+    une valeur identique ne marque pas l'univers
+
+  poll(now), appelé à la cadence de rafraîchissement voulue :
+    - univers changé depuis le dernier envoi → 1 paquet
+    - univers inchangé depuis keepaliveUs → renvoyé tel quel (keep-alive : sACN exige
+      ≤ 1 s, Art-Net ≤ 4 s, sinon le nœud considère la source perdue)
+  stop() : sACN → 3 paquets "Stream_Terminated" par univers (le nœud lâche la source
+  tout de suite au lieu d'attendre 2,5 s) ; Art-Net → rien
+
+  Lecture (dmxParse) : ArtDmx ou E1.31 → univers, séquence, canaux (host/dmx_peer.cpp)
+*/
+
+// ===================== RÉGLAGES =====================
+constexpr uint16_t DMX_SLOTS         = 512;
+constexpr uint8_t  DMX_MAX_UNIVERSES = 4;
+constexpr uint16_t DMX_NO_ADDR       = 0xFFFF;   // canal non patché
+constexpr uint16_t ARTNET_PORT       = 6454;
+constexpr uint16_t SACN_PORT         = 5568;
+constexpr uint8_t  SACN_NAME_LEN     = 64;
+
+// en-têtes (octets avant le 1er canal)
+constexpr size_t   ARTNET_HDR        = 18;
+constexpr size_t   SACN_HDR          = 126;
+constexpr size_t   DMX_MAX_PACKET    = SACN_HDR + DMX_SLOTS;
+
+enum DmxProtocol : uint8_t { DMX_ARTNET, DMX_SACN };
+
+constexpr uint16_t dmxAddr(uint8_t u, uint16_t ch) { return (uint16_t)(u * DMX_SLOTS + ch - 1); }
+
+// ===================== Émission =====================
+class DmxOutput {
+ public:
+  // u = univers local (0..count-1), universe = numéro sur le réseau
+  typedef void (*SendFn)(void* ctx, uint8_t u, uint16_t universe, const uint8_t* pkt, size_t len);
+
+  // universe0 : 1er univers (sACN 1..63999, Art-Net port-address 0..32767), les suivants
+  // à la suite ; cid (16 octets) / source / priority : sACN seulement
+  void begin(DmxProtocol proto, uint16_t universe0, uint8_t count, uint32_t keepaliveUs,
+             const uint8_t cid[16], const char* source, uint8_t priority,
+             SendFn send, void* ctx);
+
+  bool    set8(uint16_t addr, uint8_t v);        // true si la valeur a changé
+  bool    set16(uint16_t addr, uint16_t v);      // gros à addr, fin à addr + 1
+  uint8_t get(uint16_t addr) const;
+  uint8_t poll(uint32_t now_us);                 // rend le nombre de paquets envoyés
+  void    stop();
+
+  uint8_t  count() const { return n_; }
+  uint16_t universe(uint8_t u) const { return (uint16_t)(u0_ + u); }
+
+  // Statistiques
+  uint32_t txFrames = 0, txKeepalive = 0;
+
+ private:
+  uint8_t* data(uint8_t u) { return pkt_[u] + hdr_; }
+  void     send(uint8_t u);
+
+  uint8_t     pkt_[DMX_MAX_UNIVERSES][DMX_MAX_PACKET] = {};
+  uint8_t     seq_[DMX_MAX_UNIVERSES] = {};
+  uint32_t    lastUs_[DMX_MAX_UNIVERSES] = {};
+  uint8_t     dirty_ = 0;                        // 1 bit par univers
+  uint8_t     sent_  = 0;                        // déjà envoyé au moins une fois
+  DmxProtocol proto_ = DMX_SACN;
+  size_t      hdr_ = SACN_HDR;
+  uint16_t    u0_ = 1;
+  uint8_t     n_ = 0;
+  uint32_t    keepaliveUs_ = 1000000;
+  SendFn      send_ = nullptr;
+  void*       ctx_ = nullptr;
+};
+
+// ===================== Lecture =====================
+struct DmxFrame {
+  DmxProtocol    proto;
+  uint16_t       universe;
+  uint8_t        seq;
+  bool           terminated;   // sACN Stream_Terminated
+  uint16_t       count;        // canaux présents
+  const uint8_t* data;         // canal 1 = data[0]
+};
+
+// ArtDmx ou E1.31 (code de départ 0) ; false sinon
+bool dmxParse(const uint8_t* buf, size_t len, DmxFrame& out);
@@ -0,0 +1,72 @@
+#include <Arduino.h>
+#include <Ethernet.h>
+#include <EthernetUdp.h>
+#include "dmx_eth.h"
+#include "rtpmidi_eth.h"       // setupEthernet(), ETH_MAC, RTPMIDI_NAME
+#include "fader_bank.h"        // gBank.position[]
+
+// ===================== ÉTAT =====================
+static DmxOutput   dmx;
+static EthernetUDP udp[DMX_PROTOCOL == DMX_SACN ? DMX_UNIVERSES : 1];
+static bool        dmxUp = false;
+
+// Faders : dernière valeur émise (comptes ADC) + dernier changement de position
+struct DmxFader { uint16_t sent, last; uint32_t changeUs; bool primed; };
+static DmxFader faders[NUM_FADERS] = {};
+
+constexpr uint32_t HYST_ADC = ((uint32_t)DMX_FADER_HYST * ADC_MAX + 254) / 255;   // en comptes ADC
+
+static IPAddress sacnGroup(uint16_t universe) {
+  return IPAddress(239, 255, (uint8_t)(universe >> 8), (uint8_t)universe);
+}
+
+// ===================== Envoi (DmxOutput) =====================
+static void dmxSend(void*, uint8_t u, uint16_t universe, const uint8_t* pkt, size_t len) {
+  constexpr bool sacn = DMX_PROTOCOL == DMX_SACN;
+  EthernetUDP& s = udp[sacn ? u : 0];
+  if (sacn) s.beginPacket(sacnGroup(universe), SACN_PORT);
+  else      s.beginPacket(IPAddress(DMX_ARTNET_IP[0], DMX_ARTNET_IP[1], DMX_ARTNET_IP[2], DMX_ARTNET_IP[3]), ARTNET_PORT);
+  s.write(pkt, len);                         // paquet déjà complet (dmx.h), 1 seule copie : vers la puce
+  s.endPacket();
+}
+
+// ===================== SETUP/LOOP =====================
+bool setupDmx() {
+  if (!DMX_ENABLE || !setupEthernet()) return false;
+  if (DMX_PROTOCOL == DMX_SACN) {
+    for (uint8_t u = 0; u < DMX_UNIVERSES; ++u) udp[u].beginMulticast(sacnGroup(DMX_UNIVERSE + u), SACN_PORT);
+  } else {
+    udp[0].begin(ARTNET_PORT);
+  }
+  // CID sACN : fixe pour une carte (le nœud reconnaît la source après un redémarrage)
+  uint8_t cid[16] = { 'R', 'o', 'u', 'l', 'a', 'n', 't', 'e', 'D', 'M' };
+  memcpy(cid + 10, ETH_MAC, 6);
+  dmx.begin(DMX_PROTOCOL, DMX_UNIVERSE, DMX_UNIVERSES, DMX_KEEPALIVE_MS * 1000UL,
+            cid, RTPMIDI_NAME, DMX_SACN_PRIORITY, dmxSend, nullptr);
+  dmxUp = true;
+  return true;
+}
+
+void loopDmx(uint32_t now_us) {
+  if (!dmxUp) return;
+  for (uint8_t i = 0; i < NUM_FADERS; ++i) {
+    const uint16_t a = DMX_FADER_ADDR[i];
+    if (a == DMX_NO_ADDR) continue;
+    DmxFader& f = faders[i];
+    const uint16_t p = gBank.position[i];
+    if (p != f.last) { f.last = p; f.changeUs = now_us; }
+    // hystérésis uniquement en mouvement ; au repos la valeur finale part toujours
+    const bool atRest = (uint32_t)(now_us - f.changeUs) >= DMX_FADER_SETTLE_MS * 1000UL;
+    const uint16_t d = p > f.sent ? p - f.sent : f.sent - p;
+    if (f.primed && d < HYST_ADC && !(atRest && d)) continue;
+    f.sent = p;
+    f.primed = true;
+    if (DMX_FADER_16BIT) dmx.set16(a, (uint16_t)((p * 65535u + ADC_MAX / 2) / ADC_MAX));
+    else                 dmx.set8(a, (uint8_t)((p * 255u + ADC_MAX / 2) / ADC_MAX));
+  }
+  if (DMX_KEY_ADDR != DMX_NO_ADDR) {
+    for (uint8_t k = 0; k < KEY_COUNT; ++k)
+      dmx.set8((uint16_t)(DMX_KEY_ADDR + k), keyIsDown(k) ? DMX_KEY_LEVEL : 0);
+  }
+  dmx.poll(now_us);
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include "dmx.h"
+#include "fader_filtre_adc.h"   // MAX_FADERS / NUM_FADERS
+#include "key_matrix.h"         // KEY_COUNT
+
+/*
+  Sortie DMX directe depuis la surface (W5500, même Ethernet que rtpmidi_eth.h)
+  Protocole : dmx.h (Art-Net ou sACN, univers rangés dans le paquet, keep-alive)
+
+  Sans DAW ni logiciel lumière : position des faders et état des touches → canaux DMX
+  des nœuds (Cerise U2 Pro du README) ; un rappel de scène (scene.h) déplace les faders,
+  donc fait aussi un "cue" lumière.
+    fader i   → DMX_FADER_ADDR[i] : 8 bits, ou 16 bits (canal gros + canal fin suivant)
+                hystérésis en mouvement (DMX_FADER_HYST pas du canal gros) : le bruit de
+                mesure ne salit pas l'univers ; au repos (DMX_FADER_SETTLE_MS sans
+                changement) la valeur finale part, pleine résolution (même règle que midi_io.h)
+    touche k  → DMX_KEY_ADDR + k  : DMX_KEY_LEVEL enfoncée, 0 relâchée
+  Tâche "dmx" à DMX_REFRESH_HZ : seuls les univers changés repartent, les autres
+  toutes les DMX_KEEPALIVE_MS.
+  sACN : multicast 239.255.<univers>, 1 socket W5500 par univers (beginMulticast) ;
+  Art-Net : 1 socket, vers DMX_ARTNET_IP (diffusion ou IP du nœud).
+  Sockets W5500 (8) : RTP-MIDI 2 + OSC 1 + lien hôte 1 + DMX ≤ 4.
+  Faders des modules (hub, modlink_uart.h) : pas encore patchés, faders locaux seulement.
+*/
+
+// ===================== RÉGLAGES (tout en haut) =====================
+constexpr bool        DMX_ENABLE        = false;     // actif seulement si ETH_ENABLE
+constexpr DmxProtocol DMX_PROTOCOL      = DMX_SACN;
+constexpr uint16_t    DMX_UNIVERSE      = 1;         // 1er univers (sACN 1..63999, Art-Net 0..32767)
+constexpr uint8_t     DMX_UNIVERSES     = 1;         // univers consécutifs émis
+constexpr uint32_t    DMX_REFRESH_HZ    = 40;        // trames max / s / univers (DMX512 : ≤ 44)
+constexpr uint32_t    DMX_KEEPALIVE_MS  = 1000;      // univers inchangé renvoyé (sACN : ≤ 1 s)
+constexpr uint8_t     DMX_SACN_PRIORITY = 100;       // 0..200 (100 = défaut E1.31)
+constexpr uint8_t     DMX_ARTNET_IP[4]  = { 255, 255, 255, 255 };
+
+// Patch : dmxAddr(univers local 0.., canal 1..512) ; DMX_NO_ADDR = non patché
+constexpr bool     DMX_FADER_16BIT = true;
+constexpr uint8_t  DMX_FADER_HYST  = 1;    // pas de 1/255 de course (canal gros) en mouvement
+constexpr uint32_t DMX_FADER_SETTLE_MS = 50;   // "au repos" après 50 ms sans changement
+constexpr uint16_t DMX_FADER_ADDR[MAX_FADERS] = { dmxAddr(0, 1), dmxAddr(0, 3), dmxAddr(0, 5), dmxAddr(0, 7) };
+constexpr uint16_t DMX_KEY_ADDR    = dmxAddr(0, 101);  // touches 0..KEY_COUNT-1 à la suite
+constexpr uint8_t  DMX_KEY_LEVEL   = 255;
+
+namespace DmxCheck {
+constexpr uint16_t END = DMX_UNIVERSES * DMX_SLOTS;
+constexpr bool patchFits() {
+  for (uint8_t i = 0; i < NUM_FADERS; ++i)
+    if (DMX_FADER_ADDR[i] != DMX_NO_ADDR && DMX_FADER_ADDR[i] + (DMX_FADER_16BIT ? 2 : 1) > END) return false;
+  return DMX_KEY_ADDR == DMX_NO_ADDR || DMX_KEY_ADDR + KEY_COUNT <= END;
+}
+}  // namespace DmxCheck
+
+static_assert(DMX_UNIVERSES >= 1 && DMX_UNIVERSES <= DMX_MAX_UNIVERSES, "DMX_UNIVERSES : 1..DMX_MAX_UNIVERSES");
+static_assert(DMX_PROTOCOL == DMX_ARTNET || (DMX_UNIVERSE >= 1 && DMX_UNIVERSE + DMX_UNIVERSES - 1 <= 63999), "univers sACN : 1..63999");
+static_assert(DMX_REFRESH_HZ >= 1 && DMX_REFRESH_HZ <= 44, "DMX_REFRESH_HZ : 1..44");
+static_assert(DMX_KEEPALIVE_MS <= 1000 || DMX_PROTOCOL == DMX_ARTNET, "sACN : keep-alive ≤ 1 s");
+static_assert(DmxCheck::patchFits(), "patch DMX hors des univers émis");
+static_assert(DMX_FADER_HYST >= 1, "DMX_FADER_HYST : ≥ 1 (0 = chaque compte ADC, univers toujours sale)");
+static_assert(DMX_FADER_SETTLE_MS * DMX_REFRESH_HZ >= 1000, "DMX_FADER_SETTLE_MS : au moins 1 période de la tâche dmx");
+
+// ===================== API =====================
+bool setupDmx();                             // sockets + univers ; false si désactivé / pas d'Ethernet
+void loopDmx(uint32_t now_us);               // tâche "dmx" : état surface → canaux → paquets
@@ -0,0 +1,68 @@
+#include <Arduino.h>
+#include "hal.h"
+#include "encoders.h"
+#include "midi_io.h"
+
+// ===================== ÉTAT =====================
+struct EncState {
+  int8_t   ch        = -1;    // canal HALQuadrature
+  int32_t  lastCount = 0;     // dernier compte matériel lu
+  int32_t  rem       = 0;     // comptes pas encore convertis en cran
+  int32_t  position  = 0;     // crans cumulés
+  float    speed     = 0;     // crans/s, lissée
+  uint32_t lastDetUs = 0;     // dernier cran (intervalle → vitesse)
+  float    frac      = 0;     // fraction de pas accéléré reportée
+};
+
+static EncState enc[ENC_COUNT];
+
+// ===================== ACCÉLÉRATION =====================
+static float accelGain(float speed) {
+  if (ENC_ACCEL_CURVE == ENC_ACCEL_OFF) return 1.0f;
+  float x = (fabsf(speed) - ENC_ACCEL_V0) / (ENC_ACCEL_V1 - ENC_ACCEL_V0);
+  x = constrain(x, 0.0f, 1.0f);
+  if (ENC_ACCEL_CURVE == ENC_ACCEL_QUADRATIC) x *= x;
+  return 1.0f + (ENC_ACCEL_MAX - 1.0f) * x;
+}
+
+// ===================== SETUP / BOUCLE =====================
+bool setupEncoders() {
+  uint8_t n = 0;
+  for (uint8_t e = 0; e < ENC_COUNT; ++e) {
+    enc[e].ch = HALQuadrature::begin(PicoBoard::ENC_PINS[e], ENC_SAMPLE_HZ);
+    if (enc[e].ch >= 0) { enc[e].lastCount = HALQuadrature::count(enc[e].ch); ++n; }
+  }
+  return n > 0;
+}
+
+void loopEncoders(uint32_t now_us) {
+  for (uint8_t e = 0; e < ENC_COUNT; ++e) {
+    EncState& s = enc[e];
+    if (s.ch < 0) continue;
+    const int32_t c = HALQuadrature::count(s.ch);
+    s.rem += (int32_t)((uint32_t)c - (uint32_t)s.lastCount);   // modulo 2^32 : rebouclage sans saut
+    s.lastCount = c;
+    const int32_t detents = s.rem / ENC_COUNTS_PER_DETENT;
+    s.rem -= detents * ENC_COUNTS_PER_DETENT;
+
+    const uint32_t since = now_us - s.lastDetUs;
+    if (!detents) {
+      if (since > ENC_SPEED_IDLE_MS * 1000u) s.speed = 0;
+      continue;
+    }
+    s.lastDetUs = now_us;
+    s.position += detents;
+    const float inst = since > ENC_SPEED_IDLE_MS * 1000u ? 0.0f : (float)detents * 1e6f / (float)since;
+    s.speed += ENC_SPEED_SMOOTH * (inst - s.speed);
+
+    // crans × gain ; la partie fractionnaire part avec les crans suivants du même sens
+    if ((s.frac < 0) != (detents < 0)) s.frac = 0;
+    s.frac += (float)detents * accelGain(s.speed);
+    const int32_t steps = (int32_t)s.frac;
+    s.frac -= (float)steps;
+    if (steps) MIDIIO_sendEncoderDelta(e, steps);
+  }
+}
+
+int32_t encPosition(uint8_t e) { return e < ENC_COUNT ? enc[e].position : 0; }
+float   encSpeed(uint8_t e)    { return e < ENC_COUNT ? enc[e].speed : 0.0f; }
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include "hal.h"
+#include "pin_int.h"
+#include "fader_filtre_adc.h"   // NUM_FADERS (broches des voies occupées)
+
+/*
+  Encodeurs rotatifs (EC11, README : 6 par surface)
+
+  - décodage en quadrature ×4 par PIO (HALQuadrature) : le compteur 32 bits vit dans la
+    machine PIO, aucune interruption par front ; rotation rapide = aucun pas perdu ni
+    surcoût CPU (le PIO échantillonne à ENC_SAMPLE_HZ)
+  - tâche "enc" (ENC_TASK_HZ) : 1 lecture du compteur par encodeur et par tick →
+    crans (ENC_COUNTS_PER_DETENT comptes, reste conservé)
+  - accélération : vitesse = crans / intervalle depuis le cran précédent, lissée
+    (EMA de poids ENC_SPEED_SMOOTH par cran, remise à 0 après ENC_SPEED_IDLE_MS) ;
+    gain = 1 sous ENC_ACCEL_V0, ENC_ACCEL_MAX à partir de ENC_ACCEL_V1, courbe
+    ENC_ACCEL_CURVE entre les deux ; les fractions de pas sont reportées
+  - sortie : MIDIIO_sendEncoderDelta() → même ordonnanceur coalescent que les faders
+    (MIDIIO_flush : au plus 1 message / encodeur / midi_out_interval_us, pas cumulés)
+      MIDI 1.0 : CC relatif "binary offset" (64 ± pas, ±63 par message) sur midi_enc_cc[e]
+      MIDI 2.0 : Relative Assignable Controller (NRPN relatif 32 bits), index midi_enc_cc[e]
+
+  Broches : PicoBoard::ENC_PINS (A ; B = A + 1), prises sur les voies fader 1..3 : avec
+  NUM_FADERS = 1 il reste 5 paires consécutives (Pico : 26 GPIO) ; le 6e encodeur va sur le
+  module clavier. Monter NUM_FADERS impose de baisser ENC_COUNT (static_assert plus bas).
+*/
+
+// ===================== RÉGLAGES (tout en haut) =====================
+constexpr uint8_t  ENC_MAX               = 6;
+constexpr uint8_t  ENC_COUNT             = 5;        // encodeurs câblés (≤ PicoBoard::ENC_PINS)
+constexpr uint8_t  ENC_COUNTS_PER_DETENT = 4;        // EC11 20 crans / 20 impulsions
+constexpr uint32_t ENC_SAMPLE_HZ         = 1000000;  // boucles PIO par seconde (≫ fronts)
+constexpr uint32_t ENC_TASK_HZ           = 1000;     // lecture des compteurs (scheduler.h)
+
+enum EncAccelCurve : uint8_t { ENC_ACCEL_OFF, ENC_ACCEL_LINEAR, ENC_ACCEL_QUADRATIC };
+constexpr EncAccelCurve ENC_ACCEL_CURVE  = ENC_ACCEL_QUADRATIC;
+constexpr float    ENC_ACCEL_V0          = 4.0f;     // crans/s : en dessous, 1 pas par cran
+constexpr float    ENC_ACCEL_V1          = 40.0f;    // crans/s : gain maximal atteint
+constexpr float    ENC_ACCEL_MAX         = 8.0f;     // pas par cran à pleine vitesse
+constexpr float    ENC_SPEED_SMOOTH      = 0.5f;     // poids du dernier intervalle
+constexpr uint32_t ENC_SPEED_IDLE_MS     = 250;      // arrêt : la vitesse repart de 0
+
+constexpr uint8_t  ENC_CC[ENC_MAX]       = { 20, 21, 22, 23, 24, 25 };  // CC relatif / index NRPN
+constexpr uint8_t  ENC_REL_CENTER        = 64;       // CC relatif : 64 = pas de mouvement
+constexpr int32_t  ENC_REL_MAX_STEP      = 63;
+
+namespace EncCheck {
+// paires A / A+1 libres : hors voies fader utilisées, hors périphériques partagés, distinctes
+constexpr bool pinsFree() {
+  uint8_t used[PicoBoard::NUM_GPIO] = {};
+  for (uint8_t i = 0; i < NUM_FADERS; ++i) {
+    ++used[PicoBoard::ADC_PINS[i]];
+    ++used[PicoBoard::TOUCH_PINS[i]];
+    ++used[PicoBoard::MOTOR_PINS[i][0]];
+    ++used[PicoBoard::MOTOR_PINS[i][1]];
+  }
+  for (uint8_t p : PicoBoard::SHARED_PINS) ++used[p];
+  for (uint8_t e = 0; e < ENC_COUNT; ++e) {
+    const uint8_t a = PicoBoard::ENC_PINS[e];
+    if (a + 1 >= PicoBoard::NUM_GPIO || used[a]++ || used[a + 1]++) return false;
+  }
+  return true;
+}
+}  // namespace EncCheck
+
+static_assert(ENC_COUNT <= ENC_MAX && ENC_COUNT <= sizeof PicoBoard::ENC_PINS, "ENC_COUNT > broches prévues");
+static_assert(ENC_COUNT <= HAL_QUAD_CHANNELS, "une machine PIO par encodeur");
+static_assert(EncCheck::pinsFree(), "encodeur sur une broche déjà prise : baisser ENC_COUNT ou NUM_FADERS");
+
+// ===================== API =====================
+bool    setupEncoders();                 // 1 machine PIO par encodeur ; false si aucun
+void    loopEncoders(uint32_t now_us);   // compteurs → crans → accélération → MIDI
+int32_t encPosition(uint8_t e);          // crans cumulés depuis le démarrage
+float   encSpeed(uint8_t e);             // crans/s lissés (signé)
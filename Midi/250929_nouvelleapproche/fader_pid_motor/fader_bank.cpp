@@ -0,0 +1,5 @@
+#include <Arduino.h>
+#include "fader_bank.h"
+
+// Banque de faders de la carte : NUM_FADERS voies sur le brochage PicoBoard
+Faders gBank;
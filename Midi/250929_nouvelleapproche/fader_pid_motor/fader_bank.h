@@ -0,0 +1,203 @@
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include "hal.h"
+#include "pin_int.h"
+#include "fader_filtre_adc.h"   // NUM_FADERS, ADC, filtre, FaderCalib
+#include "pid.h"                // class PID
+#include "motor.h"              // breakv, FREIN_ACTIF_CYCLES
+#include "touch.h"              // seuils tactiles
+
+// ====== Control Surface (obligatoire) ======
+#include <Arduino_Helpers.h>
+#include <AH/Hardware/FilteredAnalog.hpp>
+
+/*
+  FaderBank<N, Config> — N voies fader + moteur + tactile, taille fixée à la compilation
+  (banc d'essai 1 fader comme module complet : même code, NUM_FADERS seul change)
+
+  - Config = table des broches de la carte (PicoBoard, pin_int.h) ; vérifiée par
+    static_assert : N ≤ Config::MAX_CHANNELS, curseurs sur des entrées ADC, aucune
+    broche utilisée deux fois (voies + périphériques partagés)
+  - la banque possède tout l'état par voie : filtre ADC, position calibrée, consigne,
+    PID, sortie moteur, compteur de frein, tactile ; plus une calibration commune
+  - each(f) appelle f(I) pour I = 0..N-1 avec I constante de compilation
+    (std::integral_constant) : boucle déroulée, broches et index repliés en constantes
+  - les méthodes par voie (sense/control/actuate/touch) prennent un index déjà valide :
+    pas de test de borne à chaque tick ; l'index vient d'each() ou d'une entrée
+    validée en amont (protocole hôte, paquets Python)
+*/
+
+namespace FaderBankCheck {
+
+template <class C, uint8_t N>
+constexpr bool adcPinsOk() {
+  for (uint8_t i = 0; i < N; ++i) if (!C::isAdcPin(C::ADC_PINS[i])) return false;
+  return true;
+}
+
+template <class C, uint8_t N>
+constexpr bool pinsDistinct() {
+  uint8_t used[C::NUM_GPIO] = {};
+  auto take = [&used](uint8_t p) { return p < C::NUM_GPIO && used[p]++ == 0; };
+  for (uint8_t i = 0; i < N; ++i) {
+    if (!take(C::ADC_PINS[i]) || !take(C::TOUCH_PINS[i]) ||
+        !take(C::MOTOR_PINS[i][0]) || !take(C::MOTOR_PINS[i][1])) return false;
+  }
+  for (uint8_t p : C::SHARED_PINS) if (!take(p)) return false;
+  return true;
+}
+
+}  // namespace FaderBankCheck
+
+template <uint8_t N, class Config>
+class FaderBank {
+  static_assert(N >= 1 && N <= Config::MAX_CHANNELS, "N doit être entre 1 et Config::MAX_CHANNELS");
+  static_assert(FaderBankCheck::adcPinsOk<Config, N>(), "curseur de fader hors des entrées ADC");
+  static_assert(FaderBankCheck::pinsDistinct<Config, N>(), "broche utilisée deux fois (voies / périphériques)");
+
+ public:
+  using Filter = AH::FilteredAnalog<MY_ADC_BITS, FILTER_SHIFT, uint32_t>;
+  template <uint8_t I> using Index = std::integral_constant<uint8_t, I>;
+  static constexpr uint8_t size = N;
+
+  FaderBank() : FaderBank(std::make_index_sequence<N>{}) {}
+
+  // ===================== ÉTAT PAR VOIE =====================
+  uint16_t   position[N] = {};   // mesure filtrée + calibrée 0..ADC_MAX
+  uint16_t   setpoint[N] = {};   // consigne 0..ADC_MAX
+  int16_t    drive[N]    = {};   // sortie PID signée (PWM ±255)
+  bool       touched[N]  = {};   // doigt sur la piste
+  PID        pid[N];
+  FaderCalib calib;               // butées / snap / deadband (réglables à chaud)
+
+  // ===================== ITÉRATION =====================
+  template <class F>
+  static void each(F&& f) { eachImpl(f, std::make_index_sequence<N>{}); }
+
+  // ===================== SETUP =====================
+  // Curseurs en entrée + 1re lecture du filtre
+  void beginAdc() {
+    each([this](auto i) {
+      HALGpio::mode(Config::ADC_PINS[i], HALGpio::Input);
+      filter[i].update();
+      position[i] = (uint16_t)clamp((int)filter[i].getValue(), calib.usableMin, calib.usableMax);
+    });
+  }
+
+  // Ponts en H en roue libre (sécurité au boot) + fréquence PWM
+  void beginMotors() {
+    each([](auto i) {
+      HALGpio::mode(Config::MOTOR_PINS[i][0], HALGpio::Output);
+      HALGpio::mode(Config::MOTOR_PINS[i][1], HALGpio::Output);
+      HALGpio::write(Config::MOTOR_PINS[i][0], false);
+      HALGpio::write(Config::MOTOR_PINS[i][1], false);
+    });
+    HALPwm::frequency(freqMotor);
+  }
+
+  // Amorce la baseline tactile par moyenne de quelques mesures (doigt éloigné)
+  void beginTouch() {
+    each([this](auto i) {
+      uint32_t acc = 0;
+      const uint8_t n = 40;
+      for (uint8_t k = 0; k < n; ++k) {
+        acc += measureTouch(Config::TOUCH_PINS[i]);
+        HALTime::delayMs(2);
+      }
+      baseline[i] = (uint16_t)(acc / n > TOUCH_MIN_BASELINE ? acc / n : TOUCH_MIN_BASELINE);
+      lastTouch[i] = baseline[i];
+      touched[i] = false;
+    });
+  }
+
+  // ===================== PAR VOIE =====================
+  // ADC → filtre Control Surface → butées + normalisation → snap → deadband
+  void sense(uint8_t i) {
+    filter[i].update();
+    const FaderCalib& c = calib;
+    const int span = c.usableMax - c.usableMin;
+    if (span <= 0) return;                       // calibration incohérente : position gardée
+    int v = clamp((int)filter[i].getValue(), c.usableMin, c.usableMax);
+    v = (int)((long)(v - c.usableMin) * ADC_MAX / span);
+    if (v < c.snapLow)  v = 0;
+    if (v > c.snapHigh) v = ADC_MAX;
+    if (std::abs(v - (int)position[i]) < c.deadband) return;
+    position[i] = (uint16_t)v;
+  }
+
+  uint16_t filtered(uint8_t i) const { return (uint16_t)filter[i].getValue(); }
+
+  // PID : consigne + mesure → drive[i] (arrondi au plus proche)
+  void control(uint8_t i) {
+    pid[i].setSetpoint(setpoint[i]);
+    const float u = pid[i].update(position[i]);
+    drive[i] = (int16_t)((u >= 0.f) ? (u + 0.5f) : (u - 0.5f));
+  }
+
+  // drive[i] → pont en H : PWM limité à breakv, frein actif FREIN_ACTIF_CYCLES puis roue libre
+  void actuate(uint8_t i) {
+    const uint8_t in1 = Config::MOTOR_PINS[i][0], in2 = Config::MOTOR_PINS[i][1];
+    const int16_t u = drive[i] > PWM_LIMIT ? PWM_LIMIT : (drive[i] < -PWM_LIMIT ? -PWM_LIMIT : drive[i]);
+    if (u == 0) {
+      const bool brake = brakeCount[i] < FREIN_ACTIF_CYCLES;
+      HALGpio::write(in1, brake);
+      HALGpio::write(in2, brake);
+      if (brake) ++brakeCount[i];
+      return;
+    }
+    brakeCount[i] = 0;
+    if (u > 0) { HALGpio::write(in2, false); HALPwm::write(in1, (uint16_t)u); }   // avant
+    else       { HALGpio::write(in1, false); HALPwm::write(in2, (uint16_t)-u); }  // arrière
+  }
+
+  // Mesure RC + hystérésis autour de la baseline → touched[i]
+  bool touch(uint8_t i) {
+    const uint16_t t = measureTouch(Config::TOUCH_PINS[i]);
+    lastTouch[i] = t;
+    if (!touched[i]) { if (t >= baseline[i] + TOUCH_DELTA_ON)  touched[i] = true;  }
+    else             { if (t <= baseline[i] + TOUCH_DELTA_OFF) touched[i] = false; }
+    return touched[i];
+  }
+
+  // Baseline lente (EMA sur la dernière mesure) : suit la dérive, à TOUCH_BASELINE_HZ
+  void trackTouchBaseline(uint8_t i) {
+    baseline[i] = (uint16_t)((1.0f - TOUCH_BASELINE_ALPHA) * baseline[i] + TOUCH_BASELINE_ALPHA * lastTouch[i]);
+  }
+
+  // Boucle de régulation complète d'une voie
+  void step(uint8_t i) { sense(i); control(i); actuate(i); }
+
+ private:
+  static constexpr int16_t PWM_LIMIT = (int16_t)(255 * breakv);   // ~10 V sur le moteur
+
+  template <size_t... I>
+  explicit FaderBank(std::index_sequence<I...>) : filter{ Filter(Config::ADC_PINS[I])... } {}
+
+  template <class F, size_t... I>
+  static void eachImpl(F& f, std::index_sequence<I...>) { (f(Index<(uint8_t)I>{}), ...); }
+
+  static int clamp(int v, int lo, int hi) { return (v < lo) ? lo : (v > hi) ? hi : v; }
+
+  // Décharge (sortie LOW), libère la broche, mesure le temps de montée (µs)
+  static uint16_t measureTouch(uint8_t pin) {
+    HALGpio::mode(pin, HALGpio::Output);
+    HALGpio::write(pin, false);
+    HALTime::delayUs(TOUCH_DISCHARGE_US);
+    HALGpio::mode(pin, HALGpio::Input);
+    const uint32_t t0 = HALTime::micros();
+    while ((uint32_t)(HALTime::micros() - t0) < TOUCH_TIMEOUT_US) {
+      if (HALGpio::read(pin)) return (uint16_t)(HALTime::micros() - t0);
+    }
+    return TOUCH_TIMEOUT_US;   // timeout → assimilé à "touch fort"
+  }
+
+  Filter   filter[N];
+  uint8_t  brakeCount[N] = {};
+  uint16_t baseline[N]   = {};   // temps de montée tactile au repos (µs)
+  uint16_t lastTouch[N]  = {};   // dernière mesure (µs)
+};
+
+using Faders = FaderBank<NUM_FADERS, PicoBoard>;
+extern Faders gBank;   // fader_bank.cpp
@@ -1,10 +1,12 @@
 #pragma once
 #include <cstdint>
 #include <Arduino.h>
+#include "pin_int.h"           // PicoBoard : broches par voie
 
 /*
   Faders multi-canaux (RP2040) — Control Surface + zones mortes
-  - Nombre de faders réglable via NUM_FADERS (1..11)
+  - Nombre de faders réglable via NUM_FADERS (1..MAX_FADERS) ; l'état par voie vit dans
+    la banque de faders (fader_bank.h : gBank.position[i], gBank.calib…)
   - Filtre Control Surface (FilteredAnalog) si dispo, sinon filtre exponentiel simple
   - Zones mortes :
       1) Marges de butées : USABLE_MIN / USABLE_MAX (ignore un peu les extrémités mécaniques)
@@ -46,13 +48,10 @@
 
 
 // ===================== RÉGLAGES (tout en haut) =====================
-constexpr uint8_t MAX_FADERS = 4;   // limite dure (ne pas dépasser)
-constexpr uint8_t NUM_FADERS = 1;    // ← règle ici (1..11)
+constexpr uint8_t MAX_FADERS = PicoBoard::MAX_CHANNELS;   // limite dure (voies ADC de la carte)
+constexpr uint8_t NUM_FADERS = 1;    // ← règle ici (1..MAX_FADERS)
 constexpr int DEADBAND_ADC = 8;  // ajuste 2-8 selon tolérance
 
-// Liste des broches ADC pour jusqu’à 11 faders (RP2040 : GP26=ADC0, GP27=ADC1, GP28=ADC2, GP29=ADC3)
-constexpr uint8_t FADER_PINS[MAX_FADERS] = { A0, A1, A2, A3 };
-
 // ADC (RP2040 : 12 bits → 0..4095)
 constexpr int MY_ADC_BITS = 12;
 constexpr int ADC_MAX  = (1 << MY_ADC_BITS) - 1;
@@ -68,11 +67,20 @@ constexpr int  USABLE_MAX   = 4060;  // marge haute (butée mécanique)
 constexpr int  snap_low    = 8 ; // valeur en dessous de laquel le fader se met a 0
 constexpr int  snap_high   = 4080 ; // valeur au dessus de laquel le fader se met a 4095
 
+// Calibration réglable à chaud (protocole hôte, host_protocol.h) ; départ = constantes ci-dessus
+struct FaderCalib {
+  int16_t usableMin = USABLE_MIN;
+  int16_t usableMax = USABLE_MAX;
+  int16_t snapLow   = snap_low;
+  int16_t snapHigh  = snap_high;
+  int16_t deadband  = DEADBAND_ADC;
+};
+
 // Cadence
 constexpr uint8_t LOOP_DELAY_MS = 2;
 
-extern uint16_t gFaderADC[MAX_FADERS]; // valeurs filtrées brutes 0..4095
 extern uint8_t fader_idx;    // fader/moteur à tester/envoyer
 
 void setupADC();
-void loopfader(uint8_t i);
\ No newline at end of file
+void loopfader(uint8_t i);
+void printFaderDebug(uint8_t i);   // ligne moniteur série (debugOLED_fader, tâche ui)
\ No newline at end of file
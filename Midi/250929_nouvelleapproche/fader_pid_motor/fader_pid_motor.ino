@@ -1,25 +1,193 @@
 #include <Arduino.h>
+#include "hal.h"
 #include "display.h"
 #include "fader_filtre_adc.h"
 #include "pid.h"
 #include "motor.h"
+#include "touch.h"
+#include "fader_bank.h"
+#include "midi_io.h"
+#include "scene.h"
+#include "latency_bench.h"
+#include "rtpmidi_eth.h"
+#include "osc_eth.h"
+#include "telemetry.h"
+#include "step_metrics.h"
+#include "gain_schedule.h"
 #include "bash_test_LOCAL.hpp"
 #include "bash_test_python.hpp"
 #include "debug.h"
+#include "heap_guard.h"
+#include "scheduler.h"
+#include "key_matrix.h"
+#include "encoders.h"
+#include "modlink_uart.h"
+#include "dmx_eth.h"
 
 
 // === Variables pour communication Python ===
 float t_sec = 0.0f;       // temps en secondes (sera mis à jour dans loop)
 //
 
+// ===================== TÂCHES (scheduler.h) =====================
+// Groupes de fréquence, déclarés dans setup() par ordre de priorité :
+//   link 4 kHz · midi_in 1 kHz · control 1 kHz · keys 1 kHz · enc 1 kHz · midi_out (midi_out_interval_us)
+//   · oled 1 kHz · dmx 40 Hz · touch_bl 50 Hz · scene_fl 10 Hz · ui 20 Hz · host / telem en fond
+// Une seule tâche par passage : aucun budget au-delà de CONTROL_PERIOD_US (l'OLED est
+// envoyé par morceaux, display.h)
+constexpr uint32_t CONTROL_PERIOD_US = 1000;
+constexpr uint32_t UI_PERIOD_US      = 50000;   // 20 Hz (trame OLED + moniteur série)
+static_assert(OLED_CHUNK_US < CONTROL_PERIOD_US, "morceau OLED : plus court que la boucle 1 kHz");
+
+static int8_t midiOutTask = -1;
+static bool   keys_ok     = false;
+static bool   enc_ok      = false;
+static bool   link_ok     = false;
+static bool   dmx_ok      = false;
+
+// Entrées réseau / USB : consignes DAW, RTP-MIDI, OSC, trames hôte
+static void taskMidiIn(uint32_t) {
+    if (bash_test_mode != 0) return;
+    MIDIIO_loop();
+    loopRtpMidi();                 // RTP-MIDI (Ethernet) : session + consignes réseau
+    loopOsc();                     // OSC /fader/N (Ethernet) : consignes pleine résolution
+}
+
+// === Mode NORMAL (bash_test_mode == 0) : surface MIDI ===
+// consigne DAW → PID → moteur ; doigt sur le fader → moteur coupé + position vers le DAW
+static void controlSurface(uint32_t now) {
+    loopScene();                   // rappel de scène : trajectoires → gBank.setpoint[]
+    Faders::each([now](auto i) {   // déroulée : i constante de compilation par voie
+        uint16_t ref;
+        if (MIDIIO_getTargetIfUpdated(i, ref)) {
+            benchMark(BENCH_RX, i);
+            sceneCancel(i);
+            gBank.setpoint[i] = ref;
+            benchMark(BENCH_SP, i);
+        }
+
+        loopfader(i);
+        uint16_t inj;
+        if (benchTakeInjection(i, inj)) {   // benchmark : position imposée par l'hôte
+            benchMark(BENCH_ADC, i);
+            MIDIIO_sendPositionFromADC(i, inj);
+        } else if (loopTouch(i)) {
+            sceneCancel(i);
+            // le doigt a la priorité : moteur coupé, la consigne suit la main
+            gBank.pid[i].resetIntegral();
+            gBank.drive[i]    = 0;
+            gBank.setpoint[i] = gBank.position[i];
+            MIDIIO_sendPositionFromADC(i, gBank.position[i]); // mémorisé, envoyé au flush
+            stepCancel(i, now);
+        } else {
+            loopPID(i);
+            stepSample(i, now);      // mesures de réponse indicielle (step_metrics.h)
+        }
+        loopmotor(i);
+        if (gBank.drive[i] != 0) benchMark(BENCH_PWM, i);
+    });
+    loopBench();
+    if (on_telemetry) telemSample(now);
+}
+
+// === Mode PYTHON (bash_test_mode == 2) : un seul fader, réglé par Tuning.py ===
+static void controlPython(uint32_t now) {
+    const uint8_t i = fader_idx;         // fader/moteur choisi par Python
+    loopfader(i);                        // rafraîchit gBank.position[i]
+    loopPID(i);                          // calcule gBank.drive[i]
+    stepSample(i, now);                  // 1 enregistrement 'R' par mouvement (step_metrics.h)
+    loopmotor(i);                        // applique gBank.drive[i]
+
+    if (on_telemetry) {
+        // trames 'T' groupées (TELEM_SAMPLES échantillons int16 à 1 kHz)
+        static uint16_t telemMask = 0;
+        if (telemMask != (1u << i)) { telemMask = (uint16_t)(1u << i); telemBegin(telemMask); }
+        telemSample(now);
+        return;
+    }
+    // ENVOI de la trame à Tuning.py (4/5 colonnes, mais au moins 3)
+    static uint32_t t0 = HALTime::millis();
+    const float t_py = (HALTime::millis() - t0) * 0.001f;
+    tuningSendSample(i, t_py, gBank.setpoint[i], gBank.position[i], gBank.drive[i]);
+}
+
+static void taskControl(uint32_t now) {
+    t_sec = HALTime::millis() / 1000.0f;
+    switch (bash_test_mode) {
+        case 0: controlSurface(now); break;
+        case 1:                                   // séquence locale (bash_test_LOCAL.hpp)
+            loop_test_bash_local();
+            Faders::each([&](auto i) { stepSample(i, now); });
+            if (on_debug && on_debug_python)
+                tuningSendSample(fader_idx, t_sec, gBank.setpoint[fader_idx], gBank.position[fader_idx], gBank.drive[fader_idx]);
+            break;
+        case 2: controlPython(now); break;
+    }
+}
+
+// ≤ 1 CC / fader / intervalle, 1 seul transfert USB
+// période = midi_out_interval_us (réglable à chaud), jamais plus vite que la boucle 1 kHz
+static uint32_t midiOutPeriod() {
+    return midi_out_interval_us < CONTROL_PERIOD_US ? CONTROL_PERIOD_US : midi_out_interval_us;
+}
+
+static void taskMidiOut(uint32_t now) {
+    if (bash_test_mode == 0) MIDIIO_flush(now);
+    schedSetPeriod(midiOutTask, midiOutPeriod());
+}
+
+// Liaison inter-modules : réponses au hub ou interrogation des modules (modlink_uart.h)
+static void taskModLink(uint32_t now) {
+    if (bash_test_mode == 0) loopModLink(now);
+}
+
+// Matrice de touches : anti-rebond de la dernière trame DMA → notes (key_matrix.h)
+static void taskKeys(uint32_t now) {
+    if (bash_test_mode == 0) loopKeys(now);
+}
+
+// Encodeurs : compteurs PIO → crans accélérés → pas relatifs cumulés jusqu'au flush (encoders.h)
+static void taskEncoders(uint32_t now) {
+    if (bash_test_mode == 0) loopEncoders(now);
+}
+
+// DMX : faders / touches → univers Art-Net / sACN, seuls les changés repartent (dmx_eth.h)
+static void taskDmx(uint32_t now) {
+    if (bash_test_mode == 0) loopDmx(now);
+}
+
+static void taskTouchBaseline(uint32_t) {
+    if (bash_test_mode == 0) Faders::each([](auto i) { loopTouchBaseline(i); });
+}
+
+// Scènes mémorisées : écriture flash différée, moteurs au repos (scene.h)
+static void taskSceneFlush(uint32_t) {
+    if (bash_test_mode == 0) sceneFlush(HALTime::millis());
+}
+
+static void taskUI(uint32_t) { loopUI(); }
+
+// OLED : 1 morceau de la trame composée par ui (display.h)
+static void taskOled(uint32_t) { loopOLEDPush(); }
+
+// Paquets SLIP de Tuning.py (modes PYTHON / TEST LOCAL ; en NORMAL : via MIDIIO_loop)
+static void taskHost(uint32_t) {
+    if (bash_test_mode == 2 || (bash_test_mode == 1 && on_debug && on_debug_python)) tuningHandle();
+}
+
+static void taskTelemetry(uint32_t) {
+    telemPoll();
+    stepPoll();                    // enregistrements 'R' en attente, entre deux trames 'T'
+}
+
 void setup() {
     debugsetup();
     setupOLED();
-    analogReadResolution(MY_ADC_BITS);
-    for (uint8_t i = 0; i < NUM_MOTOR; ++i) {
-        setPosition[i] = 0; // par défaut au minimum
-        Dirmotor[i] = 0;   // par défaut moteur à l'arrêt
-    }
+    HALAdc::resolution(MY_ADC_BITS);
+    Faders::each([](auto i) {
+        gBank.setpoint[i] = 0; // par défaut au minimum
+        gBank.drive[i] = 0;   // par défaut moteur à l'arrêt
+    });
 
     // ------------------------------
     // Sélection du mode série (un seul)
@@ -27,61 +195,55 @@ void setup() {
     if (on_debug) {
         if (on_debug_python) {
             // Tuning.py → haut débit
-            Serial.begin(1000000);
-            unsigned long t0 = millis();
             tuningBegin(1000000);          // ← IMPORTANT : init SLIP, timers, etc.
-            while (!Serial && (millis() - t0) < 1500) {}
         } else if (on_debug_monitorarduino) {
             // Moniteur Arduino
-            Serial.begin(115200);
-            delay(10);
+            HALSerial::begin(115200);
+            HALTime::delayMs(10);
         }
     }
     // ADC & filtres faders
     setupADC();
     setupmotor();
 
+    // Surface MIDI (mode NORMAL uniquement)
+    if (bash_test_mode == 0) {
+        setupTouch();
+        setupScene();
+        MIDIIO_begin();
+        setupRtpMidi();
+        setupOsc();
+        keys_ok = setupKeys();
+        enc_ok  = setupEncoders();
+        link_ok = setupModLink();
+        dmx_ok  = setupDmx();
+    }
+    if (on_telemetry) telemBegin(bash_test_mode == 0 ? 0xFFFF : (uint16_t)(1u << fader_idx));
+
     // PID : utilise les valeurs Python si on est en mode python ET bash_test_mode==1
     const bool use_python_vals = (on_debug && on_debug_python && (bash_test_mode == 1));
     initial_PIDv(use_python_vals);
-
+    gsBegin();                             // tables de séquencement = gains ci-dessus
+    gsSetEnabled(GS_ENABLE_DEFAULT);
+
+    // Ordonnanceur : ordre = priorité ; budgets en µs (dépassements comptés)
+    if (link_ok) schedAdd("link", taskModLink, MODLINK_TASK_US,     100);
+    schedAdd("midi_in",  taskMidiIn,        CONTROL_PERIOD_US,      200);
+    schedAdd("control",  taskControl,       CONTROL_PERIOD_US,      500);
+    if (keys_ok) schedAdd("keys", taskKeys,  1000000 / KEY_TASK_HZ,   100);
+    if (enc_ok)  schedAdd("enc",  taskEncoders, 1000000 / ENC_TASK_HZ, 100);
+    midiOutTask = schedAdd("midi_out", taskMidiOut, midiOutPeriod(),   300);
+    schedAdd("oled",     taskOled,          CONTROL_PERIOD_US,      OLED_CHUNK_US + 100);
+    if (dmx_ok)  schedAdd("dmx",  taskDmx,  1000000 / DMX_REFRESH_HZ, 200);
+    schedAdd("touch_bl", taskTouchBaseline, 1000000 / TOUCH_BASELINE_HZ, 50);
+    schedAdd("scene_fl", taskSceneFlush,    1000000 / SCENE_FLUSH_HZ, 50);   // commit flash : hors budget, moteurs au repos
+    schedAdd("ui",       taskUI,            UI_PERIOD_US,           300);
+    schedAdd("host",     taskHost,          0,                      300);
+    schedAdd("telem",    taskTelemetry,     0,                      200);
+
+    heapGuardArm();   // plus aucune allocation à partir d'ici (heap_guard.h)
 }
 
 void loop() {
-    // mettre à jour le temps (millis() → secondes)
-    t_sec = millis() / 1000.0f;
-
-    // Boucle PID pour tous les faders
- if (bash_test_mode == 2) {             // === Mode Python ===
-    tuningHandle();                      // lit les paquets SLIP (p/i/d/t/c/s)
-
-    const uint8_t i = fader_idx;         // fader/moteur choisi par Python
-    loopfader(i);                        // rafraîchit gFaderADC[i]
-    loopPID(i);                          // calcule Dirmotor[i]
-    loopmotor(i);                        // applique Dirmotor[i]
-
-    // horodatage en secondes (float)
-    static uint32_t t0 = millis();
-    float t_sec = (millis() - t0) * 0.001f;
-
-    // ENVOI de la trame à Tuning.py (4/5 colonnes, mais au moins 3)
-    tuningSendSample(i, t_sec, setPosition[i], gFaderADC[i], Dirmotor[i]);
-    return;
-  }
-
-    // --- Bash test local ---
-    if (bash_test_mode == 0) return; // pas de com Python
-    if (bash_test_mode == 1) {
-        loop_test_bash_local();  // ton test local
-    }
-
-    // --- Communication Python ---
-    if (on_debug && on_debug_python) {
-        tuningHandle();
-        tuningSendSample(fader_idx, t_sec, setPosition[fader_idx], gFaderADC[fader_idx], Dirmotor[fader_idx]);
-    }
+    schedRun();
 }
-
-
-
-
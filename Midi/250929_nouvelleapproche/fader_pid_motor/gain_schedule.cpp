@@ -0,0 +1,118 @@
+#include <Arduino.h>
+#include "gain_schedule.h"
+#include "fader_bank.h"        // gBank.pid[] / setpoint[] / position[]
+
+static inline uint16_t absDiff(uint16_t a, uint16_t b) { return a > b ? a - b : b - a; }
+
+static inline GsGains lerp(const GsGains& a, const GsGains& b, float t) {
+  return { a.kp + (b.kp - a.kp) * t, a.ki + (b.ki - a.ki) * t, a.kd + (b.kd - a.kd) * t };
+}
+
+// segment [bp[k], bp[k+1]] qui contient x (borné aux extrémités), t ∈ [0, 1]
+template <uint8_t N>
+static inline uint8_t segment(const uint16_t (&bp)[N], uint16_t x, float& t) {
+  if (x <= bp[0])     { t = 0; return 0; }
+  if (x >= bp[N - 1]) { t = 1; return N - 2; }
+  uint8_t k = 0;
+  while (x >= bp[k + 1]) ++k;
+  t = float(x - bp[k]) / float(bp[k + 1] - bp[k]);
+  return k;
+}
+
+// ===================== Table + interpolation =====================
+void GainScheduler::fill(const GsGains& g) {
+  for (auto& c : table_) c = g;
+  written_ = 0;
+  fresh_ = true;
+}
+
+void GainScheduler::refill(const GsGains& g) {
+  for (uint8_t c = 0; c < GS_CELLS; ++c) if (!(written_ & (1UL << c))) table_[c] = g;
+  fresh_ = true;
+}
+
+bool GainScheduler::set(uint8_t cell, const GsGains& g) {
+  if (cell >= GS_CELLS) return false;
+  table_[cell] = g;
+  written_ |= 1UL << cell;
+  fresh_ = true;                     // ligne en cours recalculée au prochain tick
+  return true;
+}
+
+void GainScheduler::latch(uint16_t size, uint8_t dir) {
+  float t;
+  const uint8_t k = segment(GS_SIZE_BP, size, t);
+  for (uint8_t p = 0; p < GS_POS; ++p)
+    row_[p] = lerp(table_[gsCell(dir, k, p)], table_[gsCell(dir, k + 1, p)], t);
+  size_ = size;
+  dir_  = dir;
+}
+
+void GainScheduler::apply(PID& pid, uint16_t setpoint, uint16_t position) {
+  bool latched = false;
+  if (fresh_ || setpoint != sp_) {
+    const uint16_t size = absDiff(setpoint, position);
+    const uint8_t  dir  = setpoint >= position ? 0 : 1;
+    // mouvement en cours (ancienne consigne pas encore atteinte) : on garde sa ligne,
+    // sauf saut plus grand ou changement de sens
+    const bool running = !fresh_ && absDiff(sp_, position) > GS_SETTLED;
+    if (!running || size > size_ || dir != dir_) { latch(size, dir); latched = true; }
+    sp_    = setpoint;
+    fresh_ = false;
+  }
+  if (!latched && absDiff(position, pos_) < GS_POS_STEP) return;
+  pos_ = position;
+  float t;
+  const uint8_t k = segment(GS_POS_BP, position, t);
+  const GsGains g = lerp(row_[k], row_[k + 1], t);
+  pid.setGainsBumpless(g.kp, g.ki, g.kd);
+}
+
+// ===================== ÉTAT =====================
+static GainScheduler scheds[NUM_FADERS];
+static GsGains       base[NUM_FADERS];     // gains hors séquencement, rendus à l'arrêt
+static bool          enabled = false;
+
+static GsGains pidGains(uint8_t i) {
+  const PID& p = gBank.pid[i];
+  return { p.getKp(), p.getKi(), p.getKd() };
+}
+
+// gains de base = gains du PID à cet instant (réglage à chaud compris), aussi pour
+// les cellules jamais chargées
+static void takeBase(uint8_t i) {
+  base[i] = pidGains(i);
+  scheds[i].refill(base[i]);
+}
+
+// ===================== API =====================
+void gsBegin() {
+  Faders::each([](auto i) { scheds[i].fill(pidGains(i)); });
+}
+
+void gsSetEnabled(bool on) {
+  if (on == enabled) return;
+  if (on) {
+    Faders::each([](auto i) { takeBase(i); });
+  } else {
+    Faders::each([](auto i) { gBank.pid[i].setGainsBumpless(base[i].kp, base[i].ki, base[i].kd); });
+  }
+  enabled = on;
+}
+
+bool gsEnabled() { return enabled; }
+
+bool gsSet(uint8_t i, uint8_t cell, const GsGains& g) {
+  return i < NUM_FADERS && scheds[i].set(cell, g);
+}
+
+const GsGains& gsGet(uint8_t i, uint8_t cell) { return scheds[i].get(cell); }
+
+void gsRestart() {
+  if (!enabled) return;
+  Faders::each([](auto i) { takeBase(i); });
+}
+
+void gsApply(uint8_t i) {
+  if (enabled) scheds[i].apply(gBank.pid[i], gBank.setpoint[i], gBank.position[i]);
+}
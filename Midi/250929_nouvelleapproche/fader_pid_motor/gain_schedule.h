@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include "fader_filtre_adc.h" // NUM_FADERS / ADC_MAX
+#include "pid.h"              // PID::setGainsBumpless
+
+/*
+  Séquencement de gains (gain scheduling) du PID, une table par fader
+  Les essais enregistrés (python/data/, fichiers .tsv) montrent un fader qui ne répond pas pareil
+  près des butées qu'au milieu, ni pour une retouche de quelques comptes que pour une
+  course complète : un seul jeu Kp / Ki / Kd est un compromis (retouche molle ou grand
+  mouvement qui dépasse).
+
+  Table : GS_DIRS × GS_SIZES × GS_POS cellules { Kp, Ki, Kd }
+    sens        0 montée, 1 descente (pas d'interpolation)
+    taille      |consigne − position| relevé au saut de consigne, points GS_SIZE_BP
+    position    position courante, points GS_POS_BP (butées / milieu)
+  Interpolation linéaire entre points (bornée aux extrémités) :
+    - au saut : taille → 1 ligne de GS_POS gains (fixe pendant le mouvement : les gains
+      ne glissent pas vers "retouche" pendant l'approche d'un grand mouvement)
+    - en course : position → gains, recalculés tous les GS_POS_STEP comptes
+    - une consigne qui change pendant un mouvement (flux DAW, rampe de scène) ne relève
+      une nouvelle taille que si elle est plus grande ou change de sens ; mouvement fini
+      quand |erreur| ≤ GS_SETTLED
+  Chaque changement passe par PID::setGainsBumpless (intégrale remise à l'échelle).
+
+  Réglage : cellule par cellule par le protocole hôte (GSCHED_SET / GSCHED_GET,
+  host_protocol.h) ; outil python/gain_schedule.py (lecture / chargement JSON /
+  évaluation par zone avec les mesures de step_metrics.h). Actif si gain_schedule = 1 :
+  kp / ki / kd lus par GET sont alors les gains séquencés du moment, un SET est écrasé ;
+  à l'arrêt, les gains d'avant reviennent. Table en RAM (pas d'EEPROM).
+  Cellules jamais écrites : recopiées des gains courants du PID à chaque mise en marche
+  (et à chaque pidBegin en marche) → comportement inchangé tant qu'aucune n'est chargée,
+  même après un réglage kp / ki / kd à chaud.
+*/
+
+// ===================== RÉGLAGES =====================
+constexpr bool     GS_ENABLE_DEFAULT = false;   // réglable à chaud : gain_schedule
+constexpr uint8_t  GS_DIRS     = 2;
+constexpr uint8_t  GS_SIZES    = 3;
+constexpr uint8_t  GS_POS      = 4;
+constexpr uint16_t GS_SIZE_BP[GS_SIZES] = { 32, 256, 2048 };        // retouche / moyen / grand
+constexpr uint16_t GS_POS_BP[GS_POS]    = { 0, ADC_MAX / 10, ADC_MAX - ADC_MAX / 10, ADC_MAX };
+constexpr uint16_t GS_POS_STEP = 8;      // comptes parcourus avant de recalculer les gains
+constexpr uint16_t GS_SETTLED  = 8;      // |erreur| ≤ : mouvement terminé
+constexpr uint8_t  GS_CELLS    = GS_DIRS * GS_SIZES * GS_POS;
+static_assert(GS_CELLS <= 32, "GS_CELLS : 1 bit par cellule (GainScheduler::written_)");
+
+static_assert(GS_SIZE_BP[0] < GS_SIZE_BP[1] && GS_SIZE_BP[1] < GS_SIZE_BP[2], "GS_SIZE_BP croissant");
+static_assert(GS_POS_BP[0] < GS_POS_BP[1] && GS_POS_BP[1] < GS_POS_BP[2] && GS_POS_BP[2] < GS_POS_BP[3], "GS_POS_BP croissant");
+
+struct GsGains { float kp, ki, kd; };
+
+constexpr uint8_t gsCell(uint8_t dir, uint8_t size, uint8_t pos) {
+  return (uint8_t)((dir * GS_SIZES + size) * GS_POS + pos);
+}
+
+// ===================== Table + interpolation (1 par fader) =====================
+class GainScheduler {
+ public:
+  void fill(const GsGains& g);                 // toutes les cellules, marquées non écrites
+  void refill(const GsGains& g);               // cellules jamais écrites par set()
+  bool set(uint8_t cell, const GsGains& g);    // false si hors table
+  const GsGains& get(uint8_t cell) const { return table_[cell]; }
+  void restart() { fresh_ = true; }            // relève la taille au prochain apply()
+  // avant PID::update : gains de la consigne / position courantes → pid
+  void apply(PID& pid, uint16_t setpoint, uint16_t position);
+
+ private:
+  void latch(uint16_t size, uint8_t dir);
+
+  GsGains  table_[GS_CELLS] = {};
+  uint32_t written_ = 0;           // bit n : cellule n écrite par set()
+  GsGains  row_[GS_POS] = {};      // ligne interpolée sur la taille du mouvement en cours
+  uint16_t sp_ = 0, pos_ = 0, size_ = 0;
+  uint8_t  dir_ = 0;
+  bool     fresh_ = true;
+};
+
+// ===================== API (firmware) =====================
+void gsBegin();                                       // tables = gains courants des PID, rien d'écrit
+void gsSetEnabled(bool on);                           // paramètre hôte gain_schedule
+bool gsEnabled();
+bool gsSet(uint8_t i, uint8_t cell, const GsGains& g);
+const GsGains& gsGet(uint8_t i, uint8_t cell);
+void gsRestart();                                     // pidBegin : PID recréés, gains de base relus
+void gsApply(uint8_t i);                              // loopPID, avant gBank.control(i)
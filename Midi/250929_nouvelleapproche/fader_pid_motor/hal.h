@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/*
+  HAL — seul point de contact des modules avec le matériel
+  (même principe que HALSerial des anciens projets, étendu à tout le matériel)
+
+    HALTime    micros / millis / attentes
+    HALCycles  compteur de cycles (mesures fines : hotpath_bench.h) ; now() monte,
+               elapsed() gère le rebouclage (24 bits sur SysTick)
+    HALGpio    mode, lecture, écriture d'une broche
+    HALAdc     résolution + lecture d'une voie
+    HALPwm     fréquence / plage + rapport cyclique d'une broche
+    HALI2C     broches + bus (objet TwoWire passé aux pilotes, ex. SSD1306)
+    HALSpi     broches du bus SPI0 (W5500)
+    HALSerial  CDC USB en binaire (SLIP, télémétrie) ; le texte de debug garde Serial.print
+    HALUdp     socket UDP du lien hôte (host_link.h) : recv() rend 1 datagramme et retient
+               son émetteur, write() ajoute au datagramme en cours (adressé à cet émetteur),
+               send() l'émet ; RP2040 : W5500 (lib Ethernet), write() écrit directement dans
+               le tampon TX du socket sur la puce ; hôte : socket Linux
+    HALKeyScan balayage continu d'une matrice derrière 74HC595 (rangées, actives à 0) et
+               74HC165 (colonnes) ; frame()[r] = niveaux des 16 colonnes, rangée r tirée à 0
+               (bit c = colonne c, 0 = touche enfoncée) ; RP2040 : PIO + DMA, aucun CPU
+    HALQuadrature  compteur d'encodeur en quadrature (×4, A = pinA, B = pinA + 1) tenu
+               par le matériel ; count() lu une fois par tick ; RP2040 : 1 machine PIO / encodeur
+    HALUart    liaison série inter-modules : read() rend les octets reçus depuis l'appel
+               précédent, write() confie une trame entière et rend la main ; RP2040 : UART
+               matériel, réception DMA en anneau + émission DMA ; stampArm() / stamp() :
+               instant du début de la trame suivante (RP2040 : 1 IRQ GPIO par trame)
+
+  Backends :
+    - hal_rp2040.h : core Arduino RP2040, tout en inline (aucun coût par rapport aux
+      appels directs)
+    - hal_host.h   : Linux, implémenté par host/sim/sim_hal.cpp (horloge virtuelle,
+      modèle de fader, CDC → pty) ; build CMake (CMakeLists.txt) ou ligne g++ du simulateur
+*/
+
+namespace HALGpio {
+  enum Mode : uint8_t { Input, Output, InputPullup };
+}
+
+constexpr uint8_t HAL_KEYSCAN_ROWS = 16;   // sorties des 2 × 595 (anneau DMA : puissance de 2)
+constexpr uint8_t HAL_KEYSCAN_COLS = 16;   // entrées des 2 × 165
+constexpr uint8_t HAL_QUAD_CHANNELS = 8;   // machines PIO libres au mieux (2 PIO × 4)
+constexpr size_t  HAL_UART_TX_MAX   = 256;   // plus longue trame confiée à HALUart::write()
+constexpr size_t  HAL_UDP_DGRAM_MAX = 1024;  // datagramme du lien hôte (tampon socket W5500 : 2 Kio)
+
+#if defined(ARDUINO)
+#include "hal_rp2040.h"
+#else
+#include "hal_host.h"
+#endif
@@ -0,0 +1,89 @@
+#pragma once
+// Backend Linux de la HAL (hal.h) : mêmes fonctions que hal_rp2040.h, implémentées par
+// host/sim/sim_hal.cpp (horloge virtuelle, broches → modèle de fader, CDC → pty)
+
+class TwoWire;
+
+namespace HALTime {
+  uint32_t micros();
+  uint32_t millis();
+  void     delayMs(uint32_t ms);
+  void     delayUs(uint32_t us);
+}
+
+// Hôte : temps réel CLOCK_MONOTONIC en ns (pas l'horloge virtuelle du simulateur)
+namespace HALCycles {
+  void     begin();
+  uint32_t now();
+  inline uint32_t elapsed(uint32_t from, uint32_t to) { return to - from; }
+  uint32_t hz();
+}
+
+namespace HALGpio {
+  void mode(uint8_t pin, Mode m);
+  void write(uint8_t pin, bool level);
+  bool read(uint8_t pin);
+}
+
+namespace HALAdc {
+  void     resolution(uint8_t bits);
+  uint16_t read(uint8_t pin);
+}
+
+namespace HALPwm {
+  void frequency(uint32_t hz);
+  void range(uint32_t r);
+  void write(uint8_t pin, uint16_t duty);
+}
+
+namespace HALI2C {
+  TwoWire& begin(uint8_t sda, uint8_t scl);
+  TwoWire& bus();
+}
+
+namespace HALSpi {
+  void pins(uint8_t miso, uint8_t mosi, uint8_t sck);
+}
+
+// Hôte : vrai socket UDP Linux (0.0.0.0:port, ou sim::cfg.udpPort si fader_sim -u)
+namespace HALUdp {
+  bool   begin(uint16_t port);
+  size_t recv(uint8_t* buf, size_t max);
+  bool   hasPeer();
+  size_t room();
+  size_t write(const uint8_t* buf, size_t n);
+  bool   send();
+}
+
+namespace HALSerial {
+  void   begin(uint32_t baud, uint32_t waitMs = 0);
+  int    available();
+  int    read();
+  int    availableForWrite();
+  size_t write(uint8_t b);
+  size_t write(const uint8_t* buf, size_t n);
+  void   flush();
+}
+
+// Hôte : matrice simulée (sim::key), rebonds de contact compris ; frame() lue à l'appel
+namespace HALKeyScan {
+  bool begin(uint8_t pinSer, uint8_t pinQh, uint8_t pinClk, uint32_t frameHz);
+  const volatile uint32_t* frame();
+  void service();
+}
+
+// Hôte : encodeurs simulés (sim::turn) ; canal = ordre des begin()
+namespace HALQuadrature {
+  int8_t  begin(uint8_t pinA, uint32_t sampleHz);
+  int32_t count(int8_t ch);
+}
+
+// Hôte : pas de second module dans le simulateur → begin() rend false
+// (le bus est exercé par host/modlink_loopback)
+namespace HALUart {
+  bool   begin(uint8_t pinTx, uint8_t pinRx, uint32_t baud);
+  size_t read(uint8_t* buf, size_t max);
+  bool   write(const uint8_t* buf, size_t n);
+  void   stampArm();
+  bool   stamp(uint32_t& us);
+}
@@ -0,0 +1,461 @@
+#pragma once
+// Backend RP2040 de la HAL (hal.h) : appels directs au core Arduino, tout en inline
+#include <Arduino.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <Ethernet.h>          // W5500 (HALUdp), même lib que rtpmidi_eth / osc_eth
+#include <EthernetUdp.h>
+#include <hardware/clocks.h>
+#include <hardware/structs/systick.h>
+#include <hardware/pio.h>
+#include <hardware/pio_instructions.h>
+#include <hardware/dma.h>
+#include <hardware/uart.h>
+#include <hardware/gpio.h>
+#include <hardware/irq.h>
+
+namespace HALTime {
+  inline uint32_t micros()            { return ::micros(); }
+  inline uint32_t millis()            { return ::millis(); }
+  inline void     delayMs(uint32_t ms) { ::delay(ms); }
+  inline void     delayUs(uint32_t us) { ::delayMicroseconds(us); }
+}
+
+// SysTick (24 bits, horloge CPU) : libre sans FreeRTOS ; reboucle toutes les ~130 ms à 125 MHz
+namespace HALCycles {
+  constexpr uint32_t MASK = 0x00FFFFFF;
+  inline void begin() {
+    systick_hw->rvr = MASK;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;                                    // CLKSOURCE = CPU, ENABLE
+  }
+  inline uint32_t now()                             { return MASK - systick_hw->cvr; }
+  inline uint32_t elapsed(uint32_t from, uint32_t to) { return (to - from) & MASK; }
+  inline uint32_t hz()                              { return clock_get_hz(clk_sys); }
+}
+
+namespace HALGpio {
+  inline void mode(uint8_t pin, Mode m) {
+    pinMode(pin, m == Output ? OUTPUT : (m == InputPullup ? INPUT_PULLUP : INPUT));
+  }
+  inline void write(uint8_t pin, bool level) { digitalWrite(pin, level ? HIGH : LOW); }
+  inline bool read(uint8_t pin)              { return digitalRead(pin) != LOW; }
+}
+
+namespace HALAdc {
+  inline void     resolution(uint8_t bits) { analogReadResolution(bits); }
+  inline uint16_t read(uint8_t pin)        { return (uint16_t)analogRead(pin); }
+}
+
+namespace HALPwm {
+  inline void frequency(uint32_t hz)            { analogWriteFreq(hz); }
+  inline void range(uint32_t r)                 { analogWriteRange(r); }
+  inline void write(uint8_t pin, uint16_t duty) { analogWrite(pin, duty); }
+}
+
+namespace HALI2C {
+  inline TwoWire& begin(uint8_t sda, uint8_t scl) {
+    Wire.setSDA(sda);
+    Wire.setSCL(scl);
+    Wire.begin();
+    return Wire;
+  }
+  inline TwoWire& bus() { return Wire; }
+}
+
+namespace HALSpi {
+  inline void pins(uint8_t miso, uint8_t mosi, uint8_t sck) {
+    SPI.setRX(miso);
+    SPI.setTX(mosi);
+    SPI.setSCK(sck);
+  }
+}
+
+// W5500 déjà démarré par setupEthernet() (rtpmidi_eth.h) ; sans puce, begin() rend false.
+// Zéro copie à l'émission : beginPacket / write / endPacket de la lib écrivent directement
+// dans le tampon TX du socket sur la puce (SPI), aucun tampon intermédiaire en RAM
+namespace HALUdp {
+  namespace detail {
+    inline EthernetUDP udp;
+    inline IPAddress   peerIp;
+    inline uint16_t    peerPort = 0;
+    inline size_t      txLen = 0;               // octets déjà dans le datagramme en cours
+    inline bool        up = false;
+  }
+
+  inline bool begin(uint16_t port) {
+    using namespace detail;
+    if (!up && Ethernet.hardwareStatus() != EthernetNoHardware) up = udp.begin(port) == 1;
+    return up;
+  }
+
+  inline size_t recv(uint8_t* buf, size_t max) {
+    using namespace detail;
+    if (!up || udp.parsePacket() <= 0) return 0;
+    peerIp   = udp.remoteIP();
+    peerPort = udp.remotePort();
+    const int n = udp.read(buf, max);             // 1 rafale SPI ; l'excédent est jeté
+    return n > 0 ? (size_t)n : 0;
+  }
+
+  inline bool   hasPeer() { return detail::peerPort != 0; }
+  inline size_t room()    { return hasPeer() ? HAL_UDP_DGRAM_MAX - detail::txLen : 0; }
+
+  inline size_t write(const uint8_t* buf, size_t n) {
+    using namespace detail;
+    if (n > room()) n = room();
+    if (!n) return 0;
+    if (!txLen && !udp.beginPacket(peerIp, peerPort)) return 0;
+    n = udp.write(buf, n);
+    txLen += n;
+    return n;
+  }
+
+  inline bool send() {
+    using namespace detail;
+    if (!txLen) return true;
+    txLen = 0;
+    return udp.endPacket() == 1;
+  }
+}
+
+namespace HALSerial {
+  // TinyUSB ignore le débit ; attend le montage USB au plus waitMs
+  inline void begin(uint32_t baud, uint32_t waitMs = 0) {
+    Serial.begin(baud);
+    const uint32_t t0 = ::millis();
+    while (!Serial && (::millis() - t0) < waitMs) {}
+  }
+  inline int    available()                          { return Serial.available(); }
+  inline int    read()                               { return Serial.read(); }
+  inline int    availableForWrite()                  { return Serial.availableForWrite(); }
+  inline size_t write(uint8_t b)                     { return Serial.write(b); }
+  inline size_t write(const uint8_t* buf, size_t n)  { return Serial.write(buf, n); }
+  inline void   flush()                              { Serial.flush(); }
+}
+
+// Matrice 595 / 165 : une machine PIO décale la rangée et lit les colonnes, deux canaux DMA
+// en anneau l'alimentent (motifs de rangée) et recopient chaque rangée lue dans cols[] ;
+// ni interruption ni CPU, frame() est une image toujours à jour.
+// Programme assemblé à l'exécution (pio_encode_*, pas de pioasm dans l'IDE Arduino),
+// side-set 2 bits = { CLK, LATCH } :
+//   0  nop          side 00 [7]   LATCH bas : les 165 chargent les colonnes de la rangée
+//   1  set x, 15    side 10 [7]   LATCH haut : les 595 sortent la rangée décalée au pas précédent
+//   2  out pins, 1  side 10       SER ← motif (autopull 16 bits, MSB d'abord)
+//   3  in pins, 1   side 10 [3]   QH → ISR (autopush 16 bits)
+//   4  jmp x--, 2   side 11 [3]   front montant de CLK (décalage 595 et 165)
+// Pipeline : la rangée lue au pas j a été décalée au pas j-2 → motifs décalés de 2.
+namespace HALKeyScan {
+  namespace detail {
+    constexpr uint32_t CYCLES_PER_ROW = 8 + 8 + HAL_KEYSCAN_COLS * 9;
+    constexpr uint32_t DMA_COUNT      = 0xFFFFFFFF;         // ≈ 37 h à 2 kHz ; puis service()
+    constexpr uint8_t  RING_BITS      = 6;                  // 16 mots = 64 octets
+    alignas(64) inline uint32_t          rowWords[HAL_KEYSCAN_ROWS];
+    alignas(64) inline volatile uint32_t cols[HAL_KEYSCAN_ROWS];
+    inline uint16_t prog[5];
+    inline PIO      pio = pio1;
+    inline int      sm = -1, txCh = -1, rxCh = -1;
+    inline uint     offset = 0;
+
+    inline void startDma() {
+      dma_channel_config c = dma_channel_get_default_config(txCh);
+      channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+      channel_config_set_read_increment(&c, true);
+      channel_config_set_write_increment(&c, false);
+      channel_config_set_ring(&c, false, RING_BITS);
+      channel_config_set_dreq(&c, pio_get_dreq(pio, sm, true));
+      dma_channel_configure(txCh, &c, &pio->txf[sm], rowWords, DMA_COUNT, true);
+
+      c = dma_channel_get_default_config(rxCh);
+      channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+      channel_config_set_read_increment(&c, false);
+      channel_config_set_write_increment(&c, true);
+      channel_config_set_ring(&c, true, RING_BITS);
+      channel_config_set_dreq(&c, pio_get_dreq(pio, sm, false));
+      dma_channel_configure(rxCh, &c, cols, &pio->rxf[sm], DMA_COUNT, true);
+    }
+  }
+
+  // pinClk + 1 = LATCH ; frameHz = trames complètes (HAL_KEYSCAN_ROWS rangées) par seconde
+  inline bool begin(uint8_t pinSer, uint8_t pinQh, uint8_t pinClk, uint32_t frameHz) {
+    using namespace detail;
+    if (sm >= 0) return true;
+    prog[0] = pio_encode_nop()            | pio_encode_sideset(2, 0b00) | pio_encode_delay(7);
+    prog[1] = pio_encode_set(pio_x, 15)   | pio_encode_sideset(2, 0b10) | pio_encode_delay(7);
+    prog[2] = pio_encode_out(pio_pins, 1) | pio_encode_sideset(2, 0b10);
+    prog[3] = pio_encode_in(pio_pins, 1)  | pio_encode_sideset(2, 0b10) | pio_encode_delay(3);
+    prog[4] = pio_encode_jmp_x_dec(2)     | pio_encode_sideset(2, 0b11) | pio_encode_delay(3);
+    pio_program_t program = {};
+    program.instructions = prog;
+    program.length       = 5;
+    program.origin       = -1;
+
+    for (PIO p : { pio1, pio0 }) {              // pio0 souvent pris par le core (SerialPIO…)
+      if (!pio_can_add_program(p, &program)) continue;
+      sm = pio_claim_unused_sm(p, false);
+      if (sm >= 0) { pio = p; break; }
+    }
+    if (sm < 0) return false;
+    txCh = dma_claim_unused_channel(false);
+    rxCh = dma_claim_unused_channel(false);
+    if (txCh < 0 || rxCh < 0) {
+      if (txCh >= 0) dma_channel_unclaim(txCh);
+      if (rxCh >= 0) dma_channel_unclaim(rxCh);
+      pio_sm_unclaim(pio, sm);
+      sm = txCh = rxCh = -1;
+      return false;
+    }
+    offset = pio_add_program(pio, &program);
+
+    // rangée r tirée à 0, les autres à 1 ; sortie 595 n°r = bit 16 + r (MSB sorti en premier)
+    for (uint8_t j = 0; j < HAL_KEYSCAN_ROWS; ++j) {
+      const uint8_t r = (uint8_t)((j + 2) % HAL_KEYSCAN_ROWS);
+      rowWords[j] = (~(1u << r) & 0xFFFFu) << 16;
+      cols[j] = 0xFFFF;
+    }
+
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset, offset + 4);
+    sm_config_set_sideset(&c, 2, false, false);
+    sm_config_set_sideset_pins(&c, pinClk);
+    sm_config_set_out_pins(&c, pinSer, 1);
+    sm_config_set_in_pins(&c, pinQh);
+    sm_config_set_out_shift(&c, false, true, 16);
+    sm_config_set_in_shift(&c, false, true, 16);
+    sm_config_set_clkdiv(&c, (float)clock_get_hz(clk_sys) / ((float)CYCLES_PER_ROW * HAL_KEYSCAN_ROWS * frameHz));
+    pio_gpio_init(pio, pinSer);
+    pio_gpio_init(pio, pinClk);
+    pio_gpio_init(pio, pinClk + 1);
+    gpio_pull_up(pinQh);                        // 165 absent : colonnes à 1, aucune touche
+    pio_sm_set_consecutive_pindirs(pio, sm, pinSer, 1, true);
+    pio_sm_set_consecutive_pindirs(pio, sm, pinClk, 2, true);
+    pio_sm_set_consecutive_pindirs(pio, sm, pinQh, 1, false);
+    pio_sm_init(pio, sm, offset, &c);
+    startDma();
+    pio_sm_set_enabled(pio, sm, true);
+    return true;
+  }
+
+  inline const volatile uint32_t* frame() { return detail::cols; }
+
+  // compteurs DMA épuisés : relance du balayage (la 1re trame qui suit peut être décalée)
+  inline void service() {
+    using namespace detail;
+    if (sm < 0 || dma_channel_is_busy(rxCh)) return;
+    pio_sm_set_enabled(pio, sm, false);
+    dma_channel_abort(txCh);
+    dma_channel_abort(rxCh);
+    pio_sm_clear_fifos(pio, sm);
+    pio_sm_restart(pio, sm);
+    pio_sm_exec(pio, sm, pio_encode_jmp(offset));
+    startDma();
+    pio_sm_set_enabled(pio, sm, true);
+  }
+}
+
+// Quadrature : une machine PIO par encodeur, compte 32 bits dans Y, décodage ×4 par table de
+// sauts (origine 0 : mov pc, isr saute à l'adresse ancien AB:nouvel AB) ; le compte est poussé
+// en continu (push noblock) et count() garde le plus récent. Aucune IT par front ; un rebond
+// sur A ou B donne ±1 qui s'annulent (code de Gray). 26 instructions : tient avec le balayage
+// de la matrice (5) dans le même PIO.
+//   0..15      jmp update / increment / decrement    index = ancien BA : nouveau BA
+//   16 dec:    jmp y--, update                        (les deux branches → update)
+//   17 update: mov isr, y                             (wrap_target)
+//   18         push noblock
+//   19         out isr, 2                             ISR ← ancien BA (OSR)
+//   20         in pins, 2                             ISR = ancien : nouveau
+//   21         mov osr, isr
+//   22         mov pc, isr                            → table
+//   23 inc:    mov y, ~y
+//   24         jmp y--, 25
+//   25         mov y, ~y                              (wrap)
+namespace HALQuadrature {
+  namespace detail {
+    constexpr uint8_t  DEC = 16, UPDATE = 17, INC = 23, LEN = 26;
+    constexpr uint16_t INC_MASK = (1u << 1) | (1u << 7) | (1u << 8) | (1u << 14);   // 0→1 1→3 2→0 3→2
+    constexpr uint16_t DEC_MASK = (1u << 2) | (1u << 4) | (1u << 11) | (1u << 13);  // sens inverse
+    inline uint16_t prog[LEN];
+    inline bool     loaded[2];
+    inline PIO      chPio[HAL_QUAD_CHANNELS];
+    inline uint8_t  chSm[HAL_QUAD_CHANNELS];
+    inline uint8_t  nCh = 0;
+
+    inline void build() {
+      for (uint8_t k = 0; k < 16; ++k)
+        prog[k] = pio_encode_jmp((INC_MASK >> k) & 1 ? INC : (DEC_MASK >> k) & 1 ? DEC : UPDATE);
+      prog[16] = pio_encode_jmp_y_dec(UPDATE);
+      prog[17] = pio_encode_mov(pio_isr, pio_y);
+      prog[18] = pio_encode_push(false, false);
+      prog[19] = pio_encode_out(pio_isr, 2);
+      prog[20] = pio_encode_in(pio_pins, 2);
+      prog[21] = pio_encode_mov(pio_osr, pio_isr);
+      prog[22] = pio_encode_mov(pio_pc, pio_isr);
+      prog[23] = pio_encode_mov_not(pio_y, pio_y);
+      prog[24] = pio_encode_jmp_y_dec(25);
+      prog[25] = pio_encode_mov_not(pio_y, pio_y);
+    }
+  }
+
+  // → canal 0.. ou -1 (plus de machine PIO / de place) ; sampleHz ≈ passages de boucle par seconde
+  inline int8_t begin(uint8_t pinA, uint32_t sampleHz) {
+    using namespace detail;
+    if (nCh >= HAL_QUAD_CHANNELS) return -1;
+    if (!loaded[0] && !loaded[1]) build();
+    pio_program_t program = {};
+    program.instructions = prog;
+    program.length       = LEN;
+    program.origin       = 0;
+
+    PIO pio = nullptr;
+    int sm  = -1;
+    for (PIO p : { pio0, pio1 }) {
+      const uint idx = pio_get_index(p);
+      if (!loaded[idx] && !pio_can_add_program(p, &program)) continue;
+      sm = pio_claim_unused_sm(p, false);
+      if (sm < 0) continue;
+      if (!loaded[idx]) { pio_add_program(p, &program); loaded[idx] = true; }
+      pio = p;
+      break;
+    }
+    if (sm < 0) return -1;
+
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, UPDATE, LEN - 1);
+    sm_config_set_in_pins(&c, pinA);
+    sm_config_set_in_shift(&c, false, false, 32);
+    sm_config_set_out_shift(&c, true, false, 32);
+    const float div = (float)clock_get_hz(clk_sys) / ((float)sampleHz * 10.0f);
+    sm_config_set_clkdiv(&c, div < 1.0f ? 1.0f : div);
+    for (uint8_t p = pinA; p <= pinA + 1; ++p) {
+      pio_gpio_init(pio, p);
+      gpio_pull_up(p);                            // EC11 : contacts à la masse
+    }
+    pio_sm_set_consecutive_pindirs(pio, sm, pinA, 2, false);
+    pio_sm_init(pio, sm, UPDATE, &c);
+    pio_sm_exec(pio, sm, pio_encode_set(pio_y, 0));
+    pio_sm_exec(pio, sm, pio_encode_mov(pio_osr, pio_null));
+    pio_sm_set_enabled(pio, sm, true);
+
+    chPio[nCh] = pio;
+    chSm[nCh]  = (uint8_t)sm;
+    return (int8_t)nCh++;
+  }
+
+  // FIFO pleine de comptes anciens : on la vide puis on attend la poussée suivante (1 boucle)
+  inline int32_t count(int8_t ch) {
+    using namespace detail;
+    const PIO     p  = chPio[ch];
+    const uint8_t sm = chSm[ch];
+    uint n = pio_sm_get_rx_fifo_level(p, sm) + 1;
+    uint32_t v = 0;
+    while (n--) v = pio_sm_get_blocking(p, sm);
+    return (int32_t)v;
+  }
+}
+
+// Liaison inter-modules : UART matériel ; un canal DMA en anneau recopie chaque octet reçu
+// dans rxRing (l'anneau ne déborde pas tant que read() passe au moins toutes les 1,2 ms à
+// 2 Mbauds), un second canal envoie la trame copiée dans txBuf. Ni interruption ni attente.
+// UART d'après la broche : GP0/1, 12/13, 16/17, 28/29 → uart0 ; 4/5, 8/9, 20/21, 24/25 → uart1
+namespace HALUart {
+  namespace detail {
+    constexpr uint8_t  RING_BITS = 8;                     // 256 octets
+    constexpr uint32_t RING      = 1u << RING_BITS;
+    constexpr uint32_t DMA_COUNT = 0xFFFFFFFF;            // ≈ 6 h à 2 Mbauds ; puis read() relance
+    alignas(RING) inline volatile uint8_t rxRing[RING];
+    inline uint8_t      txBuf[HAL_UART_TX_MAX];
+    inline uart_inst_t* uart = nullptr;
+    inline int          rxCh = -1, txCh = -1;
+    inline uint32_t     rxTail = 0;
+    inline uint8_t      rxPin = 0;
+    inline volatile bool     stamped = false;
+    inline volatile uint32_t stampUs = 0;
+
+    // 1er front descendant (bit de start) après stampArm() : instant puis IRQ coupée
+    inline void onRxEdge() {
+      if (!(gpio_get_irq_event_mask(rxPin) & GPIO_IRQ_EDGE_FALL)) return;
+      gpio_acknowledge_irq(rxPin, GPIO_IRQ_EDGE_FALL);
+      stampUs = ::micros();
+      stamped = true;
+      gpio_set_irq_enabled(rxPin, GPIO_IRQ_EDGE_FALL, false);
+    }
+
+    inline uint8_t index(uint8_t pin) { return (uint8_t)(((pin + 4u) >> 3) & 1u); }
+
+    inline void startRx() {
+      dma_channel_config c = dma_channel_get_default_config(rxCh);
+      channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+      channel_config_set_read_increment(&c, false);
+      channel_config_set_write_increment(&c, true);
+      channel_config_set_ring(&c, true, RING_BITS);
+      channel_config_set_dreq(&c, uart_get_dreq(uart, false));
+      dma_channel_configure(rxCh, &c, rxRing, &uart_get_hw(uart)->dr, DMA_COUNT, true);
+      rxTail = 0;
+    }
+  }
+
+  inline bool begin(uint8_t pinTx, uint8_t pinRx, uint32_t baud) {
+    using namespace detail;
+    if ((pinTx & 3u) != 0 || (pinRx & 3u) != 1 || index(pinTx) != index(pinRx)) return false;
+    rxCh = dma_claim_unused_channel(false);
+    txCh = dma_claim_unused_channel(false);
+    if (rxCh < 0 || txCh < 0) return false;
+    uart = index(pinTx) ? uart1 : uart0;
+    uart_init(uart, baud);
+    uart_set_fifo_enabled(uart, true);
+    gpio_set_function(pinTx, GPIO_FUNC_UART);
+    gpio_set_function(pinRx, GPIO_FUNC_UART);
+    gpio_pull_up(pinRx);                          // ligne au repos si rien n'est branché
+    rxPin = pinRx;
+    gpio_add_raw_irq_handler(pinRx, onRxEdge);    // sans toucher au callback d'attachInterrupt
+    irq_set_enabled(IO_IRQ_BANK0, true);
+    startRx();
+    return true;
+  }
+
+  // Horodatage du début de la prochaine trame reçue (front du bit de start, ~1 µs) :
+  // stampArm() oublie l'instant précédent et attend le front suivant, stamp() le rend
+  inline void stampArm() {
+    using namespace detail;
+    if (!uart) return;
+    gpio_set_irq_enabled(rxPin, GPIO_IRQ_EDGE_FALL, false);
+    stamped = false;
+    gpio_acknowledge_irq(rxPin, GPIO_IRQ_EDGE_FALL);
+    gpio_set_irq_enabled(rxPin, GPIO_IRQ_EDGE_FALL, true);
+  }
+
+  inline bool stamp(uint32_t& us) {
+    using namespace detail;
+    if (!stamped) return false;
+    us      = stampUs;
+    stamped = false;
+    return true;
+  }
+
+  inline size_t read(uint8_t* buf, size_t max) {
+    using namespace detail;
+    if (!uart) return 0;
+    if (!dma_channel_is_busy(rxCh)) startRx();
+    const uint32_t head = (uint32_t)(dma_hw->ch[rxCh].write_addr - (uintptr_t)rxRing) & (RING - 1);
+    size_t n = 0;
+    while (rxTail != head && n < max) {
+      buf[n++] = rxRing[rxTail];
+      rxTail   = (rxTail + 1) & (RING - 1);
+    }
+    return n;
+  }
+
+  // false si la trame précédente part encore (le protocole la réémettra)
+  inline bool write(const uint8_t* buf, size_t n) {
+    using namespace detail;
+    if (!uart || n > sizeof txBuf || dma_channel_is_busy(txCh)) return false;
+    memcpy(txBuf, buf, n);
+    dma_channel_config c = dma_channel_get_default_config(txCh);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, uart_get_dreq(uart, true));
+    dma_channel_configure(txCh, &c, &uart_get_hw(uart)->dr, txBuf, n, true);
+    return true;
+  }
+}
@@ -0,0 +1,49 @@
+#include <Arduino.h>
+#include <cstdlib>
+#include <new>
+#include "hal.h"
+#include "heap_guard.h"
+#include "pin_int.h"
+
+// ===================== ÉTAT =====================
+static volatile bool     armed      = false;
+static volatile uint32_t violations = 0;
+static volatile size_t   lastSize   = 0;
+
+void     heapGuardArm()        { armed = true; }
+bool     heapGuardArmed()      { return armed; }
+uint32_t heapGuardViolations() { return violations; }
+size_t   heapGuardLastSize()   { return lastSize; }
+
+// Sur l'hôte, operator new reste celui de la libstdc++ : le simulateur et les outils
+// allouent librement ; le firmware y est contrôlé à l'édition de liens (heap_check.cmake)
+#ifdef ARDUINO
+
+// Allocation après setup() : comptée ; en mode TRAP, ponts en H en roue libre puis arrêt
+static void noteAlloc(size_t n) {
+  if (!armed) return;
+  violations = violations + 1;
+  lastSize = n;
+  if (HEAP_GUARD_TRAP) {
+    for (uint8_t i = 0; i < PicoBoard::MAX_CHANNELS; ++i) {
+      HALGpio::write(PicoBoard::MOTOR_PINS[i][0], false);
+      HALGpio::write(PicoBoard::MOTOR_PINS[i][1], false);
+    }
+    for (;;) {}
+  }
+}
+
+// ===================== operator new / delete (remplacement global) =====================
+void* operator new(size_t n)                                   { noteAlloc(n); return malloc(n ? n : 1); }
+void* operator new[](size_t n)                                 { noteAlloc(n); return malloc(n ? n : 1); }
+void* operator new(size_t n, const std::nothrow_t&) noexcept   { noteAlloc(n); return malloc(n ? n : 1); }
+void* operator new[](size_t n, const std::nothrow_t&) noexcept { noteAlloc(n); return malloc(n ? n : 1); }
+
+void operator delete(void* p) noexcept                         { free(p); }
+void operator delete[](void* p) noexcept                       { free(p); }
+void operator delete(void* p, size_t) noexcept                 { free(p); }
+void operator delete[](void* p, size_t) noexcept               { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept  { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+
+#endif
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+/*
+  Garde-fou « zéro tas » : aucune allocation dynamique une fois setup() terminé
+
+  - les modules du firmware n'allouent rien : filtres, PID, tampons SLIP / télémétrie /
+    MIDI sont dans des tableaux de taille fixe (gBank, fader_bank.h) ; le build hôte le
+    vérifie à l'édition de liens (host/heap_check.cmake : aucun objet de fader_core ne
+    référence malloc / calloc / realloc / operator new)
+  - les bibliothèques peuvent allouer pendant setup() (tampon de l'OLED, pile USB…) ;
+    heapGuardArm() en fin de setup() ferme la porte : toute allocation C++ ultérieure
+    (operator new, remplacé ici sur la carte) est comptée, avec la taille de la dernière
+  - HEAP_GUARD_TRAP = true : la 1re allocation après setup() fige la carte (banc d'essai) ;
+    false (tournage) : on compte seulement → param. hôte "heap_allocs" (host_protocol.h)
+*/
+
+// ===================== RÉGLAGES =====================
+constexpr bool HEAP_GUARD_TRAP = false;
+
+// ===================== API =====================
+void     heapGuardArm();              // fin de setup()
+bool     heapGuardArmed();
+uint32_t heapGuardViolations();       // allocations après setup()
+size_t   heapGuardLastSize();         // taille de la dernière (octets)
@@ -0,0 +1,283 @@
+// ========================== capture_convert.cpp ==========================
+// Outil Linux : conversion des archives .tsv ↔ fichiers de capture .fpcap (capture_file.h)
+//
+//   défaut : chaque .tsv → .fpcap à côté (ou dans -o dossier)
+//     - réglages relevés dans le nom de fichier → métadonnées :
+//         data[i<idx>-]p<kp>i<ki>d<kd>[t<ts>]c<fc>[s<speed_div>][_r<essai>][-sma]   (Tuning.py)
+//         adc_<date>-<heure>[_raw][_deadzone][_ascii] / <date>_test01[_raw][_deadzone][_segNN]
+//     - 1re colonne = temps (s) si elle est croissante et non entière, sinon t = ligne × -P µs
+//     - colonnes : 3 → consigne/mesure/commande, 1 (+ temps) → adc, sinon c1, c2…
+//       typées int16/int32 si toutes les valeurs sont entières, float64 sinon
+//     - lignes de largeur différente de la 1re ignorées (comme Tuning.py)
+//   -x : .fpcap → .tsv (t en s + colonnes) sur stdout ou dans -o fichier
+//   -i : résumé (lignes, durée, colonnes, métadonnées) de chaque .fpcap
+//
+// Build : g++ -O2 -std=c++17 -o capture_convert capture_convert.cpp capture_file.cpp
+// Usage : ./capture_convert [-o dossier] [-P µs] [-m clé=valeur] fichier.tsv...
+//         ./capture_convert -x fichier.fpcap [-o sortie.tsv]
+//         ./capture_convert -i fichier.fpcap...
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "capture_file.h"
+
+namespace {
+
+struct Options {
+  enum Mode { TO_CAP, TO_TSV, INFO } mode = TO_CAP;
+  const char* out = nullptr;
+  uint32_t periodUs = 0;     // 0 : ts du nom de fichier, sinon 1000 µs
+  std::string meta;
+};
+
+std::string baseName(const std::string& path) {
+  const size_t s = path.find_last_of('/');
+  return s == std::string::npos ? path : path.substr(s + 1);
+}
+
+std::string stem(const std::string& name) {
+  const size_t d = name.find_last_of('.');
+  return d == std::string::npos ? name : name.substr(0, d);
+}
+
+// ---------------- Nom de fichier → métadonnées ----------------
+void addMeta(std::string& meta, const char* key, const std::string& v) {
+  meta += key;
+  meta += '=';
+  meta += v;
+  meta += '\n';
+}
+
+std::string metaFromName(const std::string& name, int& fader, double& tsSec) {
+  std::string meta;
+  std::string s = stem(name);
+  if (s.compare(0, 4, "data") == 0) {                       // Tuning.py
+    s = s.substr(4);
+    if (s.size() > 2 && s[0] == 'i' && s.find('-') != std::string::npos && s.find('-') < 4) {
+      fader = atoi(s.c_str() + 1);
+      addMeta(meta, "fader_idx", std::to_string(fader));
+      s = s.substr(s.find('-') + 1);
+    }
+    if (s.size() > 4 && s.compare(s.size() - 4, 4, "-sma") == 0) { addMeta(meta, "sma", "1"); s.resize(s.size() - 4); }
+    const size_t r = s.find("_r");
+    if (r != std::string::npos) { addMeta(meta, "run", s.substr(r + 2)); s.resize(r); }
+    static const struct { char tag; const char* key; } KEYS[] = {
+      {'p', "kp"}, {'i', "ki"}, {'d', "kd"}, {'t', "ts"}, {'c', "fc"}, {'s', "speed_div"}};
+    size_t pos = 0;
+    while (pos < s.size()) {
+      const char tag = s[pos++];
+      const size_t end = s.find_first_not_of("0123456789.-e", pos);
+      const std::string val = s.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+      pos = end == std::string::npos ? s.size() : end;
+      for (const auto& k : KEYS) {
+        if (k.tag != tag || val.empty()) continue;
+        addMeta(meta, k.key, val);
+        if (tag == 't') tsSec = atof(val.c_str());
+      }
+    }
+  } else {                                                   // scripts de calibration ADC
+    size_t us = s.find('_');
+    if (s.compare(0, 4, "adc_") == 0) {
+      const size_t e = s.find('_', 4);
+      addMeta(meta, "date", s.substr(4, e == std::string::npos ? std::string::npos : e - 4));
+      us = e;
+    } else if (us != std::string::npos) {
+      addMeta(meta, "date", s.substr(0, us));
+    }
+    while (us != std::string::npos) {
+      const size_t e = s.find('_', us + 1);
+      const std::string tag = s.substr(us + 1, e == std::string::npos ? std::string::npos : e - us - 1);
+      if (tag.compare(0, 3, "seg") == 0)  addMeta(meta, "segment", tag.substr(3));
+      else if (tag.compare(0, 4, "test") == 0) addMeta(meta, "test", tag.substr(4));
+      else if (!tag.empty())              addMeta(meta, tag.c_str(), "1");
+      us = e;
+    }
+  }
+  return meta;
+}
+
+// ---------------- .tsv → .fpcap ----------------
+bool readTsv(const char* path, std::vector<double>& v, size_t& cols) {
+  FILE* f = fopen(path, "r");
+  if (!f) { perror(path); return false; }
+  char line[512];
+  cols = 0;
+  std::vector<double> row;
+  while (fgets(line, sizeof line, f)) {
+    row.clear();
+    char* p = line;
+    for (;;) {
+      char* end;
+      const double x = strtod(p, &end);
+      if (end == p) break;
+      row.push_back(x);
+      p = end;
+    }
+    if (row.empty()) continue;
+    if (!cols) cols = row.size();
+    if (row.size() != cols) continue;                        // ligne tronquée
+    v.insert(v.end(), row.begin(), row.end());
+  }
+  fclose(f);
+  return true;
+}
+
+uint8_t columnType(const std::vector<double>& v, size_t cols, size_t c) {
+  bool integer = true, fits16 = true;
+  for (size_t k = c; k < v.size(); k += cols) {
+    const double x = v[k];
+    if (x != std::floor(x) || std::fabs(x) > 2147483647.0) { integer = false; break; }
+    if (x < -32768 || x > 32767) fits16 = false;
+  }
+  return !integer ? CAP_F64 : fits16 ? CAP_I16 : CAP_I32;
+}
+
+bool toCapture(const char* path, const Options& opt) {
+  std::vector<double> v;
+  size_t cols = 0;
+  if (!readTsv(path, v, cols)) return false;
+  if (!cols) { fprintf(stderr, "%s : vide, ignoré\n", path); return true; }
+  const size_t rows = v.size() / cols;
+
+  const std::string name = baseName(path);
+  int fader = -1;
+  double tsSec = 0;
+  std::string meta = "source=" + name + "\n" + metaFromName(name, fader, tsSec) + opt.meta;
+
+  // 1re colonne = temps (s) ?
+  bool hasTime = cols >= 2 && rows >= 2;
+  bool fractional = false;
+  for (size_t r = 0; hasTime && r < rows; ++r) {
+    if (v[r * cols] != std::floor(v[r * cols])) fractional = true;
+    if (r && v[r * cols] < v[(r - 1) * cols]) hasTime = false;
+  }
+  hasTime = hasTime && fractional;
+
+  uint32_t periodUs = opt.periodUs ? opt.periodUs : tsSec > 0 ? (uint32_t)std::lround(tsSec * 1e6) : 1000;
+  if (hasTime) periodUs = (uint32_t)std::lround((v[(rows - 1) * cols] - v[0]) * 1e6 / (rows - 1));
+
+  std::vector<CapColumn> cc;
+  cc.push_back(capColumn("t_us", CAP_U64));
+  const size_t first = hasTime ? 1 : 0;
+  const size_t nData = cols - first;
+  static const char* const PID_NAMES[] = {"consigne", "mesure", "commande"};
+  for (size_t c = first; c < cols; ++c) {
+    const size_t k = c - first;
+    char cname[24];
+    if (nData == 3)      snprintf(cname, sizeof cname, "%s", PID_NAMES[k]);
+    else if (nData == 1) snprintf(cname, sizeof cname, "adc");
+    else                 snprintf(cname, sizeof cname, "c%zu", k + 1);
+    const bool pid = nData == 3 && fader >= 0;
+    cc.push_back(capColumn(cname, columnType(v, cols, c), pid ? (uint8_t)fader : CAP_NO_FADER, (uint8_t)k));
+  }
+
+  std::string out = stem(name) + ".fpcap";
+  if (opt.out) out = std::string(opt.out) + "/" + out;
+  else if (name.size() != strlen(path)) out = std::string(path, strlen(path) - name.size()) + out;
+
+  CapInfo info;
+  info.periodUs = periodUs;
+  if (nData == 3 && fader >= 0) { info.mask = (uint16_t)(1u << fader); info.fields = 3; }
+  info.chunkRows = rows < CAP_CHUNK_ROWS ? (uint32_t)rows : CAP_CHUNK_ROWS;   // 1 bloc : chargement sans copie
+  CaptureWriter w;
+  if (!w.open(out.c_str(), cc.data(), (uint16_t)cc.size(), info, meta)) return false;
+  for (size_t r = 0; r < rows; ++r) {
+    const double* row = &v[r * cols];
+    w.set(0, (int64_t)(hasTime ? std::llround(row[0] * 1e6) : (int64_t)r * periodUs));
+    for (size_t c = first; c < cols; ++c) w.set((uint16_t)(c - first + 1), row[c]);
+    if (!w.commit()) return false;
+  }
+  if (!w.close()) return false;
+  printf("%s → %s (%zu lignes, %zu colonne(s))\n", path, out.c_str(), rows, nData);
+  return true;
+}
+
+// ---------------- .fpcap → .tsv / résumé ----------------
+bool toTsv(const char* path, const Options& opt) {
+  CaptureReader r;
+  if (!r.open(path)) { fprintf(stderr, "%s : %s\n", path, r.error().c_str()); return false; }
+  FILE* f = opt.out ? fopen(opt.out, "w") : stdout;
+  if (!f) { perror(opt.out); return false; }
+  for (size_t k = 0; k < r.chunks(); ++k) {
+    const CapChunkIndex& e = r.chunk(k);
+    const uint64_t* t = (const uint64_t*)r.data(k, 0);
+    for (uint32_t i = 0; i < e.rows; ++i) {
+      fprintf(f, "%.6f", t[i] * 1e-6);
+      const uint64_t row = (uint64_t)k * r.header().chunkRows + i;
+      for (uint16_t c = 1; c < r.columns(); ++c) {
+        const uint8_t type = r.column(c).type;
+        if (type == CAP_F32 || type == CAP_F64) fprintf(f, "\t%.6g", r.value(row, c));
+        else                                    fprintf(f, "\t%lld", (long long)r.value(row, c));
+      }
+      fputc('\n', f);
+    }
+  }
+  if (f != stdout) fclose(f);
+  return true;
+}
+
+bool info(const char* path) {
+  CaptureReader r;
+  if (!r.open(path)) { fprintf(stderr, "%s : %s\n", path, r.error().c_str()); return false; }
+  const CapHeader& h = r.header();
+  const double dur = r.chunks() ? (r.chunk(r.chunks() - 1).tLastUs - r.chunk(0).tFirstUs) * 1e-6 : 0;
+  printf("%s : %llu lignes, %.3f s, %zu bloc(s), période %u µs%s\n", path,
+         (unsigned long long)r.rows(), dur, r.chunks(), h.periodUs, h.indexCount ? "" : " (non fermé)");
+  printf("  colonnes :");
+  static const char* const TYPES[] = {"?", "u64", "i16", "i32", "f32", "f64"};
+  for (uint16_t c = 0; c < r.columns(); ++c)
+    printf(" %.24s:%s", r.column(c).name, TYPES[r.column(c).type <= CAP_F64 ? r.column(c).type : 0]);
+  printf("\n");
+  const std::string& m = r.metaText();
+  for (size_t pos = 0; pos < m.size();) {
+    size_t e = m.find('\n', pos);
+    if (e == std::string::npos) e = m.size();
+    printf("  %s\n", m.substr(pos, e - pos).c_str());
+    pos = e + 1;
+  }
+  return true;
+}
+
+void usage() {
+  fprintf(stderr, "usage : capture_convert [-o dossier] [-P µs] [-m k=v] fichier.tsv...\n"
+                  "        capture_convert -x fichier.fpcap [-o sortie.tsv]\n"
+                  "        capture_convert -i fichier.fpcap...\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  int c;
+  while ((c = getopt(argc, argv, "o:P:m:xih")) != -1) {
+    switch (c) {
+      case 'o': opt.out = optarg; break;
+      case 'P': opt.periodUs = (uint32_t)atoi(optarg); break;
+      case 'm':
+        if (!strchr(optarg, '=')) { usage(); return 1; }
+        opt.meta += optarg;
+        opt.meta += '\n';
+        break;
+      case 'x': opt.mode = Options::TO_TSV; break;
+      case 'i': opt.mode = Options::INFO; break;
+      default: usage(); return c == 'h' ? 0 : 1;
+    }
+  }
+  if (optind >= argc) { usage(); return 1; }
+
+  int failed = 0;
+  for (int k = optind; k < argc; ++k) {
+    const bool ok = opt.mode == Options::TO_CAP ? toCapture(argv[k], opt)
+                  : opt.mode == Options::TO_TSV ? toTsv(argv[k], opt)
+                  : info(argv[k]);
+    if (!ok) ++failed;
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,262 @@
+// ========================== capture_file.cpp ==========================
+// Écriture / lecture des fichiers .fpcap (format : capture_file.h)
+#include "capture_file.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static size_t align8(size_t n) { return (n + 7) & ~(size_t)7; }
+
+size_t capTypeSize(uint8_t type) {
+  switch (type) {
+    case CAP_U64: case CAP_F64: return 8;
+    case CAP_I32: case CAP_F32: return 4;
+    case CAP_I16:               return 2;
+    default:                    return 0;
+  }
+}
+
+CapColumn capColumn(const char* name, uint8_t type, uint8_t fader, uint8_t field) {
+  CapColumn c{};
+  strncpy(c.name, name, sizeof c.name - 1);
+  c.type  = type;
+  c.fader = fader;
+  c.field = field;
+  return c;
+}
+
+// Offsets des colonnes dans un bloc ; rend la taille du bloc (0 si type inconnu)
+static size_t layoutChunk(const CapColumn* cols, uint16_t n, uint32_t chunkRows, std::vector<size_t>& off) {
+  off.resize(n);
+  size_t o = 0;
+  for (uint16_t c = 0; c < n; ++c) {
+    const size_t sz = capTypeSize(cols[c].type);
+    if (!sz) return 0;
+    off[c] = o;
+    o += align8((size_t)chunkRows * sz);
+  }
+  return o;
+}
+
+// ===================== ÉCRITURE =====================
+bool CaptureWriter::open(const char* path, const CapColumn* c, uint16_t nCols, const CapInfo& info,
+                         const std::string& meta) {
+  if (!nCols || c[0].type != CAP_U64 || !info.chunkRows) {
+    fprintf(stderr, "%s : la colonne 0 doit être t_us (uint64)\n", path);
+    return false;
+  }
+  cols.assign(c, c + nCols);
+  chunkRows  = info.chunkRows;
+  chunkBytes = layoutChunk(c, nCols, chunkRows, colOff);
+  if (!chunkBytes) { fprintf(stderr, "%s : type de colonne inconnu\n", path); return false; }
+  headerSize = sizeof(CapHeader) + nCols * sizeof(CapColumn) + align8(meta.size());
+
+  fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) { perror(path); return false; }
+  rows = 0;
+  failed = false;
+  index.clear();
+  if (!reserve(headerSize + chunkBytes)) return false;
+
+  CapHeader* h = header();
+  memcpy(h->magic, CAP_MAGIC, sizeof h->magic);
+  h->version     = CAP_VERSION;
+  h->headerSize  = (uint32_t)headerSize;
+  h->chunkRows   = chunkRows;
+  h->chunkBytes  = (uint32_t)chunkBytes;
+  h->nColumns    = nCols;
+  h->mask        = info.mask;
+  h->metaSize    = (uint32_t)meta.size();
+  h->periodUs    = info.periodUs;
+  h->fields      = info.fields;
+  h->startUnixUs = info.startUnixUs;
+  memcpy(base + sizeof(CapHeader), c, nCols * sizeof(CapColumn));
+  memcpy(base + sizeof(CapHeader) + nCols * sizeof(CapColumn), meta.data(), meta.size());
+  return true;
+}
+
+uint8_t* CaptureWriter::cell(uint16_t col) {
+  const size_t r = (size_t)(rows % chunkRows);
+  return base + headerSize + (size_t)(rows / chunkRows) * chunkBytes + colOff[col]
+       + r * capTypeSize(cols[col].type);
+}
+
+void CaptureWriter::set(uint16_t col, int64_t v) {
+  if (failed || col >= cols.size()) return;
+  uint8_t* p = cell(col);
+  switch (cols[col].type) {
+    case CAP_U64: { const uint64_t x = (uint64_t)v; memcpy(p, &x, 8); break; }
+    case CAP_I16: { const int16_t  x = (int16_t)v;  memcpy(p, &x, 2); break; }
+    case CAP_I32: { const int32_t  x = (int32_t)v;  memcpy(p, &x, 4); break; }
+    case CAP_F32: { const float    x = (float)v;    memcpy(p, &x, 4); break; }
+    case CAP_F64: { const double   x = (double)v;   memcpy(p, &x, 8); break; }
+  }
+}
+
+void CaptureWriter::set(uint16_t col, double v) {
+  if (failed || col >= cols.size()) return;
+  switch (cols[col].type) {
+    case CAP_F32: { const float x = (float)v; memcpy(cell(col), &x, 4); break; }
+    case CAP_F64: memcpy(cell(col), &v, 8); break;
+    default:      set(col, (int64_t)(v < 0 ? v - 0.5 : v + 0.5)); break;
+  }
+}
+
+bool CaptureWriter::commit() {
+  if (failed) return false;
+  const size_t r = (size_t)(rows % chunkRows);
+  uint64_t t;
+  memcpy(&t, cell(0), 8);
+  if (r == 0) {
+    CapChunkIndex e{};
+    e.offset   = headerSize + (uint64_t)(rows / chunkRows) * chunkBytes;
+    e.tFirstUs = t;
+    index.push_back(e);
+  }
+  index.back().rows = (uint32_t)(r + 1);
+  index.back().tLastUs = t;
+  if (++rows % chunkRows == 0) {                 // bloc complet : visible + bloc suivant prêt
+    header()->rows = rows;
+    if (!reserve(headerSize + (size_t)(rows / chunkRows + 1) * chunkBytes)) failed = true;
+  }
+  return !failed;
+}
+
+void CaptureWriter::flush() { if (base) header()->rows = rows; }
+
+bool CaptureWriter::close() {
+  if (fd < 0) return true;
+  const size_t data = headerSize + index.size() * chunkBytes;
+  const size_t idxBytes = index.size() * sizeof(CapChunkIndex);
+  bool ok = !failed && reserve(data + idxBytes);
+  if (ok) {
+    memcpy(base + data, index.data(), idxBytes);
+    header()->indexOffset = data;
+    header()->indexCount  = (uint32_t)index.size();
+  }
+  flush();
+  munmap(base, mapped);
+  if (ok && ftruncate(fd, (off_t)(data + idxBytes)) != 0) { perror("ftruncate"); ok = false; }
+  ::close(fd);
+  fd = -1;
+  base = nullptr;
+  mapped = 0;
+  return ok;
+}
+
+bool CaptureWriter::reserve(size_t need) {
+  if (need <= mapped) return true;
+  size_t cap = mapped ? mapped : CAP_GROW;
+  while (cap < need) cap += CAP_GROW;
+  if (ftruncate(fd, (off_t)cap) != 0) { perror("ftruncate"); return false; }
+  void* p = base ? mremap(base, mapped, cap, MREMAP_MAYMOVE)
+                 : mmap(nullptr, cap, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED) { perror("mmap"); return false; }
+  base = (uint8_t*)p;
+  mapped = cap;
+  return true;
+}
+
+// ===================== LECTURE =====================
+bool CaptureReader::open(const char* path) {
+  close();
+  fd = ::open(path, O_RDONLY);
+  if (fd < 0) { err = strerror(errno); return false; }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(CapHeader)) { err = "fichier tronqué"; close(); return false; }
+  mapped = (size_t)st.st_size;
+  void* p = mmap(nullptr, mapped, PROT_READ, MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED) { err = strerror(errno); mapped = 0; close(); return false; }
+  base = (const uint8_t*)p;
+
+  const CapHeader& h = header();
+  if (memcmp(h.magic, CAP_MAGIC, sizeof h.magic) != 0 || h.version != CAP_VERSION) {
+    err = "pas un fichier .fpcap v2"; close(); return false;
+  }
+  const size_t metaOff = sizeof(CapHeader) + h.nColumns * sizeof(CapColumn);
+  if (!h.nColumns || !h.chunkRows || metaOff + h.metaSize > h.headerSize || h.headerSize > mapped) {
+    err = "en-tête incohérent"; close(); return false;
+  }
+  cols = (const CapColumn*)(base + sizeof(CapHeader));
+  if (layoutChunk(cols, h.nColumns, h.chunkRows, colOff) != h.chunkBytes) {
+    err = "colonnes incohérentes"; close(); return false;
+  }
+  metaTxt.assign((const char*)base + metaOff, h.metaSize);
+
+  index.clear();
+  if (h.indexCount) {                              // fichier fermé : index écrit
+    if (h.indexOffset + (uint64_t)h.indexCount * sizeof(CapChunkIndex) > mapped) {
+      err = "index hors du fichier"; close(); return false;
+    }
+    index.resize(h.indexCount);
+    memcpy(index.data(), base + h.indexOffset, h.indexCount * sizeof(CapChunkIndex));
+  } else {                                         // capture en cours : blocs complets seulement
+    for (uint64_t r = 0; r < h.rows; r += h.chunkRows) {
+      CapChunkIndex e{};
+      e.offset = h.headerSize + (r / h.chunkRows) * (uint64_t)h.chunkBytes;
+      e.rows   = (uint32_t)(h.rows - r < h.chunkRows ? h.rows - r : h.chunkRows);
+      if (e.offset + h.chunkBytes > mapped) break;
+      const uint64_t* t = (const uint64_t*)(base + e.offset);
+      e.tFirstUs = t[0];
+      e.tLastUs  = t[e.rows - 1];
+      index.push_back(e);
+    }
+  }
+  for (const CapChunkIndex& e : index) {
+    if (e.offset + h.chunkBytes > mapped || e.rows > h.chunkRows) { err = "bloc hors du fichier"; close(); return false; }
+  }
+  return true;
+}
+
+void CaptureReader::close() {
+  if (base) munmap((void*)base, mapped);
+  if (fd >= 0) ::close(fd);
+  base = nullptr;
+  mapped = 0;
+  fd = -1;
+  cols = nullptr;
+  index.clear();
+}
+
+int CaptureReader::find(const char* name) const {
+  for (uint16_t c = 0; c < columns(); ++c)
+    if (strncmp(cols[c].name, name, sizeof cols[c].name) == 0) return c;
+  return -1;
+}
+
+std::string CaptureReader::meta(const char* key, const char* def) const {
+  const size_t klen = strlen(key);
+  size_t pos = 0;
+  while (pos < metaTxt.size()) {
+    size_t end = metaTxt.find('\n', pos);
+    if (end == std::string::npos) end = metaTxt.size();
+    if (end - pos > klen && metaTxt.compare(pos, klen, key) == 0 && metaTxt[pos + klen] == '=')
+      return metaTxt.substr(pos + klen + 1, end - pos - klen - 1);
+    pos = end + 1;
+  }
+  return def;
+}
+
+const void* CaptureReader::data(size_t k, uint16_t c) const {
+  return base + index[k].offset + colOff[c];
+}
+
+double CaptureReader::value(uint64_t row, uint16_t c) const {
+  const size_t k = (size_t)(row / header().chunkRows);
+  const size_t r = (size_t)(row % header().chunkRows);
+  const uint8_t* p = (const uint8_t*)data(k, c);
+  switch (cols[c].type) {
+    case CAP_U64: { uint64_t x; memcpy(&x, p + r * 8, 8); return (double)x; }
+    case CAP_I16: { int16_t  x; memcpy(&x, p + r * 2, 2); return x; }
+    case CAP_I32: { int32_t  x; memcpy(&x, p + r * 4, 4); return x; }
+    case CAP_F32: { float    x; memcpy(&x, p + r * 4, 4); return x; }
+    case CAP_F64: { double   x; memcpy(&x, p + r * 8, 8); return x; }
+    default:      return 0;
+  }
+}
@@ -0,0 +1,149 @@
+#pragma once
+// ========================== capture_file.h ==========================
+// Fichier de capture colonnaire .fpcap (Linux, mmap) : remplace les .tsv dont les
+// réglages n'étaient codés que dans le nom de fichier.
+//
+//   [CapHeader 128 o]
+//   [CapColumn × nColumns, 32 o]            nom, type, fader/champ d'origine
+//   [métadonnées, metaSize o]               texte "clé=valeur\n" (réglages PID, calibration,
+//                                           version firmware, source…), complété à 8 o
+//   [blocs]  ← headerSize                   chunkRows lignes chacun ; dans un bloc, chaque
+//                                           colonne est un tableau typé contigu (complété à 8 o)
+//   [index]  ← indexOffset                  CapChunkIndex × indexCount (écrit à la fermeture)
+//
+// La colonne 0 est toujours t_us (uint64, µs) ; l'index en garde les bornes par bloc.
+// Tant que le fichier n'est pas fermé (indexCount = 0), `rows` est mis à jour à chaque
+// bloc complet → un lecteur peut suivre une capture en cours (python/capture.py).
+// Écriture sans allocation par ligne : le fichier grossit par paliers (ftruncate + mremap).
+//
+// Outils : host/telemetry_capture (écriture), host/capture_convert (.tsv ↔ .fpcap, infos).
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+constexpr char     CAP_MAGIC[8]   = {'F', 'P', 'M', 'C', 'A', 'P', '\0', '\0'};
+constexpr uint32_t CAP_VERSION    = 2;
+constexpr uint32_t CAP_CHUNK_ROWS = 4096;
+constexpr size_t   CAP_GROW       = 16u << 20;   // palier d'agrandissement du fichier
+constexpr uint8_t  CAP_NO_FADER   = 0xFF;
+
+enum CapType : uint8_t { CAP_U64 = 1, CAP_I16 = 2, CAP_I32 = 3, CAP_F32 = 4, CAP_F64 = 5 };
+
+size_t capTypeSize(uint8_t type);                // 0 si type inconnu
+
+struct CapHeader {              // 128 o, LE
+  char     magic[8];
+  uint32_t version;
+  uint32_t headerSize;          // offset du 1er bloc
+  uint32_t chunkRows;
+  uint32_t chunkBytes;
+  uint16_t nColumns;
+  uint16_t mask;                // faders capturés (bit i = fader i), 0 si inconnu
+  uint32_t metaSize;
+  uint32_t periodUs;            // période d'échantillonnage (0 si inconnue)
+  uint8_t  fields;              // champs par fader (télémétrie : consigne, mesure, commande)
+  uint8_t  reserved0[3];
+  uint64_t rows;                // lignes valides
+  uint64_t startUnixUs;         // début de capture (horloge hôte), 0 si inconnu
+  uint64_t indexOffset;         // 0 tant que le fichier n'est pas fermé
+  uint32_t indexCount;
+  uint8_t  reserved[60];
+};
+static_assert(sizeof(CapHeader) == 128, "CapHeader : 128 octets");
+
+struct CapColumn {              // 32 o
+  char    name[24];
+  uint8_t type;                 // CapType
+  uint8_t fader;                // CAP_NO_FADER si la colonne n'est pas liée à un fader
+  uint8_t field;
+  uint8_t reserved[5];
+};
+static_assert(sizeof(CapColumn) == 32, "CapColumn : 32 octets");
+
+struct CapChunkIndex {          // 32 o
+  uint64_t offset;
+  uint32_t rows;
+  uint32_t reserved;
+  uint64_t tFirstUs;
+  uint64_t tLastUs;
+};
+static_assert(sizeof(CapChunkIndex) == 32, "CapChunkIndex : 32 octets");
+
+struct CapInfo {
+  uint16_t mask = 0;
+  uint8_t  fields = 0;
+  uint32_t periodUs = 0;
+  uint64_t startUnixUs = 0;
+  uint32_t chunkRows = CAP_CHUNK_ROWS;
+};
+
+CapColumn capColumn(const char* name, uint8_t type, uint8_t fader = CAP_NO_FADER, uint8_t field = 0);
+
+// ---------------- Écriture ----------------
+class CaptureWriter {
+ public:
+  ~CaptureWriter() { close(); }
+
+  // cols[0] doit être t_us (CAP_U64) ; meta : "clé=valeur\n"…
+  bool open(const char* path, const CapColumn* cols, uint16_t nCols, const CapInfo& info,
+            const std::string& meta);
+  bool isOpen() const { return fd >= 0; }
+  uint64_t size() const { return rows; }
+
+  // Ligne courante : set() par colonne puis commit()
+  void set(uint16_t col, int64_t v);
+  void set(uint16_t col, double v);
+  bool commit();
+
+  void flush();                 // rows visible par un lecteur
+  bool close();                 // écrit l'index, ajuste la taille du fichier
+
+ private:
+  CapHeader* header() { return (CapHeader*)base; }
+  uint8_t* cell(uint16_t col);
+  bool reserve(size_t need);
+
+  int      fd = -1;
+  uint8_t* base = nullptr;
+  size_t   mapped = 0;
+  std::vector<CapColumn> cols;
+  std::vector<size_t>    colOff;     // offset de chaque colonne dans un bloc
+  std::vector<CapChunkIndex> index;
+  size_t   headerSize = 0, chunkBytes = 0;
+  uint32_t chunkRows = 0;
+  uint64_t rows = 0;
+  bool     failed = false;
+};
+
+// ---------------- Lecture ----------------
+class CaptureReader {
+ public:
+  ~CaptureReader() { close(); }
+
+  bool open(const char* path);  // false + error() si le fichier est invalide
+  void close();
+  const std::string& error() const { return err; }
+
+  const CapHeader& header() const { return *(const CapHeader*)base; }
+  uint64_t rows() const { return header().rows; }
+  uint16_t columns() const { return header().nColumns; }
+  const CapColumn& column(uint16_t c) const { return cols[c]; }
+  int find(const char* name) const;                 // -1 si absente
+  std::string meta(const char* key, const char* def = "") const;
+  const std::string& metaText() const { return metaTxt; }
+
+  size_t chunks() const { return index.size(); }
+  const CapChunkIndex& chunk(size_t k) const { return index[k]; }
+  const void* data(size_t k, uint16_t c) const;     // tableau typé de la colonne c, bloc k
+  double value(uint64_t row, uint16_t c) const;     // accès générique (lent)
+
+ private:
+  int      fd = -1;
+  const uint8_t* base = nullptr;
+  size_t   mapped = 0;
+  const CapColumn* cols = nullptr;
+  std::vector<size_t> colOff;
+  std::vector<CapChunkIndex> index;
+  std::string metaTxt, err;
+};
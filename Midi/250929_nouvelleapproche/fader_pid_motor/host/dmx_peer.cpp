@@ -0,0 +1,248 @@
+// ========================== dmx_peer.cpp ==========================
+// Outil Linux : récepteur / source Art-Net et sACN pour la sortie DMX du firmware
+// (dmx_eth.h), sur la même pile dmx.h/.cpp que le Pico.
+//
+//   récepteur (défaut) : écoute le port du protocole (sACN 5568, Art-Net 6454), rejoint
+//     les groupes multicast sACN des univers suivis ; affiche les canaux qui changent
+//     et, chaque seconde, par univers : trames / s, dont keep-alive (contenu inchangé),
+//     trous de séquence
+//   -S : source simulée, le patch par défaut du firmware : 4 faders 16 bits (canaux
+//        1/3/5/7) et touches 101.. allumées tour à tour, actifs 2 s sur 4 ;
+//        DmxOutput.poll() à -r Hz → seuls les univers changés partent, keep-alive sinon
+//     -i ip : destination (défaut 127.0.0.1 ; "m" = groupe multicast sACN de l'univers)
+//
+// Test local :  ./dmx_peer -t 6 &  ./dmx_peer -S -t 5
+//               (-p artnet des deux côtés pour Art-Net)
+//
+// Build : g++ -O2 -std=c++17 -I.. -o dmx_peer dmx_peer.cpp ../dmx.cpp
+// Usage : ./dmx_peer [-S] [-p sacn|artnet] [-u univers] [-n univers] [-i ip|m] [-r Hz] [-t s] [-q]
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "dmx.h"
+
+namespace {
+
+constexpr int SIM_FADERS = 4;
+constexpr int SIM_KEYS   = 16;
+
+volatile sig_atomic_t gStop = 0;
+
+uint64_t nowUs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000;
+}
+
+struct Options {
+  bool source = false;
+  DmxProtocol proto = DMX_SACN;
+  int universe = 1;
+  int universes = 1;
+  const char* host = "127.0.0.1";
+  int rate = 40;
+  int seconds = 0;
+  bool quiet = false;
+};
+
+in_addr sacnGroup(uint16_t universe) {
+  in_addr a;
+  a.s_addr = htonl(0xEFFF0000u | universe);      // 239.255.hi.lo
+  return a;
+}
+
+// ---------------- Source simulée ----------------
+struct Source {
+  int fd;
+  sockaddr_in dst;
+  bool multicast;
+  uint32_t datagrams = 0;
+};
+
+void sourceSend(void* ctx, uint8_t, uint16_t universe, const uint8_t* pkt, size_t len) {
+  Source& s = *(Source*)ctx;
+  sockaddr_in d = s.dst;
+  if (s.multicast) d.sin_addr = sacnGroup(universe);
+  if (sendto(s.fd, pkt, len, 0, (sockaddr*)&d, sizeof d) == (ssize_t)len) ++s.datagrams;
+}
+
+// ---------------- Récepteur ----------------
+struct UniverseStats {
+  uint16_t universe = 0;
+  bool     seen = false;
+  uint8_t  seq = 0;
+  uint8_t  data[DMX_SLOTS] = {};
+  uint32_t frames = 0, keepalive = 0, seqGaps = 0, terminated = 0;
+  uint32_t prevFrames = 0, prevKeepalive = 0;
+};
+
+void onFrame(UniverseStats& u, const DmxFrame& f, bool quiet) {
+  ++u.frames;
+  if (f.terminated) { ++u.terminated; return; }
+  if (u.seen) {
+    // Art-Net : 1..255 (0 = pas de séquence) ; sACN : 0..255
+    const uint8_t expect = f.proto == DMX_ARTNET ? (u.seq == 255 ? 1 : u.seq + 1) : (uint8_t)(u.seq + 1);
+    if (f.seq && f.seq != expect) ++u.seqGaps;
+  }
+  u.seq = f.seq;
+  bool changed = !u.seen;
+  for (uint16_t c = 0; c < f.count; ++c) {
+    if (u.data[c] == f.data[c]) continue;
+    if (!quiet) printf("u%-5u ch%-3u %3u -> %3u\n", u.universe, c + 1, u.data[c], f.data[c]);
+    u.data[c] = f.data[c];
+    changed = true;
+  }
+  if (!changed) ++u.keepalive;
+  u.seen = true;
+}
+
+void usage() {
+  fprintf(stderr, "usage: dmx_peer [-S] [-p sacn|artnet] [-u univers] [-n univers] [-i ip|m] [-r Hz] [-t s] [-q]\n");
+  exit(2);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options o;
+  for (int k = 1; k < argc; ++k) {
+    const std::string a = argv[k];
+    auto val = [&]() { if (k + 1 >= argc) usage(); return argv[++k]; };
+    if      (a == "-S") o.source = true;
+    else if (a == "-p") {
+      const std::string p = val();
+      if      (p == "sacn")   o.proto = DMX_SACN;
+      else if (p == "artnet") o.proto = DMX_ARTNET;
+      else usage();
+    }
+    else if (a == "-u") o.universe = atoi(val());
+    else if (a == "-n") o.universes = atoi(val());
+    else if (a == "-i") o.host = val();
+    else if (a == "-r") o.rate = atoi(val());
+    else if (a == "-t") o.seconds = atoi(val());
+    else if (a == "-q") o.quiet = true;
+    else usage();
+  }
+  if (o.universes < 1 || o.universes > DMX_MAX_UNIVERSES || o.rate < 1 || o.rate > 1000) usage();
+  if (o.universe < (o.proto == DMX_SACN ? 1 : 0) || o.universe + o.universes - 1 > 32767) usage();
+  signal(SIGINT, [](int) { gStop = 1; });
+  const uint16_t port = o.proto == DMX_SACN ? SACN_PORT : ARTNET_PORT;
+
+  const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) { perror("socket"); return 1; }
+  const int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+  setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &one, sizeof one);   // Art-Net en diffusion
+  const uint64_t t0 = nowUs();
+
+  // ---------------- Source ----------------
+  if (o.source) {
+    Source src{ fd, {}, false };
+    src.dst.sin_family = AF_INET;
+    src.dst.sin_port   = htons(port);
+    src.multicast = !strcmp(o.host, "m");
+    if (src.multicast && o.proto != DMX_SACN) usage();
+    if (!src.multicast && inet_pton(AF_INET, o.host, &src.dst.sin_addr) != 1) usage();
+
+    static DmxOutput out;                                        // 2,5 Kio de paquets
+    const uint8_t cid[16] = { 'R', 'o', 'u', 'l', 'a', 'n', 't', 'e', 'D', 'M', 'p', 'e', 'e', 'r', 0, 1 };
+    out.begin(o.proto, (uint16_t)o.universe, (uint8_t)o.universes, 1000000, cid, "dmx_peer", 100, sourceSend, &src);
+
+    const uint64_t period = 1000000u / (uint64_t)o.rate;
+    uint64_t next = t0;
+    while (!gStop) {
+      const uint64_t now = nowUs();
+      if (now < next) { usleep((useconds_t)(next - now)); continue; }
+      next += period;
+      const double t = (now - t0) * 1e-6;
+      const bool moving = fmod(t, 4.0) < 2.0;                    // surface active 2 s sur 4
+      if (moving) {
+        for (int i = 0; i < SIM_FADERS; ++i) {
+          const double v = 0.5 - 0.5 * cos(2 * M_PI * (t / 2.0 + 0.25 * i));
+          out.set16(dmxAddr(0, (uint16_t)(1 + 2 * i)), (uint16_t)lround(v * 65535));
+        }
+      }
+      const int key = moving ? (int)(t / 0.5) % SIM_KEYS : -1;   // 1 touche enfoncée / 0,5 s
+      for (int k = 0; k < SIM_KEYS; ++k) out.set8(dmxAddr(0, (uint16_t)(101 + k)), k == key ? 255 : 0);
+      out.poll((uint32_t)(now - t0));
+      if (o.seconds && now - t0 >= (uint64_t)o.seconds * 1000000u) break;
+    }
+    out.stop();
+    printf("source: %s univers %d..%d  trames=%u keep-alive=%u datagrammes=%u\n",
+           o.proto == DMX_SACN ? "sACN" : "Art-Net", o.universe, o.universe + o.universes - 1,
+           out.txFrames, out.txKeepalive, src.datagrams);
+    return 0;
+  }
+
+  // ---------------- Récepteur ----------------
+  sockaddr_in a{};
+  a.sin_family = AF_INET;
+  a.sin_addr.s_addr = htonl(INADDR_ANY);
+  a.sin_port = htons(port);
+  if (bind(fd, (sockaddr*)&a, sizeof a) < 0) { perror("bind"); return 1; }
+  UniverseStats uni[DMX_MAX_UNIVERSES];
+  for (int u = 0; u < o.universes; ++u) {
+    uni[u].universe = (uint16_t)(o.universe + u);
+    if (o.proto != DMX_SACN) continue;
+    ip_mreq m{};
+    m.imr_multiaddr = sacnGroup(uni[u].universe);
+    m.imr_interface.s_addr = htonl(INADDR_ANY);
+    if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &m, sizeof m) < 0 && u == 0)
+      perror("IP_ADD_MEMBERSHIP (unicast seulement)");
+  }
+
+  uint8_t buf[DMX_MAX_PACKET + 64];
+  uint32_t bad = 0, other = 0;
+  uint64_t lastStat = t0;
+  while (!gStop) {
+    pollfd pfd{ fd, POLLIN, 0 };
+    poll(&pfd, 1, 10);
+    if (pfd.revents & POLLIN) {
+      const ssize_t n = recv(fd, buf, sizeof buf, 0);
+      DmxFrame f;
+      if (n > 0 && dmxParse(buf, (size_t)n, f) && f.proto == o.proto) {
+        int u = f.universe - o.universe;
+        if (u >= 0 && u < o.universes) onFrame(uni[u], f, o.quiet);
+        else ++other;
+      } else if (n > 0) {
+        ++bad;
+      }
+    }
+    const uint64_t now = nowUs();
+    if (now - lastStat >= 1000000) {
+      const double dt = (now - lastStat) * 1e-6;
+      for (int u = 0; u < o.universes; ++u) {
+        UniverseStats& s = uni[u];
+        printf("  u%-5u %5.1f trames/s (keep-alive %4.1f/s)  séquence : %u trou(s)\n", s.universe,
+               (s.frames - s.prevFrames) / dt, (s.keepalive - s.prevKeepalive) / dt, s.seqGaps);
+        s.prevFrames = s.frames;
+        s.prevKeepalive = s.keepalive;
+      }
+      fflush(stdout);
+      lastStat = now;
+    }
+    if (o.seconds && now - t0 >= (uint64_t)o.seconds * 1000000u) break;
+  }
+
+  printf("récepteur: autres univers=%u invalides=%u\n", other, bad);
+  for (int u = 0; u < o.universes; ++u) {
+    const UniverseStats& s = uni[u];
+    printf("  u%u : trames=%u keep-alive=%u trous=%u fin de flux=%u  ch1..8 =", s.universe,
+           s.frames, s.keepalive, s.seqGaps, s.terminated);
+    for (int c = 0; c < 8; ++c) printf(" %u", s.data[c]);
+    printf("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,1041 @@
+// ========================== fader_tests.cpp ==========================
+// Tests hôte des modules portables du firmware (fader_core), sans dépendance externe :
+//   pid        PID::update (P, I, D sur la mesure, saturation) et setGainsBumpless
+//              (Ki → Ki', Ki → 0 figé, 0 → Ki' : le terme I ne saute pas)
+//   ump        umpScaleUp / umpScaleDown (min-centre-max MIDI 2.0, aller-retour 12 bits),
+//              NRPN / NRPN relatif relus par umpParseController, UMP Stream, MIDI-CI
+//   host       CRC-16/CCITT, slipEncode, protocole hôte : SET appliqué ; CRC faux,
+//              hors bornes et ré-émission (même seq) sans effet ; butées / snap
+//              croisées → NACK HP_ERR_RANGE (réponse relue sur le pty du simulateur)
+//   midiout    ordonnanceur de sortie coalescent (MIDIIO_flush) : 1er envoi immédiat,
+//              rafale ramenée à 1 CC (dernière valeur) par intervalle, CC inchangé muet,
+//              pas d'encodeur cumulés puis découpés en ±ENC_REL_MAX_STEP
+//   scene      mémorisation (RAM tout de suite, flash différée jusqu'au repos ou
+//              SCENE_FLUSH_MAX_MS, moteurs coupés), rappel minimum jerk vers la scène,
+//              limite PWM progressive, sceneCancel, SysEx F0 7D 01/02
+//   osc        motifs OSC 1.0 (* ? [..] [!..] {a,b}), OscWriter → oscParse (bundles
+//              imbriqués, types s/i/f/T), paquets tronqués refusés, OscAddressTable
+//              (hachage exact, motifs mis en cache puis invalidés par add)
+//   keys       anti-rebond de la matrice : impulsion < KEY_DEBOUNCE_COUNT balayages rejetée,
+//              contact qui rebondit (simulateur) → 1 seul événement par appui / relâché,
+//              délai borné, touches hors matrice ignorées, file pleine comptée, notes
+//              MIDI (canal suivant au-delà de 127)
+//   encoders   quadrature simulée → crans → accélération → CC relatifs : lent = 1 pas par
+//              cran, rapide = gain ENC_ACCEL_MAX, moyen entre les deux ; vitesse remise à 0
+//              après ENC_SPEED_IDLE_MS, fraction de pas jetée au changement de sens
+//   dmx        paquets DmxOutput (Art-Net, sACN) relus par dmxParse, keep-alive, arrêt sACN
+//   telemetry  trames 'T' v1 / v2 construites à la main → telemDecode, CRC faux détecté
+//   rtpmidi    session AppleMIDI initiateur ↔ responder, paquet perdu rattrapé par le
+//              journal (chapitre C) ; CC relatif hors journal ; RS vide le journal
+//   step       StepAnalyzer sur la réponse indicielle analytique d'un 2e ordre (ζ, ωn) :
+//              montée 10-90 %, dépassement, établissement comparés aux valeurs théoriques
+//
+// Enregistré dans CTest (CMakeLists.txt) : ctest --test-dir build --output-on-failure
+// Usage : ./fader_tests [groupe ...]     (défaut : tous ; code de sortie 0 = tout passe)
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <EEPROM.h>
+
+#include "crc16.h"
+#include "dmx.h"
+#include "encoders.h"
+#include "fader_bank.h"
+#include "host_protocol.h"
+#include "key_matrix.h"
+#include "midi_io.h"
+#include "scene.h"
+#include "osc.h"
+#include "pid.h"
+#include "rtpmidi.h"
+#include "sim_hal.h"
+#include "step_metrics.h"
+#include "telemetry.h"
+#include "telemetry_codec.h"
+#include "ump.h"
+
+namespace {
+
+// ===================== Vérifications =====================
+int gChecks = 0, gFails = 0;
+
+void check(bool ok, const char* expr, const char* file, int line) {
+  ++gChecks;
+  if (ok) return;
+  ++gFails;
+  printf("[ECHEC] %s:%d  %s\n", file, line, expr);
+}
+
+void checkNear(double a, double b, double tol, const char* expr, const char* file, int line) {
+  ++gChecks;
+  if (std::fabs(a - b) <= tol) return;
+  ++gFails;
+  printf("[ECHEC] %s:%d  %s : %.6g au lieu de %.6g (±%g)\n", file, line, expr, a, b, tol);
+}
+
+#define CHECK(c)              check((c), #c, __FILE__, __LINE__)
+#define CHECK_NEAR(a, b, tol) checkNear((a), (b), (tol), #a, __FILE__, __LINE__)
+
+void put16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+
+// ===================== PID =====================
+void testPid() {
+  // P seul : u = Kp·e, borné à ±maxOutput
+  PID p(2, 0, 0, 0.001f);
+  p.setSetpoint(1000);
+  CHECK_NEAR(p.update(900), 200, 1e-4);
+  CHECK_NEAR(p.update(1200), -255, 1e-4);
+  CHECK_NEAR(p.update(0), 255, 1e-4);
+
+  // I seul : u = Ki·Ts·Σe des échantillons précédents
+  PID i(0, 10, 0, 0.001f);
+  i.setSetpoint(600);
+  float u = 0;
+  for (int k = 0; k < 5; ++k) u = i.update(500);
+  CHECK_NEAR(u, 0.01 * 100 * 4, 1e-4);
+
+  // D sur la mesure (f_c = 0 : sans filtre) : u = −Kd/Ts·Δmesure, pas de coup de consigne
+  PID d(0, 0, 0.01f, 0.001f);
+  d.setSetpoint(500);
+  d.update(500);
+  CHECK_NEAR(d.update(500), 0, 1e-4);
+  CHECK_NEAR(d.update(490), 100, 1e-3);
+  d.setSetpoint(2000);
+  CHECK_NEAR(d.update(490), 0, 1e-4);
+
+  // anti-windup : sortie saturée → l'intégrale ne grossit plus
+  PID w(0.1f, 10, 0, 0.001f);
+  w.setSetpoint(4000);
+  for (int k = 0; k < 100; ++k) CHECK_NEAR(w.update(0), 255, 1e-4);
+  w.setSetpoint(0);
+  CHECK_NEAR(w.update(0), 0, 1e-4);    // sans anti-windup : Ki·Ts·Σe = 4000 → encore saturé
+
+  // setGainsBumpless : la sortie suit celle qu'auraient donnée les anciens gains
+  PID b(0, 10, 0, 0.001f);
+  b.setSetpoint(600);
+  for (int k = 0; k < 20; ++k) u = b.update(500);
+  CHECK_NEAR(u, 19, 1e-3);
+  b.setGainsBumpless(0, 4, 0);                       // Ki → Ki'
+  CHECK_NEAR(b.getKi(), 4, 1e-5);
+  CHECK_NEAR(b.update(500), 20, 0.004);              // ±1 pas d'intégrale (arrondi)
+  CHECK_NEAR(b.update(500), 20.4, 0.004);
+  b.setGainsBumpless(0, 0, 0);                       // Ki → 0 : terme I figé
+  CHECK_NEAR(b.update(500), 20.8, 0.004);
+  CHECK_NEAR(b.update(500), 20.8, 0.004);
+  CHECK_NEAR(b.update(400), 20.8, 0.004);
+  b.setGainsBumpless(0, 10, 0);                      // 0 → Ki' : reprise sans à-coup
+  CHECK_NEAR(b.update(500), 20.8, 0.01);
+  CHECK_NEAR(b.update(500), 21.8, 0.01);
+  b.resetIntegral();
+  CHECK_NEAR(b.update(600), 0, 1e-4);
+}
+
+// ===================== UMP =====================
+void testUmp() {
+  CHECK(umpScaleUp(0, 7, 32) == 0);
+  CHECK(umpScaleUp(64, 7, 32) == 0x80000000u);
+  CHECK(umpScaleUp(127, 7, 32) == 0xFFFFFFFFu);
+  CHECK(umpScaleUp(127, 7, 14) == 0x3FFF);
+  CHECK(umpScaleUp(2048, 12, 16) == 0x8000);
+  CHECK(umpScaleUp(4095, 12, 16) == 0xFFFF);
+  CHECK(umpScaleUp(4095, 12, 32) == 0xFFFFFFFFu);
+  CHECK(umpScaleUp(1234, 12, 12) == 1234);
+  CHECK(umpScaleDown(0xFFFFFFFFu, 32, 7) == 127);
+  CHECK(umpScaleDown(0x80000000u, 32, 14) == 0x2000);
+
+  // 12 bits → 32 → 12 : identité, strictement croissant
+  bool roundTrip = true, monotonic = true;
+  uint32_t prev = 0;
+  for (uint32_t v = 0; v <= 4095; ++v) {
+    const uint32_t up = umpScaleUp(v, 12, 32);
+    if (umpScaleDown(up, 32, 12) != v) roundTrip = false;
+    if (v && up <= prev) monotonic = false;
+    prev = up;
+  }
+  CHECK(roundTrip);
+  CHECK(monotonic);
+
+  // NRPN (fader) émis puis relu ; NRPN relatif (encodeur) : delta signé, pas un contrôleur
+  uint32_t w[4];
+  UmpController c;
+  umpMidi2NRPN(w, 2, 5, 1, 16, 0x80000000u);
+  CHECK(umpWordCount(w[0]) == 2);
+  CHECK(umpParseController(w, c));
+  CHECK(c.status == UMP_M2_NRPN && c.group == 2 && c.channel == 5 && c.bank == 1 && c.index == 16);
+  CHECK(c.value == 0x80000000u);
+  umpMidi2RelNRPN(w, 0, 5, 1, 40, -3);
+  CHECK((int32_t)w[1] == -3 && ((w[0] >> 20) & 0xF) == UMP_M2_REL_NRPN);
+  CHECK(!umpParseController(w, c));
+  w[0] = 0x40B51000u; w[1] = 0xFFFFFFFFu;              // CC 16 reçu d'un hôte MIDI 2.0
+  CHECK(umpParseController(w, c) && c.status == UMP_M2_CC && c.bank == 0 && c.index == 16);
+
+  // UMP Stream : 128 bits, statut / protocole relus
+  umpStreamConfig(w, UMP_STREAM_CONFIG_NOTIFY, UMP_PROTOCOL_MIDI2);
+  CHECK(umpWordCount(w[0]) == 4);
+  CHECK(umpStreamStatus(w) == UMP_STREAM_CONFIG_NOTIFY && umpStreamProtocol(w) == UMP_PROTOCOL_MIDI2);
+  umpStreamEndpointInfo(w, 1, true, true);
+  CHECK(umpStreamStatus(w) == UMP_STREAM_EP_INFO && (w[1] & 0x300) == 0x300);
+
+  // MIDI-CI : Discovery / Reply relus (MUID de l'émetteur) ; autre SysEx → 0
+  const MidiCiIdentity id{ 0x0ABCDEF, { 0x7D, 0, 0 }, 1, 2, 0x00010203, 512 };
+  uint8_t ci[40];
+  uint32_t src = 0;
+  size_t len = midiCiDiscovery(ci, sizeof ci, id);
+  CHECK(len == 32 && ci[0] == 0xF0 && ci[len - 1] == 0xF7);
+  CHECK(midiCiParse(ci, len, src) == MIDICI_DISCOVERY && src == id.muid);
+  len = midiCiDiscoveryReply(ci, sizeof ci, id, 0x0123456);
+  CHECK(len == 33 && midiCiParse(ci + 1, len - 1, src) == MIDICI_DISCOVERY_REP && src == id.muid);
+  CHECK(midiCiDiscovery(ci, 31, id) == 0);
+  static const uint8_t identity[] = { 0xF0, 0x7E, 0x7F, 0x06, 0x01, 0xF7, 0, 0, 0, 0 };
+  CHECK(midiCiParse(identity, sizeof identity, src) == 0);
+}
+
+// ===================== Lien hôte =====================
+size_t hpFrame(uint8_t* f, uint8_t msg, uint8_t seq, const uint8_t* p, uint8_t n) {
+  f[0] = HP_MAGIC; f[1] = HP_VERSION; f[2] = msg; f[3] = seq;
+  memcpy(f + 4, p, n);
+  put16(f + 4 + n, crc16_ccitt(f, 4u + n));
+  return 6u + n;
+}
+
+size_t hpSetF32(uint8_t* f, uint8_t seq, uint8_t param, uint8_t idx, float v) {
+  uint8_t p[7] = { param, idx, HP_T_F32 };
+  memcpy(p + 3, &v, 4);
+  return hpFrame(f, HP_SET, seq, p, sizeof p);
+}
+
+size_t hpSetI32(uint8_t* f, uint8_t seq, uint8_t param, uint8_t idx, int32_t v) {
+  uint8_t p[7] = { param, idx, HP_T_I32 };
+  memcpy(p + 3, &v, 4);
+  return hpFrame(f, HP_SET, seq, p, sizeof p);
+}
+
+// Réponses : le CDC simulé sort sur un pty (sim_hal.h), relu ici côté esclave.
+// Renvoie la dernière trame SLIP reçue, décodée (0 : aucune).
+int gLink = -1;
+
+size_t hpReply(uint8_t* r, size_t cap) {
+  sim::advance(2000);                                  // FIFO USB → pty
+  uint8_t buf[512], tmp[HP_MAX_FRAME];
+  size_t len = 0, n = 0, last = 0;
+  ssize_t k;
+  while (len < sizeof buf && (k = read(gLink, buf + len, sizeof buf - len)) > 0) len += (size_t)k;
+  bool esc = false;
+  for (size_t i = 0; i < len; ++i) {
+    uint8_t b = buf[i];
+    if (b == 0xC0) {                                   // SLIP END
+      if (n && n <= cap) { memcpy(r, tmp, n); last = n; }
+      n = 0; esc = false;
+      continue;
+    }
+    if (b == 0xDB) { esc = true; continue; }           // SLIP ESC
+    if (esc) { b = (b == 0xDC) ? 0xC0 : 0xDB; esc = false; }
+    if (n < sizeof tmp) tmp[n++] = b;
+  }
+  return last;
+}
+
+bool hpNacked(uint8_t seq, uint8_t code) {
+  uint8_t r[HP_MAX_FRAME];
+  const size_t n = hpReply(r, sizeof r);
+  return n == 8 && r[2] == HP_NACK && r[3] == seq && r[4] == HP_SET && r[5] == code;
+}
+
+bool hpAcked(uint8_t seq) {
+  uint8_t r[HP_MAX_FRAME];
+  const size_t n = hpReply(r, sizeof r);
+  return n == 7 && r[2] == HP_ACK && r[3] == seq && r[4] == HP_SET;
+}
+
+void testHost() {
+  static const uint8_t check9[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+  CHECK(crc16_ccitt(check9, sizeof check9) == 0x29B1);      // valeur de contrôle CCITT-FALSE
+  CHECK(crc16_ccitt(check9 + 4, 5, crc16_ccitt(check9, 4)) == 0x29B1);   // par morceaux
+
+  static const uint8_t raw[] = { 0x01, 0xC0, 0xDB, 0x02 };
+  static const uint8_t slip[] = { 0xC0, 0x01, 0xDB, 0xDC, 0xDB, 0xDD, 0x02, 0xC0 };
+  uint8_t enc[2 * sizeof raw + 2];
+  CHECK(slipEncode(raw, sizeof raw, enc) == sizeof slip);
+  CHECK(!memcmp(enc, slip, sizeof slip));
+
+  // SET kp du fader 0 : appliqué au PID et mémorisé pour Tuning.py
+  PID& pid = gBank.pid[0];
+  pid.setKp(1.0f);
+  uint8_t f[HP_MAX_FRAME];
+  size_t n = hpSetF32(f, 1, HP_P_KP, 0, 0.5f);
+  hostProtoHandle(f, (uint16_t)n);
+  CHECK(pid.getKp() == 0.5f);
+  CHECK(kp_python == 0.5f);
+
+  // CRC faux → rien n'est appliqué
+  n = hpSetF32(f, 2, HP_P_KP, 0, 0.75f);
+  f[n - 1] ^= 0x01;
+  hostProtoHandle(f, (uint16_t)n);
+  CHECK(pid.getKp() == 0.5f);
+
+  // hors bornes (kp ≤ 1000), mauvais type, fader inexistant → refusés
+  n = hpSetF32(f, 3, HP_P_KP, 0, 2000.0f);
+  hostProtoHandle(f, (uint16_t)n);
+  CHECK(pid.getKp() == 0.5f);
+  n = hpSetF32(f, 4, HP_P_SETPOINT, 0, 100.0f);
+  hostProtoHandle(f, (uint16_t)n);
+  CHECK(gBank.setpoint[0] != 100);
+  n = hpSetF32(f, 5, HP_P_KP, NUM_FADERS, 0.25f);
+  hostProtoHandle(f, (uint16_t)n);
+  CHECK(pid.getKp() == 0.5f);
+
+  // ré-émission (même seq, même CRC) : réponse renvoyée, pas ré-appliquée
+  n = hpSetF32(f, 6, HP_P_KP, 0, 0.25f);
+  hostProtoHandle(f, (uint16_t)n);
+  CHECK(pid.getKp() == 0.25f);
+  pid.setKp(0.1f);
+  hostProtoHandle(f, (uint16_t)n);
+  CHECK(pid.getKp() == 0.1f);
+
+  // SET entier (setpoint)
+  n = hpSetI32(f, 7, HP_P_SETPOINT, 0, 3000);
+  hostProtoHandle(f, (uint16_t)n);
+  CHECK(gBank.setpoint[0] == 3000);
+
+  // butées / snap : chaque valeur dans [0, ADC_MAX] mais min ≥ max → NACK, calibration
+  // inchangée (sense() diviserait par zéro)
+  CHECK(sim::begin(nullptr));
+  gLink = open(sim::ptyName(), O_RDONLY | O_NONBLOCK | O_NOCTTY);
+  CHECK(gLink >= 0);
+  const FaderCalib saved = gBank.calib;
+  n = hpSetI32(f, 8, HP_P_USABLE_MIN, 0, 2000);
+  hostProtoHandle(f, (uint16_t)n);
+  CHECK(hpAcked(8));
+  CHECK(gBank.calib.usableMin == 2000);
+  n = hpSetI32(f, 9, HP_P_USABLE_MAX, 0, 2000);
+  hostProtoHandle(f, (uint16_t)n);
+  CHECK(hpNacked(9, HP_ERR_RANGE));
+  CHECK(gBank.calib.usableMin == 2000 && gBank.calib.usableMax == saved.usableMax);
+  n = hpSetI32(f, 10, HP_P_SNAP_LOW, 0, saved.snapHigh);
+  hostProtoHandle(f, (uint16_t)n);
+  CHECK(hpNacked(10, HP_ERR_RANGE));
+  n = hpSetI32(f, 11, HP_P_SNAP_HIGH, 0, saved.snapLow);
+  hostProtoHandle(f, (uint16_t)n);
+  CHECK(hpNacked(11, HP_ERR_RANGE));
+  CHECK(gBank.calib.snapLow == saved.snapLow && gBank.calib.snapHigh == saved.snapHigh);
+
+  // plage vide posée directement : sense() garde la position sans diviser
+  gBank.calib.usableMax = gBank.calib.usableMin;
+  const uint16_t pos = gBank.position[0];
+  gBank.sense(0);
+  CHECK(gBank.position[0] == pos);
+  gBank.calib = saved;
+
+  close(gLink);
+  gLink = -1;
+  sim::end();
+}
+
+// ===================== Ordonnanceur de sortie MIDI =====================
+struct MidiMsg { uint8_t st, d1, d2; };
+MidiMsg gMidi[16];
+int     gMidiN = 0;
+
+void midiCapture(uint8_t st, uint8_t d1, uint8_t d2) {
+  if (gMidiN < 16) gMidi[gMidiN++] = { st, d1, d2 };
+}
+
+// fait passer dtUs puis un flush ; messages émis dans gMidi
+uint8_t flushAfter(uint32_t dtUs) {
+  sim::advance(dtUs);
+  gMidiN = 0;
+  return MIDIIO_flush((uint32_t)sim::now());
+}
+
+bool sentCC(uint8_t cc, uint8_t value) {
+  return gMidiN == 1 && gMidi[0].st == (0xB0 | (midi_channel - 1)) && gMidi[0].d1 == cc && gMidi[0].d2 == value;
+}
+
+void testMidiOut() {
+  sim::setMidiHook(midiCapture);
+  const uint32_t T = midi_out_interval_us;
+  const uint8_t fcc = midi_fader_cc[0], ecc = midi_enc_cc[0];
+
+  // 1er envoi sans attendre l'intervalle
+  MIDIIO_sendPositionFromADC(0, 2048);
+  CHECK(flushAfter(0) == 1 && sentCC(fcc, adcToCC(2048)));
+
+  // rafale : rien avant l'intervalle, puis UN CC avec la dernière valeur
+  MIDIIO_sendPositionFromADC(0, 3000);
+  MIDIIO_sendPositionFromADC(0, 3500);
+  CHECK(flushAfter(T / 4) == 0 && gMidiN == 0);
+  CHECK(flushAfter(T) == 1 && sentCC(fcc, adcToCC(3500)));
+
+  // même CC 7 bits (MIDI 1.0) : rien, même au repos
+  CHECK(adcToCC(3505) == adcToCC(3500));
+  MIDIIO_sendPositionFromADC(0, 3505);
+  CHECK(flushAfter(MIDI_OUT_SETTLE_MS * 1000 + T) == 0 && gMidiN == 0);
+
+  // encodeur : pas cumulés, ±ENC_REL_MAX_STEP par message et par intervalle, le reste ensuite
+  MIDIIO_sendEncoderDelta(0, 50);
+  MIDIIO_sendEncoderDelta(0, 30);
+  CHECK(flushAfter(T) == 1 && sentCC(ecc, ENC_REL_CENTER + ENC_REL_MAX_STEP));
+  CHECK(flushAfter(T / 4) == 0);
+  CHECK(flushAfter(T) == 1 && sentCC(ecc, ENC_REL_CENTER + 80 - ENC_REL_MAX_STEP));
+  CHECK(flushAfter(T) == 0);
+  MIDIIO_sendEncoderDelta(0, -5);
+  CHECK(flushAfter(T) == 1 && sentCC(ecc, ENC_REL_CENTER - 5));
+  sim::setMidiHook(nullptr);
+}
+
+// ===================== Scènes =====================
+// masque des scènes valides écrit en flash (SceneTable : magic, validMask, ...)
+uint32_t flashSceneMask() {
+  uint32_t magic = 0, mask = 0;
+  EEPROM.get(0, magic);
+  EEPROM.get(4, mask);
+  return magic == 0x53434E31 ? mask : 0;               // SCENE_MAGIC "SCN1" ; flash effacée : 0
+}
+
+// rappel suivi toutes les 10 ms jusqu'à la fin ; consignes relevées dans sp[]
+int followRecall(uint16_t* sp, int cap, float& minLimit) {
+  int n = 0;
+  minLimit = 255;
+  while (loopScene() && n < cap) {
+    sp[n++] = gBank.setpoint[0];
+    if (gBank.pid[0].getMaxOutput() < minLimit) minLimit = gBank.pid[0].getMaxOutput();
+    sim::advance(10000);
+  }
+  return n;
+}
+
+void testScene() {
+  setupScene();
+  sim::forcePin(SCENE_BTN_PIN, 1);                     // bouton relâché
+  gBank.drive[0] = 0;
+  gBank.position[0] = 1000;
+  CHECK(sceneStore(3));
+  CHECK(!sceneStore(SCENE_COUNT));
+  CHECK(!sceneRecall(5));                              // jamais mémorisée
+
+  // flash : pas pendant que le moteur tourne, dès le repos, une seule fois
+  CHECK(!(flashSceneMask() & (1u << 3)));
+  gBank.drive[0] = 100;
+  CHECK(!sceneFlush(HALTime::millis()));
+  CHECK(!(flashSceneMask() & (1u << 3)));
+  gBank.drive[0] = 0;
+  CHECK(sceneFlush(HALTime::millis()));
+  CHECK(flashSceneMask() & (1u << 3));
+  CHECK(!sceneFlush(HALTime::millis()));
+
+  // jamais au repos : écriture forcée après SCENE_FLUSH_MAX_MS, moteur coupé
+  gBank.position[0] = 3500;
+  CHECK(sceneStore(4));
+  gBank.drive[0] = 100;
+  CHECK(!sceneFlush(HALTime::millis() + SCENE_FLUSH_MAX_MS / 2));
+  CHECK(sceneFlush(HALTime::millis() + SCENE_FLUSH_MAX_MS));
+  CHECK(gBank.drive[0] == 0 && (flashSceneMask() & (1u << 4)));
+
+  // rappel 3000 → 1000 : départ sans saut, descente monotone, mi-course à mi-temps,
+  // limite PWM réduite au départ puis rendue, arrivée exacte en SCENE_RECALL_MS
+  gBank.position[0] = 3000;
+  CHECK(sceneRecall(3) && sceneActive());
+  CHECK(gBank.setpoint[0] == 3000);
+  uint16_t sp[100];
+  float minLimit;
+  const int n = followRecall(sp, 100, minLimit);
+  CHECK_NEAR(n, SCENE_RECALL_MS / 10, 2);
+  bool monotonic = true;
+  for (int k = 1; k < n; ++k) monotonic &= sp[k] <= sp[k - 1];
+  CHECK(monotonic);
+  CHECK_NEAR(sp[n / 2], 2000, 100);
+  CHECK(minLimit < 255.0f && minLimit >= SCENE_PWM_START);
+  CHECK(gBank.setpoint[0] == 1000 && !sceneActive());
+  CHECK(gBank.pid[0].getMaxOutput() == 255.0f);
+
+  // fader touché : sort du rappel, la consigne reste où elle était
+  CHECK(sceneRecall(4));
+  sim::advance(200000);
+  loopScene();
+  const uint16_t held = gBank.setpoint[0];
+  sceneCancel(0);
+  CHECK(!loopScene() && gBank.setpoint[0] == held && held > 1000 && held < 3500);
+
+  // SysEx : F0 7D 02 n F7 mémorise, F0 7D 01 n F7 rappelle
+  static const uint8_t STORE7[]  = { 0xF0, SCENE_SYSEX_ID, 0x02, 7, 0xF7 };
+  static const uint8_t RECALL7[] = { 0xF0, SCENE_SYSEX_ID, 0x01, 7, 0xF7 };
+  gBank.position[0] = 2500;
+  sceneHandleSysEx(STORE7, sizeof STORE7);
+  gBank.position[0] = 500;
+  sceneHandleSysEx(RECALL7, sizeof RECALL7);
+  CHECK(sceneActive());
+  followRecall(sp, 100, minLimit);
+  CHECK(gBank.setpoint[0] == 2500);
+  CHECK(sceneFlush(HALTime::millis()) && (flashSceneMask() & (1u << 7)));
+
+  // bouton : scène valide suivante (7 → 3, en rebouclant)
+  sim::forcePin(SCENE_BTN_PIN, 0);
+  sim::advance(40000);
+  CHECK(loopScene());
+  followRecall(sp, 100, minLimit);
+  CHECK(gBank.setpoint[0] == 1000);
+  sim::forcePin(SCENE_BTN_PIN, -1);
+}
+
+// ===================== Matrice de touches =====================
+// balaye toutes les 1 ms pendant ms ; événements dans ev[] (rend leur nombre)
+int scanKeys(uint32_t ms, KeyEvent* ev, int cap) {
+  int n = 0;
+  for (uint32_t k = 0; k < ms; ++k) {
+    sim::advance(1000);
+    keysScan((uint32_t)sim::now());
+    while (n < cap && keysPop(ev[n])) ++n;
+  }
+  return n;
+}
+
+void testKeys() {
+  CHECK(setupKeys());
+  KeyEvent ev[80];
+
+  // contact franc : impulsions de 1 à KEY_DEBOUNCE_COUNT - 1 balayages ignorées,
+  // KEY_DEBOUNCE_COUNT balayages → appui validé au dernier
+  sim::cfg.keyBounceUs = 0;
+  int n;
+  for (uint32_t len = 1; len < KEY_DEBOUNCE_COUNT; ++len) {
+    sim::key(9, true);
+    n = scanKeys(len, ev, 80);
+    sim::key(9, false);
+    n += scanKeys(10, ev + n, 80 - n);
+    CHECK(n == 0 && !keyIsDown(9));
+  }
+  sim::key(9, true);
+  CHECK(scanKeys(KEY_DEBOUNCE_COUNT - 1, ev, 80) == 0);
+  CHECK(scanKeys(1, ev, 80) == 1 && ev[0].key == 9 && ev[0].pressed);
+  sim::key(9, false);                                  // relâché bref puis reposé : toujours enfoncée
+  scanKeys(1, ev, 80);
+  sim::key(9, true);
+  CHECK(scanKeys(10, ev, 80) == 0 && keyIsDown(9));
+  sim::key(9, false);
+  CHECK(scanKeys(10, ev, 80) == 1 && !ev[0].pressed);
+  sim::cfg.keyBounceUs = SIM_KEY_BOUNCE_US;
+
+  // appui : le contact rebondit SIM_KEY_BOUNCE_US, un seul événement, après au plus
+  // rebond + KEY_DEBOUNCE_COUNT balayages
+  uint32_t t0 = (uint32_t)sim::now();
+  sim::key(5, true);
+  n = scanKeys(20, ev, 80);
+  CHECK(n == 1 && ev[0].key == 5 && ev[0].pressed && keyIsDown(5));
+  CHECK(n == 1 && ev[0].tUs - t0 <= SIM_KEY_BOUNCE_US + (KEY_DEBOUNCE_COUNT + 1) * 1000u);
+  t0 = (uint32_t)sim::now();
+  sim::key(5, false);
+  n = scanKeys(20, ev, 80);
+  CHECK(n == 1 && ev[0].key == 5 && !ev[0].pressed && !keyIsDown(5));
+  CHECK(n == 1 && ev[0].tUs - t0 >= KEY_DEBOUNCE_COUNT * 1000u);
+
+  // 2 rangées du même mot + dernière touche ; position câblée hors KEY_COUNT ignorée
+  sim::key(3, true); sim::key(16 + 3, true); sim::key(KEY_COUNT - 1, true); sim::key(KEY_COUNT, true);
+  n = scanKeys(20, ev, 80);
+  CHECK(n == 3 && keyIsDown(3) && keyIsDown(19) && keyIsDown(KEY_COUNT - 1));
+  sim::key(3, false); sim::key(16 + 3, false); sim::key(KEY_COUNT - 1, false); sim::key(KEY_COUNT, false);
+  n = scanKeys(20, ev, 80);
+  CHECK(n == 3 && !keyIsDown(3) && !keyIsDown(19) && !keyIsDown(KEY_COUNT - 1));
+
+  // accord plus grand que la file : le surplus est compté, pas d'écrasement
+  const uint32_t lost0 = keysDropped();
+  for (uint16_t k = 0; k < KEY_QUEUE_LEN + 6; ++k) sim::key(k, true);
+  for (int k = 0; k < 20; ++k) { sim::advance(1000); keysScan((uint32_t)sim::now()); }
+  CHECK(keysDropped() - lost0 == 6);
+  KeyEvent e;
+  n = 0;
+  while (keysPop(e)) n += e.pressed;
+  CHECK(n == KEY_QUEUE_LEN);
+  for (uint16_t k = 0; k < KEY_QUEUE_LEN + 6; ++k) sim::key(k, false);
+  scanKeys(20, ev, 80);
+
+  // notes : touche 0..127 sur KEY_MIDI_CHANNEL, au-delà sur le canal suivant (contact franc :
+  // les deux touches validées au même balayage, dans l'ordre des touches)
+  sim::cfg.keyBounceUs = 0;
+  sim::setMidiHook(midiCapture);
+  gMidiN = 0;
+  sim::key(60, true); sim::key(130, true);
+  for (int k = 0; k < 20; ++k) { sim::advance(1000); loopKeys((uint32_t)sim::now()); }
+  CHECK(gMidiN == 2);
+  CHECK(gMidi[0].st == 0x90 + KEY_MIDI_CHANNEL - 1 && gMidi[0].d1 == 60 && gMidi[0].d2 == KEY_NOTE_VELOCITY);
+  CHECK(gMidi[1].st == 0x90 + KEY_MIDI_CHANNEL && gMidi[1].d1 == 2);
+  gMidiN = 0;
+  sim::key(60, false); sim::key(130, false);
+  for (int k = 0; k < 20; ++k) { sim::advance(1000); loopKeys((uint32_t)sim::now()); }
+  CHECK(gMidiN == 2 && gMidi[0].st == 0x80 + KEY_MIDI_CHANNEL - 1 && gMidi[1].st == 0x80 + KEY_MIDI_CHANNEL);
+  sim::setMidiHook(nullptr);
+  sim::cfg.keyBounceUs = SIM_KEY_BOUNCE_US;
+}
+
+// ===================== Encodeurs =====================
+// tourne l'encodeur 0 de detents crans en ms, tâche "enc" + flush à 1 kHz jusqu'au repos ;
+// rend la somme des pas émis en CC relatifs
+int32_t turnSteps(int32_t detents, uint32_t ms) {
+  sim::turn(0, detents, ms);
+  int32_t steps = 0;
+  for (uint32_t k = 0; k < ms + ENC_SPEED_IDLE_MS + 50; ++k) {
+    sim::advance(1000);
+    loopEncoders((uint32_t)sim::now());
+    gMidiN = 0;
+    MIDIIO_flush((uint32_t)sim::now());
+    for (int m = 0; m < gMidiN; ++m)
+      if (gMidi[m].st == (0xB0 | (midi_channel - 1)) && gMidi[m].d1 == midi_enc_cc[0])
+        steps += gMidi[m].d2 - ENC_REL_CENTER;
+  }
+  return steps;
+}
+
+void testEncoders() {
+  CHECK(setupEncoders());
+  sim::setMidiHook(midiCapture);
+  sim::advance((ENC_SPEED_IDLE_MS + 1) * 1000);        // lastDetUs = 0 : pas de cran "récent" au démarrage
+  int32_t pos = encPosition(0);
+
+  // lent (2 crans/s < ENC_ACCEL_V0) : 1 pas par cran, dans les deux sens
+  CHECK(turnSteps(10, 5000) == 10 && encPosition(0) - pos == 10);
+  CHECK(turnSteps(-10, 5000) == -10 && encPosition(0) - pos == 0);
+  CHECK(encSpeed(0) == 0.0f);                          // repos > ENC_SPEED_IDLE_MS
+
+  // rapide (100 crans/s > ENC_ACCEL_V1) : 1er cran à vitesse nulle, les suivants au gain maximal
+  const int32_t fast = turnSteps(40, 400);
+  CHECK(fast == 1 + 39 * (int32_t)ENC_ACCEL_MAX && encPosition(0) - pos == 40);
+  CHECK(turnSteps(-40, 400) == -fast);
+
+  // moyen (20 crans/s tenus) : gain de la courbe quadratique entre ENC_ACCEL_V0 et V1
+  const float x = (20.0f - ENC_ACCEL_V0) / (ENC_ACCEL_V1 - ENC_ACCEL_V0);
+  CHECK_NEAR(turnSteps(200, 10000) / 200.0, 1.0 + (ENC_ACCEL_MAX - 1.0) * x * x, 0.05);
+
+  // vitesse mesurée pendant la rotation, puis remise à 0 à l'arrêt
+  sim::turn(0, 20, 1000);
+  for (int k = 0; k < 500; ++k) { sim::advance(1000); loopEncoders((uint32_t)sim::now()); }
+  CHECK_NEAR(encSpeed(0), 20.0, 1.0);
+  turnSteps(0, 500);
+  CHECK(encSpeed(0) == 0.0f);
+
+  // changement de sens : la fraction accumulée d'un côté ne part pas de l'autre
+  // (3 crans rapides puis 1 cran lent en sens inverse = exactement -1 pas)
+  turnSteps(3, 30);
+  CHECK(turnSteps(-1, 1) == -1);
+  sim::setMidiHook(nullptr);
+}
+
+// ===================== OSC =====================
+struct OscSeen { char addr[2][OSC_ADDR_LEN]; float v[2][2]; int n; };
+
+void oscCollect(void* ctx, const OscMessage& m) {
+  OscSeen& s = *static_cast<OscSeen*>(ctx);
+  if (s.n >= 2) { ++s.n; return; }
+  snprintf(s.addr[s.n], OSC_ADDR_LEN, "%s", m.addr);
+  s.v[s.n][0] = s.v[s.n][1] = -1;
+  oscArgFloat(m, 0, s.v[s.n][0]);
+  oscArgFloat(m, 1, s.v[s.n][1]);
+  ++s.n;
+}
+
+size_t put32be(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16); p[2] = (uint8_t)(v >> 8); p[3] = (uint8_t)v;
+  return 4;
+}
+
+void testOsc() {
+  // motifs : '*' et '?' ne traversent pas '/'
+  CHECK(oscMatch("/fader/*", "/fader/12"));
+  CHECK(!oscMatch("/fader/*", "/fader/1/touch"));
+  CHECK(oscMatch("/*/1/touch", "/fader/1/touch"));
+  CHECK(oscMatch("/fader/?", "/fader/3") && !oscMatch("/fader/?", "/fader/10"));
+  CHECK(oscMatch("/fader/[1-3]", "/fader/2") && !oscMatch("/fader/[1-3]", "/fader/4"));
+  CHECK(oscMatch("/fader/[!1]", "/fader/2") && !oscMatch("/fader/[!1]", "/fader/1"));
+  CHECK(oscMatch("/fader/{1,3}/touch", "/fader/3/touch") && !oscMatch("/fader/{1,3}", "/fader/2"));
+  CHECK(!oscMatch("/fader/1", "/fader/12") && !oscMatch("/fader/12", "/fader/1"));
+
+  // bundle de 2 messages (,f et ,i) relu tel quel
+  uint8_t buf[OSC_MAX_PACKET];
+  OscWriter w(buf, sizeof buf);
+  w.beginBundle();
+  CHECK(w.message("/fader/1", 0.25f));
+  CHECK(w.message("/fader/2/touch", (int32_t)1));
+  CHECK(w.ok() && w.count() == 2 && w.size() % 4 == 0);
+  OscSeen seen{};
+  CHECK(oscParse(buf, w.size(), oscCollect, &seen));
+  CHECK(seen.n == 2 && !strcmp(seen.addr[0], "/fader/1") && !strcmp(seen.addr[1], "/fader/2/touch"));
+  CHECK(seen.v[0][0] == 0.25f && seen.v[1][0] == 1.0f && seen.v[0][1] == -1);
+
+  // tronqué / taille d'élément fausse → refusé
+  seen = {};
+  CHECK(!oscParse(buf, w.size() - 4, oscCollect, &seen));
+  buf[19] += 4;                                        // taille du 1er élément
+  CHECK(!oscParse(buf, w.size(), oscCollect, &seen));
+
+  // hors bundle : un seul message ; tampon trop petit → size() = 0
+  w.reset();
+  CHECK(w.message("/a", 1.0f) && !w.message("/b", 2.0f) && w.size() == 0);
+  uint8_t tiny[12];
+  OscWriter t(tiny, sizeof tiny);
+  CHECK(!t.message("/fader/1", 0.5f) && t.size() == 0);
+
+  // bundle imbriqué contenant ,sfT : l'argument chaîne est sauté
+  uint8_t inner[32], *q = inner;
+  memcpy(q, "/x\0\0,sfT\0\0\0\0ab\0\0", 16); q += 16;
+  float half = 0.5f;
+  uint32_t bits;
+  memcpy(&bits, &half, 4);
+  q += put32be(q, bits);
+  const size_t innerLen = (size_t)(q - inner);
+  uint8_t outer[64], *o = outer;
+  memcpy(o, "#bundle\0", 8); o += 8;
+  o += put32be(o, 0); o += put32be(o, 1);
+  o += put32be(o, 16 + 4 + innerLen);
+  memcpy(o, "#bundle\0", 8); o += 8;
+  o += put32be(o, 0); o += put32be(o, 1);
+  o += put32be(o, (uint32_t)innerLen);
+  memcpy(o, inner, innerLen); o += innerLen;
+  seen = {};
+  CHECK(oscParse(outer, (size_t)(o - outer), oscCollect, &seen));
+  float v = 0;
+  CHECK(seen.n == 1 && !strcmp(seen.addr[0], "/x") && seen.v[0][1] == 0.5f);
+  OscMessage m{ (const char*)inner, "sfT", inner + 8, inner + innerLen };
+  CHECK(!oscArgFloat(m, 0, v) && oscArgFloat(m, 2, v) && v == 1.0f);
+
+  // table d'adresses : exact par hachage, motifs (cache vidé quand la table change)
+  OscAddressTable tab;
+  char name[OSC_ADDR_LEN];
+  for (int k = 1; k <= 4; ++k) {
+    snprintf(name, sizeof name, "/fader/%d", k);
+    CHECK(tab.add(name) == k - 1);
+  }
+  CHECK(tab.add("/fader/1/touch") == 4);
+  CHECK(tab.resolve("/fader/3") == 1u << 2);
+  CHECK(tab.resolve("/fader/5") == 0);
+  CHECK(tab.resolve("/fader/*") == 0x0Fu);
+  CHECK(tab.resolve("/fader/*") == 0x0Fu);             // depuis le cache
+  CHECK(tab.resolve("/fader/{1,4}") == 0x09u);
+  CHECK(tab.resolve("/*/1/touch") == 1u << 4);
+  CHECK(tab.add("/fader/5") == 5);
+  CHECK(tab.resolve("/fader/*") == 0x2Fu);
+  CHECK(tab.add("/une/adresse/bien/trop/longue") == -1);
+}
+
+// ===================== DMX =====================
+struct DmxCapture {
+  uint8_t  pkt[2][DMX_MAX_PACKET];
+  size_t   len[2];
+  int      sent;
+};
+
+void dmxCapture(void* ctx, uint8_t u, uint16_t, const uint8_t* pkt, size_t len) {
+  DmxCapture& c = *static_cast<DmxCapture*>(ctx);
+  memcpy(c.pkt[u], pkt, len);
+  c.len[u] = len;
+  ++c.sent;
+}
+
+void testDmx() {
+  static const uint8_t cid[16] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+  static DmxOutput   out;
+  static DmxCapture  cap;
+  for (DmxProtocol proto : { DMX_ARTNET, DMX_SACN }) {
+    cap = {};
+    out.begin(proto, 7, 2, 1000000, cid, "fader_tests", 100, dmxCapture, &cap);
+    CHECK(out.set16(dmxAddr(0, 1), 0xABCD));
+    CHECK(out.set8(dmxAddr(1, 512), 42));
+    CHECK(!out.set8(dmxAddr(1, 512), 42));            // inchangé : univers pas marqué
+    CHECK(out.get(dmxAddr(0, 2)) == 0xCD);
+    CHECK(out.poll(0) == 2);
+
+    DmxFrame fr;
+    CHECK(dmxParse(cap.pkt[0], cap.len[0], fr));
+    CHECK(fr.proto == proto && fr.universe == 7 && !fr.terminated);
+    CHECK(fr.count == DMX_SLOTS && fr.data[0] == 0xAB && fr.data[1] == 0xCD && fr.data[2] == 0);
+    const uint8_t seq0 = fr.seq;
+    CHECK(dmxParse(cap.pkt[1], cap.len[1], fr));
+    CHECK(fr.universe == 8 && fr.data[511] == 42);
+    CHECK(!dmxParse(cap.pkt[0], 10, fr));             // tronqué
+
+    // inchangé → rien avant le keep-alive, puis renvoyé tel quel
+    CHECK(out.poll(500000) == 0);
+    out.set8(dmxAddr(0, 3), 7);
+    CHECK(out.poll(600000) == 1);
+    CHECK(dmxParse(cap.pkt[0], cap.len[0], fr) && fr.data[2] == 7 && fr.seq != seq0);
+    CHECK(out.poll(1000000) == 1);                    // univers 8 : keep-alive
+    CHECK(out.txKeepalive == 1);
+
+    if (proto == DMX_SACN) {                          // Stream_Terminated ×3 par univers
+      cap.sent = 0;
+      out.stop();
+      CHECK(cap.sent == 6);
+      CHECK(dmxParse(cap.pkt[0], cap.len[0], fr) && fr.terminated);
+    }
+  }
+}
+
+// ===================== Télémétrie =====================
+// en-tête 'T' de telemetry_codec.h
+uint8_t* telemHeader(uint8_t* f, uint8_t version, uint16_t mask, uint8_t n, uint8_t fields) {
+  f[0] = 'T'; f[1] = version;
+  put16(f + 2, 0x1234);
+  put16(f + 4, mask);
+  f[6] = n; f[7] = fields;
+  put16(f + 8, 0x5678); put16(f + 10, 0x0001);       // t0 = 0x00015678
+  put16(f + 12, 1000);
+  put16(f + 14, 3);
+  return f + TELEM_HDR_LEN;
+}
+
+size_t telemCrc(uint8_t* f, uint8_t* end) {
+  const size_t len = (size_t)(end - f);
+  put16(end, crc16_ccitt(f, len));
+  return len + 2;
+}
+
+void testTelemetry() {
+  for (int32_t v : { 0, 1, -1, 300, -300, 32767, -32768, 0x3FFFFFFF, -0x40000000 })
+    CHECK(telemUnzigzag(telemZigzag(v)) == v);
+  CHECK(telemZigzag(-1) == 1 && telemZigzag(1) == 2 && telemZigzag(-300) == 599);
+  uint8_t vb[5];
+  CHECK(telemPutVarint(vb, 599) - vb == 2 && vb[0] == 0xD7 && vb[1] == 0x04);
+
+  // v1 + CRC : 2 échantillons × 2 faders (masque 0b101) × 3 champs
+  static const int16_t v1[12] = { 100, 98, -40, 4000, 4095, 255, 101, 99, -41, 4000, 4094, -255 };
+  uint8_t f[256];
+  uint8_t* q = telemHeader(f, TELEM_V_RAW | TELEM_F_CRC, 0x0005, 2, 3);
+  for (int16_t v : v1) { put16(q, (uint16_t)v); q += 2; }
+  size_t len = telemCrc(f, q);
+  TelemHeader h;
+  int16_t out[32];
+  bool crcErr = true;
+  CHECK(telemDecode(f, len, h, out, 32, &crcErr) == 2);
+  CHECK(!crcErr && h.crc && h.version == TELEM_V_RAW);
+  CHECK(h.seq == 0x1234 && h.faders == 2 && h.fields == 3 && h.t0_us == 0x15678 &&
+        h.period_us == 1000 && h.dropped == 3);
+  CHECK(!memcmp(out, v1, sizeof v1));
+  CHECK(telemDecode(f, len, h, out, 11) == 0);         // out trop petit
+
+  f[20] ^= 0x40;                                       // 1 bit faux → CRC
+  CHECK(telemDecode(f, len, h, out, 32, &crcErr) == 0);
+  CHECK(crcErr);
+
+  // v2 : image clé puis bitmap + deltas zig-zag, 1 fader × 3 champs
+  q = telemHeader(f, TELEM_V_DELTA | TELEM_F_CRC, 0x0001, 3, 3);
+  put16(q, 100); put16(q + 2, 200); put16(q + 4, (uint16_t)-5); q += 6;
+  *q++ = 0x05;                                         // champs 0 et 2 changés
+  q = telemPutVarint(q, telemZigzag(1));
+  q = telemPutVarint(q, telemZigzag(-300));
+  *q++ = 0x00;                                         // au repos
+  len = telemCrc(f, q);
+  static const int16_t v2[9] = { 100, 200, -5, 101, 200, -305, 101, 200, -305 };
+  CHECK(telemDecode(f, len, h, out, 32, &crcErr) == 3);
+  CHECK(!crcErr && h.version == TELEM_V_DELTA && h.faders == 1);
+  CHECK(!memcmp(out, v2, sizeof v2));
+
+  f[TELEM_HDR_LEN + 7] ^= 0x01;                        // delta faux → CRC
+  CHECK(telemDecode(f, len, h, out, 32, &crcErr) == 0);
+  CHECK(crcErr);
+
+  // sans CRC : une trame tronquée est refusée
+  f[1] = TELEM_V_DELTA;
+  f[TELEM_HDR_LEN + 7] ^= 0x01;
+  CHECK(telemDecode(f, len - 2, h, out, 32, &crcErr) == 3 && !crcErr);
+  CHECK(telemDecode(f, len - 3, h, out, 32, &crcErr) == 0 && !crcErr);
+}
+
+// ===================== RTP-MIDI =====================
+// Pair de test : datagrammes émis gardés jusqu'à livraison, CC reçus relevés
+struct RtpPeer {
+  RtpMidiSession s;
+  struct Dgram { bool data; size_t len; uint8_t buf[RTPMIDI_MAX_PACKET]; } out[8];
+  int nOut = 0;
+  uint8_t cc[16][3];
+  int nCC = 0;
+};
+
+void rtpSend(void* ctx, bool dataPort, const uint8_t* buf, size_t len) {
+  RtpPeer& p = *static_cast<RtpPeer*>(ctx);
+  if (p.nOut >= 8) return;
+  RtpPeer::Dgram& d = p.out[p.nOut++];
+  d.data = dataPort; d.len = len;
+  memcpy(d.buf, buf, len);
+}
+
+void rtpOnCC(void* ctx, uint8_t ch, uint8_t cc, uint8_t value) {
+  RtpPeer& p = *static_cast<RtpPeer*>(ctx);
+  if (p.nCC < 16) { p.cc[p.nCC][0] = ch; p.cc[p.nCC][1] = cc; p.cc[p.nCC][2] = value; ++p.nCC; }
+}
+
+// livre tout ce que from a émis (nombre de datagrammes)
+int rtpDeliver(RtpPeer& from, RtpPeer& to, uint32_t now) {
+  const int n = from.nOut;
+  from.nOut = 0;
+  for (int k = 0; k < n; ++k) to.s.onPacket(from.out[k].data, from.out[k].buf, from.out[k].len, now);
+  return n;
+}
+
+bool rtpHasCC(const RtpPeer& p, int k, uint8_t cc, uint8_t value) {
+  return k < p.nCC && p.cc[k][0] == 0 && p.cc[k][1] == cc && p.cc[k][2] == value;
+}
+
+void testRtpMidi() {
+  static RtpPeer a, b;                                 // a : responder (firmware), b : initiateur
+  a.s.begin("fader", 0x1111, 0, rtpSend, rtpOnCC, &a);
+  b.s.begin("peer", 0x2222, 0, rtpSend, rtpOnCC, &b);
+
+  // IN/OK contrôle, IN/OK données, CK0/CK1/CK2
+  uint32_t now = 1000;
+  b.s.invite(now);
+  for (int k = 0; k < 8 && (rtpDeliver(b, a, now) | rtpDeliver(a, b, now)); ++k) {}
+  CHECK(a.s.connected() && b.s.connected());
+
+  // paquet 1 : CC 7 absolu + CC 20 relatif (encodeur), reçus tels quels
+  a.s.beginPacket();
+  a.s.addCC(0, 7, 100);
+  a.s.addCC(0, 20, 65, false);
+  a.s.endPacket(now += 1000);
+  CHECK(rtpDeliver(a, b, now) == 1);
+  CHECK(b.nCC == 2 && rtpHasCC(b, 0, 7, 100) && rtpHasCC(b, 1, 20, 65));
+
+  // paquet 2 perdu ; paquet 3 : son journal rend CC 7 = 110, le pas relatif n'est pas rejoué
+  a.s.beginPacket();
+  a.s.addCC(0, 7, 110);
+  a.s.addCC(0, 20, 63, false);
+  a.s.endPacket(now += 1000);
+  a.nOut = 0;
+  a.s.beginPacket();
+  a.s.addCC(0, 9, 1);
+  a.s.endPacket(now += 1000);
+  CHECK(rtpDeliver(a, b, now) == 1);
+  CHECK(b.s.rxLost == 1 && b.s.rxRecovered == 1);
+  CHECK(b.nCC == 4 && rtpHasCC(b, 2, 7, 110) && rtpHasCC(b, 3, 9, 1));
+
+  // RS du pair (checkpoint = paquet 3) → paquet suivant sans journal (bit J)
+  b.s.poll(now += RTPMIDI_RS_PERIOD_US + 1);
+  CHECK(rtpDeliver(b, a, now) == 1);
+  a.s.beginPacket();
+  a.s.addCC(0, 7, 120);
+  a.s.endPacket(now += 1000);
+  CHECK(a.nOut == 1 && !(a.out[0].buf[12] & 0x40));
+  rtpDeliver(a, b, now);
+  CHECK(b.nCC == 5 && rtpHasCC(b, 4, 7, 120));
+
+  // BY : fin de session, plus rien n'est émis
+  static const uint8_t BY[16] = { 0xFF, 0xFF, 'B', 'Y' };
+  a.s.onPacket(false, BY, sizeof BY, now);
+  CHECK(!a.s.connected());
+  a.s.beginPacket();
+  a.s.addCC(0, 7, 0);
+  a.s.endPacket(now);
+  CHECK(a.nOut == 0);
+}
+
+// ===================== Réponse indicielle =====================
+// 2e ordre sous-amorti, saut unité : y(t) = 1 − e^(−ζωn·t) / √(1−ζ²) · sin(ωd·t + acos ζ)
+struct SecondOrder {
+  double zeta, wn;
+  double wd() const { return wn * std::sqrt(1 - zeta * zeta); }
+  double y(double t) const {
+    return 1 - std::exp(-zeta * wn * t) / std::sqrt(1 - zeta * zeta) * std::sin(wd() * t + std::acos(zeta));
+  }
+  double overshoot() const { return std::exp(-M_PI * zeta / std::sqrt(1 - zeta * zeta)); }
+  // 1er passage à la fraction f (y croissant jusqu'au pic π/ωd) : dichotomie
+  double cross(double f) const {
+    double lo = 0, hi = M_PI / wd();
+    for (int k = 0; k < 60; ++k) ((y((lo + hi) / 2) < f) ? lo : hi) = (lo + hi) / 2;
+    return hi;
+  }
+  // dernière sortie de la bande ±tol (fraction du saut), pas de 1 µs jusqu'à tMax
+  double settle(double tol, double tMax) const {
+    double last = 0;
+    for (double t = 0; t < tMax; t += 1e-6) if (std::fabs(1 - y(t)) > tol) last = t;
+    return last;
+  }
+};
+
+// 1 mouvement from → to suivi à 1 kHz, mesure = from + saut·y(t) arrondie au compte
+bool runStep(const SecondOrder& s, uint16_t from, uint16_t to, uint16_t band, StepRecord& r) {
+  constexpr uint32_t TICK_US = 1000;
+  StepAnalyzer a;
+  uint32_t now = 0;
+  a.cancel(now, from, r);                               // au repos sur from (stepSetEnabled)
+  now += TICK_US;
+  if (a.sample(now, to, from, 0, band, r)) return false;   // saut : t0
+  const uint32_t t0 = now;
+  const double amp = (double)to - from;
+  while (now - t0 < STEP_TIMEOUT_US + 2 * TICK_US) {
+    now += TICK_US;
+    const double pos = from + amp * s.y((now - t0) * 1e-6);
+    const int32_t err = (int32_t)to - (int32_t)std::lround(pos);
+    const int16_t drive = (int16_t)(err > 255 ? 255 : (err < -255 ? -255 : err));
+    if (a.sample(now, to, (uint16_t)std::lround(pos), drive, band, r)) return true;
+  }
+  return false;
+}
+
+void testStep() {
+  struct Case { double zeta, fn; uint16_t from, to, band; };
+  static const Case CASES[] = {
+    { 0.5, 5.0, 1000, 3000, 8 },     // montée, 16 % de dépassement
+    { 0.7, 8.0, 3500, 500,  8 },     // descente, ~5 %
+    { 0.3, 12.0, 200, 1200, 16 },    // peu amorti : plusieurs alternances hors bande, chacune
+  };                                 // < STEP_HOLD_US (limite de step_metrics.h)
+  for (const Case& c : CASES) {
+    const SecondOrder s{ c.zeta, 2 * M_PI * c.fn };
+    const double amp = std::fabs((double)c.to - c.from);
+    StepRecord r{};
+    CHECK(runStep(s, c.from, c.to, c.band, r));
+    CHECK(r.flags == STEP_F_SETTLED);
+    CHECK(r.from == c.from && r.to == c.to && r.band == c.band);
+
+    // échantillonnage 1 ms : chaque instant relevé au tick qui suit → ±1 tick sur un écart ;
+    // mesure arrondie au compte → bande effective ±(band + 0,5)
+    const double riseUs   = (s.cross(0.9) - s.cross(0.1)) * 1e6;
+    const double settleUs = s.settle((c.band + 0.5) / amp, 1.9) * 1e6;
+    CHECK_NEAR(r.riseUs, riseUs, 1000);
+    CHECK_NEAR(r.overshoot, amp * s.overshoot(), 1.5);   // pic lissé : ±arrondi au compte
+    CHECK_NEAR(r.settleUs, settleUs, 1000);
+    CHECK(r.settleUs >= settleUs - 1);                   // jamais avant l'entrée réelle dans la bande
+    CHECK_NEAR(r.durationUs, r.settleUs + STEP_HOLD_US, 1000);
+    CHECK(std::fabs(r.ssError) <= c.band);
+    CHECK(r.reversals >= 1);
+  }
+
+  // consigne qui ne bouge pas assez : pas de mouvement ; nouveau saut : interrompu
+  StepAnalyzer a;
+  StepRecord r{};
+  CHECK(!a.cancel(0, 1000, r));
+  CHECK(!a.sample(1000, 1000 + STEP_MIN_MOVE - 1, 1000, 0, 8, r) && !a.active());
+  CHECK(!a.sample(2000, 2000, 1000, 0, 8, r) && a.active());
+  CHECK(a.sample(3000, 3000, 1100, 0, 8, r) && r.flags == STEP_F_INTERRUPTED && a.active());
+  CHECK(a.cancel(4000, 3000, r) && r.flags == STEP_F_CANCELLED && !a.active());
+}
+
+// ===================== Groupes =====================
+struct Group { const char* name; void (*fn)(); };
+const Group GROUPS[] = {
+  { "pid", testPid }, { "ump", testUmp }, { "host", testHost }, { "midiout", testMidiOut },
+  { "scene", testScene }, { "keys", testKeys }, { "encoders", testEncoders }, { "osc", testOsc },
+  { "dmx", testDmx }, { "telemetry", testTelemetry }, { "rtpmidi", testRtpMidi },
+  { "step", testStep },
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  sim::cfg.speed = 0;                                  // horloge virtuelle au plus vite
+  int run = 0;
+  for (const Group& g : GROUPS) {
+    bool wanted = argc < 2;
+    for (int a = 1; a < argc; ++a) wanted |= !strcmp(argv[a], g.name);
+    if (!wanted) continue;
+    const int before = gFails;
+    g.fn();
+    ++run;
+    printf("%-10s %s\n", g.name, gFails == before ? "ok" : "ÉCHEC");
+  }
+  if (!run) {
+    fprintf(stderr, "[ERREUR] groupe inconnu (pid ump host midiout scene keys encoders osc dmx telemetry rtpmidi step)\n");
+    return 2;
+  }
+  printf("[INFO] %d vérification(s), %d échec(s)\n", gChecks, gFails);
+  return gFails ? 1 : 0;
+}
@@ -0,0 +1,42 @@
+# ========================== heap_check.cmake ==========================
+# Contrôle « zéro tas » du firmware (heap_guard.h) : échoue si un objet des modules
+# portables référence l'allocateur. Lancé après chaque build de fader_core / fader_sim.
+#
+# Usage : cmake -DNM=<nm> -DOBJS="a.o|b.o|..." [-DFILTER=<regex>] -P host/heap_check.cmake
+#   FILTER : ne garde que les objets dont le chemin correspond (ex. le sketch dans fader_sim)
+#
+# operator delete n'est pas visé : tout destructeur virtuel le référence sans rien allouer.
+
+set(FORBIDDEN
+  "^malloc$" "^calloc$" "^realloc$" "^strdup$" "^posix_memalign$"
+  "^_Znwm$" "^_Znam$" "^_ZnwmRKSt9nothrow_t$" "^_ZnamRKSt9nothrow_t$"   # operator new / new[]
+  "^_Znwj$" "^_Znaj$" "^_ZnwjRKSt9nothrow_t$" "^_ZnajRKSt9nothrow_t$"   # idem, size_t 32 bits
+  "^_ZN6String"                                                         # String Arduino
+)
+
+string(REPLACE "|" ";" OBJ_LIST "${OBJS}")
+set(FAILED "")
+foreach(obj IN LISTS OBJ_LIST)
+  if(DEFINED FILTER AND NOT obj MATCHES "${FILTER}")
+    continue()
+  endif()
+  execute_process(COMMAND ${NM} -u ${obj} OUTPUT_VARIABLE out RESULT_VARIABLE rc)
+  if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "heap_check : nm a échoué sur ${obj}")
+  endif()
+  string(REPLACE "\n" ";" syms "${out}")
+  foreach(line IN LISTS syms)
+    string(REGEX REPLACE "^[ \t]*U[ \t]+" "" sym "${line}")
+    foreach(re IN LISTS FORBIDDEN)
+      if(sym MATCHES "${re}")
+        get_filename_component(name ${obj} NAME)
+        list(APPEND FAILED "${name} : ${sym}")
+      endif()
+    endforeach()
+  endforeach()
+endforeach()
+
+if(FAILED)
+  string(REPLACE ";" "\n  " msg "${FAILED}")
+  message(FATAL_ERROR "heap_check : allocation dynamique dans le firmware\n  ${msg}")
+endif()
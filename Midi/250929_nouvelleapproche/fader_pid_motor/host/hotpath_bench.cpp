@@ -0,0 +1,64 @@
+// ========================== hotpath_bench.cpp ==========================
+// Outil Linux : même suite de micro-benchmarks que la carte (hotpath_bench.h),
+// compilée avec les modules du firmware sur le backend hôte de la HAL.
+//
+// Ticks = ns CLOCK_MONOTONIC. Les cas liés au matériel (adc_read, touch, draw_oled,
+// slip_floats) passent par le simulateur (modèle de fader, transfert I2C, FIFO USB) :
+// utiles pour suivre les régressions d'un commit à l'autre, pas comme valeurs absolues.
+// Sortie TSV (une ligne par cas) relue par python/bench_hotpath.py --host.
+//
+// Build : cmake --build build --target hotpath_bench
+// Usage : ./hotpath_bench [-n 1000]
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <unistd.h>
+
+#include "sim_hal.h"
+#include "fader_bank.h"
+#include "display.h"
+#include "pid.h"
+#include "hotpath_bench.h"
+
+namespace {
+
+struct Options {
+  int iters = 1000;
+};
+
+void usage() {
+  fprintf(stderr, "Usage : hotpath_bench [-n itérations]\n");
+}
+
+void printResult(uint8_t, uint8_t, const HotpathResult& r) {
+  printf("%s\t%u\t%u\t%u\t%u\t%u\t%u\n", r.name, (unsigned)r.iters, (unsigned)r.minTicks,
+         (unsigned)r.avgTicks, (unsigned)r.maxTicks, (unsigned)r.stackBytes, (unsigned)r.ticksPerSec);
+  fflush(stdout);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  int c;
+  while ((c = getopt(argc, argv, "n:h")) != -1) {
+    switch (c) {
+      case 'n': opt.iters = atoi(optarg); break;
+      default:  usage(); return c == 'h' ? 0 : 2;
+    }
+  }
+  if (opt.iters < 1 || opt.iters > 65535) { usage(); return 2; }
+
+  sim::cfg.speed = 0;                 // horloge virtuelle sans attente ; pas de pty (CDC → puits)
+  HALAdc::resolution(MY_ADC_BITS);
+  setupOLED();
+  gBank.beginAdc();
+  gBank.beginMotors();
+  gBank.beginTouch();
+  initial_PIDv(false);
+
+  printf("# cas\titérations\tmin\tmoy\tmax\tpile_o\tticks_s\n");
+  hotpathRun((uint16_t)opt.iters, printResult);
+  return 0;
+}
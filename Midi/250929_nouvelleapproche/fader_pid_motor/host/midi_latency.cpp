@@ -0,0 +1,259 @@
+// ========================== midi_latency.cpp ==========================
+// Outil Linux : latence et gigue MIDI de bout en bout (firmware en mode
+// NORMAL avec on_bench_latency = true, voir latency_bench.h).
+//
+// Parle directement au périphérique rawmidi ALSA (/dev/snd/midiC<c>D<d>),
+// sans alsa-lib : horodatage CLOCK_MONOTONIC au plus près des read/write.
+//
+//   ping : SysEx ping → pong           → aller-retour du transport USB seul
+//   cc   : CC consigne → rapport PWM    → aller-retour + RX→consigne→PWM côté Pico
+//   adc  : position injectée → CC reçu  → aller-retour + ADC→CC côté Pico
+// Les modes cc/adc lancent d'abord un ping pour estimer le trajet simple
+// (aller-retour − ping/2).
+//
+// Build : g++ -O2 -std=c++17 -o midi_latency midi_latency.cpp
+// Usage : ./midi_latency /dev/snd/midiC1D0 [-m ping|cc|adc] [-n 500] [-f 0]
+//                        [-c 16] [-w 400] [-o run.tsv]
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint8_t SYSEX_ID = 0x7D;
+
+uint64_t nowNs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// ---------------- Flux MIDI entrant → messages ----------------
+struct MidiMsg {
+  uint64_t t_ns = 0;
+  std::vector<uint8_t> bytes;   // message complet (SysEx avec F0..F7)
+};
+
+class MidiPort {
+ public:
+  explicit MidiPort(const char* path) {
+    fd_ = open(path, O_RDWR | O_NONBLOCK);
+    if (fd_ < 0) { perror(path); exit(1); }
+  }
+  ~MidiPort() { if (fd_ >= 0) close(fd_); }
+
+  uint64_t send(const std::vector<uint8_t>& b) {
+    const uint64_t t = nowNs();
+    if (write(fd_, b.data(), b.size()) != (ssize_t)b.size()) perror("write");
+    return t;
+  }
+
+  // Attend un message complet (timeout en ms). false si timeout.
+  bool next(MidiMsg& out, int timeout_ms) {
+    const uint64_t deadline = nowNs() + (uint64_t)timeout_ms * 1000000ull;
+    for (;;) {
+      if (popMessage(out)) return true;
+      const int64_t left_ms = ((int64_t)deadline - (int64_t)nowNs()) / 1000000;
+      if (left_ms < 0) return false;
+      pollfd pfd{ fd_, POLLIN, 0 };
+      if (poll(&pfd, 1, (int)left_ms + 1) <= 0) continue;
+      uint8_t buf[256];
+      const ssize_t n = read(fd_, buf, sizeof buf);
+      const uint64_t t = nowNs();
+      for (ssize_t k = 0; k < n; ++k) feed(buf[k], t);
+    }
+  }
+
+ private:
+  void feed(uint8_t b, uint64_t t) {
+    if (b >= 0xF8) return;                       // temps réel : ignoré
+    if (b == 0xF0) { cur_.assign(1, b); curT_ = t; sysex_ = true; return; }
+    if (sysex_) {
+      cur_.push_back(b);
+      if (b == 0xF7) { pending_.push_back({ curT_, cur_ }); sysex_ = false; cur_.clear(); }
+      return;
+    }
+    if (b & 0x80) { status_ = b; cur_.assign(1, b); curT_ = t; return; }
+    if (!status_) return;
+    if (cur_.empty()) { cur_.push_back(status_); curT_ = t; }   // running status
+    cur_.push_back(b);
+    const uint8_t hi = status_ & 0xF0;
+    const size_t need = (hi == 0xC0 || hi == 0xD0) ? 2 : 3;
+    if (cur_.size() == need) { pending_.push_back({ curT_, cur_ }); cur_.clear(); }
+  }
+
+  bool popMessage(MidiMsg& out) {
+    if (pending_.empty()) return false;
+    out = pending_.front();
+    pending_.erase(pending_.begin());
+    return true;
+  }
+
+  int fd_ = -1;
+  std::vector<uint8_t> cur_;
+  uint64_t curT_ = 0;
+  uint8_t status_ = 0;
+  bool sysex_ = false;
+  std::vector<MidiMsg> pending_;
+};
+
+uint32_t get21(const uint8_t* p) { return p[0] | (p[1] << 7) | (p[2] << 14); }
+
+// ---------------- Statistiques ----------------
+struct Series {
+  explicit Series(std::string n) : name(std::move(n)) {}
+  std::string name;
+  std::vector<double> us;
+
+  void report() const {
+    if (us.empty()) { printf("%-16s (aucune mesure)\n", name.c_str()); return; }
+    std::vector<double> v = us;
+    std::sort(v.begin(), v.end());
+    auto pct = [&](double p) { return v[std::min(v.size() - 1, (size_t)(p / 100.0 * (v.size() - 1) + 0.5))]; };
+    double sum = 0, sq = 0;
+    for (double x : v) { sum += x; sq += x * x; }
+    const double mean = sum / v.size();
+    const double sd   = std::sqrt(std::max(0.0, sq / v.size() - mean * mean));
+    printf("%-16s n=%-5zu min=%8.1f p50=%8.1f p90=%8.1f p99=%8.1f p99.9=%8.1f max=%8.1f mean=%8.1f sd=%7.1f us\n",
+           name.c_str(), v.size(), v.front(), pct(50), pct(90), pct(99), pct(99.9), v.back(), mean, sd);
+  }
+
+  double median() const {
+    if (us.empty()) return 0;
+    std::vector<double> v = us;
+    std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+    return v[v.size() / 2];
+  }
+};
+
+struct Options {
+  const char* dev = nullptr;
+  std::string mode = "cc";
+  int n = 500;
+  int fader = 0;
+  int cc = -1;
+  int channel = 1;
+  int wait_ms = 400;
+  const char* out = nullptr;
+};
+
+void usage() {
+  fprintf(stderr, "usage: midi_latency /dev/snd/midiC1D0 [-m ping|cc|adc] [-n N] [-f fader] "
+                  "[-c cc] [-ch canal] [-w attente_ms] [-o fichier.tsv]\n");
+  exit(2);
+}
+
+Series runPing(MidiPort& port, int n) {
+  Series rtt{ "ping rtt" };
+  for (int k = 0; k < n; ++k) {
+    const uint8_t seq = (uint8_t)(k & 0x7F);
+    const uint64_t t0 = port.send({ 0xF0, SYSEX_ID, 0x12, seq, 0xF7 });
+    MidiMsg m;
+    while (port.next(m, 200)) {
+      if (m.bytes.size() == 5 && m.bytes[1] == SYSEX_ID && m.bytes[2] == 0x13 && m.bytes[3] == seq) {
+        rtt.us.push_back((m.t_ns - t0) / 1000.0);
+        break;
+      }
+    }
+    usleep(2000);
+  }
+  return rtt;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options o;
+  for (int k = 1; k < argc; ++k) {
+    const std::string a = argv[k];
+    auto val = [&]() { if (k + 1 >= argc) usage(); return argv[++k]; };
+    if      (a == "-m")  o.mode = val();
+    else if (a == "-n")  o.n = atoi(val());
+    else if (a == "-f")  o.fader = atoi(val());
+    else if (a == "-c")  o.cc = atoi(val());
+    else if (a == "-ch") o.channel = atoi(val());
+    else if (a == "-w")  o.wait_ms = atoi(val());
+    else if (a == "-o")  o.out = val();
+    else if (a[0] != '-' && !o.dev) o.dev = argv[k];
+    else usage();
+  }
+  if (!o.dev) usage();
+  if (o.cc < 0) o.cc = 16 + o.fader;  // FADER_CC[] de midi_io.h
+
+  MidiPort port(o.dev);
+  const uint8_t ccStatus = (uint8_t)(0xB0 | ((o.channel - 1) & 0x0F));
+
+  Series ping = runPing(port, o.mode == "ping" ? o.n : std::min(o.n, 200));
+  ping.report();
+  if (o.mode == "ping") return 0;
+
+  Series rtt{ o.mode + " rtt" }, oneway{ o.mode + " one-way*" };
+  Series devA{ o.mode == "cc" ? "pico rx->sp" : "pico adc->tx" }, devB{ "pico sp->pwm" };
+  const double halfPing = ping.median() / 2.0;
+  int lost = 0;
+
+  for (int k = 0; k < o.n; ++k) {
+    const bool hi = (k & 1) != 0;
+    uint64_t t0;
+    if (o.mode == "cc") {
+      t0 = port.send({ ccStatus, (uint8_t)o.cc, (uint8_t)(hi ? 100 : 25) });
+    } else {
+      const uint16_t v14 = hi ? 12000 : 4000;
+      t0 = port.send({ 0xF0, SYSEX_ID, 0x14, (uint8_t)o.fader,
+                       (uint8_t)(v14 & 0x7F), (uint8_t)(v14 >> 7), 0xF7 });
+    }
+
+    // cc : on attend le rapport 10 ; adc : le CC puis le rapport 11
+    bool gotHost = false, gotDev = false;
+    MidiMsg m;
+    while ((!gotHost || !gotDev) && port.next(m, 500)) {
+      const auto& b = m.bytes;
+      const bool isReport = b.size() >= 8 && b[0] == 0xF0 && b[1] == SYSEX_ID && b[3] == o.fader;
+      if (o.mode == "cc" && isReport && b[2] == 0x10 && b.size() == 11) {
+        rtt.us.push_back((m.t_ns - t0) / 1000.0);
+        oneway.us.push_back((m.t_ns - t0) / 1000.0 - halfPing);
+        devA.us.push_back(get21(&b[4]));
+        if (get21(&b[7]) != 0x1FFFFF) devB.us.push_back(get21(&b[7]));
+        gotHost = gotDev = true;
+      } else if (o.mode == "adc" && b.size() == 3 && b[0] == ccStatus && b[1] == o.cc && !gotHost) {
+        rtt.us.push_back((m.t_ns - t0) / 1000.0);
+        oneway.us.push_back((m.t_ns - t0) / 1000.0 - halfPing);
+        gotHost = true;
+      } else if (o.mode == "adc" && isReport && b[2] == 0x11) {
+        devA.us.push_back(get21(&b[4]));
+        gotDev = true;
+      }
+    }
+    if (!gotHost) ++lost;
+    usleep((useconds_t)o.wait_ms * 1000);
+  }
+
+  rtt.report();
+  oneway.report();
+  devA.report();
+  if (o.mode == "cc") devB.report();
+  printf("perdus: %d / %d   (* one-way = rtt - ping_p50/2 = rtt - %.1f us)\n", lost, o.n, halfPing);
+
+  if (o.out) {
+    FILE* f = fopen(o.out, "w");
+    if (!f) { perror(o.out); return 1; }
+    fprintf(f, "rtt_us\toneway_us\tdevice_us\n");
+    for (size_t k = 0; k < rtt.us.size(); ++k) {
+      fprintf(f, "%.1f\t%.1f\t%.1f\n", rtt.us[k], oneway.us[k], k < devA.us.size() ? devA.us[k] : NAN);
+    }
+    fclose(f);
+  }
+  return 0;
+}
@@ -0,0 +1,385 @@
+// ========================== modlink_loopback.cpp ==========================
+// Outil Linux : bus inter-modules (modlink.h) simulé en mémoire, avec le même code
+// que les Pico (modlink.cpp), en temps virtuel (pas de 1 µs).
+//
+//   hub      : interroge les modules, reçoit faders / encodeurs / notes, envoie des
+//              consignes au module faders toutes les 40 ms
+//   module 1 : 4 faders — gestes tactiles aléatoires (position qui bouge tant que le
+//              doigt est posé), consignes reçues
+//   module 2 : clavier + encodeurs — accords de 1 à 10 notes (appui puis relâché),
+//              rotations de 1 à 20 pas
+//   bus      : -b bauds (10 bits / octet) dans chaque sens, TX des modules en ET câblé
+//              (émission pendant celle d'un autre = collision, octets faussés),
+//              -e ‰ d'octets corrompus (1 bit inversé) ; tâches "link" à MODLINK_TASK_US,
+//              déphasées, qui vident un tampon de réception comme l'anneau DMA de la carte
+//   horloges : le hub fait référence ; module 1 à +d ppm, module 2 à -d ppm (-d), départs
+//              quelconques (module 2 reboucle à 2^32 après ~1 s) ; horodatage du bit de
+//              start (HALUart::stampArm / stamp) retardé de 0 à -j µs (latence d'IRQ)
+//
+// Vérifie après -t secondes d'activité + 100 ms de calme : toutes les notes reçues une
+// fois et dans l'ordre, somme des pas de chaque encodeur, dernière position / tactile de
+// chaque fader côté hub, dernière consigne côté module ; synchro verrouillée en moins de
+// 2 s, puis écart d'horloge et erreur d'horodatage des notes (instant porté par la note
+// vs instant réel de l'appui) ≤ MAX_SYNC_ERR_US. Affiche les latences maximales
+// (événement → hub) et la borne sans erreur. Code de sortie 1 si une vérification échoue.
+//
+// Build : cmake --build build --target modlink_loopback   (CTest : ctest -R modlink)
+// Usage : ./modlink_loopback [-t s] [-b bauds] [-e pour_mille] [-d ppm] [-j µs] [-s graine]
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+#include <unistd.h>
+
+#include "modlink.h"
+
+namespace {
+
+constexpr uint32_t TASK_US   = 250;      // = MODLINK_TASK_US (modlink_uart.h)
+constexpr uint8_t  N_LEAVES  = 2;
+constexpr uint8_t  N_FADERS  = 4;
+constexpr uint8_t  N_ENC     = 6;
+constexpr uint32_t TARGET_US = 40000;
+constexpr uint32_t LOCK_MAX_US = 2000000;   // synchro verrouillée avant
+constexpr int32_t  MAX_SYNC_ERR_US = 50;    // "quelques dizaines de µs"
+constexpr uint32_t LEAF_START[N_LEAVES] = { 0x80003039u, 0xFFF0BDC0u };   // horloges locales à t = 0
+
+struct Options {
+  int seconds = 10;
+  uint32_t baud = 2000000;
+  int errPermil = 0;
+  double ppm = 50;
+  uint32_t jitterUs = 20;
+  unsigned seed = 1;
+};
+
+uint32_t rnd(uint32_t n) { return (uint32_t)rand() % n; }
+
+// ---------------- Fil série : octets datés, livrés à l'arrivée ----------------
+struct Wire {
+  struct Byte { uint32_t t; uint8_t b; };
+  std::deque<Byte> q;
+  uint32_t busyUntil = 0, byteUs10 = 0;   // durée d'un octet × 10 (µs)
+  int errPermil = 0;
+  uint32_t corrupted = 0, collisions = 0;
+
+  void send(const uint8_t* buf, size_t n, uint32_t now) {
+    const bool collide = busyUntil > now;
+    if (collide) ++collisions;
+    uint32_t t10 = (collide ? now : busyUntil > now ? busyUntil : now) * 10;
+    for (size_t k = 0; k < n; ++k) {
+      uint8_t b = buf[k];
+      if (collide) b &= (uint8_t)rand();                      // ET câblé avec l'autre émetteur
+      if (errPermil && (int)rnd(1000) < errPermil) { b ^= (uint8_t)(1u << rnd(8)); ++corrupted; }
+      t10 += byteUs10;
+      q.push_back(Byte{ t10 / 10, b });
+    }
+    if (t10 / 10 > busyUntil) busyUntil = t10 / 10;
+  }
+  template <class F> void deliver(uint32_t now, F&& f) {
+    while (!q.empty() && q.front().t <= now) { f(q.front().b); q.pop_front(); }
+  }
+};
+
+// ---------------- Vérité terrain ----------------
+struct SentNote { uint8_t ch, note, vel; uint32_t t; bool synced; };
+
+// Horloge d'un module : départ + dérive par rapport au hub (temps réel)
+struct LocalClock {
+  uint32_t start = 0;
+  double   ppm = 0;
+  uint32_t at(uint32_t t) const { return start + (uint32_t)(int64_t)((double)t * (1.0 + ppm * 1e-6)); }
+};
+
+// Horodatage du bit de start (IRQ GPIO de HALUart) : 1er octet après stampArm()
+struct Stamper {
+  bool armed = false, has = false;
+  uint32_t t = 0;
+  void arm() { armed = true; has = false; }
+};
+
+struct World {
+  Wire down, up;                              // hub → modules, modules → hub
+  std::vector<uint8_t> hubRx, leafRx[N_LEAVES];
+  ModLinkHub  hub;
+  ModLinkLeaf leaf[N_LEAVES];
+  uint32_t now = 0;
+  LocalClock clk[N_LEAVES];
+  Stamper  hubStamp, leafStamp[N_LEAVES];
+  uint32_t jitterUs = 0, byteUs = 0;
+
+  // synchro : verrouillage, écart d'horloge réel (module → hub vs temps réel)
+  uint32_t lockUs[N_LEAVES] = {0};
+  bool     locked[N_LEAVES] = {false};
+  int32_t  syncErrMax[N_LEAVES] = {0};
+  int32_t  noteErrMax = 0;
+  uint32_t notesTimed = 0;
+
+  // module 1 : faders
+  uint16_t pos[N_FADERS] = {0};
+  bool     touched[N_FADERS] = {false};
+  uint32_t gestureEnd[N_FADERS] = {0}, nextGesture[N_FADERS] = {0}, changedUs[N_FADERS] = {0};
+  uint16_t leafTarget[N_FADERS] = {0};
+  uint16_t sentTarget[N_FADERS] = {0};
+  bool     targetSeen[N_FADERS] = {false};
+
+  // module 2 : notes + encodeurs
+  std::vector<SentNote> notes;
+  int64_t  encSent[N_ENC] = {0};
+  uint32_t nextChord = 0, nextTurn = 0;
+
+  // hub
+  size_t   notesRx = 0;
+  bool     noteOrderOk = true;
+  uint64_t noteLatSum = 0;
+  uint32_t noteLatMax = 0, faderLatMax = 0;
+  int64_t  encRx[N_ENC] = {0};
+  uint16_t hubPos[N_FADERS] = {0};
+  bool     hubTouch[N_FADERS] = {false};
+};
+
+World w;
+
+void hubSend(void*, const uint8_t* buf, size_t n)  { w.hubStamp.arm(); w.down.send(buf, n, w.now); }
+void leafSend(void*, const uint8_t* buf, size_t n) { w.up.send(buf, n, w.now); }
+
+uint32_t hubClock(void*) { return w.now; }
+uint32_t leafClock(void* ctx) { return w.clk[(uintptr_t)ctx].at(w.now); }
+
+// front du bit de start de l'octet arrivé à t (fin de l'octet), vu avec la latence d'IRQ
+uint32_t edgeUs(uint32_t t) { return t - w.byteUs + (w.jitterUs ? rnd(w.jitterUs + 1) : 0); }
+
+void hubItem(void*, uint8_t addr, const ModLinkItem& it) {
+  switch (it.tag) {
+    case ML_IT_FADER:
+      if (addr != 1 || it.index >= N_FADERS) return;
+      w.hubPos[it.index]   = (uint16_t)it.value;
+      w.hubTouch[it.index] = it.arg;
+      if (w.hubPos[it.index] == w.pos[it.index]) {
+        const uint32_t lat = w.now - w.changedUs[it.index];
+        if (lat > w.faderLatMax) w.faderLatMax = lat;
+      }
+      break;
+    case ML_IT_ENC:
+      if (it.index < N_ENC) w.encRx[it.index] += it.value;
+      break;
+    case ML_IT_NOTE: {
+      if (w.notesRx >= w.notes.size()) { w.noteOrderOk = false; return; }
+      const SentNote& s = w.notes[w.notesRx++];
+      if (s.ch != it.index || s.note != it.arg || s.vel != it.value) w.noteOrderOk = false;
+      const uint32_t lat = w.now - s.t;
+      w.noteLatSum += lat;
+      if (lat > w.noteLatMax) w.noteLatMax = lat;
+      if (s.synced) {                          // instant porté par la note vs appui réel
+        const int32_t e = (int32_t)(it.tUs - s.t), a = e < 0 ? -e : e;
+        if (a > w.noteErrMax) w.noteErrMax = a;
+        ++w.notesTimed;
+      }
+      break;
+    }
+  }
+}
+
+void leafItem(void*, uint8_t, const ModLinkItem& it) {
+  if (it.tag == ML_IT_TARGET && it.index < N_FADERS) w.leafTarget[it.index] = (uint16_t)it.value;
+}
+
+// ---------------- Activité ----------------
+void faderActivity(bool active) {
+  for (uint8_t ch = 0; ch < N_FADERS; ++ch) {
+    if (!w.touched[ch] && active && w.now >= w.nextGesture[ch]) {
+      w.touched[ch]    = true;
+      w.gestureEnd[ch] = w.now + 50000 + rnd(400000);
+    }
+    if (w.touched[ch]) {
+      if (w.now >= w.gestureEnd[ch] || !active) {   // calme final : tous les doigts levés
+        w.touched[ch]     = false;
+        w.nextGesture[ch] = w.now + rnd(300000);
+      } else {
+        const int p = (int)w.pos[ch] + (int)rnd(81) - 40;   // ±40 LSB par tick
+        w.pos[ch] = (uint16_t)(p < 0 ? 0 : p > 4095 ? 4095 : p);
+      }
+      w.changedUs[ch] = w.now;
+      w.leaf[0].setFader(ch, w.pos[ch]);
+    }
+    w.leaf[0].setTouch(ch, w.touched[ch]);
+  }
+}
+
+void keyActivity(bool active) {
+  if (!active) return;
+  if (w.now >= w.nextChord) {                  // appui : accord de 1 à 10 notes, puis relâché
+    const uint8_t n = (uint8_t)(1 + rnd(10));
+    for (uint8_t k = 0; k < n; ++k) {
+      const uint8_t ch = (uint8_t)(2 + rnd(2)), note = (uint8_t)rnd(128);
+      for (uint8_t vel : { (uint8_t)100, (uint8_t)0 }) {
+        if (w.leaf[1].pushNote(ch, note, vel))
+          w.notes.push_back(SentNote{ ch, note, vel, w.now, w.leaf[1].clockSync().locked() });
+      }
+    }
+    w.nextChord = w.now + 2000 + rnd(30000);
+  }
+  if (w.now >= w.nextTurn) {
+    const uint8_t e = (uint8_t)rnd(N_ENC);
+    const int32_t steps = (int32_t)(1 + rnd(20)) * (rnd(2) ? 1 : -1);
+    w.leaf[1].addEncoder(e, steps);
+    w.encSent[e] += steps;
+    w.nextTurn = w.now + rnd(5000);
+  }
+}
+
+void hubActivity(bool active) {
+  static uint32_t next = 0;
+  if (!active || w.now < next) return;
+  const uint8_t ch = (uint8_t)rnd(N_FADERS);
+  w.sentTarget[ch] = (uint16_t)rnd(4096);
+  w.targetSeen[ch] = true;
+  w.hub.setTarget(ch, w.sentTarget[ch]);
+  next = w.now + TARGET_US;
+}
+
+// écart réel toutes les ms : toMaster(horloge locale) - temps réel
+void syncCheck() {
+  if (w.now % 1000) return;
+  for (uint8_t l = 0; l < N_LEAVES; ++l) {
+    const ClockSync& cs = w.leaf[l].clockSync();
+    if (!w.locked[l] && cs.locked()) { w.locked[l] = true; w.lockUs[l] = w.now; }
+    if (!w.locked[l]) continue;
+    const int32_t e = (int32_t)(w.leaf[l].toMaster(w.clk[l].at(w.now)) - w.now), a = e < 0 ? -e : e;
+    if (a > w.syncErrMax[l]) w.syncErrMax[l] = a;
+  }
+}
+
+void usage() {
+  fprintf(stderr, "Usage : modlink_loopback [-t s] [-b bauds] [-e pour_mille] [-d ppm] [-j µs] [-s graine]\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options o;
+  int c;
+  while ((c = getopt(argc, argv, "t:b:e:d:j:s:h")) != -1) {
+    switch (c) {
+      case 't': o.seconds = atoi(optarg); break;
+      case 'b': o.baud = (uint32_t)atol(optarg); break;
+      case 'e': o.errPermil = atoi(optarg); break;
+      case 'd': o.ppm = atof(optarg); break;
+      case 'j': o.jitterUs = (uint32_t)atol(optarg); break;
+      case 's': o.seed = (unsigned)atoi(optarg); break;
+      default: usage(); return 2;
+    }
+  }
+  if (o.seconds <= 0 || o.baud < 9600 || o.ppm < 0 || o.ppm > 500) { usage(); return 2; }
+  srand(o.seed);
+
+  for (Wire* wire : { &w.down, &w.up }) {
+    wire->byteUs10  = (uint32_t)(100000000ull / o.baud);   // 10 bits × 1e6 µs × 10
+    wire->errPermil = o.errPermil;
+  }
+  w.byteUs   = (w.down.byteUs10 + 5) / 10;
+  w.jitterUs = o.jitterUs;
+  for (uint8_t l = 0; l < N_LEAVES; ++l) w.clk[l] = LocalClock{ LEAF_START[l], l ? -o.ppm : o.ppm };
+  w.hub.begin(N_LEAVES, hubSend, hubItem, hubClock, nullptr);
+  w.leaf[0].begin(1, N_FADERS, leafSend, leafItem, leafClock, (void*)(uintptr_t)0);
+  w.leaf[1].begin(2, 0, leafSend, leafItem, leafClock, (void*)(uintptr_t)1);
+  for (Stamper& s : w.leafStamp) s.arm();
+
+  const uint32_t activeUs = (uint32_t)o.seconds * 1000000u, endUs = activeUs + 100000;
+  for (w.now = 0; w.now < endUs; ++w.now) {
+    const bool active = w.now < activeUs;
+    w.down.deliver(w.now, [](uint8_t b) {
+      for (uint8_t l = 0; l < N_LEAVES; ++l) {
+        Stamper& s = w.leafStamp[l];
+        if (s.armed) { s.t = w.clk[l].at(edgeUs(w.now)); s.has = true; s.armed = false; }
+        w.leafRx[l].push_back(b);
+      }
+    });
+    w.up.deliver(w.now, [](uint8_t b) {
+      Stamper& s = w.hubStamp;
+      if (s.armed) { s.t = edgeUs(w.now); s.has = true; s.armed = false; }
+      w.hubRx.push_back(b);
+    });
+
+    if (w.now % TASK_US == 0) {                              // tâche "link" du hub
+      hubActivity(active);
+      if (w.hubStamp.has) { w.hub.rxStamp(w.hubStamp.t); w.hubStamp.has = false; }
+      w.hub.onBytes(w.hubRx.data(), w.hubRx.size());
+      w.hubRx.clear();
+      w.hub.poll();
+    }
+    for (uint8_t l = 0; l < N_LEAVES; ++l) {                 // tâches des modules, déphasées
+      if ((w.now + 60 + 90 * l) % TASK_US) continue;
+      if (l == 0) faderActivity(active);
+      else        keyActivity(active);
+      Stamper& s = w.leafStamp[l];
+      if (s.has) { w.leaf[l].rxStamp(s.t); s.has = false; }
+      w.leaf[l].onBytes(w.leafRx[l].data(), w.leafRx[l].size());
+      w.leafRx[l].clear();
+      if (w.leaf[l].rxIdle()) s.arm();
+    }
+    syncCheck();
+  }
+
+  // ---------------- Bilan ----------------
+  bool ok = true;
+  printf("[modlink] %u modules, %u bauds, %d ‰ d'octets corrompus, dérive ±%.0f ppm, gigue %u µs, "
+         "%d s (+0,1 s de calme), graine %u\n",
+         N_LEAVES, (unsigned)o.baud, o.errPermil, o.ppm, (unsigned)o.jitterUs, o.seconds, o.seed);
+  for (uint8_t a = 1; a <= N_LEAVES; ++a) {
+    const ModLinkHub::LeafStats& s = w.hub.stats(a);
+    const ModLinkLeaf& l = w.leaf[a - 1];
+    printf("  module %u : %u POLL, %u réponses, %u sans réponse, %u doublons écartés, RTT max %u µs\n"
+           "             état renvoyé %u, lots renvoyés %u, trames rejetées (module) %u, notes perdues %u\n",
+           a, (unsigned)s.polls, (unsigned)s.replies, (unsigned)s.timeouts, (unsigned)s.duplicates,
+           (unsigned)s.rttMaxUs, (unsigned)l.stateResent, (unsigned)l.batchResent,
+           (unsigned)l.rx().errors, (unsigned)l.notesDropped);
+  }
+  printf("  bus : %u octets corrompus, %u collisions, trames rejetées (hub) %u\n",
+         (unsigned)(w.down.corrupted + w.up.corrupted), (unsigned)(w.down.collisions + w.up.collisions),
+         (unsigned)w.hub.rx().errors);
+
+  const bool notesOk = w.noteOrderOk && w.notesRx == w.notes.size();
+  ok &= notesOk;
+  printf("  notes     : %zu émises, %zu reçues, ordre %s, latence moy %.0f µs, max %u µs  %s\n",
+         w.notes.size(), w.notesRx, w.noteOrderOk ? "ok" : "FAUX",
+         w.notesRx ? (double)w.noteLatSum / (double)w.notesRx : 0.0, (unsigned)w.noteLatMax,
+         notesOk ? "OK" : "ÉCHEC");
+
+  bool encOk = true;
+  for (uint8_t e = 0; e < N_ENC; ++e) encOk &= (w.encSent[e] == w.encRx[e]);
+  ok &= encOk;
+  printf("  encodeurs : somme des pas %s\n", encOk ? "identique  OK" : "différente  ÉCHEC");
+
+  bool fadOk = true, tgtOk = true;
+  for (uint8_t ch = 0; ch < N_FADERS; ++ch) {
+    fadOk &= (w.hubPos[ch] == w.pos[ch] && w.hubTouch[ch] == w.touched[ch]);
+    tgtOk &= (!w.targetSeen[ch] || w.leafTarget[ch] == w.sentTarget[ch]);
+  }
+  ok &= fadOk && tgtOk;
+  printf("  faders    : dernière position / tactile %s, latence max %u µs  %s\n",
+         fadOk ? "identiques" : "différents", (unsigned)w.faderLatMax, fadOk ? "OK" : "ÉCHEC");
+  printf("  consignes : dernière valeur côté module %s\n", tgtOk ? "identique  OK" : "différente  ÉCHEC");
+
+  for (uint8_t l = 0; l < N_LEAVES; ++l) {
+    const ClockSync& cs = w.leaf[l].clockSync();
+    const bool syncOk = w.locked[l] && w.lockUs[l] <= LOCK_MAX_US && w.syncErrMax[l] <= MAX_SYNC_ERR_US;
+    ok &= syncOk;
+    printf("  horloge %u : verrouillée à %.0f ms, écart max %d µs, dérive %+.1f ppm (réelle %+.1f), "
+           "%u échanges dont %u écartés, %u reprises  %s\n",
+           l + 1, w.locked[l] ? w.lockUs[l] / 1000.0 : -1.0, (int)w.syncErrMax[l], (double)cs.ppm(),
+           w.clk[l].ppm, (unsigned)cs.samples, (unsigned)cs.rejected, (unsigned)cs.resets,
+           syncOk ? "OK" : "ÉCHEC");
+  }
+  const bool stampOk = w.notesTimed > 0 && w.noteErrMax <= MAX_SYNC_ERR_US;
+  ok &= stampOk;
+  printf("  horodatage: %u notes après verrouillage, erreur max %d µs (≤ %d)  %s\n",
+         (unsigned)w.notesTimed, (int)w.noteErrMax, (int)MAX_SYNC_ERR_US, stampOk ? "OK" : "ÉCHEC");
+
+  const uint32_t bound = N_LEAVES * (MODLINK_SLOT_US + TASK_US) + TASK_US;
+  printf("  borne sans erreur (1 trame d'éléments par événement) : %u µs\n", (unsigned)bound);
+  printf("%s\n", ok ? "OK" : "ÉCHEC");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+// ========================== osc_peer.cpp ==========================
+// Outil Linux : pair OSC local pour la surface OSC du firmware (osc_eth.h),
+// sur la même pile osc.h/.cpp que le Pico.
+//
+//   client (défaut) : envoie vers hôte:8000, écoute 9000, affiche ce qui revient
+//     -s             : balayage /fader/<f> (float) toutes les 10 ms
+//     -m adr val     : un seul message (motifs acceptés, ex. "/fader/{1,2}" 0.3)
+//   -S : surface simulée (écoute 8000, répond sur 9000) : les faders rejoignent
+//        la consigne en ~100 ms, 1 bundle / ms avec les faders changés, le tactile
+//        du fader 1 bascule toutes les 2 s
+//
+// Test local :  ./osc_peer -S -t 4 &  ./osc_peer -s -t 3
+//
+// Build : g++ -O2 -std=c++17 -I.. -o osc_peer osc_peer.cpp ../osc.cpp
+// Usage : ./osc_peer [-S] [-i hôte] [-s] [-f 1] [-n 4] [-m adr val] [-t s] [-q]
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "osc.h"
+
+namespace {
+
+constexpr uint16_t SURFACE_PORT = 8000;   // OSC_LOCAL_PORT du firmware
+constexpr uint16_t CLIENT_PORT  = 9000;   // OSC_REMOTE_PORT du firmware
+constexpr int      MAX_SIM      = 16;
+
+volatile sig_atomic_t gStop = 0;
+
+uint64_t nowUs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000;
+}
+
+struct Options {
+  bool surface = false;
+  const char* host = "127.0.0.1";
+  bool sweep = false;
+  int fader = 1;
+  int faders = 4;
+  const char* msgAddr = nullptr;
+  float msgVal = 0;
+  int seconds = 0;
+  bool quiet = false;
+};
+
+int openUdp(uint16_t port) {
+  const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) { perror("socket"); exit(1); }
+  const int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+  sockaddr_in a{};
+  a.sin_family = AF_INET;
+  a.sin_addr.s_addr = htonl(INADDR_ANY);
+  a.sin_port = htons(port);
+  if (bind(fd, (sockaddr*)&a, sizeof a) < 0) { perror("bind"); exit(1); }
+  return fd;
+}
+
+// ---------------- Surface simulée ----------------
+struct Surface {
+  OscAddressTable table;
+  float pos[MAX_SIM] = {};
+  float target[MAX_SIM] = {};
+  float sent[MAX_SIM];
+  int n = 4;
+  uint32_t rxMsgs = 0;
+  bool quiet = false;
+};
+
+void onSurfaceMsg(void* ctx, const OscMessage& m) {
+  Surface& s = *(Surface*)ctx;
+  ++s.rxMsgs;
+  uint32_t mask = s.table.resolve(m.addr) & 0x55555555u;
+  float v;
+  if (!mask || !oscArgFloat(m, 0, v)) return;
+  while (mask) {
+    const int id = __builtin_ctz(mask);
+    mask &= mask - 1;
+    s.target[id / 2] = std::fmin(1.0f, std::fmax(0.0f, v));
+  }
+}
+
+// ---------------- Client ----------------
+struct Client {
+  uint32_t bundles = 0, msgs = 0;
+  bool quiet = false;
+};
+
+void onClientMsg(void* ctx, const OscMessage& m) {
+  Client& c = *(Client*)ctx;
+  ++c.msgs;
+  float v = NAN;
+  oscArgFloat(m, 0, v);
+  if (!c.quiet) printf("%-18s ,%-3s %.6f\n", m.addr, m.types, v);
+}
+
+void usage() {
+  fprintf(stderr, "usage: osc_peer [-S] [-i hôte] [-s] [-f fader] [-n faders] [-m adr val] [-t s] [-q]\n");
+  exit(2);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options o;
+  for (int k = 1; k < argc; ++k) {
+    const std::string a = argv[k];
+    auto val = [&]() { if (k + 1 >= argc) usage(); return argv[++k]; };
+    if      (a == "-S") o.surface = true;
+    else if (a == "-i") o.host = val();
+    else if (a == "-s") o.sweep = true;
+    else if (a == "-f") o.fader = atoi(val());
+    else if (a == "-n") o.faders = atoi(val());
+    else if (a == "-m") { o.msgAddr = val(); o.msgVal = (float)atof(val()); }
+    else if (a == "-t") o.seconds = atoi(val());
+    else if (a == "-q") o.quiet = true;
+    else usage();
+  }
+  if (o.faders < 1 || o.faders > MAX_SIM) usage();
+  signal(SIGINT, [](int) { gStop = 1; });
+
+  const int fd = openUdp(o.surface ? SURFACE_PORT : CLIENT_PORT);
+  sockaddr_in dst{};
+  dst.sin_family = AF_INET;
+  dst.sin_port = htons(o.surface ? CLIENT_PORT : SURFACE_PORT);
+  if (inet_pton(AF_INET, o.host, &dst.sin_addr) != 1) usage();
+  bool dstKnown = !o.surface;
+
+  Surface sim;
+  sim.n = o.faders;
+  sim.quiet = o.quiet;
+  for (int i = 0; i < MAX_SIM; ++i) sim.sent[i] = -1.0f;
+  char a[OSC_ADDR_LEN];
+  for (int i = 0; i < o.faders; ++i) {
+    snprintf(a, sizeof a, "/fader/%d", i + 1);       sim.table.add(a);
+    snprintf(a, sizeof a, "/fader/%d/touch", i + 1); sim.table.add(a);
+  }
+  Client cli;
+  cli.quiet = o.quiet;
+
+  uint8_t buf[OSC_MAX_PACKET];
+  OscWriter w(buf, sizeof buf);
+  if (o.msgAddr) {
+    w.message(o.msgAddr, o.msgVal);
+    sendto(fd, buf, w.size(), 0, (sockaddr*)&dst, sizeof dst);
+  }
+
+  const uint64_t t0 = nowUs();
+  uint64_t lastTick = t0, lastSweep = t0;
+  uint32_t txBundles = 0, bad = 0;
+  int sweep = 0;
+  bool touch = false, touchSent = false;
+
+  while (!gStop) {
+    pollfd pfd{ fd, POLLIN, 0 };
+    poll(&pfd, 1, 1);
+    if (pfd.revents & POLLIN) {
+      sockaddr_in from{};
+      socklen_t fl = sizeof from;
+      const ssize_t n = recvfrom(fd, buf, sizeof buf, 0, (sockaddr*)&from, &fl);
+      if (n > 0) {
+        if (o.surface) {
+          dst.sin_addr = from.sin_addr;     // comme le firmware : on répond au dernier client
+          dstKnown = true;
+          if (!oscParse(buf, (size_t)n, onSurfaceMsg, &sim)) ++bad;
+        } else {
+          if (buf[0] == '#') ++cli.bundles;
+          if (!oscParse(buf, (size_t)n, onClientMsg, &cli)) ++bad;
+        }
+      }
+    }
+
+    const uint64_t now = nowUs();
+    if (o.surface && now - lastTick >= 1000) {          // tick 1 kHz comme loopSurface()
+      lastTick = now;
+      w.beginBundle();
+      for (int i = 0; i < sim.n; ++i) {
+        sim.pos[i] += (sim.target[i] - sim.pos[i]) * 0.05f;
+        const float q = std::round(sim.pos[i] * 4095.0f) / 4095.0f;   // pas ADC 12 bits
+        if (q != sim.sent[i]) { w.message(sim.table.name((uint8_t)(2 * i)), q); sim.sent[i] = q; }
+      }
+      touch = ((now - t0) / 2000000) & 1;
+      if (touch != touchSent) { w.message(sim.table.name(1), (int32_t)touch); touchSent = touch; }
+      if (dstKnown && w.count() && w.ok()) {
+        sendto(fd, buf, w.size(), 0, (sockaddr*)&dst, sizeof dst);
+        ++txBundles;
+      }
+    }
+    if (!o.surface && o.sweep && now - lastSweep >= 10000) {
+      lastSweep = now;
+      sweep = (sweep + 1) % 200;
+      const float v = sweep < 100 ? sweep / 99.0f : (199 - sweep) / 99.0f;
+      snprintf(a, sizeof a, "/fader/%d", o.fader);
+      w.reset();
+      w.message(a, v);
+      sendto(fd, buf, w.size(), 0, (sockaddr*)&dst, sizeof dst);
+    }
+    if (o.seconds && now - t0 >= (uint64_t)o.seconds * 1000000u) break;
+  }
+
+  if (o.surface) {
+    printf("surface: messages reçus=%u bundles émis=%u malformés=%u\n", sim.rxMsgs, txBundles, bad);
+    for (int i = 0; i < sim.n; ++i) printf("  /fader/%d = %.6f (consigne %.6f)\n", i + 1, sim.pos[i], sim.target[i]);
+  } else {
+    printf("client: bundles reçus=%u messages=%u malformés=%u\n", cli.bundles, cli.msgs, bad);
+  }
+  return 0;
+}
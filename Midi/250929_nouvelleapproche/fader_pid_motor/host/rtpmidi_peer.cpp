@@ -0,0 +1,188 @@
+// ========================== rtpmidi_peer.cpp ==========================
+// Outil Linux : pair RTP-MIDI local pour tester la pile rtpmidi.h/.cpp du
+// firmware (même code, compilé ici sur sockets UDP POSIX).
+//
+//   responder (défaut) : écoute sur -p/-p+1, comme le Pico (un iPad, rtpmidid,
+//                         ou une 2e instance en -i se connecte)
+//   -i hôte            : initiateur vers hôte:-r/-r+1 (le Pico ou une instance locale)
+//   -r port            : port contrôle du pair invité (défaut 5004, celui du Pico) ;
+//                         -p reste le port local
+//   -s                 : émet un balayage CC (canal/CC de -ch/-c) toutes les 10 ms
+//   -d 20              : jette 20 % des paquets RTP reçus → exerce le journal
+//
+// Affiche les CC reçus ; à la fin (Ctrl-C ou -t secondes) : paquets reçus,
+// perdus, CC rattrapés par le journal, et la dernière valeur de chaque CC.
+// Test local :
+//   ./rtpmidi_peer -p 5008 -d 30 &  ./rtpmidi_peer -i 127.0.0.1 -r 5008 -p 5010 -s -t 5
+//
+// Build : g++ -O2 -std=c++17 -I.. -o rtpmidi_peer rtpmidi_peer.cpp ../rtpmidi.cpp
+// Usage : ./rtpmidi_peer [-i hôte] [-r port] [-p port] [-s] [-d pct] [-ch 1] [-c 16] [-t s] [-q]
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "rtpmidi.h"
+
+namespace {
+
+volatile sig_atomic_t gStop = 0;
+
+uint32_t nowUs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000);
+}
+
+struct Options {
+  const char* invite = nullptr;
+  uint16_t port = RTPMIDI_CTRL_PORT;
+  uint16_t remotePort = RTPMIDI_CTRL_PORT;   // -i : port contrôle du pair
+  bool sweep = false;
+  int dropPct = 0;
+  int channel = 1;
+  int cc = 16;          // FADER_CC[0] de midi_io.h
+  int seconds = 0;
+  bool quiet = false;
+};
+
+// ---------------- Transport UDP (2 sockets : contrôle / données) ----------------
+struct Peer {
+  int fd[2] = { -1, -1 };
+  sockaddr_in remote[2] = {};
+  bool known[2] = { false, false };
+  int dropPct = 0;
+  bool quiet = false;
+  uint8_t last[128] = {};
+  bool seen[128] = {};
+};
+
+int openUdp(uint16_t port) {
+  const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) { perror("socket"); exit(1); }
+  const int one = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+  sockaddr_in a{};
+  a.sin_family = AF_INET;
+  a.sin_addr.s_addr = htonl(INADDR_ANY);
+  a.sin_port = htons(port);
+  if (bind(fd, (sockaddr*)&a, sizeof a) < 0) { perror("bind"); exit(1); }
+  return fd;
+}
+
+void udpSend(void* ctx, bool dataPort, const uint8_t* buf, size_t len) {
+  Peer& p = *(Peer*)ctx;
+  const int k = dataPort ? 1 : 0;
+  if (!p.known[k]) return;
+  sendto(p.fd[k], buf, len, 0, (sockaddr*)&p.remote[k], sizeof p.remote[k]);
+}
+
+void onCC(void* ctx, uint8_t ch, uint8_t cc, uint8_t value) {
+  Peer& p = *(Peer*)ctx;
+  p.last[cc] = value;
+  p.seen[cc] = true;
+  if (!p.quiet) printf("CC ch=%u cc=%u val=%u\n", ch + 1, cc, value);
+}
+
+void usage() {
+  fprintf(stderr, "usage: rtpmidi_peer [-i hôte] [-r port] [-p port] [-s] [-d pct] [-ch canal] [-c cc] "
+                  "[-t secondes] [-q]\n");
+  exit(2);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options o;
+  for (int k = 1; k < argc; ++k) {
+    const std::string a = argv[k];
+    auto val = [&]() { if (k + 1 >= argc) usage(); return argv[++k]; };
+    if      (a == "-i")  o.invite = val();
+    else if (a == "-r")  o.remotePort = (uint16_t)atoi(val());
+    else if (a == "-p")  o.port = (uint16_t)atoi(val());
+    else if (a == "-s")  o.sweep = true;
+    else if (a == "-d")  o.dropPct = atoi(val());
+    else if (a == "-ch") o.channel = atoi(val());
+    else if (a == "-c")  o.cc = atoi(val());
+    else if (a == "-t")  o.seconds = atoi(val());
+    else if (a == "-q")  o.quiet = true;
+    else usage();
+  }
+  signal(SIGINT, [](int) { gStop = 1; });
+  srand((unsigned)nowUs());
+
+  Peer peer;
+  peer.dropPct = o.dropPct;
+  peer.quiet = o.quiet;
+  peer.fd[0] = openUdp(o.port);
+  peer.fd[1] = openUdp((uint16_t)(o.port + 1));
+
+  RtpMidiSession rtp;
+  rtp.begin(o.invite ? "rtpmidi_peer (init)" : "rtpmidi_peer", (uint32_t)rand(),
+            (uint8_t)(o.channel - 1), udpSend, onCC, &peer);
+
+  if (o.invite) {
+    for (int k = 0; k < 2; ++k) {
+      peer.remote[k].sin_family = AF_INET;
+      peer.remote[k].sin_port = htons((uint16_t)(o.remotePort + k));
+      if (inet_pton(AF_INET, o.invite, &peer.remote[k].sin_addr) != 1) usage();
+      peer.known[k] = true;
+    }
+    rtp.invite(nowUs());
+  }
+
+  const uint32_t t0 = nowUs();
+  uint32_t lastSweep = t0;
+  uint8_t sweep = 0;
+  bool wasConnected = false;
+
+  while (!gStop) {
+    pollfd pfd[2] = { { peer.fd[0], POLLIN, 0 }, { peer.fd[1], POLLIN, 0 } };
+    poll(pfd, 2, 2);
+    for (int k = 0; k < 2; ++k) {
+      if (!(pfd[k].revents & POLLIN)) continue;
+      uint8_t buf[RTPMIDI_MAX_PACKET];
+      sockaddr_in from{};
+      socklen_t fl = sizeof from;
+      const ssize_t n = recvfrom(peer.fd[k], buf, sizeof buf, 0, (sockaddr*)&from, &fl);
+      if (n <= 0) continue;
+      // perte simulée : seulement les paquets RTP (pas la session)
+      if (k == 1 && buf[0] != 0xFF && rand() % 100 < peer.dropPct) continue;
+      peer.remote[k] = from;
+      peer.known[k] = true;
+      rtp.onPacket(k == 1, buf, (size_t)n, nowUs());
+    }
+
+    const uint32_t now = nowUs();
+    rtp.poll(now);
+    if (rtp.connected() != wasConnected) {
+      wasConnected = rtp.connected();
+      printf("[RTP] session %s\n", wasConnected ? "ouverte" : "fermée");
+    }
+    if (o.sweep && rtp.connected() && (uint32_t)(now - lastSweep) >= 10000) {
+      lastSweep = now;
+      sweep = (uint8_t)((sweep + 1) & 0x7F);
+      rtp.beginPacket();
+      rtp.addCC((uint8_t)(o.channel - 1), (uint8_t)o.cc, sweep);
+      rtp.addCC((uint8_t)(o.channel - 1), (uint8_t)(o.cc + 1), (uint8_t)(127 - sweep));
+      rtp.endPacket(now);
+    }
+    if (o.seconds && (uint32_t)(now - t0) >= (uint32_t)o.seconds * 1000000u) break;
+  }
+
+  printf("rx=%u perdus=%u rattrapés(journal)=%u tx=%u\n",
+         rtp.rxPackets, rtp.rxLost, rtp.rxRecovered, rtp.txPackets);
+  for (int cc = 0; cc < 128; ++cc) {
+    if (peer.seen[cc]) printf("  cc %3d = %3u\n", cc, peer.last[cc]);
+  }
+  return 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+// ========================== sim/AH/Hardware/FilteredAnalog.hpp ==========================
+// Filtre de Control Surface : EMA à décalage (alpha = 2^-FilterShift) sur l'ADC
+// suréchantillonné, départ à 0 comme la bibliothèque
+#include <Arduino.h>
+
+namespace AH {
+
+template <uint8_t Precision, uint8_t FilterShift, class FilterType>
+class FilteredAnalog {
+ public:
+  explicit FilteredAnalog(uint8_t pin) : pin(pin) {}
+
+  bool update() {
+    // acc = moyenne × 2^(FilterShift + EXTRA) ; acc += x − acc / 2^FilterShift
+    acc += ((FilterType)analogRead(pin) << EXTRA) - (acc >> FilterShift);
+    const FilterType v = ((acc >> FilterShift) + ((FilterType)1 << (EXTRA - 1))) >> EXTRA;
+    const bool changed = v != value;
+    value = v;
+    return changed;
+  }
+  FilterType getValue() const { return value; }
+
+ private:
+  static constexpr uint8_t EXTRA = 4;                       // bits de suréchantillonnage
+  uint8_t pin;
+  FilterType acc = 0;
+  FilterType value = 0;
+};
+
+}  // namespace AH
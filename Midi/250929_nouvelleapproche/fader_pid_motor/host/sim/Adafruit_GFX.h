@@ -0,0 +1,3 @@
+#pragma once
+// ========================== sim/Adafruit_GFX.h ==========================
+// Rien à dessiner : voir Adafruit_SSD1306.h
@@ -0,0 +1,32 @@
+#pragma once
+// ========================== sim/Adafruit_SSD1306.h ==========================
+// OLED simulé : pas de pixels, mais display() coûte le temps du transfert I2C
+// (1 Kio à 400 kHz ≈ 23 ms) → la boucle simulée a la cadence de la carte réelle.
+// getBuffer() : tampon de trame réel (envoi par morceaux de display.cpp, Wire.h)
+#include <Arduino.h>
+#include <Wire.h>
+
+#define SSD1306_SWITCHCAPVCC 2
+#define SSD1306_WHITE 1
+#define SSD1306_BLACK 0
+
+class Adafruit_SSD1306 : public Print {
+ public:
+  Adafruit_SSD1306(int w, int h, TwoWire* wire, int rst) : w(w), h(h), wire(wire) { (void)rst; }
+  bool begin(int vcs, int addr) { (void)vcs; (void)addr; return true; }
+  void clearDisplay() {}
+  void setTextSize(int) {}
+  void setTextColor(int) {}
+  void setCursor(int, int) {}
+  void fillRect(int, int, int, int, int) {}
+  void drawRect(int, int, int, int, int) {}
+  void display() { simOledTransfer((size_t)w * h / 8, wire->clockHz); }
+  uint8_t* getBuffer() { return buffer; }
+  using Print::write;
+  size_t write(uint8_t) override { return 1; }
+
+ private:
+  int w, h;
+  TwoWire* wire;
+  uint8_t buffer[128 * 64 / 8] = {};
+};
@@ -0,0 +1,121 @@
+#pragma once
+// ========================== sim/Arduino.h ==========================
+// Cœur Arduino simulé (Linux) pour fader_sim : même API que le core RP2040 pour ce que
+// le firmware et les bibliothèques utilisent encore directement. Temps et E/S ne sont
+// qu'un habillage du backend hôte de la HAL (hal.h) ; Serial = pseudo-terminal (sim_hal.cpp).
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+using std::min;
+using std::max;
+
+// ===================== Broches (RP2040) =====================
+constexpr uint8_t A0 = 26, A1 = 27, A2 = 28, A3 = 29;
+constexpr uint8_t SIM_NUM_PINS = 30;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define DEC 10
+#define HEX 16
+#define BIN 2
+#define PI 3.14159265358979f
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// ===================== Temps / E/S : backend hôte de la HAL (hal_host.h) =====================
+#include "hal.h"
+
+inline unsigned long millis() { return HALTime::millis(); }
+inline unsigned long micros() { return HALTime::micros(); }
+inline void delay(unsigned long ms) { HALTime::delayMs((uint32_t)ms); }
+inline void delayMicroseconds(unsigned int us) { HALTime::delayUs(us); }
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+  HALGpio::mode(pin, mode == OUTPUT ? HALGpio::Output : (mode == INPUT_PULLUP ? HALGpio::InputPullup : HALGpio::Input));
+}
+inline void digitalWrite(uint8_t pin, uint8_t level) { HALGpio::write(pin, level != LOW); }
+inline int  digitalRead(uint8_t pin) { return HALGpio::read(pin) ? HIGH : LOW; }
+inline int  analogRead(uint8_t pin) { return HALAdc::read(pin); }
+inline void analogReadResolution(int bits) { HALAdc::resolution((uint8_t)bits); }
+inline void analogWrite(uint8_t pin, int value) { HALPwm::write(pin, (uint16_t)(value < 0 ? 0 : value)); }
+inline void analogWriteFreq(uint32_t hz) { HALPwm::frequency(hz); }
+inline void analogWriteRange(uint32_t range) { HALPwm::range(range); }
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+template <class T, class L, class H>
+T constrain(T x, L lo, H hi) { return x < lo ? (T)lo : (x > hi ? (T)hi : x); }
+
+// ===================== Print / Stream =====================
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t b) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    size_t k = 0;
+    while (k < n && write(buf[k])) ++k;
+    return k;
+  }
+  size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(double v, int digits = 2);
+  template <class T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+  size_t print(T v, int base = DEC) {
+    return std::is_signed<T>::value ? printSigned((long long)v, base) : printUnsigned((unsigned long long)v, base);
+  }
+
+  size_t println() { return write("\r\n"); }
+  template <class T>
+  size_t println(T v) { const size_t n = print(v); return n + println(); }
+  template <class T>
+  size_t println(T v, int fmt) { const size_t n = print(v, fmt); return n + println(); }
+
+ private:
+  size_t printSigned(long long v, int base);
+  size_t printUnsigned(unsigned long long v, int base);
+};
+
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  size_t readBytes(uint8_t* buf, size_t n);
+  void setTimeout(unsigned long ms) { timeoutMs = ms; }
+
+ protected:
+  unsigned long timeoutMs = 1000;
+};
+
+// USB CDC du Pico → pseudo-terminal côté hôte
+class SerialUSB : public Stream {
+ public:
+  void begin(unsigned long baud = 115200) { (void)baud; }
+  void end() {}
+  operator bool() { return true; }            // DTR non visible sur un pty : toujours prêt
+
+  using Print::write;
+  size_t write(uint8_t b) override { return write(&b, 1); }
+  size_t write(const uint8_t* buf, size_t n) override;
+  int availableForWrite() override;
+  void flush() override;
+  int available() override;
+  int read() override;
+  int peek() override;
+};
+
+extern SerialUSB Serial;
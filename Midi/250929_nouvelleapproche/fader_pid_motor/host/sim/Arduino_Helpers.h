@@ -0,0 +1,3 @@
+#pragma once
+// ========================== sim/Arduino_Helpers.h ==========================
+#include <Arduino.h>
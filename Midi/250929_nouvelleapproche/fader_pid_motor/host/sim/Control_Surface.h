@@ -0,0 +1,66 @@
+#pragma once
+// ========================== sim/Control_Surface.h ==========================
+// Sous-ensemble de Control Surface utilisé par midi_io.cpp. Pas de port USB MIDI dans le
+// simulateur : les messages émis sont comptés (stats du simulateur), rien n'est reçu.
+// Le MIDI 2.0 (UMP en SLIP sur le CDC) passe, lui, par le pty comme sur la carte.
+#include <Arduino.h>
+
+class Channel {
+ public:
+  constexpr Channel(uint8_t raw = 0) : raw(raw) {}
+  static constexpr Channel createChannel(uint8_t oneBased) { return Channel((uint8_t)(oneBased - 1)); }
+  constexpr uint8_t getRaw() const { return raw; }
+
+ private:
+  uint8_t raw;
+};
+constexpr Channel Channel_1{0};
+
+struct MIDIAddress {
+  constexpr MIDIAddress(uint8_t address = 0, Channel channel = Channel_1) : address(address), channel(channel) {}
+  uint8_t address;
+  Channel channel;
+};
+
+struct ChannelMessage {
+  uint8_t header, data1, data2;
+  uint8_t getMessageType() const { return header & 0xF0; }
+  Channel getChannel() const { return Channel(header & 0x0F); }
+};
+
+struct SysExMessage {
+  const uint8_t* data;
+  uint16_t length;
+  uint8_t cable = 0;
+};
+
+class MIDI_Interface {
+ public:
+  void begin() {}
+  void update() {}
+  void sendControlChange(MIDIAddress a, uint8_t value);
+  void sendProgramChange(MIDIAddress a);
+  void sendNoteOn(MIDIAddress a, uint8_t velocity);
+  void sendNoteOff(MIDIAddress a, uint8_t velocity);
+  void sendSysEx(const uint8_t* data, uint16_t len);
+  void sendNow() {}
+};
+
+class USBMIDI_Interface : public MIDI_Interface {};
+
+class Control_Surface_ {
+ public:
+  typedef bool (*ChannelCb)(ChannelMessage);
+  typedef bool (*SysExCb)(SysExMessage);
+  typedef bool (*SysCommonCb)(int);
+  typedef bool (*RealTimeCb)(int);
+  void begin() {}
+  void loop() {}
+  void setMIDIInputCallbacks(ChannelCb ch, SysExCb sx, SysCommonCb sc, RealTimeCb rt) {
+    onChannel = ch; onSysEx = sx; (void)sc; (void)rt;
+  }
+  ChannelCb onChannel = nullptr;
+  SysExCb   onSysEx = nullptr;
+};
+
+extern Control_Surface_ Control_Surface;
@@ -0,0 +1,24 @@
+#pragma once
+// ========================== sim/EEPROM.h ==========================
+// EEPROM émulée : tableau en RAM, commit() l'écrit dans le fichier --eeprom du simulateur
+#include <Arduino.h>
+
+class EEPROMClass {
+ public:
+  void begin(size_t size);
+  template <class T> T& get(int addr, T& t) {
+    if (addr >= 0 && addr + sizeof(T) <= len) memcpy(&t, data + addr, sizeof(T));
+    return t;
+  }
+  template <class T> const T& put(int addr, const T& t) {
+    if (addr >= 0 && addr + sizeof(T) <= len) memcpy(data + addr, &t, sizeof(T));
+    return t;
+  }
+  bool commit();
+
+ private:
+  uint8_t data[4096];
+  size_t len = 0;
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,31 @@
+#pragma once
+// ========================== sim/Ethernet.h ==========================
+// Pas de W5500 dans le simulateur : hardwareStatus() = EthernetNoHardware,
+// rtpmidi_eth.cpp / osc_eth.cpp restent inactifs comme sur une carte sans module.
+#include <Arduino.h>
+
+class IPAddress {
+ public:
+  IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : b{a, b, c, d} {}
+  uint8_t operator[](int i) const { return b[i & 3]; }
+  bool operator==(const IPAddress& o) const { return memcmp(b, o.b, 4) == 0; }
+
+ private:
+  uint8_t b[4];
+};
+
+enum EthernetHardwareStatus { EthernetNoHardware, EthernetW5100, EthernetW5200, EthernetW5500 };
+enum EthernetLinkStatus { Unknown, LinkON, LinkOFF };
+
+class EthernetClass {
+ public:
+  void init(uint8_t) {}
+  int begin(uint8_t*, unsigned long = 60000, unsigned long = 4000) { return 0; }
+  void begin(uint8_t*, IPAddress) {}
+  EthernetHardwareStatus hardwareStatus() { return EthernetNoHardware; }
+  EthernetLinkStatus linkStatus() { return LinkOFF; }
+  IPAddress localIP() { return IPAddress(); }
+  int maintain() { return 0; }
+};
+
+extern EthernetClass Ethernet;
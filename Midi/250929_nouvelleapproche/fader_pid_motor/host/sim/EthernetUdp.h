@@ -0,0 +1,17 @@
+#pragma once
+// ========================== sim/EthernetUdp.h ==========================
+#include <Ethernet.h>
+
+class EthernetUDP {
+ public:
+  uint8_t begin(uint16_t) { return 0; }
+  uint8_t beginMulticast(IPAddress, uint16_t) { return 0; }
+  int parsePacket() { return 0; }
+  int read(uint8_t*, size_t) { return 0; }
+  IPAddress remoteIP() { return IPAddress(); }
+  uint16_t remotePort() { return 0; }
+  int beginPacket(IPAddress, uint16_t) { return 0; }
+  size_t write(const uint8_t*, size_t n) { return n; }
+  int endPacket() { return 0; }
+  void stop() {}
+};
@@ -0,0 +1,15 @@
+#pragma once
+// ========================== sim/SPI.h ==========================
+#include <Arduino.h>
+
+class SPIClass {
+ public:
+  bool setRX(uint8_t) { return true; }
+  bool setTX(uint8_t) { return true; }
+  bool setSCK(uint8_t) { return true; }
+  bool setCS(uint8_t) { return true; }
+  void begin() {}
+};
+
+extern SPIClass SPI;
+extern SPIClass SPI1;
@@ -0,0 +1,23 @@
+#pragma once
+// ========================== sim/Wire.h ==========================
+// I2C simulé : seul l'OLED (display.cpp) l'utilise, voir Adafruit_SSD1306.h
+// une transaction coûte le temps de ses octets (+ adresse) à clockHz, comme display()
+#include <Arduino.h>
+
+void simOledTransfer(size_t bytes, uint32_t clockHz);   // sim_hal.cpp
+
+class TwoWire {
+ public:
+  void setSDA(uint8_t) {}
+  void setSCL(uint8_t) {}
+  void begin() {}
+  void setClock(uint32_t hz) { clockHz = hz; }
+  void beginTransmission(uint8_t) { pending = 1; }                 // octet d'adresse
+  size_t write(uint8_t) { ++pending; return 1; }
+  size_t write(const uint8_t*, size_t n) { pending += n; return n; }
+  uint8_t endTransmission() { simOledTransfer(pending, clockHz); pending = 0; return 0; }
+  size_t pending = 0;
+  uint32_t clockHz = 400000;
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,65 @@
+#include "fader_plant.h"
+#include <cmath>
+
+static constexpr float TRAVEL_M = FADER_TRAVEL_MM * 1e-3f;
+
+void FaderPlant::reset(float pos_mm) {
+  x = pos_mm * 1e-3f;
+  v = 0;
+  amps = 0;
+  fingerDown = false;
+}
+
+void FaderPlant::finger(bool down, float pos_mm) {
+  fingerDown = down;
+  fingerX = pos_mm < 0 ? x : pos_mm * 1e-3f;
+  if (fingerX > TRAVEL_M) fingerX = TRAVEL_M;
+}
+
+void FaderPlant::step(uint32_t dt_us) {
+  while (dt_us) {
+    const uint32_t d = dt_us < FADER_STEP_US ? dt_us : FADER_STEP_US;
+    substep(d * 1e-6f);
+    dt_us -= d;
+  }
+}
+
+void FaderPlant::substep(float dt) {
+  // pont en H : (1,1) frein, (0,0) roue libre, sinon tension moyenne du PWM
+  const bool open = in1.duty <= 0 && in2.duty <= 0;
+  const float volts = FADER_SUPPLY_V * (in1.duty - in2.duty);
+  amps = open ? 0.0f : (volts - FADER_KE_V_MS * v) / FADER_R_OHM;
+
+  float f = FADER_KF_N_A * amps - FADER_VISCOUS * v;
+  if (fingerDown) f += FADER_FINGER_K * (fingerX - x) - FADER_FINGER_C * v;
+
+  // frottement sec : adhérence tant que la force ne le dépasse pas
+  if (std::fabs(v) < 1e-4f) {
+    if (std::fabs(f) <= FADER_COULOMB_N) { v = 0; return; }
+    f -= std::copysign(FADER_COULOMB_N, f);
+  } else {
+    f -= std::copysign(FADER_COULOMB_N, v);
+  }
+
+  const float v1 = v + f / FADER_MASS_KG * dt;
+  if (v != 0 && (v1 > 0) != (v > 0)) v = 0;   // le frottement arrête, ne relance pas
+  else v = v1;
+  x += v * dt;
+  if (x < 0)        { x = 0;        if (v < 0) v = 0; }
+  if (x > TRAVEL_M) { x = TRAVEL_M; if (v > 0) v = 0; }
+}
+
+uint16_t FaderPlant::adc(uint8_t bits) {
+  // bruit gaussien approché (somme de 4 uniformes, xorshift32)
+  float n = 0;
+  for (int k = 0; k < 4; ++k) {
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    n += (float)(rng & 0xFFFF) / 65535.0f - 0.5f;
+  }
+  n *= FADER_ADC_NOISE * 1.732f;              // 4 uniformes : σ = 1/√3 → σ = FADER_ADC_NOISE
+  const float full = (float)((1u << bits) - 1);
+  float r = x / TRAVEL_M * full + n * full / 4095.0f;
+  if (r < 0) r = 0;
+  if (r > full) r = full;
+  return (uint16_t)(r + 0.5f);
+}
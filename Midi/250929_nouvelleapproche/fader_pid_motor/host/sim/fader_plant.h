@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+
+/*
+  Modèle physique d'un fader motorisé (type ALPS RSA0N11M9, 100 mm) pour le simulateur
+  Code portable (pas d'Arduino) : entrées = états du pont en H (IN1/IN2), sortie = tension
+  du curseur en pas ADC.
+
+  Moteur CC + courroie ramenés à un chariot de masse m :
+    I = (V - Ke·v) / R        (circuit fermé : PWM ou frein IN1 = IN2 = HIGH)
+    I = 0                     (roue libre IN1 = IN2 = LOW)
+    m·a = Kf·I - b·v - frottement sec (Coulomb, avec adhérence à l'arrêt)
+  Butées mécaniques à 0 et FADER_TRAVEL_MM (choc inélastique).
+  Doigt posé : ressort + amortisseur vers la position tenue par la main (finger()).
+*/
+
+// ===================== RÉGLAGES =====================
+constexpr float FADER_TRAVEL_MM  = 100.0f;
+constexpr float FADER_SUPPLY_V   = 12.0f;   // alim du pont (breakv 0.83 → ~10 V max)
+constexpr float FADER_R_OHM      = 12.0f;   // résistance d'induit
+// Kf = Ke (même constante en SI) ; Kf, m·R, b, frottement ajustés sur les essais réels
+// (1 kHz, old project/250924-calibration fader/python/calibration/data : profil rampe +
+// paliers, P/PI/PID) par python/fit_plant.py, écart RMS ≈ 40 comptes / 1023 ; seul le
+// produit m·R est identifiable (pas d'inductance) → R fixé, m = 0,160 / R.
+// Pleine tension : 100 mm en ~55 ms
+constexpr float FADER_KF_N_A     = 2.45f;   // constante de force (moteur + poulie)
+constexpr float FADER_KE_V_MS    = FADER_KF_N_A;   // f.c.é.m. (V par m/s)
+constexpr float FADER_MASS_KG    = 0.0134f; // chariot + inertie rotor ramenée
+constexpr float FADER_VISCOUS    = 0.030f;  // N par m/s (hors f.c.é.m.)
+constexpr float FADER_COULOMB_N  = 0.61f;   // frottement sec (décollage à ~25 % de PWM)
+constexpr float FADER_FINGER_K   = 400.0f;  // N/m : raideur de la main
+constexpr float FADER_FINGER_C   = 8.0f;    // N par m/s
+constexpr float FADER_ADC_NOISE  = 1.5f;    // bruit de l'ADC (LSB rms)
+constexpr uint32_t FADER_STEP_US = 20;      // pas d'intégration max
+
+// Commande du pont pour une broche : niveau logique ou rapport cyclique PWM
+struct BridgePin {
+  bool  pwm = false;
+  float duty = 0.0f;     // 0..1 (niveau HIGH = 1)
+};
+
+class FaderPlant {
+ public:
+  void  reset(float pos_mm = 0.0f);
+  void  step(uint32_t dt_us);                 // intègre dt (sous-pas ≤ FADER_STEP_US)
+
+  BridgePin in1, in2;                         // écrits par la HAL (digitalWrite / analogWrite)
+
+  // Main de l'utilisateur
+  void  finger(bool down, float pos_mm = -1); // pos < 0 : garde la position courante
+  bool  touched() const { return fingerDown; }
+
+  float position() const { return x * 1000.0f; }   // mm
+  float velocity() const { return v * 1000.0f; }   // mm/s
+  float current() const { return amps; }
+  uint16_t adc(uint8_t bits);                 // curseur : 0..(2^bits - 1), bruité
+
+ private:
+  void  substep(float dt);
+
+  float x = 0, v = 0;                         // m, m/s
+  float amps = 0;
+  bool  fingerDown = false;
+  float fingerX = 0;
+  uint32_t rng = 0x12345678u;
+};
@@ -0,0 +1,177 @@
+// ========================== sim/fader_sim.cpp ==========================
+// Simulateur Linux du firmware fader_pid_motor : le vrai code (fader_pid_motor.ino + *.cpp)
+// compilé contre une HAL simulée (sim_hal.h) et un modèle physique de fader
+// (fader_plant.h). Le CDC du Pico devient un pseudo-terminal qui parle exactement les
+// mêmes protocoles (texte, SLIP, télémétrie 'T', protocole hôte binaire) : Tuning.py,
+// telemetry_capture, capture.py… tournent sans carte.
+//
+//   - horloge virtuelle : -s 1 temps réel, -s 10 dix fois plus vite, -s 0 au plus vite
+//   - -l lien symbolique stable vers le pty (ex. /tmp/fader0 ; FADER_PORT=/tmp/fader0
+//     pour Tuning.py)
+//   - commandes sur stdin (main de l'utilisateur, entrées) :
+//       touch <i> 0|1     doigt posé / levé sur le fader i (tactile + ressort)
+//       move <i> <pct>    doigt posé qui amène le fader à pct %
+//       release <i>       doigt levé
+//       pin <n> 0|1|-     impose une entrée (bouton de scène…) ; '-' la libère
+//       key <k> 0|1       touche k de la matrice enfoncée / relâchée (avec rebonds)
+//       enc <e> <n> [ms]  encodeur e tourné de n crans (signé), répartis sur ms
+//       state             position / vitesse / courant de chaque fader
+//       quit
+//   - USB MIDI : messages émis comptés (stats à la sortie, détail avec -v) ; pas de W5500
+//   - -u port : lien hôte (host_link.h) en UDP sur un vrai socket au lieu du pty, comme un
+//     module PoE (FADER_PORT=udp:127.0.0.1:port python Tuning.py)
+//
+// Build : cmake (CMakeLists.txt du firmware, cible fader_sim) ou, depuis host/ :
+//   g++ -O2 -std=gnu++17 -Isim -I.. -o fader_sim sim/*.cpp -x c++ ../fader_pid_motor.ino -x none ../*.cpp
+// Usage : ./fader_sim [-l /tmp/fader0] [-s vitesse] [-t s] [-e eeprom.bin] [-p pct] [-L µs] [-u port] [-v] [-q]
+#include <Arduino.h>
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sim_hal.h"
+#include "host_link.h"          // host_link_transport (-u)
+
+void setup();   // fader_pid_motor.ino
+void loop();
+
+namespace {
+
+volatile sig_atomic_t gStop = 0;
+
+struct Options {
+  const char* link = nullptr;
+  double seconds = 0;        // durée virtuelle (0 = jusqu'à Ctrl-C / quit)
+  bool quiet = false;
+};
+
+void usage() {
+  fprintf(stderr,
+          "Usage : fader_sim [-l lien] [-s vitesse] [-t s] [-e eeprom.bin] [-p pct] [-L µs] [-u port] [-v] [-q]\n"
+          "  -l lien      lien symbolique vers le pty (ex. /tmp/fader0)\n"
+          "  -s vitesse   1 = temps réel (défaut), 10 = 10× plus vite, 0 = au plus vite\n"
+          "  -t s         arrêt après s secondes virtuelles\n"
+          "  -e fichier   EEPROM persistante (calibration, scènes)\n"
+          "  -p pct       position initiale des faders (%%)\n"
+          "  -L µs        coût d'un passage dans loop() (défaut 10)\n"
+          "  -u port      lien hôte en UDP sur ce port (au lieu du pty)\n"
+          "  -v           trace les messages MIDI émis\n"
+          "  -q           pas de stats à la sortie\n");
+}
+
+// ---------------- Commandes stdin ----------------
+void command(char* line) {
+  char* argv[4] = {};
+  int argc = 0;
+  for (char* t = strtok(line, " \t"); t && argc < 4; t = strtok(nullptr, " \t")) argv[argc++] = t;
+  if (!argc) return;
+  const uint8_t i = argc > 1 ? (uint8_t)atoi(argv[1]) : 0;
+
+  if (!strcmp(argv[0], "touch") && argc == 3) {
+    sim::plant(i).finger(atoi(argv[2]) != 0);
+  } else if (!strcmp(argv[0], "move") && argc == 3) {
+    sim::plant(i).finger(true, (float)atof(argv[2]) * FADER_TRAVEL_MM / 100.0f);
+  } else if (!strcmp(argv[0], "release") && argc == 2) {
+    sim::plant(i).finger(false);
+  } else if (!strcmp(argv[0], "pin") && argc == 3) {
+    sim::forcePin(i, argv[2][0] == '-' ? -1 : atoi(argv[2]));
+  } else if (!strcmp(argv[0], "key") && argc == 3) {
+    sim::key((uint16_t)atoi(argv[1]), atoi(argv[2]) != 0);
+  } else if (!strcmp(argv[0], "enc") && (argc == 3 || argc == 4)) {
+    sim::turn(i, atoi(argv[2]), argc == 4 ? (uint32_t)atoi(argv[3]) : 0);
+  } else if (!strcmp(argv[0], "state")) {
+    for (uint8_t k = 0; k < NUM_FADERS; ++k) {
+      FaderPlant& f = sim::plant(k);
+      fprintf(stderr, "[SIM] t=%.3f s f%u : %.2f mm  %.1f mm/s  %.3f A%s\n", sim::now() * 1e-6, k,
+              f.position(), f.velocity(), f.current(), f.touched() ? "  (touché)" : "");
+    }
+  } else if (!strcmp(argv[0], "quit")) {
+    gStop = 1;
+  } else {
+    fprintf(stderr, "[SIM] commande inconnue : %s\n", argv[0]);
+  }
+}
+
+void pollStdin() {
+  static char line[256];
+  static size_t len = 0;
+  char buf[256];
+  const ssize_t n = read(STDIN_FILENO, buf, sizeof buf);
+  for (ssize_t k = 0; k < n; ++k) {
+    if (buf[k] == '\n' || buf[k] == '\r') {
+      line[len] = 0;
+      command(line);
+      len = 0;
+    } else if (len < sizeof line - 1) {
+      line[len++] = buf[k];
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  int c;
+  while ((c = getopt(argc, argv, "l:s:t:e:p:L:u:vqh")) != -1) {
+    switch (c) {
+      case 'l': opt.link = optarg; break;
+      case 's': sim::cfg.speed = atof(optarg); break;
+      case 't': opt.seconds = atof(optarg); break;
+      case 'e': sim::cfg.eeprom = optarg; break;
+      case 'p': sim::cfg.startPct = (float)atof(optarg); break;
+      case 'L': sim::cfg.loopUs = (uint32_t)atoi(optarg); break;
+      case 'u':
+        sim::cfg.udpPort    = (uint16_t)atoi(optarg);
+        host_link_transport = HOSTLINK_UDP;
+        break;
+      case 'v': sim::cfg.verbose = true; break;
+      case 'q': opt.quiet = true; break;
+      default: usage(); return c == 'h' ? 0 : 1;
+    }
+  }
+
+  if (!sim::begin(opt.link)) return 1;
+  fprintf(stderr, "[SIM] port : %s (vitesse %s)\n", sim::ptyName(),
+          sim::cfg.speed > 0 ? (sim::cfg.speed == 1 ? "temps réel" : "accélérée") : "max");
+  if (sim::cfg.udpPort) fprintf(stderr, "[SIM] lien hôte : UDP port %u\n", (unsigned)sim::cfg.udpPort);
+
+  fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+  sim::setIdleHook(pollStdin);
+  signal(SIGINT, [](int) { gStop = 1; });
+  signal(SIGTERM, [](int) { gStop = 1; });
+  signal(SIGTTIN, SIG_IGN);                   // lancé en arrière-plan : stdin → EIO, pas d'arrêt
+
+  timespec w0, w1;
+  clock_gettime(CLOCK_MONOTONIC, &w0);
+  const uint64_t stopUs = (uint64_t)(opt.seconds * 1e6);
+
+  setup();
+  while (!gStop && (!stopUs || sim::now() < stopUs)) {
+    loop();
+    sim::advance(sim::cfg.loopUs);
+    ++sim::stats.loops;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &w1);
+  const double wall = (w1.tv_sec - w0.tv_sec) + (w1.tv_nsec - w0.tv_nsec) * 1e-9;
+  const double virt = sim::now() * 1e-6;
+  if (!opt.quiet) {
+    const sim::Stats& s = sim::stats;
+    fprintf(stderr,
+            "[SIM] %.3f s virtuelles en %.3f s (×%.1f), %llu boucles (%.0f/s virtuelles)\n"
+            "[SIM] USB : %llu o émis, %llu o reçus, %llu o jetés ; UDP : %llu / %llu datagrammes ; MIDI émis : %llu\n",
+            virt, wall, wall > 0 ? virt / wall : 0.0, (unsigned long long)s.loops,
+            virt > 0 ? s.loops / virt : 0.0, (unsigned long long)s.usbTx, (unsigned long long)s.usbRx,
+            (unsigned long long)s.usbDropped, (unsigned long long)s.udpTx, (unsigned long long)s.udpRx,
+            (unsigned long long)s.midiOut);
+  }
+  sim::end();
+  return 0;
+}
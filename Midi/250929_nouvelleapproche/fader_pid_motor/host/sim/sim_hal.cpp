@@ -0,0 +1,503 @@
+// ========================== sim/sim_hal.cpp ==========================
+// Machine simulée : horloge virtuelle, broches, ADC, pty (voir sim_hal.h) ;
+// implémente le backend hôte de la HAL (hal_host.h)
+#include <Arduino.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <EEPROM.h>
+#include <Ethernet.h>
+#include <Control_Surface.h>
+
+#include <cerrno>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sim_hal.h"
+#include "pin_int.h"            // PicoBoard : curseurs, pistes tactiles, ponts en H
+
+SerialUSB        Serial;
+TwoWire          Wire;
+SPIClass         SPI, SPI1;
+EEPROMClass      EEPROM;
+EthernetClass    Ethernet;
+Control_Surface_ Control_Surface;
+
+namespace sim {
+
+Config cfg;
+Stats  stats;
+
+// ===================== ÉTAT =====================
+static uint64_t   nowUs = 0;
+static FaderPlant plants[MAX_FADERS];
+
+static HALGpio::Mode pinModes[SIM_NUM_PINS];
+static bool     pinLevel[SIM_NUM_PINS];
+static int8_t   pinForced[SIM_NUM_PINS];
+static uint64_t pinReleasedUs[SIM_NUM_PINS];   // tactile : passage en entrée (début de la charge RC)
+static uint8_t  adcBits = 10;
+static bool     keyDown[HAL_KEYSCAN_ROWS * HAL_KEYSCAN_COLS];
+static uint64_t keyChangedUs[HAL_KEYSCAN_ROWS * HAL_KEYSCAN_COLS];
+static volatile uint32_t keyFrame[HAL_KEYSCAN_ROWS];
+
+struct SimEncoder {
+  int32_t  count = 0;
+  int32_t  todo = 0;            // crans restants de la rotation en cours
+  uint32_t stepUs = 0;          // intervalle entre crans
+  uint64_t nextUs = 0;
+};
+static SimEncoder encoders[HAL_QUAD_CHANNELS];
+static uint8_t    nEncoders = 0;
+static uint32_t pwmRange = 255;
+
+static int      master = -1, slaveHold = -1;
+static char     slaveName[128];
+static const char* linkPath = nullptr;
+static uint8_t  txFifo[SIM_USB_FIFO];
+static size_t   txLen = 0;
+static float    txCredit = 0;
+static uint8_t  rxBuf[4096];
+static size_t   rxHead = 0, rxTail = 0;
+static uint64_t lastRxPollUs = 0;
+
+static uint64_t wallStartNs = 0;
+static uint64_t lastPaceUs = 0;
+static uint64_t lastHookUs = 0;
+static void   (*idleHook)() = nullptr;
+static void   (*midiHook)(uint8_t, uint8_t, uint8_t) = nullptr;
+
+static uint64_t wallNs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// ===================== pty =====================
+bool begin(const char* link) {
+  master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) { perror("posix_openpt"); return false; }
+  snprintf(slaveName, sizeof slaveName, "%s", ptsname(master));
+  fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+
+  // côté esclave gardé ouvert (pas de EIO sans client) et brut comme un CDC
+  slaveHold = open(slaveName, O_RDWR | O_NOCTTY);
+  if (slaveHold >= 0) {
+    termios tio;
+    tcgetattr(slaveHold, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slaveHold, TCSANOW, &tio);
+  }
+  if (link) {
+    unlink(link);
+    if (symlink(slaveName, link) != 0) perror(link);
+    else linkPath = link;
+  }
+
+  for (uint8_t p = 0; p < SIM_NUM_PINS; ++p) pinForced[p] = -1;
+  for (FaderPlant& f : plants) f.reset(cfg.startPct * FADER_TRAVEL_MM / 100.0f);
+  wallStartNs = wallNs();
+  return true;
+}
+
+const char* ptyName() { return linkPath ? linkPath : slaveName; }
+
+void end() {
+  if (linkPath) unlink(linkPath);
+  if (slaveHold >= 0) close(slaveHold);
+  if (master >= 0) close(master);
+  master = slaveHold = -1;
+}
+
+// FIFO TX → pty par paquets (crédit de débit USB)
+static void usbDrain(uint32_t dt) {
+  if (!txLen) { txCredit = 0; return; }
+  txCredit += dt * SIM_USB_BYTES_PER_US;
+  size_t n = (size_t)txCredit;
+  if (n < 64 && n < txLen) return;             // attend au moins un paquet USB plein
+  if (n > txLen) n = txLen;
+  const ssize_t w = write(master, txFifo, n);
+  if (w <= 0) return;                           // hôte ne lit pas : la FIFO reste pleine
+  memmove(txFifo, txFifo + w, txLen - (size_t)w);
+  txLen -= (size_t)w;
+  txCredit -= (float)w;
+  stats.usbTx += (uint64_t)w;
+}
+
+static void usbPollRx() {
+  if (nowUs - lastRxPollUs < SIM_RX_POLL_US) return;
+  lastRxPollUs = nowUs;
+  if (rxHead == rxTail) rxHead = rxTail = 0;
+  if (rxTail >= sizeof rxBuf) return;
+  const ssize_t n = read(master, rxBuf + rxTail, sizeof rxBuf - rxTail);
+  if (n > 0) { rxTail += (size_t)n; stats.usbRx += (uint64_t)n; }
+}
+
+// ===================== Temps =====================
+uint64_t now() { return nowUs; }
+
+static void pace() {
+  if (nowUs - lastHookUs >= 10000) {
+    lastHookUs = nowUs;
+    if (idleHook) idleHook();
+  }
+  if (cfg.speed <= 0 || nowUs - lastPaceUs < 1000) return;
+  lastPaceUs = nowUs;
+  const uint64_t target = wallStartNs + (uint64_t)(nowUs * 1000.0 / cfg.speed);
+  const uint64_t w = wallNs();
+  if (target > w + 1000000) {                   // > 1 ms d'avance : on attend
+    const uint64_t d = target - w;
+    timespec ts{(time_t)(d / 1000000000ull), (long)(d % 1000000000ull)};
+    nanosleep(&ts, nullptr);
+  }
+}
+
+void advance(uint32_t us) {
+  while (us) {
+    const uint32_t d = us < SIM_STEP_US ? us : SIM_STEP_US;
+    nowUs += d;
+    us -= d;
+    for (uint8_t i = 0; i < MAX_FADERS; ++i) plants[i].step(d);
+    usbDrain(d);
+    for (uint8_t e = 0; e < nEncoders; ++e) {
+      SimEncoder& q = encoders[e];
+      while (q.todo && nowUs >= q.nextUs) {
+        const int32_t dir = q.todo > 0 ? 1 : -1;
+        q.count += dir * SIM_ENC_COUNTS;
+        q.todo  -= dir;
+        q.nextUs += q.stepUs;
+      }
+    }
+  }
+  pace();
+}
+
+FaderPlant& plant(uint8_t i) { return plants[i < MAX_FADERS ? i : 0]; }
+
+void forcePin(uint8_t pin, int level) {
+  if (pin < SIM_NUM_PINS) pinForced[pin] = (int8_t)(level < 0 ? -1 : level != 0);
+}
+
+void key(uint16_t k, bool down) {
+  if (k >= HAL_KEYSCAN_ROWS * HAL_KEYSCAN_COLS || keyDown[k] == down) return;
+  keyDown[k] = down;
+  keyChangedUs[k] = nowUs;
+}
+
+void turn(uint8_t ch, int32_t detents, uint32_t ms) {
+  if (ch >= nEncoders || !detents) return;
+  SimEncoder& q = encoders[ch];
+  q.todo   = detents;
+  q.stepUs = (uint32_t)((uint64_t)ms * 1000 / (uint32_t)(detents < 0 ? -detents : detents));
+  q.nextUs = nowUs;
+}
+
+void setIdleHook(void (*fn)()) { idleHook = fn; }
+void setMidiHook(void (*fn)(uint8_t, uint8_t, uint8_t)) { midiHook = fn; }
+
+// ===================== Broches =====================
+static int faderOfAdcPin(uint8_t pin) {
+  for (uint8_t i = 0; i < MAX_FADERS; ++i) if (PicoBoard::ADC_PINS[i] == pin) return i;
+  return -1;
+}
+
+static int faderOfTouchPin(uint8_t pin) {
+  for (uint8_t i = 0; i < MAX_FADERS; ++i) if (PicoBoard::TOUCH_PINS[i] == pin) return i;
+  return -1;
+}
+
+// Broche moteur → entrée du pont en H du fader correspondant
+static BridgePin* bridgeOf(uint8_t pin) {
+  for (uint8_t i = 0; i < MAX_FADERS; ++i) {
+    if (PicoBoard::MOTOR_PINS[i][0] == pin) return &plants[i].in1;
+    if (PicoBoard::MOTOR_PINS[i][1] == pin) return &plants[i].in2;
+  }
+  return nullptr;
+}
+
+}  // namespace sim
+
+using namespace sim;
+
+// ===================== Backend hôte de la HAL (hal_host.h) =====================
+uint32_t HALTime::micros() { advance(SIM_CALL_US); return (uint32_t)nowUs; }
+uint32_t HALTime::millis() { advance(SIM_CALL_US); return (uint32_t)(nowUs / 1000); }
+void HALTime::delayMs(uint32_t ms) { advance(ms * 1000); }
+void HALTime::delayUs(uint32_t us) { advance(us); }
+
+void     HALCycles::begin() {}
+uint32_t HALCycles::now() { return (uint32_t)sim::wallNs(); }
+uint32_t HALCycles::hz() { return 1000000000u; }
+
+void HALGpio::mode(uint8_t pin, Mode m) {
+  if (pin >= SIM_NUM_PINS) return;
+  if (m != Output && pinModes[pin] == Output) pinReleasedUs[pin] = nowUs;
+  pinModes[pin] = m;
+}
+
+void HALGpio::write(uint8_t pin, bool level) {
+  if (pin >= SIM_NUM_PINS) return;
+  pinLevel[pin] = level;
+  if (BridgePin* b = bridgeOf(pin)) { b->pwm = false; b->duty = level ? 1.0f : 0.0f; }
+}
+
+bool HALGpio::read(uint8_t pin) {
+  if (pin >= SIM_NUM_PINS) return false;
+  if (pinForced[pin] >= 0) return pinForced[pin];
+  if (pinModes[pin] == Output) return pinLevel[pin];
+  const int f = faderOfTouchPin(pin);
+  if (f >= 0) {                                 // charge RC : plus longue avec le doigt
+    const uint32_t rise = SIM_TOUCH_RISE_US + (plants[f].touched() ? SIM_TOUCH_FINGER_US : 0);
+    return nowUs - pinReleasedUs[pin] >= rise;
+  }
+  return pinModes[pin] == InputPullup;
+}
+
+uint16_t HALAdc::read(uint8_t pin) {
+  advance(SIM_ADC_US);
+  const int f = faderOfAdcPin(pin);
+  return f < 0 ? 0 : plants[f].adc(adcBits);
+}
+
+void HALAdc::resolution(uint8_t bits) { adcBits = bits; }
+
+void HALPwm::write(uint8_t pin, uint16_t duty) {
+  if (pin >= SIM_NUM_PINS) return;
+  pinModes[pin] = HALGpio::Output;
+  if (BridgePin* b = bridgeOf(pin)) {
+    b->pwm = true;
+    b->duty = constrain((float)duty / (float)pwmRange, 0.0f, 1.0f);
+  }
+}
+
+void HALPwm::frequency(uint32_t) {}
+void HALPwm::range(uint32_t r) { pwmRange = r ? r : 255; }
+
+TwoWire& HALI2C::begin(uint8_t, uint8_t) { return Wire; }
+TwoWire& HALI2C::bus() { return Wire; }
+
+void HALSpi::pins(uint8_t, uint8_t, uint8_t) {}
+
+// ---------------- Lien hôte UDP : socket Linux (le "tampon du W5500" est udpTx) ----------------
+namespace {
+int         udpFd = -1;
+sockaddr_in udpPeer{};
+bool        udpHasPeer = false;
+uint8_t     udpTx[HAL_UDP_DGRAM_MAX];
+size_t      udpTxLen = 0;
+}
+
+bool HALUdp::begin(uint16_t port) {
+  if (udpFd >= 0) return true;
+  const int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  if (fd < 0) return false;
+  sockaddr_in a{};
+  a.sin_family      = AF_INET;
+  a.sin_addr.s_addr = htonl(INADDR_ANY);
+  a.sin_port        = htons(cfg.udpPort ? cfg.udpPort : port);
+  if (bind(fd, (const sockaddr*)&a, sizeof a) != 0) {
+    perror("[sim] UDP bind");
+    close(fd);
+    return false;
+  }
+  udpFd = fd;
+  return true;
+}
+
+size_t HALUdp::recv(uint8_t* buf, size_t max) {
+  if (udpFd < 0) return 0;
+  sockaddr_in from{};
+  socklen_t   fromLen = sizeof from;
+  const ssize_t n = recvfrom(udpFd, buf, max, MSG_TRUNC, (sockaddr*)&from, &fromLen);
+  if (n < 0) return 0;
+  udpPeer    = from;
+  udpHasPeer = true;
+  ++stats.udpRx;
+  return (size_t)n < max ? (size_t)n : max;
+}
+
+bool   HALUdp::hasPeer() { return udpHasPeer; }
+size_t HALUdp::room()    { return udpHasPeer ? sizeof udpTx - udpTxLen : 0; }
+
+size_t HALUdp::write(const uint8_t* buf, size_t n) {
+  if (n > room()) n = room();
+  memcpy(udpTx + udpTxLen, buf, n);
+  udpTxLen += n;
+  return n;
+}
+
+bool HALUdp::send() {
+  if (!udpTxLen) return true;
+  const ssize_t n = sendto(udpFd, udpTx, udpTxLen, 0, (const sockaddr*)&udpPeer, sizeof udpPeer);
+  udpTxLen = 0;
+  if (n < 0) return false;
+  ++stats.udpTx;
+  return true;
+}
+
+void   HALSerial::begin(uint32_t baud, uint32_t) { Serial.begin(baud); }   // pty toujours prêt
+int    HALSerial::available() { return Serial.available(); }
+int    HALSerial::read() { return Serial.read(); }
+int    HALSerial::availableForWrite() { return Serial.availableForWrite(); }
+size_t HALSerial::write(uint8_t b) { return Serial.write(b); }
+size_t HALSerial::write(const uint8_t* buf, size_t n) { return Serial.write(buf, n); }
+void   HALSerial::flush() { Serial.flush(); }
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// ===================== Print / Stream =====================
+size_t Print::printUnsigned(unsigned long long v, int base) {
+  char buf[65];
+  char* p = buf + sizeof buf;
+  if (base < 2) base = 10;
+  do { const int d = (int)(v % base); *--p = (char)(d < 10 ? '0' + d : 'A' + d - 10); v /= base; } while (v);
+  return write((const uint8_t*)p, (size_t)(buf + sizeof buf - p));
+}
+
+size_t Print::printSigned(long long v, int base) {
+  if (v < 0 && base == 10) return print('-') + printUnsigned((unsigned long long)-v, base);
+  return printUnsigned((unsigned long long)v, base);
+}
+
+size_t Print::print(double v, int digits) {
+  char buf[64];
+  snprintf(buf, sizeof buf, "%.*f", digits, v);
+  return write(buf);
+}
+
+size_t Stream::readBytes(uint8_t* buf, size_t n) {
+  size_t k = 0;
+  const uint64_t t0 = now();
+  while (k < n && now() - t0 < (uint64_t)timeoutMs * 1000) {
+    const int c = read();
+    if (c >= 0) buf[k++] = (uint8_t)c;
+    else advance(SIM_RX_POLL_US);
+  }
+  return k;
+}
+
+size_t SerialUSB::write(const uint8_t* buf, size_t n) {
+  if (master < 0) { stats.usbTx += n; return n; }   // pas de pty (banc hôte) : puits
+  size_t done = 0;
+  uint32_t waited = 0;
+  while (done < n) {
+    const size_t room = SIM_USB_FIFO - txLen;
+    if (!room) {
+      if (waited >= SIM_USB_TIMEOUT_US) {       // hôte absent : on jette (et le pty en attente)
+        stats.usbDropped += n - done + txLen;
+        txLen = 0;
+        if (slaveHold >= 0) tcflush(slaveHold, TCIFLUSH);
+        return n;
+      }
+      advance(10);
+      waited += 10;
+      continue;
+    }
+    const size_t k = n - done < room ? n - done : room;
+    memcpy(txFifo + txLen, buf + done, k);
+    txLen += k;
+    done += k;
+  }
+  return n;
+}
+
+int SerialUSB::availableForWrite() { return (int)(SIM_USB_FIFO - txLen); }
+
+void SerialUSB::flush() {
+  for (uint32_t w = 0; txLen && w < SIM_USB_TIMEOUT_US; w += 10) advance(10);
+}
+
+int SerialUSB::available() {
+  usbPollRx();
+  return (int)(rxTail - rxHead);
+}
+
+int SerialUSB::read() {
+  if (rxHead == rxTail) usbPollRx();
+  return rxHead < rxTail ? rxBuf[rxHead++] : -1;
+}
+
+int SerialUSB::peek() {
+  if (rxHead == rxTail) usbPollRx();
+  return rxHead < rxTail ? rxBuf[rxHead] : -1;
+}
+
+// ===================== OLED / EEPROM / MIDI =====================
+void simOledTransfer(size_t bytes, uint32_t clockHz) {
+  advance((uint32_t)(bytes * 9 * 1000000ull / (clockHz ? clockHz : 400000)));   // 8 bits + ACK
+}
+
+void EEPROMClass::begin(size_t size) {
+  len = size < sizeof data ? size : sizeof data;
+  memset(data, 0xFF, sizeof data);              // flash effacée
+  if (!cfg.eeprom) return;
+  if (FILE* f = fopen(cfg.eeprom, "rb")) {
+    if (fread(data, 1, len, f) == 0 && cfg.verbose) fprintf(stderr, "[SIM] EEPROM vide\n");
+    fclose(f);
+  }
+}
+
+// Matrice : colonne à 0 si la touche est enfoncée ; pendant cfg.keyBounceUs après un
+// changement, niveau pseudo-aléatoire (contact qui rebondit) toutes les 100 µs
+bool HALKeyScan::begin(uint8_t, uint8_t, uint8_t, uint32_t) { return true; }
+void HALKeyScan::service() {}
+
+const volatile uint32_t* HALKeyScan::frame() {
+  for (uint8_t r = 0; r < HAL_KEYSCAN_ROWS; ++r) {
+    uint32_t levels = 0xFFFF;
+    for (uint8_t c = 0; c < HAL_KEYSCAN_COLS; ++c) {
+      const uint16_t k = (uint16_t)(r * HAL_KEYSCAN_COLS + c);
+      bool down = keyDown[k];
+      if (keyChangedUs[k] && nowUs - keyChangedUs[k] < cfg.keyBounceUs) {
+        const uint64_t h = ((nowUs / 100) ^ k) * 0x9E3779B97F4A7C15ull;
+        down = (h >> 61) & 1;
+      }
+      if (down) levels &= ~(1u << c);
+    }
+    keyFrame[r] = levels;
+  }
+  return keyFrame;
+}
+
+int8_t HALQuadrature::begin(uint8_t, uint32_t) {
+  return nEncoders < HAL_QUAD_CHANNELS ? (int8_t)nEncoders++ : -1;
+}
+
+int32_t HALQuadrature::count(int8_t ch) { return encoders[ch].count; }
+
+bool   HALUart::begin(uint8_t, uint8_t, uint32_t) { return false; }
+size_t HALUart::read(uint8_t*, size_t)            { return 0; }
+bool   HALUart::write(const uint8_t*, size_t)     { return false; }
+void   HALUart::stampArm()                       {}
+bool   HALUart::stamp(uint32_t&)                  { return false; }
+
+bool EEPROMClass::commit() {
+  advance(5000);                                // effacement + écriture d'un secteur flash
+  if (!cfg.eeprom) return true;
+  FILE* f = fopen(cfg.eeprom, "wb");
+  if (!f) return false;
+  const bool ok = fwrite(data, 1, len, f) == len;
+  fclose(f);
+  return ok;
+}
+
+static void logMidi(const char* what, uint8_t st, uint8_t a, uint8_t ch, int v) {
+  ++stats.midiOut;
+  if (cfg.verbose) fprintf(stderr, "[SIM] MIDI %s ch%u %u %d\n", what, ch + 1, a, v);
+  if (midiHook) midiHook((uint8_t)(st | (st < 0xF0 ? ch : 0)), a, (uint8_t)(v < 0 ? 0 : v));
+}
+
+void MIDI_Interface::sendControlChange(MIDIAddress a, uint8_t v) { logMidi("CC", 0xB0, a.address, a.channel.getRaw(), v); }
+void MIDI_Interface::sendProgramChange(MIDIAddress a) { logMidi("PC", 0xC0, a.address, a.channel.getRaw(), -1); }
+void MIDI_Interface::sendNoteOn(MIDIAddress a, uint8_t v) { logMidi("NoteOn", 0x90, a.address, a.channel.getRaw(), v); }
+void MIDI_Interface::sendNoteOff(MIDIAddress a, uint8_t v) { logMidi("NoteOff", 0x80, a.address, a.channel.getRaw(), v); }
+void MIDI_Interface::sendSysEx(const uint8_t*, uint16_t len) {
+  logMidi("SysEx", 0xF0, (uint8_t)(len & 0x7F), 0, len >> 7);
+}
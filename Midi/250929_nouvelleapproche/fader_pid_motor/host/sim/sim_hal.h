@@ -0,0 +1,73 @@
+#pragma once
+// ========================== sim/sim_hal.h ==========================
+// HAL simulée de fader_sim : horloge virtuelle, broches → modèle de fader, CDC → pty.
+//
+// Horloge virtuelle (µs) : elle n'avance que par le firmware simulé
+//   - delay()/delayMicroseconds() : durée demandée
+//   - micros()/millis() : SIM_CALL_US par appel (les attentes actives se terminent)
+//   - analogRead() : SIM_ADC_US ; OLED display() : transfert I2C ; loop() : Config::loopUs
+// Cadence : speed = 1 → temps réel, 10 → 10× plus vite, 0 → au plus vite (pas d'attente).
+//
+// UDP (lien hôte, fader_sim -u) : vrai socket Linux non bloquant, hors horloge virtuelle.
+//
+// CDC : FIFO TX de SIM_USB_FIFO octets vidée vers le pty à SIM_USB_BYTES_PER_US
+// (Serial.availableForWrite() se comporte comme sur la carte : la télémétrie perd des
+// trames si l'hôte ne suit pas). Hôte absent (pty plein) → données jetées.
+#include <cstdint>
+#include "fader_plant.h"
+#include "fader_filtre_adc.h"   // MAX_FADERS
+
+// ===================== RÉGLAGES =====================
+constexpr uint32_t SIM_CALL_US          = 1;      // coût d'un appel micros()/millis()
+constexpr uint32_t SIM_ADC_US           = 2;      // conversion ADC RP2040 (500 kéch/s)
+constexpr uint32_t SIM_STEP_US          = 50;     // granularité de l'avance du temps
+constexpr uint32_t SIM_USB_FIFO         = 256;    // CFG_TUD_CDC_TX_BUFSIZE
+constexpr float    SIM_USB_BYTES_PER_US = 1.0f;   // ~1 Mo/s (USB full speed, bulk)
+constexpr uint32_t SIM_USB_TIMEOUT_US   = 100000; // Serial.write bloqué → octets jetés
+constexpr uint32_t SIM_RX_POLL_US       = 100;    // lecture du pty au plus toutes les 100 µs
+constexpr uint32_t SIM_TOUCH_RISE_US    = 25;     // RC 1 MΩ × pad seul
+constexpr uint32_t SIM_TOUCH_FINGER_US  = 120;    // + capacité du doigt
+constexpr uint32_t SIM_KEY_BOUNCE_US    = 2000;   // rebonds du contact après appui / relâché
+constexpr int32_t  SIM_ENC_COUNTS       = 4;      // comptes par cran (EC11, décodage ×4)
+
+namespace sim {
+
+struct Config {
+  double speed = 1.0;          // 0 = au plus vite
+  uint32_t loopUs = 10;        // coût d'un passage dans loop() hors appels simulés
+  float startPct = 0;          // position initiale des faders (%)
+  const char* eeprom = nullptr;
+  bool verbose = false;
+  uint16_t udpPort = 0;        // lien hôte en UDP sur ce port (0 = port demandé par le firmware)
+  uint32_t keyBounceUs = SIM_KEY_BOUNCE_US;  // rebonds des touches (0 = contact franc)
+};
+
+struct Stats {
+  uint64_t loops = 0;
+  uint64_t usbTx = 0, usbRx = 0, usbDropped = 0;
+  uint64_t udpTx = 0, udpRx = 0;            // datagrammes du lien hôte
+  uint64_t midiOut = 0;
+};
+
+extern Config cfg;
+extern Stats  stats;
+
+bool begin(const char* link);          // crée le pty (+ lien symbolique), modèles à startPct
+const char* ptyName();
+void end();
+
+uint64_t now();                        // µs virtuels depuis le démarrage
+void advance(uint32_t us);             // fait passer le temps : modèles, USB, cadence
+FaderPlant& plant(uint8_t i);
+void forcePin(uint8_t pin, int level); // entrée imposée (-1 : libre)
+void key(uint16_t k, bool down);       // touche k de la matrice (rangée k / 16, colonne k % 16)
+void turn(uint8_t ch, int32_t detents, uint32_t ms);  // encodeur : crans répartis sur ms (0 = d'un coup)
+
+// Appelé ~toutes les 10 ms virtuelles (commandes du simulateur sur stdin)
+void setIdleHook(void (*fn)());
+
+// Messages MIDI émis sur le port USB MIDI 1.0 (Control_Surface simulé) : statut, data1,
+// data2 (SysEx : statut 0xF0, longueur dans data1 / data2) — fader_tests
+void setMidiHook(void (*fn)(uint8_t status, uint8_t d1, uint8_t d2));
+
+}  // namespace sim
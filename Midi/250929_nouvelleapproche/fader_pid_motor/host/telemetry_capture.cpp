@@ -0,0 +1,329 @@
+// ========================== telemetry_capture.cpp ==========================
+// Outil Linux : capture haut débit des trames de télémétrie 'T' (telemetry.h) depuis
+// le port CDC du Pico, vers un fichier colonnaire mmap .fpcap (capture_file.h).
+// Remplace la boucle de lecture de Tuning.py (qui le lance si le binaire existe).
+//
+//   - lectures non bloquantes par blocs de 64 Kio (poll), aucun appel par octet
+//   - SLIP décodé sur place dans le tampon de lecture : pas de copie ni d'allocation
+//     par trame ; les trames autres que 'T' (ACK, texte) sont comptées et ignorées
+//   - stats en direct sur stderr (1/s) : échantillons/s, trames, Kio/s, trames perdues
+//     (trou de seq + pertes annoncées par la carte), erreurs CRC, trames invalides
+//   - le masque de faders est figé par la 1re trame ; les trames d'un autre masque
+//     sont comptées à part (changement de fader_idx pendant la capture)
+//   - colonnes : t_us puis f<N>.consigne / f<N>.mesure / f<N>.commande (int16) ;
+//     -m clé=valeur (répétable) ajoute des métadonnées (réglages PID, calibration…,
+//     Tuning.py les renseigne)
+//
+// Un fichier ordinaire à la place du port rejoue un flux enregistré (ex. cat /dev/ttyACM0 > flux.bin).
+// -d udp:IP[:port] lit le lien hôte UDP d'un module PoE (host_link.h) : le Pico répond au
+// dernier émetteur vu, on s'annonce (END seul) à l'ouverture puis toutes les secondes.
+//
+// Build : g++ -O2 -std=c++17 -I.. -o telemetry_capture telemetry_capture.cpp capture_file.cpp ../telemetry_codec.cpp
+// Usage : ./telemetry_capture [-d /dev/ttyACM0 | udp:IP[:port]] [-o capture.fpcap] [-t s] [-I s] [-m clé=valeur] [-q]
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "telemetry_codec.h"
+#include "capture_file.h"
+
+namespace {
+
+constexpr size_t READ_CHUNK = 64 * 1024;
+constexpr size_t MAX_FRAME  = 4096;          // trame SLIP plus longue → jetée
+constexpr size_t MAX_COLS   = 16 * 4;        // faders × champs
+constexpr size_t MAX_ROWS   = 255;           // n (uint8_t) échantillons par trame
+constexpr uint16_t UDP_PORT = 9100;          // = HOSTLINK_UDP_PORT (host_link.h)
+const char* const FIELD_NAMES[] = {"consigne", "mesure", "commande"};
+
+volatile sig_atomic_t gStop = 0;
+
+uint64_t nowUs(clockid_t clk = CLOCK_MONOTONIC) {
+  timespec ts;
+  clock_gettime(clk, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ull + (uint64_t)ts.tv_nsec / 1000;
+}
+
+struct Options {
+  const char* device = "/dev/ttyACM0";
+  const char* output = "capture.fpcap";
+  double seconds = 0;        // 0 = jusqu'à Ctrl-C
+  double idle = 0;           // arrêt après idle s sans trame 'T' (0 = jamais)
+  std::string meta;          // "clé=valeur\n"…
+  bool quiet = false;
+};
+
+struct Stats {
+  uint64_t bytes = 0, frames = 0, samples = 0;
+  uint64_t seqLost = 0, devDropped = 0, crcErrors = 0, invalid = 0;
+  uint64_t other = 0, oversize = 0, maskChanges = 0;
+};
+
+// ---------------- Capture ----------------
+struct Capture {
+  Options opt;
+  Stats st;
+  CaptureWriter out;
+  bool first = true;
+  uint16_t mask = 0;
+  uint16_t nextSeq = 0;
+  uint16_t lastDevDropped = 0;
+  uint32_t lastT = 0;          // déroulement des µs carte (32 → 64 bits)
+  uint64_t tHigh = 0;
+  uint64_t lastFrameUs = 0;
+  int16_t vals[MAX_ROWS * MAX_COLS];
+
+  bool openOutput(const TelemHeader& h) {
+    CapColumn cols[1 + MAX_COLS];
+    uint16_t n = 0;
+    cols[n++] = capColumn("t_us", CAP_U64);
+    for (uint8_t i = 0; i < 16; ++i) {
+      if (!(h.mask & (1u << i))) continue;
+      for (uint8_t k = 0; k < h.fields; ++k) {
+        char name[24];
+        snprintf(name, sizeof name, "f%u.%s", i, k < 3 ? FIELD_NAMES[k] : "champ");
+        cols[n++] = capColumn(name, CAP_I16, i, k);
+      }
+    }
+    CapInfo info;
+    info.mask        = h.mask;
+    info.fields      = h.fields;
+    info.periodUs    = h.period_us;
+    info.startUnixUs = nowUs(CLOCK_REALTIME);
+    char rate[48];
+    snprintf(rate, sizeof rate, "sample_rate_hz=%g\n", h.period_us ? 1e6 / h.period_us : 0.0);
+    return out.open(opt.output, cols, n, info,
+                    std::string("source=telemetry_capture\n") + rate + "device=" + opt.device + "\n" + opt.meta);
+  }
+
+  uint64_t unwrap(uint32_t t) {
+    if (!first && t < lastT && (lastT - t) > 0x80000000u) tHigh += 1ull << 32;
+    lastT = t;
+    return tHigh | t;
+  }
+
+  void onFrame(const uint8_t* p, size_t len) {
+    if (len == 0) return;
+    if (p[0] != 'T') { ++st.other; return; }   // TELEM_TAG (telemetry.h)
+    TelemHeader h;
+    bool crcError = false;
+    const uint8_t n = telemDecode(p, len, h, vals, sizeof vals / sizeof vals[0], &crcError);
+    if (!n) { ++(crcError ? st.crcErrors : st.invalid); return; }
+
+    if (first) {
+      mask = h.mask;
+      if (!openOutput(h)) { gStop = 1; return; }
+      if (!opt.quiet)
+        fprintf(stderr, "capture : masque 0x%04X, %u champ(s), %u µs → %s\n",
+                h.mask, h.fields, h.period_us, opt.output);
+    } else {
+      if (h.mask != mask) { ++st.maskChanges; return; }
+      st.seqLost += (uint16_t)(h.seq - nextSeq);
+      st.devDropped += (uint16_t)(h.dropped - lastDevDropped);
+    }
+    nextSeq = (uint16_t)(h.seq + 1);
+    lastDevDropped = h.dropped;
+
+    const size_t stride = (size_t)__builtin_popcount(h.mask) * h.fields;
+    for (uint8_t k = 0; k < n; ++k) {
+      const int16_t* v = vals + k * stride;
+      out.set(0, (int64_t)unwrap(h.t0_us + (uint32_t)k * h.period_us));
+      first = false;
+      for (size_t j = 0; j < stride; ++j) out.set((uint16_t)(j + 1), (int64_t)v[j]);
+      if (!out.commit()) { gStop = 1; return; }
+    }
+    ++st.frames;
+    st.samples += n;
+    lastFrameUs = nowUs();
+  }
+};
+
+// Décodage SLIP sur place : buf[0..w) = trame en cours (déjà déséchappée), les octets
+// lus sont écrits juste derrière puis compactés au fil de l'eau (w ≤ position de lecture).
+struct SlipInPlace {
+  uint8_t buf[MAX_FRAME + READ_CHUNK];
+  size_t  w = 0;
+  bool    esc = false;
+  bool    overflow = false;
+
+  uint8_t* tail() { return buf + w; }
+  size_t room() const { return sizeof buf - w; }
+
+  template <class Fn>
+  void feed(size_t n, Fn&& onFrame, uint64_t& oversize) {
+    const uint8_t* r = buf + w;
+    const uint8_t* end = r + n;
+    while (r < end) {
+      const uint8_t b = *r++;
+      if (b == 0xC0) {
+        if (overflow) ++oversize;
+        else if (w) onFrame(buf, w);
+        w = 0; esc = false; overflow = false;
+        continue;
+      }
+      if (esc) { esc = false; buf[w++] = b == 0xDC ? 0xC0 : b == 0xDD ? 0xDB : b; }
+      else if (b == 0xDB) esc = true;
+      else buf[w++] = b;
+      if (w > MAX_FRAME) { overflow = true; w = 0; }
+    }
+  }
+};
+
+bool configureTty(int fd) {
+  termios tio;
+  if (tcgetattr(fd, &tio) != 0) return false;   // pas un tty : fichier rejoué
+  cfmakeraw(&tio);
+  cfsetispeed(&tio, B1000000);                   // ignoré par le CDC, requis par certains pilotes
+  cfsetospeed(&tio, B1000000);
+  tio.c_cc[VMIN]  = 0;
+  tio.c_cc[VTIME] = 0;
+  tcsetattr(fd, TCSANOW, &tio);
+  tcflush(fd, TCIFLUSH);
+  return true;
+}
+
+// "IP[:port]" → socket UDP connecté au Pico (read() rend 1 datagramme), -1 si invalide
+int openUdp(const char* spec) {
+  char host[64];
+  const char* colon = strchr(spec, ':');
+  const size_t len = colon ? (size_t)(colon - spec) : strlen(spec);
+  if (!len || len >= sizeof host) return -1;
+  memcpy(host, spec, len);
+  host[len] = 0;
+  sockaddr_in a{};
+  a.sin_family = AF_INET;
+  a.sin_port   = htons(colon ? (uint16_t)atoi(colon + 1) : UDP_PORT);
+  if (inet_pton(AF_INET, host, &a.sin_addr) != 1) return -1;
+  const int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  if (fd < 0) return -1;
+  if (connect(fd, (const sockaddr*)&a, sizeof a) != 0) { close(fd); return -1; }
+  return fd;
+}
+
+void udpAnnounce(int fd) {
+  const uint8_t end = 0xC0;                  // ignoré par le décodeur SLIP de la carte
+  (void)!send(fd, &end, 1, 0);
+}
+
+void printStats(const Stats& s, const Stats& prev, double dt, bool final) {
+  fprintf(stderr, "%s%8.0f éch/s %6.0f trames/s %7.1f Kio/s | éch %llu  perdues %llu (carte %llu)"
+                  "  CRC %llu  invalides %llu  autres %llu%s",
+          final ? "" : "\r",
+          (s.samples - prev.samples) / dt, (s.frames - prev.frames) / dt,
+          (s.bytes - prev.bytes) / dt / 1024.0,
+          (unsigned long long)s.samples, (unsigned long long)s.seqLost,
+          (unsigned long long)s.devDropped, (unsigned long long)s.crcErrors,
+          (unsigned long long)s.invalid, (unsigned long long)s.other,
+          final ? "\n" : "   ");
+}
+
+void usage() {
+  fprintf(stderr, "usage : telemetry_capture [-d port] [-o fichier] [-t s] [-I s] [-m k=v] [-q]\n"
+                  "  -d port  : port CDC du Pico, flux enregistré ou udp:IP[:port] (défaut /dev/ttyACM0)\n"
+                  "  -o fich. : fichier de capture (défaut capture.fpcap)\n"
+                  "  -t s     : durée (défaut : jusqu'à Ctrl-C)\n"
+                  "  -I s     : arrêt après s secondes sans trame de télémétrie\n"
+                  "  -m k=v   : métadonnée enregistrée dans le fichier (répétable)\n"
+                  "  -q       : pas de stats en direct (résumé final seulement)\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  static Capture cap;
+  static SlipInPlace slip;
+  Options& opt = cap.opt;
+  int c;
+  while ((c = getopt(argc, argv, "d:o:t:I:m:qh")) != -1) {
+    switch (c) {
+      case 'd': opt.device = optarg; break;
+      case 'o': opt.output = optarg; break;
+      case 't': opt.seconds = atof(optarg); break;
+      case 'I': opt.idle = atof(optarg); break;
+      case 'm':
+        if (!strchr(optarg, '=') || strchr(optarg, '\n')) { usage(); return 1; }
+        opt.meta += optarg;
+        opt.meta += '\n';
+        break;
+      case 'q': opt.quiet = true; break;
+      default: usage(); return c == 'h' ? 0 : 1;
+    }
+  }
+
+  const bool udp = !strncmp(opt.device, "udp:", 4);
+  const int fd = udp ? openUdp(opt.device + 4) : open(opt.device, O_RDONLY | O_NOCTTY | O_NONBLOCK);
+  if (fd < 0) {
+    if (udp) fprintf(stderr, "%s : adresse invalide (udp:IP[:port])\n", opt.device);
+    else     perror(opt.device);
+    return 1;
+  }
+  const bool tty = udp || configureTty(fd);      // udp : attente comme un port
+  if (udp) udpAnnounce(fd);
+
+  signal(SIGINT, [](int) { gStop = 1; });
+  signal(SIGTERM, [](int) { gStop = 1; });
+
+  const uint64_t t0 = nowUs();
+  uint64_t lastStat = t0;
+  Stats prev;
+  cap.lastFrameUs = t0;
+  auto onFrame = [](const uint8_t* p, size_t len) { cap.onFrame(p, len); };
+
+  while (!gStop) {
+    const uint64_t now = nowUs();
+    if (opt.seconds > 0 && now - t0 >= (uint64_t)(opt.seconds * 1e6)) break;
+    if (opt.idle > 0 && now - cap.lastFrameUs >= (uint64_t)(opt.idle * 1e6)) break;
+    if (now - lastStat >= 1000000) {
+      if (!opt.quiet) printStats(cap.st, prev, (now - lastStat) * 1e-6, false);
+      if (udp) udpAnnounce(fd);
+      cap.out.flush();
+      prev = cap.st;
+      lastStat = now;
+    }
+
+    pollfd pfd{fd, POLLIN, 0};
+    if (tty && poll(&pfd, 1, 100) <= 0) continue;
+    const size_t want = slip.room() < READ_CHUNK ? slip.room() : READ_CHUNK;
+    const ssize_t n = read(fd, slip.tail(), want);
+    if (n < 0) {
+      if (errno == EAGAIN || errno == EINTR || (udp && errno == ECONNREFUSED)) continue;
+      perror("read");
+      break;
+    }
+    if (n == 0) {
+      if (udp) continue;                      // datagramme vide
+      if (!tty) break;                        // fin du flux rejoué
+      fprintf(stderr, "\nport fermé (carte débranchée ?)\n");
+      break;
+    }
+    cap.st.bytes += (uint64_t)n;
+    slip.feed((size_t)n, onFrame, cap.st.oversize);
+  }
+
+  const double dt = (nowUs() - t0) * 1e-6;
+  if (!opt.quiet) fputc('\n', stderr);
+  printStats(cap.st, Stats{}, dt > 0 ? dt : 1, true);
+  if (cap.st.maskChanges || cap.st.oversize)
+    fprintf(stderr, "trames ignorées : %llu autre masque, %llu trop longues\n",
+            (unsigned long long)cap.st.maskChanges, (unsigned long long)cap.st.oversize);
+  const uint64_t rows = cap.out.size();
+  cap.out.close();
+  close(fd);
+  if (!rows) { fprintf(stderr, "aucun échantillon capturé\n"); return 2; }
+  fprintf(stderr, "%llu échantillon(s) → %s\n", (unsigned long long)rows, opt.output);
+  return 0;
+}
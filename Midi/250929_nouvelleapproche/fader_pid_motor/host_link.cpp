@@ -0,0 +1,73 @@
+#include <Arduino.h>
+#include "hal.h"
+#include "host_link.h"
+#include "rtpmidi_eth.h"       // setupEthernet()
+
+uint8_t host_link_transport = HOSTLINK_TRANSPORT;
+
+// ===================== ÉTAT =====================
+static bool    udp     = false;
+static uint8_t rxBuf[HAL_UDP_DGRAM_MAX];     // datagramme reçu, lu octet par octet
+static size_t  rxLen   = 0, rxPos = 0;
+static size_t  txLen   = 0;                  // octets dans le datagramme en cours
+
+static constexpr uint8_t SLIP_END = 0xC0;
+
+// ===================== API =====================
+namespace HostLink {
+
+void begin(uint32_t baud, uint32_t waitMs) {
+  if (udp) return;                           // tuning + pont UMP : un seul socket
+  if (host_link_transport == HOSTLINK_UDP) {
+    setupEthernet();                         // sans effet sur l'hôte (socket Linux)
+    udp = HALUdp::begin(HOSTLINK_UDP_PORT);
+    if (udp) return;
+  }
+  HALSerial::begin(baud, waitMs);
+}
+
+bool overUdp() { return udp; }
+
+int available() {
+  if (!udp) return HALSerial::available();
+  if (rxPos >= rxLen) {
+    rxLen = HALUdp::recv(rxBuf, sizeof rxBuf);
+    rxPos = 0;
+  }
+  return (int)(rxLen - rxPos);
+}
+
+int read() {
+  if (!udp) return HALSerial::read();
+  return available() > 0 ? rxBuf[rxPos++] : -1;
+}
+
+int availableForWrite() {
+  return udp ? (int)HALUdp::room() : HALSerial::availableForWrite();
+}
+
+size_t write(uint8_t b) { return write(&b, 1); }
+
+// Datagramme émis au END qui ferme une trame (le END d'ouverture seul ne compte pas)
+// ou quand il est plein ; une trame plus longue que la place restante continue dans le suivant
+size_t write(const uint8_t* buf, size_t n) {
+  if (!udp) return HALSerial::write(buf, n);
+  size_t done = 0;
+  while (done < n) {
+    const size_t k = HALUdp::write(buf + done, n - done);
+    if (!k) break;                           // pas encore de pair
+    done  += k;
+    txLen += k;
+    if (!HALUdp::room()) flush();
+  }
+  if (done && buf[done - 1] == SLIP_END && txLen > 1) flush();
+  return done;
+}
+
+void flush() {
+  if (!udp) { HALSerial::flush(); return; }
+  HALUdp::send();
+  txLen = 0;
+}
+
+}  // namespace HostLink
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/*
+  Lien hôte : Tuning.py / capture (SLIP, télémétrie 'T'), protocole binaire
+  (host_protocol.h), pont UMP (midi_io.h). Même interface que HALSerial, transport choisi
+  au démarrage :
+    HOSTLINK_USB  CDC USB (HALSerial) — carte branchée au PC
+    HOSTLINK_UDP  UDP sur le W5500 (HALUdp, port HOSTLINK_UDP_PORT) — module PoE sur le
+                  chariot, réglage et suivi des faders sans câble USB ; repli sur l'USB si
+                  la puce est absente (ETH_ENABLE, rtpmidi_eth.h)
+
+  UDP : le flux SLIP est découpé en datagrammes. Les octets écrits vont directement dans le
+  tampon du socket ; le datagramme part au END qui ferme une trame (ou plein, ou flush()),
+  donc 1 trame SLIP = 1 datagramme en pratique. Réponse au dernier émetteur vu (comme
+  rtpmidi_eth / osc_eth) : avant le 1er datagramme reçu rien ne part, availableForWrite()
+  rend 0 et la télémétrie compte ses trames perdues.
+
+  Côté PC : "udp:IP[:port]" à la place du port série (python/SLIP.py open_port(),
+  FADER_PORT, host/telemetry_capture -d) ; sur Linux, fader_sim -u port sert le même lien
+  par un socket.
+*/
+
+// ===================== RÉGLAGES (tout en haut) =====================
+enum HostLinkTransport : uint8_t { HOSTLINK_USB, HOSTLINK_UDP };
+constexpr HostLinkTransport HOSTLINK_TRANSPORT = HOSTLINK_USB;
+constexpr uint16_t          HOSTLINK_UDP_PORT  = 9100;
+
+extern uint8_t host_link_transport;          // HOSTLINK_TRANSPORT au démarrage (fader_sim -u)
+
+// ===================== API (celle de HALSerial) =====================
+namespace HostLink {
+  void   begin(uint32_t baud, uint32_t waitMs = 0);   // baud / waitMs : USB seulement
+  bool   overUdp();                                   // transport effectif après begin()
+  int    available();
+  int    read();
+  int    availableForWrite();
+  size_t write(uint8_t b);
+  size_t write(const uint8_t* buf, size_t n);
+  void   flush();
+}
@@ -0,0 +1,308 @@
+#include <Arduino.h>
+#include "host_protocol.h"
+#include "crc16.h"
+#include "pid.h"
+#include "fader_filtre_adc.h"
+#include "fader_bank.h"
+#include "heap_guard.h"
+#include "scheduler.h"
+#include "hotpath_bench.h"
+#include "midi_io.h"
+#include "telemetry.h"
+#include "step_metrics.h"
+#include "gain_schedule.h"
+#include "debug.h"
+#include "bash_test_python.hpp"   // bash_test_mode, fader_idx
+
+// ===================== Table des paramètres =====================
+struct HpParamDesc {
+  uint8_t     id;
+  uint8_t     type;
+  uint8_t     flags;
+  float       min, max;
+  const char* name;
+};
+
+static const HpParamDesc PARAMS[] = {
+  { HP_P_KP,            HP_T_F32, HP_F_PER_FADER, 0,      1000,    "kp" },
+  { HP_P_KI,            HP_T_F32, HP_F_PER_FADER, 0,      10000,   "ki" },
+  { HP_P_KD,            HP_T_F32, HP_F_PER_FADER, 0,      100,     "kd" },
+  { HP_P_FC,            HP_T_F32, 0,              0,      500,     "fc" },
+  { HP_P_TS,            HP_T_F32, 0,              0.0001f, 0.1f,   "ts" },
+  { HP_P_MAX_OUT,       HP_T_F32, HP_F_PER_FADER, 0,      255,     "max_out" },
+  { HP_P_SETPOINT,      HP_T_I32, HP_F_PER_FADER, 0,      ADC_MAX, "setpoint" },
+  { HP_P_POSITION,      HP_T_I32, HP_F_PER_FADER | HP_F_READ_ONLY, 0, ADC_MAX, "position" },
+  { HP_P_OUTPUT,        HP_T_I32, HP_F_PER_FADER | HP_F_READ_ONLY, -255, 255, "output" },
+  { HP_P_MODE,          HP_T_I32, 0,              1,      2,       "mode" },
+  { HP_P_FADER_IDX,     HP_T_I32, 0,              0,      NUM_FADERS - 1, "fader_idx" },
+  { HP_P_TELEMETRY,     HP_T_I32, 0,              0,      1,       "telemetry" },
+  { HP_P_TELEM_CODEC,   HP_T_I32, 0,              TELEM_V_RAW, TELEM_V_DELTA, "telemetry_codec" },
+  { HP_P_STEP_METRICS,  HP_T_I32, 0,              0,      1,       "step_metrics" },
+  { HP_P_STEP_BAND,     HP_T_I32, 0,              1,      ADC_MAX, "step_band" },
+  { HP_P_GAIN_SCHEDULE, HP_T_I32, 0,              0,      1,       "gain_schedule" },
+  { HP_P_USABLE_MIN,    HP_T_I32, 0,              0,      ADC_MAX, "usable_min" },
+  { HP_P_USABLE_MAX,    HP_T_I32, 0,              0,      ADC_MAX, "usable_max" },
+  { HP_P_SNAP_LOW,      HP_T_I32, 0,              0,      ADC_MAX, "snap_low" },
+  { HP_P_SNAP_HIGH,     HP_T_I32, 0,              0,      ADC_MAX, "snap_high" },
+  { HP_P_DEADBAND,      HP_T_I32, 0,              0,      255,     "deadband" },
+  { HP_P_MIDI_CHANNEL,  HP_T_I32, 0,              1,      16,      "midi_channel" },
+  { HP_P_FADER_CC,      HP_T_I32, HP_F_PER_FADER, 0,      127,     "fader_cc" },
+  { HP_P_MIDI_INTERVAL, HP_T_I32, 0,              0,      100000,  "midi_interval_us" },
+  { HP_P_HEAP_ALLOCS,   HP_T_I32, HP_F_READ_ONLY, 0,      2147483647.0f, "heap_allocs" },
+};
+static constexpr uint8_t N_PARAMS = sizeof PARAMS / sizeof PARAMS[0];
+
+static const HpParamDesc* findParam(uint8_t id) {
+  for (const HpParamDesc& d : PARAMS) if (d.id == id) return &d;
+  return nullptr;
+}
+
+// valeur échangée : float ou int32 selon le type du paramètre
+union HpValue { float f; int32_t i; };
+
+// ===================== Lecture / écriture =====================
+static HpValue paramGet(uint8_t id, uint8_t k) {
+  HpValue v; v.i = 0;
+  const PID& pid = gBank.pid[k];            // k < NUM_FADERS (handleGetSet)
+  switch (id) {
+    case HP_P_KP:            v.f = pid.getKp(); break;
+    case HP_P_KI:            v.f = pid.getKi(); break;
+    case HP_P_KD:            v.f = pid.getKd(); break;
+    case HP_P_FC:            v.f = fc; break;
+    case HP_P_TS:            v.f = ts; break;
+    case HP_P_MAX_OUT:       v.f = pid.getMaxOutput(); break;
+    case HP_P_SETPOINT:      v.i = gBank.setpoint[k]; break;
+    case HP_P_POSITION:      v.i = gBank.position[k]; break;
+    case HP_P_OUTPUT:        v.i = gBank.drive[k]; break;
+    case HP_P_MODE:          v.i = bash_test_mode; break;
+    case HP_P_FADER_IDX:     v.i = fader_idx; break;
+    case HP_P_TELEMETRY:     v.i = on_telemetry; break;
+    case HP_P_TELEM_CODEC:   v.i = telemCodec(); break;
+    case HP_P_STEP_METRICS:  v.i = stepEnabled(); break;
+    case HP_P_STEP_BAND:     v.i = stepBand(); break;
+    case HP_P_GAIN_SCHEDULE: v.i = gsEnabled(); break;
+    case HP_P_USABLE_MIN:    v.i = gBank.calib.usableMin; break;
+    case HP_P_USABLE_MAX:    v.i = gBank.calib.usableMax; break;
+    case HP_P_SNAP_LOW:      v.i = gBank.calib.snapLow; break;
+    case HP_P_SNAP_HIGH:     v.i = gBank.calib.snapHigh; break;
+    case HP_P_DEADBAND:      v.i = gBank.calib.deadband; break;
+    case HP_P_MIDI_CHANNEL:  v.i = midi_channel; break;
+    case HP_P_FADER_CC:      v.i = midi_fader_cc[k]; break;
+    case HP_P_MIDI_INTERVAL: v.i = (int32_t)midi_out_interval_us; break;
+    case HP_P_HEAP_ALLOCS:   v.i = (int32_t)heapGuardViolations(); break;
+  }
+  return v;
+}
+
+// butées / snap : min < max contre la valeur déjà en place (sense() divise par l'écart)
+static bool calibConsistent(uint8_t id, int32_t v) {
+  const FaderCalib& c = gBank.calib;
+  switch (id) {
+    case HP_P_USABLE_MIN: return v < c.usableMax;
+    case HP_P_USABLE_MAX: return v > c.usableMin;
+    case HP_P_SNAP_LOW:   return v < c.snapHigh;
+    case HP_P_SNAP_HIGH:  return v > c.snapLow;
+  }
+  return true;
+}
+
+static void paramSet(uint8_t id, uint8_t k, HpValue v) {
+  PID& pid = gBank.pid[k];
+  switch (id) {
+    case HP_P_KP:  kp_python = v.f; pid.setKp(v.f); break;
+    case HP_P_KI:  ki_python = v.f; pid.setKi(v.f); break;
+    case HP_P_KD:  kd_python = v.f; pid.setKd(v.f); break;
+    case HP_P_FC:
+      fc = fc_python = v.f;
+      Faders::each([&](auto m) { gBank.pid[m].setEMACutoff(v.f); });
+      break;
+    case HP_P_TS:  ts_python = v.f; initial_PIDv(true); break;   // recrée les PID (gains python)
+    case HP_P_MAX_OUT:       pid.setMaxOutput(v.f); break;
+    case HP_P_SETPOINT:      gBank.setpoint[k] = (uint16_t)v.i; break;
+    case HP_P_MODE:          bash_test_mode = (uint8_t)v.i; break;
+    case HP_P_FADER_IDX:     fader_idx = (uint8_t)v.i; break;
+    case HP_P_TELEMETRY:     on_telemetry = v.i != 0; break;
+    case HP_P_TELEM_CODEC:   telemSetCodec((uint8_t)v.i); break;
+    case HP_P_STEP_METRICS:  stepSetEnabled(v.i != 0); break;
+    case HP_P_STEP_BAND:     stepSetBand((uint16_t)v.i); break;
+    case HP_P_GAIN_SCHEDULE: gsSetEnabled(v.i != 0); break;
+    case HP_P_USABLE_MIN:    gBank.calib.usableMin = (int16_t)v.i; break;
+    case HP_P_USABLE_MAX:    gBank.calib.usableMax = (int16_t)v.i; break;
+    case HP_P_SNAP_LOW:      gBank.calib.snapLow   = (int16_t)v.i; break;
+    case HP_P_SNAP_HIGH:     gBank.calib.snapHigh  = (int16_t)v.i; break;
+    case HP_P_DEADBAND:      gBank.calib.deadband  = (int16_t)v.i; break;
+    case HP_P_MIDI_CHANNEL:  midi_channel = (uint8_t)v.i; break;
+    case HP_P_FADER_CC:      midi_fader_cc[k] = (uint8_t)v.i; break;
+    case HP_P_MIDI_INTERVAL: midi_out_interval_us = (uint32_t)v.i; break;
+  }
+}
+
+// ===================== Émission =====================
+static uint8_t  lastReply[HP_MAX_FRAME];
+static uint8_t  lastReplyLen = 0;
+static uint8_t  lastSeq      = 0;
+static uint16_t lastCrc      = 0;
+static bool     haveLast     = false;
+
+static void reply(uint8_t msg, uint8_t seq, const uint8_t* payload, uint8_t n) {
+  uint8_t* f = lastReply;
+  f[0] = HP_MAGIC; f[1] = HP_VERSION; f[2] = msg; f[3] = seq;
+  memcpy(f + 4, payload, n);
+  const uint16_t crc = crc16_ccitt(f, 4u + n);
+  f[4 + n] = (uint8_t)crc;
+  f[5 + n] = (uint8_t)(crc >> 8);
+  lastReplyLen = (uint8_t)(6 + n);
+  telemWriteFrame(f, lastReplyLen);          // jamais au milieu d'une trame 'T' (telemetry.h)
+}
+
+static void ack(uint8_t seq, uint8_t req)                { reply(HP_ACK, seq, &req, 1); }
+static void nack(uint8_t seq, uint8_t req, HpError e)    { const uint8_t p[2] = { req, e }; reply(HP_NACK, seq, p, 2); }
+
+// ===================== Réception =====================
+bool hostProtoIsFrame(const uint8_t* data, uint16_t len) {
+  return len >= 1 && data[0] == HP_MAGIC;
+}
+
+static void handleGetSet(uint8_t msg, uint8_t seq, const uint8_t* p, uint8_t n) {
+  if (n < 2 || (msg == HP_SET && n < 7)) { nack(seq, msg, HP_ERR_LENGTH); return; }
+  const HpParamDesc* d = findParam(p[0]);
+  const uint8_t k = p[1];
+  if (!d)                                                   { nack(seq, msg, HP_ERR_BAD_PARAM); return; }
+  if ((d->flags & HP_F_PER_FADER) ? k >= NUM_FADERS : k != 0) { nack(seq, msg, HP_ERR_BAD_INDEX); return; }
+
+  if (msg == HP_GET) {
+    const HpValue v = paramGet(d->id, k);
+    uint8_t out[7] = { d->id, k, d->type };
+    memcpy(out + 3, &v, 4);                       // RP2040 = little-endian
+    reply(HP_VALUE, seq, out, sizeof out);
+    return;
+  }
+
+  if (d->flags & HP_F_READ_ONLY) { nack(seq, msg, HP_ERR_READ_ONLY); return; }
+  if (p[2] != d->type)           { nack(seq, msg, HP_ERR_TYPE); return; }
+  HpValue v;
+  memcpy(&v, p + 3, 4);
+  const float x = (d->type == HP_T_F32) ? v.f : (float)v.i;
+  if (!(x >= d->min && x <= d->max)) { nack(seq, msg, HP_ERR_RANGE); return; }  // NaN refusé
+  if (!calibConsistent(d->id, v.i))  { nack(seq, msg, HP_ERR_RANGE); return; }
+  paramSet(d->id, k, v);
+  ack(seq, msg);
+}
+
+// GSCHED_SET / GSCHED_GET : 1 cellule de la table de séquencement d'un fader
+static void handleGainSchedule(uint8_t msg, uint8_t seq, const uint8_t* p, uint8_t n) {
+  if (n < 2 || (msg == HP_GSCHED_SET && n < 14)) { nack(seq, msg, HP_ERR_LENGTH); return; }
+  const uint8_t k = p[0], cell = p[1];
+  if (k >= NUM_FADERS || cell >= GS_CELLS) { nack(seq, msg, HP_ERR_BAD_INDEX); return; }
+
+  if (msg == HP_GSCHED_GET) {
+    const GsGains& g = gsGet(k, cell);
+    const uint8_t  pos = cell % GS_POS, size = (cell / GS_POS) % GS_SIZES;
+    uint8_t out[20] = { k, cell, GS_CELLS, (uint8_t)(cell / (GS_POS * GS_SIZES)) };
+    memcpy(out + 4, &GS_SIZE_BP[size], 2);
+    memcpy(out + 6, &GS_POS_BP[pos], 2);
+    memcpy(out + 8, &g.kp, 4);
+    memcpy(out + 12, &g.ki, 4);
+    memcpy(out + 16, &g.kd, 4);
+    reply(HP_GSCHED_CELL, seq, out, sizeof out);
+    return;
+  }
+
+  GsGains g;
+  memcpy(&g.kp, p + 2, 4);
+  memcpy(&g.ki, p + 6, 4);
+  memcpy(&g.kd, p + 10, 4);
+  // mêmes bornes que les paramètres kp / ki / kd
+  const HpParamDesc *dp = findParam(HP_P_KP), *di = findParam(HP_P_KI), *dd = findParam(HP_P_KD);
+  if (!(g.kp >= dp->min && g.kp <= dp->max && g.ki >= di->min && g.ki <= di->max &&
+        g.kd >= dd->min && g.kd <= dd->max)) { nack(seq, msg, HP_ERR_RANGE); return; }   // NaN refusé
+  gsSet(k, cell, g);
+  ack(seq, msg);
+}
+
+void hostProtoHandle(const uint8_t* data, uint16_t len) {
+  if (len < 6) { nack(len >= 4 ? data[3] : 0, len >= 3 ? data[2] : 0, HP_ERR_LENGTH); return; }
+  const uint8_t  msg = data[2], seq = data[3];
+  const uint16_t crc = (uint16_t)(data[len - 2] | (data[len - 1] << 8));
+  if (crc16_ccitt(data, len - 2u) != crc) { nack(seq, msg, HP_ERR_CRC); return; }
+
+  // ré-émission de la même requête : on renvoie la même réponse sans ré-appliquer
+  if (haveLast && seq == lastSeq && crc == lastCrc) { telemWriteFrame(lastReply, lastReplyLen); return; }
+  haveLast = true; lastSeq = seq; lastCrc = crc;
+
+  if (data[1] != HP_VERSION) { nack(seq, msg, HP_ERR_VERSION); return; }
+  const uint8_t* p = data + 4;
+  const uint8_t  n = (uint8_t)(len - 6);
+
+  switch (msg) {
+    case HP_HELLO: {
+      if (n < 1 || p[0] != HP_VERSION) { nack(seq, msg, HP_ERR_VERSION); return; }
+      uint8_t out[8] = { HP_VERSION, NUM_FADERS, MAX_FADERS, N_PARAMS };
+      memcpy(out + 4, &HP_FW_VERSION, 4);
+      reply(HP_HELLO_REPLY, seq, out, sizeof out);
+      return;
+    }
+    case HP_GET:
+    case HP_SET:
+      handleGetSet(msg, seq, p, n);
+      return;
+    case HP_GSCHED_SET:
+    case HP_GSCHED_GET:
+      handleGainSchedule(msg, seq, p, n);
+      return;
+    case HP_DESCRIBE: {
+      if (n < 1)              { nack(seq, msg, HP_ERR_LENGTH); return; }
+      if (p[0] >= N_PARAMS)   { nack(seq, msg, HP_ERR_BAD_PARAM); return; }
+      const HpParamDesc& d = PARAMS[p[0]];
+      uint8_t out[HP_MAX_FRAME - 6];
+      out[0] = d.id; out[1] = d.type; out[2] = d.flags;
+      memcpy(out + 3, &d.min, 4);
+      memcpy(out + 7, &d.max, 4);
+      const size_t nl = strlen(d.name) + 1;
+      memcpy(out + 11, d.name, nl);
+      reply(HP_PARAM_DESC, seq, out, (uint8_t)(11 + nl));
+      return;
+    }
+    case HP_START:
+      if (n < 5 || p[0] >= NUM_FADERS) { nack(seq, msg, n < 5 ? HP_ERR_LENGTH : HP_ERR_BAD_INDEX); return; }
+      fader_idx = p[0];
+      bash_test_mode = 1;                 // profil local (bash_test_LOCAL.hpp)
+      ack(seq, msg);
+      return;
+    case HP_PING:
+      ack(seq, msg);
+      return;
+    case HP_SCHED: {
+      if (n < 1)                { nack(seq, msg, HP_ERR_LENGTH); return; }
+      if (p[0] >= schedCount()) { nack(seq, msg, HP_ERR_BAD_INDEX); return; }
+      const SchedTask&  t = schedTask(p[0]);
+      const SchedStats& s = t.stats;
+      const uint32_t f[9] = { t.periodUs, t.budgetUs, s.runs, s.runs ? s.minUs : 0, schedAvgUs(s),
+                              s.maxUs, s.maxLateUs, s.misses, s.overruns };
+      uint8_t out[HP_MAX_FRAME - 6];
+      out[0] = p[0]; out[1] = schedCount();
+      memcpy(out + 2, f, sizeof f);
+      size_t nl = strlen(t.name);
+      if (nl > SCHED_NAME_MAX) nl = SCHED_NAME_MAX;
+      memcpy(out + 2 + sizeof f, t.name, nl);
+      out[2 + sizeof f + nl] = 0;
+      reply(HP_SCHED_STATS, seq, out, (uint8_t)(2 + sizeof f + nl + 1));
+      return;
+    }
+    case HP_SCHED_RESET:
+      schedResetStats();
+      ack(seq, msg);
+      return;
+    case HP_BENCH: {
+      if (n < 2) { nack(seq, msg, HP_ERR_LENGTH); return; }
+      const uint16_t iters = (uint16_t)(p[0] | (p[1] << 8));
+      if (!iters) { nack(seq, msg, HP_ERR_RANGE); return; }
+      hotpathRun(iters, hotpathSendSlip);   // bloque la boucle : moteurs arrêtés pendant le banc
+      schedResetStats();                    // échéances manquées pendant le banc : sans objet
+      ack(seq, msg);
+      return;
+    }
+    default:
+      nack(seq, msg, HP_ERR_UNKNOWN_MSG);
+  }
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+
+/*
+  Protocole hôte binaire versionné (remplace les commandes 'p' 'i' 'd' 'c' 't' 's'
+  et les lignes String de comms.hpp) — côté hôte : python/hostproto.py
+
+  Trame (dans une trame SLIP, little-endian) :
+    [0] HP_MAGIC  [1] HP_VERSION  [2] id message  [3] seq  [4..n-3] charge  [n-2] CRC-16
+    CRC-16/CCITT-FALSE (crc16.h) sur [0..n-3]
+  - toute requête reçoit UNE réponse avec le même seq : ACK, NACK (code d'erreur) ou VALUE
+    → l'hôte peut enchaîner les commandes sans pause et apparier les réponses par seq
+  - trame corrompue (CRC) → NACK HP_ERR_CRC, rien n'est appliqué
+  - SET hors [min, max] → NACK HP_ERR_RANGE ; de même usable_min ≥ usable_max ou
+    snap_low ≥ snap_high (comparé à l'autre borne en place : changer l'ordre des SET
+    pour déplacer la plage au-delà de l'ancienne)
+  - même seq + même CRC que la requête précédente → réponse renvoyée sans ré-appliquer
+    (ré-émission de l'hôte après perte de la réponse)
+  - les anciennes commandes lettre restent acceptées (1er octet ≠ HP_MAGIC)
+
+  Messages (hôte → Pico) :
+    HELLO    01  [version hôte]                      → HELLO_REPLY 81
+    GET      02  [param] [index]                     → VALUE 82 [param][index][type][valeur 4 o]
+    SET      03  [param] [index] [type] [valeur 4 o] → ACK 80 / NACK 7F
+    DESCRIBE 04  [rang 0..n-1]                       → PARAM_DESC 84 (énumération de la table)
+    START    05  [fader] [f32 réservé]               → ACK (profil local, ex-commande 's')
+    PING     06                                      → ACK
+    SCHED    07  [rang 0..n-1]                       → SCHED_STATS 87 (tâches de scheduler.h)
+    SCHED_RESET 08                                   → ACK (remet les statistiques à zéro)
+    BENCH    09  [itérations u16]                    → trames 'H' (hotpath_bench.h) puis ACK
+    GSCHED_SET 0A [fader][cellule][kp f32][ki f32][kd f32] → ACK (gain_schedule.h)
+    GSCHED_GET 0B [fader][cellule]                   → GSCHED_CELL 8B
+  Réponses :
+    ACK 80 [id requête]   NACK 7F [id requête][code]
+    HELLO_REPLY 81 [version][NUM_FADERS][MAX_FADERS][nb params][version firmware u32]
+    PARAM_DESC  84 [param][type][flags][min f32][max f32][nom\0]
+    SCHED_STATS 87 [rang][nb tâches] puis u32 : [période µs][budget µs][exécutions]
+                   [durée min][moy][max µs][retard max µs][échéances manquées][dépassements] [nom\0]
+    GSCHED_CELL 8B [fader][cellule][nb cellules][sens][taille u16][position u16][kp][ki][kd f32]
+                   (sens / taille / position : points GS_SIZE_BP / GS_POS_BP de la cellule)
+*/
+
+// ===================== RÉGLAGES =====================
+constexpr uint8_t  HP_MAGIC      = 0xA5;      // ≠ lettres ASCII, 'U' (UMP), 'T' (télémétrie)
+constexpr uint8_t  HP_VERSION    = 1;
+constexpr uint32_t HP_FW_VERSION = 0x00010000; // 1.0.0
+constexpr uint8_t  HP_MAX_FRAME  = 64;
+
+enum HpMsg : uint8_t {
+  HP_HELLO = 0x01, HP_GET = 0x02, HP_SET = 0x03, HP_DESCRIBE = 0x04, HP_START = 0x05, HP_PING = 0x06,
+  HP_SCHED = 0x07, HP_SCHED_RESET = 0x08, HP_BENCH = 0x09, HP_GSCHED_SET = 0x0A, HP_GSCHED_GET = 0x0B,
+  HP_NACK = 0x7F, HP_ACK = 0x80, HP_HELLO_REPLY = 0x81, HP_VALUE = 0x82, HP_PARAM_DESC = 0x84,
+  HP_SCHED_STATS = 0x87, HP_GSCHED_CELL = 0x8B,
+};
+
+enum HpError : uint8_t {
+  HP_ERR_CRC = 1, HP_ERR_VERSION = 2, HP_ERR_UNKNOWN_MSG = 3, HP_ERR_LENGTH = 4,
+  HP_ERR_BAD_PARAM = 5, HP_ERR_BAD_INDEX = 6, HP_ERR_RANGE = 7, HP_ERR_READ_ONLY = 8, HP_ERR_TYPE = 9,
+};
+
+enum HpType : uint8_t { HP_T_F32 = 'f', HP_T_I32 = 'i' };
+
+// flags de PARAM_DESC
+constexpr uint8_t HP_F_PER_FADER = 0x01;   // index = n° de fader
+constexpr uint8_t HP_F_READ_ONLY = 0x02;
+
+// Paramètres
+enum HpParam : uint8_t {
+  HP_P_KP = 0x01, HP_P_KI = 0x02, HP_P_KD = 0x03, HP_P_FC = 0x04, HP_P_TS = 0x05,
+  HP_P_MAX_OUT = 0x06, HP_P_SETPOINT = 0x07, HP_P_POSITION = 0x08, HP_P_OUTPUT = 0x09,
+  HP_P_MODE = 0x10, HP_P_FADER_IDX = 0x11, HP_P_TELEMETRY = 0x12, HP_P_TELEM_CODEC = 0x13,
+  HP_P_STEP_METRICS = 0x14, HP_P_STEP_BAND = 0x15, HP_P_GAIN_SCHEDULE = 0x16,
+  HP_P_USABLE_MIN = 0x20, HP_P_USABLE_MAX = 0x21, HP_P_SNAP_LOW = 0x22, HP_P_SNAP_HIGH = 0x23,
+  HP_P_DEADBAND = 0x24,
+  HP_P_MIDI_CHANNEL = 0x30, HP_P_FADER_CC = 0x31, HP_P_MIDI_INTERVAL = 0x32,
+  HP_P_HEAP_ALLOCS = 0x40,
+};
+
+// ===================== API =====================
+bool hostProtoIsFrame(const uint8_t* data, uint16_t len);  // 1er octet = HP_MAGIC
+void hostProtoHandle(const uint8_t* data, uint16_t len);   // trame SLIP décodée → réponse SLIP
@@ -0,0 +1,171 @@
+#include <Arduino.h>
+#include <cstring>
+#include "hal.h"
+#include "hotpath_bench.h"
+#include "fader_bank.h"
+#include "gain_schedule.h"
+#include "display.h"
+#include "crc16.h"
+#include "bash_test_python.hpp"   // slipWrite / slipWriteFloats
+
+// ===================== PILE =====================
+static constexpr uint8_t STACK_PAINT = 0xA5;
+
+#ifdef ARDUINO
+extern "C" uint8_t __StackBottom;    // bas de la pile du cœur 0 (script d'édition de liens pico-sdk)
+#endif
+
+static inline uintptr_t stackPointer() {
+  uintptr_t sp = 0;
+#if defined(__arm__) || defined(__aarch64__)
+  asm volatile("mov %0, sp" : "=r"(sp));
+#elif defined(__x86_64__)
+  asm volatile("mov %%rsp, %0" : "=r"(sp));
+#endif
+  return sp;
+}
+
+// ===================== CAS =====================
+// entrées déterministes : triangle ±512 autour du milieu de course
+static inline int16_t tri(uint16_t k) {
+  const int16_t p = (int16_t)((k * 37u) & 2047u);
+  return (int16_t)(p < 1024 ? p - 512 : 1535 - p);
+}
+
+static volatile int32_t sink;        // empêche l'optimiseur de supprimer les appels
+static PID     benchPid;             // copie des gains : le PID du fader 0 n'est pas touché
+static GainScheduler benchSched;     // table à part : celles des faders ne sont pas touchées
+static uint8_t crcBuf[64];
+static float   slipVals[4];
+
+constexpr int16_t BENCH_DRIVE = 20;  // sous le seuil de décollage : le fader ne bouge pas
+
+static void motorsIdle() {
+  Faders::each([](auto i) { gBank.drive[i] = 0; gBank.actuate(i); });
+}
+
+static void prepPid() {
+  benchPid = PID(kp, ki, kd, ts, fc, 255.0f);
+  benchPid.setSetpoint(ADC_MAX / 2);
+}
+
+static void prepSched() {
+  prepPid();
+  for (uint8_t c = 0; c < GS_CELLS; ++c) benchSched.set(c, { kp * (1 + c * 0.05f), ki, kd * (1 + c * 0.02f) });
+  benchSched.restart();
+}
+
+static void prepCrc() {
+  for (uint8_t k = 0; k < sizeof crcBuf; ++k) crcBuf[k] = (uint8_t)(k * 29u + 7u);
+}
+
+static void caseTimer(uint16_t)        {}
+static void casePid(uint16_t k)        { sink = (int32_t)benchPid.update((uint16_t)(ADC_MAX / 2 + tri(k))); }
+// consigne qui saute tous les 64 appels (taille relevée), position qui parcourt les zones
+static void caseSched(uint16_t k) {
+  benchSched.apply(benchPid, (uint16_t)((k >> 6) * 997u & ADC_MAX), (uint16_t)(ADC_MAX / 2 + 4 * tri(k)));
+}
+static void caseAdc(uint16_t)          { sink = HALAdc::read(PicoBoard::ADC_PINS[0]); }
+static void caseSense(uint16_t)        { gBank.sense(0); }
+static void caseTouch(uint16_t)        { sink = gBank.touch(0); }
+static void caseCrc(uint16_t)          { sink = crc16_ccitt(crcBuf, sizeof crcBuf); }
+static void caseOled(uint16_t k)       { drawOLED((k * 41) & ADC_MAX); }
+
+static void caseActuate(uint16_t k) {
+  gBank.drive[0] = (k & 2) ? ((k & 1) ? BENCH_DRIVE : -BENCH_DRIVE) : 0;
+  gBank.actuate(0);
+}
+
+static void caseSlip(uint16_t k) {
+  slipVals[0] = k * 0.001f; slipVals[1] = ADC_MAX / 2; slipVals[2] = (float)(ADC_MAX / 2 + tri(k)); slipVals[3] = tri(k) * 0.1f;
+  slipWriteFloats(slipVals, 4);
+}
+
+struct HotpathCase {
+  const char* name;
+  void      (*prep)();
+  void      (*fn)(uint16_t k);
+  uint16_t    maxIters;               // cas lents ou bruyants (I2C, USB, RC) : plafonnés
+};
+
+static const HotpathCase CASES[] = {
+  { "timer",         nullptr,    caseTimer,   0xFFFF },   // coût de la mesure (retiré des autres)
+  { "pid_update",    prepPid,    casePid,     0xFFFF },
+  { "gain_sched",    prepSched,  caseSched,   0xFFFF },   // GainScheduler::apply, sans update
+  { "adc_read",      nullptr,    caseAdc,     0xFFFF },
+  { "fader_sense",   nullptr,    caseSense,   0xFFFF },   // FilteredAnalog::update + calibration
+  { "motor_actuate", motorsIdle, caseActuate, 0xFFFF },
+  { "touch",         nullptr,    caseTouch,   64 },
+  { "crc16_64",      prepCrc,    caseCrc,     0xFFFF },
+  { "slip_floats",   nullptr,    caseSlip,    256 },
+  { "draw_oled",     nullptr,    caseOled,    16 },
+};
+static constexpr uint8_t N_CASES = sizeof CASES / sizeof CASES[0];
+
+// ===================== EXÉCUTION =====================
+// noinline : la pile peinte commence sous le cadre de cette fonction
+__attribute__((noinline))
+static void runCase(const HotpathCase& c, uint16_t iters, uint32_t overhead, HotpathResult& r) {
+  uint8_t* hi = (uint8_t*)stackPointer();
+  uint8_t* lo = hi ? hi - HOTPATH_STACK_PROBE : nullptr;
+#ifdef ARDUINO
+  if (lo < &__StackBottom + 16) lo = &__StackBottom + 16;
+#endif
+  for (volatile uint8_t* p = lo; p < hi; ++p) *p = STACK_PAINT;
+
+  uint32_t mn = UINT32_MAX, mx = 0;
+  uint64_t sum = 0;
+  for (uint16_t k = 0; k < iters; ++k) {
+    const uint32_t t0 = HALCycles::now();
+    c.fn(k);
+    uint32_t dt = HALCycles::elapsed(t0, HALCycles::now());
+    dt = dt > overhead ? dt - overhead : 0;
+    if (dt < mn) mn = dt;
+    if (dt > mx) mx = dt;
+    sum += dt;
+  }
+
+  const volatile uint8_t* q = lo;
+  while (q < hi && *q == STACK_PAINT) ++q;
+
+  r.name        = c.name;
+  r.iters       = iters;
+  r.minTicks    = iters ? mn : 0;
+  r.avgTicks    = iters ? (uint32_t)(sum / iters) : 0;
+  r.maxTicks    = mx;
+  r.stackBytes  = (uint32_t)(hi - q);
+  r.ticksPerSec = HALCycles::hz();
+}
+
+void hotpathRun(uint16_t iters, HotpathReport report) {
+  telemFlush();        // banc bloquant (pas de telemPoll) : trame 'T' et file parties avant les trames 'H'
+  HALCycles::begin();
+  motorsIdle();
+  uint32_t overhead = 0;
+  for (uint8_t k = 0; k < N_CASES; ++k) {
+    const HotpathCase& c = CASES[k];
+    if (c.prep) c.prep();
+    HotpathResult r;
+    runCase(c, iters < c.maxIters ? iters : c.maxIters, overhead, r);
+    if (k == 0) overhead = r.minTicks;
+    motorsIdle();
+    if (report) report(k, N_CASES, r);
+  }
+}
+
+// ===================== ÉMISSION =====================
+void hotpathSendSlip(uint8_t rank, uint8_t count, const HotpathResult& r) {
+  uint8_t f[28 + 24 + 2];
+  f[0] = HOTPATH_TAG; f[1] = HOTPATH_VERSION; f[2] = rank; f[3] = count;
+  const uint32_t v[6] = { r.iters, r.minTicks, r.avgTicks, r.maxTicks, r.stackBytes, r.ticksPerSec };
+  memcpy(f + 4, v, sizeof v);                       // RP2040 = little-endian
+  size_t nl = strlen(r.name);
+  if (nl > 23) nl = 23;
+  memcpy(f + 28, r.name, nl);
+  f[28 + nl] = 0;
+  size_t n = 28 + nl + 1;
+  const uint16_t crc = crc16_ccitt(f, n);
+  f[n++] = (uint8_t)crc;
+  f[n++] = (uint8_t)(crc >> 8);
+  slipWrite(f, n);
+}
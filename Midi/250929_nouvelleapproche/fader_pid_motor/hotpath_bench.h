@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+
+/*
+  Micro-benchmarks des chemins chauds (cycles par appel + pile consommée)
+  Déclenché par le protocole hôte (HP_BENCH, host_protocol.h) ; hôte : python/bench_hotpath.py
+  Même suite sur Linux : host/hotpath_bench.cpp (build CMake, cible hotpath_bench)
+
+  - chaque cas appelle sa fonction N fois avec des entrées déterministes (rampe,
+    triangle) ; chaque appel est chronométré avec HALCycles (SysTick sur la carte,
+    ns CLOCK_MONOTONIC sur l'hôte) ; le coût de la mesure seule (cas "timer") est
+    retiré de min / moy / max
+  - pile : la zone sous le pointeur de pile est peinte avant le cas, la marque la plus
+    basse atteinte donne la pile consommée par l'appel le plus profond (octets)
+  - sur la carte : moteurs arrêtés pendant le banc (la boucle de régulation est
+    bloquée), statistiques de l'ordonnanceur remises à zéro ensuite
+
+  Trame résultat (SLIP, little-endian), une par cas :
+    [0] 'H'  [1] HOTPATH_VERSION  [2] rang  [3] nb de cas
+    [4] itérations u32  [8] min u32  [12] moy u32  [16] max u32   (ticks HALCycles)
+    [20] pile u32 (octets)  [24] ticks par seconde u32  [28] nom\0  [fin] CRC-16/CCITT
+*/
+
+// ===================== RÉGLAGES =====================
+constexpr uint8_t  HOTPATH_TAG         = 'H';
+constexpr uint8_t  HOTPATH_VERSION     = 1;
+constexpr uint16_t HOTPATH_STACK_PROBE = 1024;   // octets peints sous le pointeur de pile
+
+struct HotpathResult {
+  const char* name;
+  uint32_t    iters;
+  uint32_t    minTicks, avgTicks, maxTicks;
+  uint32_t    stackBytes;
+  uint32_t    ticksPerSec;
+};
+
+typedef void (*HotpathReport)(uint8_t rank, uint8_t count, const HotpathResult& r);
+
+// ===================== API =====================
+void hotpathRun(uint16_t iters, HotpathReport report);   // tous les cas, dans l'ordre
+void hotpathSendSlip(uint8_t rank, uint8_t count, const HotpathResult& r);  // report → trame 'H'
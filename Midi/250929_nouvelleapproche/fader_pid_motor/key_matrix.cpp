@@ -0,0 +1,94 @@
+#include <Arduino.h>
+#include "hal.h"
+#include "key_matrix.h"
+#include "pin_int.h"
+#include "midi_io.h"
+
+// ===================== ÉTAT =====================
+// 2 rangées de 16 colonnes par mot : bit (r & 1) × 16 + c du mot r / 2 = touche r × 16 + c
+static constexpr uint8_t KEY_WORDS = (KEY_ROWS + 1) / 2;
+
+static bool     active = false;
+static uint32_t stable[KEY_WORDS];        // 1 = enfoncée
+static uint32_t cnt0[KEY_WORDS];          // compteurs verticaux : bit 0 …
+static uint32_t cnt1[KEY_WORDS];          // … et bit 1, une touche par colonne de bits
+static uint32_t validMask[KEY_WORDS];     // positions câblées (k < KEY_COUNT)
+
+static KeyEvent queue[KEY_QUEUE_LEN];
+static uint8_t  qHead = 0, qTail = 0;
+static uint32_t dropped = 0;
+
+static void push(uint8_t k, bool pressed, uint32_t now_us) {
+  if ((uint8_t)(qHead - qTail) >= KEY_QUEUE_LEN) { ++dropped; return; }
+  queue[qHead++ & (KEY_QUEUE_LEN - 1)] = KeyEvent{ k, pressed, now_us };
+}
+
+// ===================== BALAYAGE =====================
+bool setupKeys() {
+  if (!KEYS_ENABLE) return false;
+  for (uint8_t w = 0; w < KEY_WORDS; ++w) {
+    validMask[w] = 0;
+    for (uint8_t b = 0; b < 32; ++b) if (w * 32u + b < KEY_COUNT) validMask[w] |= 1u << b;
+  }
+  active = HALKeyScan::begin(PicoBoard::KEY_SER, PicoBoard::KEY_QH, PicoBoard::KEY_CLK, KEY_SCAN_HZ);
+  return active;
+}
+
+void keysScan(uint32_t now_us) {
+  if (!active) return;
+  HALKeyScan::service();
+  const volatile uint32_t* f = HALKeyScan::frame();
+
+  for (uint8_t w = 0; w < KEY_WORDS; ++w) {
+    const uint8_t  r   = (uint8_t)(2 * w);
+    const uint32_t lo  = ~f[r] & 0xFFFFu;                                   // actif bas
+    const uint32_t hi  = r + 1 < KEY_ROWS ? ~f[r + 1] & 0xFFFFu : 0;
+    const uint32_t raw = (lo | hi << 16) & validMask[w];
+
+    const uint32_t delta = raw ^ stable[w];
+    uint32_t c0 = cnt0[w], c1 = cnt1[w];
+    if (!(delta | c0 | c1)) continue;
+
+    // +1 là où la touche diffère de l'état stable, -1 (saturé à 0) ailleurs
+    const uint32_t n0 = ~c0 & (delta | c1);
+    const uint32_t n1 = (delta & (c1 ^ c0)) | (~delta & c1 & c0);
+    c0 = n0; c1 = n1;
+
+    uint32_t toggle = delta;
+    if (KEY_DEBOUNCE_COUNT & 1) toggle &= c0; else toggle &= ~c0;
+    if (KEY_DEBOUNCE_COUNT & 2) toggle &= c1; else toggle &= ~c1;
+    cnt0[w] = c0 & ~toggle;
+    cnt1[w] = c1 & ~toggle;
+    if (!toggle) continue;
+
+    stable[w] ^= toggle;
+    for (uint32_t t = toggle; t; t &= t - 1) {
+      const uint8_t b = (uint8_t)__builtin_ctz(t);
+      push((uint8_t)(w * 32 + b), (stable[w] >> b) & 1u, now_us);
+    }
+  }
+}
+
+bool keysPop(KeyEvent& ev) {
+  if (qTail == qHead) return false;
+  ev = queue[qTail++ & (KEY_QUEUE_LEN - 1)];
+  return true;
+}
+
+bool keyIsDown(uint8_t k) {
+  return k < KEY_COUNT && ((stable[k / 32] >> (k % 32)) & 1u);
+}
+
+uint32_t keysDropped() { return dropped; }
+
+// ===================== ÉMISSION =====================
+void loopKeys(uint32_t now_us) {
+  keysScan(now_us);
+  KeyEvent ev;
+  uint8_t n = 0;
+  while (keysPop(ev)) {
+    MIDIIO_sendNote(keyChannel(ev.key), keyNote(ev.key), ev.pressed ? KEY_NOTE_VELOCITY : 0);
+    ++n;
+  }
+  if (n) MIDIIO_sendNow();
+}
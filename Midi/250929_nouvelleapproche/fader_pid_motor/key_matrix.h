@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include "hal.h"              // HAL_KEYSCAN_ROWS / HAL_KEYSCAN_COLS
+
+/*
+  Matrice de touches mécaniques (module 166 touches, README)
+  Matériel (Materiel/Clavier_Pico_MIDI_166B_Composants.txt) :
+    - 2× 74HC595 → 11 rangées (actives à 0), diode 1N4148 par touche (pas de fantômes)
+    - 2× 74HC165 ← 16 colonnes, rappel 10 kΩ (RN8) au 3V3
+    - broches : PicoBoard::KEY_SER / KEY_QH / KEY_CLK / KEY_LATCH (pin_int.h)
+  Touche k = rangée × 16 + colonne, k < KEY_COUNT
+
+  Chaîne appui → MIDI :
+    1) balayage : HALKeyScan (RP2040 : PIO + DMA, aucun CPU), KEY_SCAN_HZ trames / s ;
+       l'image des colonnes est en RAM en continu
+    2) anti-rebond intégrateur (tâche "keys", KEY_TASK_HZ) sur des mots de 32 touches :
+       diff = trame XOR état stable ; compteurs verticaux 2 bits par touche, +1 si la
+       touche diffère, -1 sinon ; bascule à KEY_DEBOUNCE_COUNT ; mot sans diff ni
+       compteur en cours = un seul test
+    3) événements {touche, appui / relâché, t_us} dans une file circulaire (sans tas)
+    4) la même tâche vide la file → Note On / Note Off USB MIDI 1.0, 1 transfert par passage
+
+  Latence appui → MIDI (contact franc) : ≤ 1 trame (0,5 ms) + 3 échantillons à 1 kHz
+  (2 à 3 ms) + transfert USB (1 ms) ≈ 4,5 ms au pire
+  Notes : 166 > 128 → touches 0..127 sur KEY_MIDI_CHANNEL, 128..165 sur le canal suivant
+*/
+
+// ===================== RÉGLAGES (tout en haut) =====================
+constexpr bool     KEYS_ENABLE        = true;   // sans 165 câblé : QH tiré à 1, aucune touche
+constexpr uint8_t  KEY_ROWS           = 11;
+constexpr uint8_t  KEY_COLS           = HAL_KEYSCAN_COLS;
+constexpr uint16_t KEY_COUNT          = 166;
+constexpr uint32_t KEY_SCAN_HZ        = 2000;   // trames complètes par seconde (PIO)
+constexpr uint32_t KEY_TASK_HZ        = 1000;   // anti-rebond + émission (scheduler.h)
+constexpr uint8_t  KEY_DEBOUNCE_COUNT = 3;      // compteur 2 bits : 1..3
+constexpr uint8_t  KEY_QUEUE_LEN      = 64;     // puissance de 2
+constexpr uint8_t  KEY_MIDI_CHANNEL   = 2;      // canal 1..15 (les faders sont sur MIDI_CHANNEL)
+constexpr uint8_t  KEY_NOTE_VELOCITY  = 100;    // contacts sans vélocité
+
+static_assert(KEY_ROWS * KEY_COLS >= KEY_COUNT && KEY_ROWS <= HAL_KEYSCAN_ROWS, "matrice trop petite");
+static_assert(KEY_DEBOUNCE_COUNT >= 1 && KEY_DEBOUNCE_COUNT <= 3, "compteurs verticaux 2 bits");
+static_assert((KEY_QUEUE_LEN & (KEY_QUEUE_LEN - 1)) == 0, "KEY_QUEUE_LEN : puissance de 2");
+static_assert(KEY_MIDI_CHANNEL >= 1 && KEY_MIDI_CHANNEL + (KEY_COUNT - 1) / 128 <= 16, "canal MIDI");
+
+struct KeyEvent {
+  uint8_t  key;
+  bool     pressed;
+  uint32_t tUs;       // passage de l'anti-rebond qui a validé le changement
+};
+
+// ===================== API =====================
+bool setupKeys();                         // démarre le balayage ; false si absent / désactivé
+void keysScan(uint32_t now_us);           // anti-rebond d'une trame → événements
+bool keysPop(KeyEvent& ev);               // événement le plus ancien
+bool keyIsDown(uint8_t k);                // état stable
+uint32_t keysDropped();                   // événements perdus (file pleine)
+void loopKeys(uint32_t now_us);           // keysScan + file → notes MIDI (tâche "keys")
+
+// Touche → note (canal 1..16, note 0..127)
+inline uint8_t keyChannel(uint8_t k) { return (uint8_t)(KEY_MIDI_CHANNEL + k / 128); }
+inline uint8_t keyNote(uint8_t k)    { return (uint8_t)(k % 128); }
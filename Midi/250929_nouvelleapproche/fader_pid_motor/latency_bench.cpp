@@ -0,0 +1,102 @@
+#include <Arduino.h>
+#include "hal.h"
+#include "latency_bench.h"
+#include "fader_filtre_adc.h" // MAX_FADERS / NUM_FADERS / ADC_MAX
+#include "midi_io.h"          // MIDIIO_sendSysEx
+#include "debug.h"            // on_bench_latency
+
+// ===================== ÉTAT =====================
+struct BenchSlot {
+  uint32_t tRx     = 0;
+  uint32_t tSp     = 0;
+  uint32_t tAdc    = 0;
+  bool     waitPwm = false;   // consigne appliquée, moteur pas encore démarré
+  bool     waitTx  = false;   // position prise en compte, CC pas encore parti
+  bool     injPending = false;
+  uint16_t inj     = 0;
+};
+static BenchSlot slot[MAX_FADERS];
+
+// ===================== SysEx =====================
+static inline uint8_t* put21(uint8_t* p, uint32_t us) {
+  if (us > BENCH_NONE) us = BENCH_NONE;
+  *p++ = (uint8_t)(us & 0x7F);
+  *p++ = (uint8_t)((us >> 7) & 0x7F);
+  *p++ = (uint8_t)((us >> 14) & 0x7F);
+  return p;
+}
+
+static void reportSetpoint(uint8_t i, uint32_t rxToSp, uint32_t spToPwm) {
+  uint8_t msg[11] = { 0xF0, BENCH_SYSEX_ID, 0x10, i };
+  uint8_t* p = put21(msg + 4, rxToSp);
+  p = put21(p, spToPwm);
+  *p = 0xF7;
+  MIDIIO_sendSysEx(msg, sizeof msg);
+}
+
+static void reportTx(uint8_t i, uint32_t adcToTx) {
+  uint8_t msg[8] = { 0xF0, BENCH_SYSEX_ID, 0x11, i };
+  put21(msg + 4, adcToTx)[0] = 0xF7;
+  MIDIIO_sendSysEx(msg, sizeof msg);
+}
+
+void benchHandleSysEx(const uint8_t* data, uint16_t len) {
+  if (!on_bench_latency) return;
+  if (len && data[0] == 0xF0) { ++data; --len; }
+  if (len < 3 || data[0] != BENCH_SYSEX_ID) return;
+
+  if (data[1] == 0x12) {                       // ping → pong immédiat
+    const uint8_t pong[5] = { 0xF0, BENCH_SYSEX_ID, 0x13, data[2], 0xF7 };
+    MIDIIO_sendSysEx(pong, sizeof pong);
+  } else if (data[1] == 0x14 && len >= 5) {    // injection de position (14 bits → ADC)
+    const uint8_t i = data[2];
+    if (i >= NUM_FADERS) return;
+    const uint16_t v14 = (uint16_t)(data[3] | (data[4] << 7));
+    slot[i].inj        = (uint16_t)(((uint32_t)v14 * ADC_MAX) / 16383);
+    slot[i].injPending = true;
+  }
+}
+
+// ===================== Sondes =====================
+void benchMark(BenchProbe p, uint8_t i) {
+  if (!on_bench_latency || i >= NUM_FADERS) return;
+  BenchSlot &s = slot[i];
+  const uint32_t now = HALTime::micros();
+  switch (p) {
+    case BENCH_RX:  s.tRx = now; break;
+    case BENCH_SP:  s.tSp = now; s.waitPwm = true; break;
+    case BENCH_PWM:
+      if (!s.waitPwm) break;
+      s.waitPwm = false;
+      reportSetpoint(i, s.tSp - s.tRx, now - s.tSp);
+      break;
+    case BENCH_ADC:
+      if (s.waitTx) break;                     // mesure depuis la 1re valeur non émise
+      s.tAdc = now; s.waitTx = true;
+      break;
+    case BENCH_TX:
+      if (!s.waitTx) break;
+      s.waitTx = false;
+      reportTx(i, now - s.tAdc);
+      break;
+  }
+}
+
+bool benchTakeInjection(uint8_t i, uint16_t& adcOut) {
+  if (i >= NUM_FADERS || !slot[i].injPending) return false;
+  slot[i].injPending = false;
+  adcOut = slot[i].inj;
+  return true;
+}
+
+void loopBench() {
+  if (!on_bench_latency) return;
+  const uint32_t now = HALTime::micros();
+  for (uint8_t i = 0; i < NUM_FADERS; ++i) {
+    BenchSlot &s = slot[i];
+    if (s.waitPwm && (uint32_t)(now - s.tSp) > BENCH_PWM_TIMEOUT_US) {
+      s.waitPwm = false;                       // déjà en place : le moteur ne démarre pas
+      reportSetpoint(i, s.tSp - s.tRx, BENCH_NONE);
+    }
+  }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+
+/*
+  Mode benchmark de latence MIDI (on_bench_latency = true dans debug.cpp)
+  Outil hôte : host/midi_latency.cpp (Linux, rawmidi ALSA)
+
+  Sondes (micros()) posées dans la boucle surface :
+    RX  : CC consigne vu par MIDIIO_getTargetIfUpdated()
+    SP  : consigne appliquée (gBank.setpoint[i])
+    PWM : 1re commande moteur non nulle après la nouvelle consigne
+    ADC : position injectée par l'hôte (entrée contrôlée, remplace la lecture du fader)
+    TX  : CC correspondant parti dans MIDIIO_flush()
+
+  Protocole SysEx (ID non commercial 0x7D, valeurs µs sur 3 octets de 7 bits, LSB d'abord) :
+    hôte → Pico  F0 7D 12 <seq> F7             ping (réponse immédiate 13)
+    hôte → Pico  F0 7D 14 <i> <lsb> <msb> F7   injecte une position 14 bits sur le fader i
+    Pico → hôte  F0 7D 13 <seq> F7             pong
+    Pico → hôte  F0 7D 10 <i> <RX→SP> <SP→PWM> F7   (SP→PWM = 0x1FFFFF si le moteur n'a pas démarré)
+    Pico → hôte  F0 7D 11 <i> <ADC→TX> F7
+*/
+
+// ===================== RÉGLAGES =====================
+constexpr uint8_t  BENCH_SYSEX_ID      = 0x7D;
+constexpr uint32_t BENCH_PWM_TIMEOUT_US = 200000; // consigne sans démarrage moteur → rapport "aucun"
+constexpr uint32_t BENCH_NONE          = 0x1FFFFF; // valeur "pas de mesure" (21 bits)
+
+enum BenchProbe : uint8_t { BENCH_RX, BENCH_SP, BENCH_PWM, BENCH_ADC, BENCH_TX };
+
+// ===================== API =====================
+void benchMark(BenchProbe p, uint8_t i);                      // horodate une sonde
+void benchHandleSysEx(const uint8_t* data, uint16_t len);     // F0 7D 12/14 ...
+bool benchTakeInjection(uint8_t i, uint16_t& adcOut);         // position injectée par l'hôte ?
+void loopBench();                                             // timeouts + envoi des rapports
@@ -0,0 +1,339 @@
+#include <Arduino.h>
+#include "hal.h"
+#include <Control_Surface.h>   // lib Arduino Control Surface
+#include "midi_io.h"
+#include "fader_bank.h"
+#include "ump.h"
+#include "scene.h"
+#include "latency_bench.h"
+#include "rtpmidi_eth.h"
+#include "osc_eth.h"
+#include "host_protocol.h"
+#include "telemetry.h"          // telemWriteFrame : trames entières, jamais dans une trame 'T'
+#include "bash_test_python.hpp" // slipFeed (transport UMP sur le lien hôte)
+
+// =============== Interface MIDI USB (Control_Surface) ==============
+static USBMIDI_Interface midi;          // RP2040 + Control_Surface requis
+
+// Table d'adresses réglable à chaud : les CC consignes sont décodés dans onChannelMessage()
+uint8_t midi_channel = MIDI_CHANNEL;
+uint8_t midi_fader_cc[MAX_FADERS] = { FADER_CC[0], FADER_CC[1], FADER_CC[2], FADER_CC[3] };
+static_assert(MAX_FADERS == 4, "compléter midi_fader_cc[] pour MAX_FADERS");
+uint8_t midi_enc_cc[ENC_MAX] = { ENC_CC[0], ENC_CC[1], ENC_CC[2], ENC_CC[3], ENC_CC[4], ENC_CC[5] };
+static_assert(ENC_MAX == 6, "compléter midi_enc_cc[] pour ENC_MAX");
+
+static uint32_t lastRxMs = 0; // horodatage dernier RX (badge MIDI)
+
+// ===================== Ordonnanceur de sortie =====================
+static constexpr uint16_t NEVER_SENT = 0xFFFF;
+
+struct MidiOutSlot {
+  uint16_t pending      = 0;          // dernière valeur ADC connue (écrase les précédentes)
+  uint16_t sent         = NEVER_SENT; // dernière valeur émise (force le 1er envoi)
+  bool     dirty        = false;
+  uint32_t lastTxUs     = 0;          // dernier envoi (limite de débit)
+  uint32_t lastChangeMs = 0;          // dernier changement (détection repos)
+};
+
+static MidiOutSlot outSlot[MAX_FADERS];
+
+// encodeurs : pas cumulés (pas de valeur absolue à écraser)
+struct MidiEncSlot {
+  int32_t  pending  = 0;
+  uint32_t lastTxUs = 0;
+};
+
+static MidiEncSlot encSlot[ENC_MAX];
+uint32_t midi_out_interval_us = MIDI_OUT_INTERVAL_US;
+
+// ===================== État MIDI 2.0 =====================
+static MidiProtocol proto      = MIDI_PROTO_1;
+static uint32_t     lastLinkMs = 0;                  // dernier paquet reçu du pont UMP
+
+// consignes reçues (CC USB, UMP 32 bits, RTP-MIDI, OSC) → 0..ADC_MAX
+static uint16_t     netTarget[MAX_FADERS] = {0};
+static bool         netTargetDirty[MAX_FADERS] = {false};
+
+static MidiCiIdentity ciId = {
+  0,                    // MUID tiré dans MIDIIO_begin()
+  { 0x7D, 0x00, 0x00 }, // ID fabricant "non commercial / éducatif"
+  0x0001,               // famille : faders motorisés
+  NUM_FADERS,           // modèle : nb de faders
+  0x00010000,           // version firmware
+  128                   // taille SysEx max acceptée
+};
+static bool ciAnnounced = false;
+
+// ===================== Conversions =====================
+uint8_t adcToCC(uint16_t adc) {
+  if (adc > ADC_MAX) adc = ADC_MAX;
+  return (uint8_t)(((uint32_t)adc * 127 + ADC_MAX / 2) / ADC_MAX);
+}
+
+uint16_t ccToAdc(uint8_t cc) {
+  if (cc > 127) cc = 127;
+  return (uint16_t)(((uint32_t)cc * ADC_MAX + 63) / 127);
+}
+
+// valeur comparée pour l'envoi : 7 bits en MIDI 1.0, pleine résolution en MIDI 2.0
+// unité de détection de changement : ADC si MIDI 2.0 ou client OSC, sinon pas de CC
+static inline bool fullRes() { return proto == MIDI_PROTO_2 || oscActive(); }
+static inline uint16_t outUnit(uint16_t adc) {
+  return fullRes() ? adc : adcToCC(adc);
+}
+
+// renvoie les positions déjà publiées (jamais celles d'un fader pas encore bougé)
+static void markAllDirty() {
+  for (uint8_t i = 0; i < MIDI_FADER_SLOTS; ++i) {
+    if (outSlot[i].sent != NEVER_SENT) outSlot[i].dirty = true;
+  }
+}
+
+static void setProtocol(MidiProtocol p) {
+  if (p == proto) return;
+  proto = p;
+  markAllDirty(); // le nouvel hôte doit recevoir les positions connues
+}
+
+// ===================== Transport UMP (SLIP 'U' sur le CDC) =====================
+static void umpSend(const uint32_t* w, uint8_t nWords) {
+  uint8_t buf[1 + 4 * 2 * (MAX_FADERS + ENC_MAX)];
+  static_assert(2 * sizeof buf + 2 <= TELEM_TXQ_LEN, "trame UMP échappée : plus grande que la file du lien");
+  if (nWords > 2 * (MAX_FADERS + ENC_MAX)) return;
+  buf[0] = UMP_SLIP_TAG;
+  memcpy(buf + 1, w, 4u * nWords);   // RP2040 = little-endian → direct
+  telemWriteFrame(buf, 1 + 4u * nWords);   // en file pendant un envoi 'T' morcelé
+}
+
+static void onUmpStream(const uint32_t* w) {
+  uint32_t r[4];
+  switch (umpStreamStatus(w)) {
+    case UMP_STREAM_EP_DISCOVERY:
+      umpStreamEndpointInfo(r, 1, MIDI2_ENABLE, true);
+      umpSend(r, 4);
+      umpStreamConfig(r, UMP_STREAM_CONFIG_NOTIFY, (uint8_t)proto);
+      umpSend(r, 4);
+      break;
+    case UMP_STREAM_CONFIG_REQUEST:
+      setProtocol((MIDI2_ENABLE && umpStreamProtocol(w) == UMP_PROTOCOL_MIDI2)
+                  ? MIDI_PROTO_2 : MIDI_PROTO_1);
+      umpStreamConfig(r, UMP_STREAM_CONFIG_NOTIFY, (uint8_t)proto);
+      umpSend(r, 4);
+      break;
+    default: break;
+  }
+}
+
+static void onUmpController(const uint32_t* w) {
+  UmpController c;
+  if (!umpParseController(w, c) || c.channel != midi_channel - 1) return;
+  for (uint8_t i = 0; i < MIDI_FADER_SLOTS; ++i) {
+    const bool match = (c.status == UMP_M2_NRPN && c.bank == MIDI2_NRPN_BANK && c.index == midi_fader_cc[i])
+                    || (c.status == UMP_M2_CC   && c.index == midi_fader_cc[i]);
+    if (!match) continue;
+    netTarget[i]      = (uint16_t)umpScaleDown(c.value, 32, MY_ADC_BITS);
+    netTargetDirty[i] = true;
+  }
+}
+
+static void onUmpPacket(const uint8_t* data, uint16_t len) {
+  if (hostProtoIsFrame(data, len)) { hostProtoHandle(data, len); return; } // protocole hôte
+  if (len < 5 || data[0] != UMP_SLIP_TAG) return;
+  lastLinkMs = HALTime::millis();
+
+  uint32_t w[4];
+  uint16_t p = 1;
+  while (p + 4 <= len) {
+    memcpy(&w[0], data + p, 4);
+    const uint8_t n = umpWordCount(w[0]);
+    if (p + 4u * n > len) break;
+    memcpy(w, data + p, 4u * n);
+    p += 4u * n;
+
+    const uint8_t mt = (uint8_t)(w[0] >> 28);
+    if      (mt == UMP_MT_STREAM) onUmpStream(w);
+    else if (mt == UMP_MT_MIDI2)  onUmpController(w);
+  }
+}
+
+// ===================== CC consignes / Program Change → scène =====================
+static bool onChannelMessage(ChannelMessage msg) {
+  if ((msg.header & 0x0F) != midi_channel - 1) return false;
+  switch (msg.header & 0xF0) {
+    case 0xB0: MIDIIO_onNetworkCC(msg.header & 0x0F, msg.data1, msg.data2); return true;
+    case 0xC0: sceneRecall(msg.data1);                                      return true;
+    default:   return false;
+  }
+}
+
+// ===================== MIDI-CI / scènes (SysEx sur USB MIDI 1.0) =====================
+static bool onSysEx(SysExMessage se) {
+  uint32_t src = 0;
+  const uint8_t sub = midiCiParse(se.data, se.length, src);
+  if (sub == 0) {                           // pas du MIDI-CI → SysEx scène éventuel
+    sceneHandleSysEx(se.data, se.length);
+    benchHandleSysEx(se.data, se.length);
+    return false;
+  }
+  if (sub == MIDICI_DISCOVERY) {
+    uint8_t buf[40];
+    const size_t n = midiCiDiscoveryReply(buf, sizeof buf, ciId, src);
+    if (n) midi.sendSysEx(buf, (uint16_t)n);
+  }
+  return true;
+}
+
+// ===================== SETUP/LOOP =====================
+void MIDIIO_begin() {
+  Control_Surface.begin();  // init USB MIDI
+  Control_Surface.setMIDIInputCallbacks(onChannelMessage, onSysEx, nullptr, nullptr);
+
+  // MUID 28 bits aléatoire (hors plage réservée 0x0FFFFF00..)
+  ciId.muid = (HALTime::micros() ^ ((uint32_t)HALAdc::read(PicoBoard::ADC_PINS[0]) << 16)) & 0x0FFFFEFF;
+
+  if (MIDI2_ENABLE) HostLink::begin(1000000);  // transport UMP (pont python, USB ou UDP)
+}
+
+void MIDIIO_loop() {
+  Control_Surface.loop();
+
+  if (!MIDI2_ENABLE) return;
+  while (HostLink::available()) slipFeed((uint8_t)HostLink::read(), onUmpPacket);
+
+  const uint32_t now_ms = HALTime::millis();
+  if (proto == MIDI_PROTO_2 && (uint32_t)(now_ms - lastLinkMs) > MIDI2_LINK_TIMEOUT_MS) {
+    setProtocol(MIDI_PROTO_1); // pont perdu → repli MIDI 1.0
+  }
+  if (!ciAnnounced && now_ms > 2000) { // USB monté : annonce MIDI-CI une fois
+    uint8_t buf[40];
+    const size_t n = midiCiDiscovery(buf, sizeof buf, ciId);
+    if (n) midi.sendSysEx(buf, (uint16_t)n);
+    ciAnnounced = true;
+  }
+}
+
+MidiProtocol MIDIIO_protocol() { return proto; }
+
+void MIDIIO_onNetworkCC(uint8_t ch, uint8_t cc, uint8_t value) {
+  if (ch != midi_channel - 1) return;
+  for (uint8_t i = 0; i < MIDI_FADER_SLOTS; ++i) {
+    if (cc == midi_fader_cc[i]) MIDIIO_onNetworkTarget(i, ccToAdc(value));
+  }
+}
+
+void MIDIIO_onNetworkTarget(uint8_t i, uint16_t adc) {
+  if (i >= MIDI_FADER_SLOTS) return;
+  netTarget[i]      = adc > ADC_MAX ? ADC_MAX : adc;
+  netTargetDirty[i] = true;
+}
+
+void MIDIIO_sendSysEx(const uint8_t* data, uint16_t len) {
+  midi.sendSysEx(data, len);
+  midi.sendNow();
+}
+
+void MIDIIO_sendNote(uint8_t ch, uint8_t note, uint8_t velocity) {
+  if (MODLINK_ROLE == MODLINK_LEAF) { modLinkNote(ch, note, velocity); return; }
+  const MIDIAddress a{ note, Channel::createChannel(ch) };
+  if (velocity) midi.sendNoteOn(a, velocity);
+  else          midi.sendNoteOff(a, 0);
+}
+
+void MIDIIO_sendNow() { midi.sendNow(); }
+
+bool MIDIIO_getTargetIfUpdated(uint8_t i, uint16_t &refOut) {
+  if (i >= MIDI_FADER_SLOTS) return false;
+  if (!netTargetDirty[i]) return false;
+  refOut = netTarget[i];
+  netTargetDirty[i] = false;
+  lastRxMs = HALTime::millis();          // mémorise le moment de réception
+  return true;
+}
+
+bool MIDIIO_hasRecentRX(uint32_t window_ms) {
+  return (HALTime::millis() - lastRxMs) < window_ms;
+}
+
+void MIDIIO_sendPositionFromADC(uint8_t i, uint16_t adc) {
+  if (MODLINK_ROLE == MODLINK_LEAF) { modLinkFader(i, adc); return; }
+  if (i >= MIDI_FADER_SLOTS) return;
+  MidiOutSlot &s = outSlot[i];
+  if (adc > ADC_MAX) adc = ADC_MAX;
+  if (outUnit(adc) != outUnit(s.pending)) s.lastChangeMs = HALTime::millis();
+  s.pending = adc;
+  s.dirty   = (s.sent == NEVER_SENT) || (outUnit(s.pending) != outUnit(s.sent));
+}
+
+void MIDIIO_sendEncoderDelta(uint8_t e, int32_t steps) {
+  if (MODLINK_ROLE == MODLINK_LEAF) { modLinkEncoder(e, steps); return; }
+  if (e >= MIDI_ENC_SLOTS) return;
+  encSlot[e].pending += steps;
+}
+
+uint8_t MIDIIO_flush(uint32_t now_us) {
+  const uint32_t now_ms = HALTime::millis();
+  const bool     m2     = (proto == MIDI_PROTO_2);
+  uint32_t       words[2 * (MAX_FADERS + ENC_MAX)];
+  uint8_t        n = 0, nMidi = 0;
+
+  rtpMidiBeginPacket();
+  oscBeginBundle();
+  for (uint8_t i = 0; i < MIDI_FADER_SLOTS; ++i) {
+    MidiOutSlot &s = outSlot[i];
+    if (!s.dirty) continue;
+    const bool first = (s.sent == NEVER_SENT);
+
+    // 1) limite de débit : au plus 1 message par fader et par intervalle
+    if (!first && (uint32_t)(now_us - s.lastTxUs) < midi_out_interval_us) continue;
+
+    // 2) hystérésis (CC 7 bits) uniquement en mouvement ; au repos la valeur finale part toujours
+    const bool atRest = (uint32_t)(now_ms - s.lastChangeMs) >= MIDI_OUT_SETTLE_MS;
+    if (!fullRes() && !atRest && !first &&
+        abs((int)adcToCC(s.pending) - (int)adcToCC(s.sent)) < MIDI_OUT_HYST_LSB) continue;
+
+    // en pleine résolution (OSC) le CC 7 bits ne part que s'il a changé
+    const bool ccChanged = first || adcToCC(s.pending) != adcToCC(s.sent);
+    if (m2) {
+      umpMidi2NRPN(&words[2 * nMidi++], MIDI2_GROUP, midi_channel - 1, MIDI2_NRPN_BANK, midi_fader_cc[i],
+                   umpScaleUp(s.pending, MY_ADC_BITS, 32));
+    } else if (ccChanged) {
+      midi.sendControlChange(MIDIAddress{ midi_fader_cc[i], Channel::createChannel(midi_channel) }, adcToCC(s.pending));
+      ++nMidi;
+    }
+    if (ccChanged) rtpMidiAddCC(midi_channel - 1, midi_fader_cc[i], adcToCC(s.pending)); // RTP-MIDI : toujours en 1.0
+    oscAddFader(i, s.pending);
+    s.sent     = s.pending;
+    s.dirty    = false;
+    s.lastTxUs = now_us;
+    benchMark(BENCH_TX, i);
+    ++n;
+  }
+
+  // encodeurs : même limite de débit, ±ENC_REL_MAX_STEP par message, le reste attend
+  for (uint8_t e = 0; e < MIDI_ENC_SLOTS; ++e) {
+    MidiEncSlot &s = encSlot[e];
+    if (!s.pending || (uint32_t)(now_us - s.lastTxUs) < midi_out_interval_us) continue;
+    const int32_t step = constrain(s.pending, -ENC_REL_MAX_STEP, ENC_REL_MAX_STEP);
+    const uint8_t rel  = (uint8_t)(ENC_REL_CENTER + step);
+    if (m2) {
+      umpMidi2RelNRPN(&words[2 * nMidi++], MIDI2_GROUP, midi_channel - 1, MIDI2_NRPN_BANK, midi_enc_cc[e], step);
+    } else {
+      midi.sendControlChange(MIDIAddress{ midi_enc_cc[e], Channel::createChannel(midi_channel) }, rel);
+      ++nMidi;
+    }
+    rtpMidiAddCC(midi_channel - 1, midi_enc_cc[e], rel, false);   // relatif : hors journal
+    s.pending -= step;
+    s.lastTxUs = now_us;
+    ++n;
+  }
+
+  // 3) tous les messages du tick partent dans un seul transfert (USB MIDI ou trame UMP)
+  //    + un seul paquet RTP-MIDI + un seul bundle OSC
+  if (nMidi) {
+    if (m2) umpSend(words, (uint8_t)(2 * nMidi));
+    else    midi.sendNow();
+  }
+  rtpMidiEndPacket();
+  oscEndBundle();
+  return n;
+}
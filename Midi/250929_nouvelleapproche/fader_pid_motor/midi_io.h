@@ -0,0 +1,111 @@
+#pragma once
+#include <cstdint>
+#include "fader_filtre_adc.h" // MAX_FADERS / NUM_FADERS / ADC_MAX
+#include "encoders.h"         // ENC_MAX / ENC_COUNT / ENC_CC
+#include "modlink_uart.h"     // MODLINK_ROLE (surface en plusieurs modules)
+
+/*
+  MIDI USB (Control Surface) — réception des consignes + émission des positions
+  (repris de 250926-intégration MIDI/midi_io.hpp, passé en multi-faders)
+
+  Émission : ordonnanceur de sortie "coalescent"
+    - MIDIIO_sendPositionFromADC() ne fait que MÉMORISER la dernière valeur du fader
+    - MIDIIO_flush() (1 fois par tick) émet au plus 1 CC par fader et par
+      midi_out_interval_us, puis pousse tous les messages du tick en UN seul
+      transfert USB (midi.sendNow())
+    - les valeurs intermédiaires sont écrasées (pas de file qui grossit)
+    - au repos (MIDI_OUT_SETTLE_MS sans changement) la dernière valeur part
+      TOUJOURS, même si elle est dans l'hystérésis → jamais de valeur finale perdue
+
+  MIDI 2.0 (optionnel, voir ump.h) :
+    - transport UMP = trames SLIP 'U' + mots UMP (LE) sur le port série USB (CDC),
+      relayées vers ALSA par python/ump_bridge.py (pas d'alt setting USB MIDI 2.0
+      dans la pile TinyUSB/Control Surface actuelle)
+    - le pont envoie Endpoint Discovery + Stream Config Request(MIDI 2.0) → on passe
+      en MIDI 2.0 : 1 Assignable Controller (NRPN) 32 bits par fader, consignes idem
+    - sans nouvelles du pont pendant MIDI2_LINK_TIMEOUT_MS → repli MIDI 1.0 (CC 7 bits)
+    - MIDI-CI Discovery (SysEx) sur le port USB MIDI 1.0 : on répond aux Discovery de
+      l'hôte et on s'annonce une fois au démarrage
+
+  Encodeurs (encoders.h) : MIDIIO_sendEncoderDelta() CUMULE des pas ; MIDIIO_flush() émet
+  au plus 1 message relatif par encodeur et par midi_out_interval_us (CC 64 ± pas en 1.0,
+  NRPN relatif 32 bits en 2.0) ; le reste part au flush suivant
+  Scènes (scene.h) : Program Change et SysEx F0 7D .. sont transmis au moteur de scènes
+  RTP-MIDI (rtpmidi_eth.h) : mêmes adresses, les CC du tick partent aussi dans 1 paquet RTP ;
+  les CC reçus du réseau arrivent par MIDIIO_onNetworkCC()
+  OSC (osc_eth.h) : même ordonnanceur ; dès qu'un client OSC est connu, la détection de
+  changement passe en pleine résolution ADC (les CC 7 bits ne partent que s'ils changent)
+  Benchmark de latence (latency_bench.h) : SysEx F0 7D 1x .., sonde TX dans MIDIIO_flush()
+  Liaison inter-modules (modlink_uart.h) :
+    - hub : les faders / encodeurs des modules prennent les emplacements après ceux du hub
+      (MIDI_FADER_SLOTS / MIDI_ENC_SLOTS) → même ordonnanceur, mêmes adresses CC ; les
+      consignes de ces emplacements repartent vers le module (pas d'OSC pour eux)
+    - module : MIDIIO_sendPositionFromADC / sendEncoderDelta / sendNote vont au hub
+      au lieu de l'USB ; les consignes du hub arrivent par MIDIIO_onNetworkTarget()
+*/
+
+// ===================== RÉGLAGES (tout en haut) =====================
+constexpr uint8_t  MIDI_CHANNEL = 1;                       // canal 1..16
+constexpr uint8_t  FADER_CC[MAX_FADERS] = { 16, 17, 18, 19 }; // 1 CC par fader
+
+constexpr uint32_t MIDI_OUT_INTERVAL_US = 2000; // au plus 1 message / fader / 2 ms
+constexpr uint8_t  MIDI_OUT_HYST_LSB    = 1;    // hystérésis en mouvement (pas de CC)
+constexpr uint32_t MIDI_OUT_SETTLE_MS   = 20;   // "au repos" après 20 ms sans changement
+constexpr uint32_t MIDI_RX_BADGE_MS     = 300;  // fenêtre du badge RX (OLED)
+
+// MIDI 2.0 (UMP)
+constexpr bool     MIDI2_ENABLE          = true;
+constexpr uint8_t  MIDI2_GROUP           = 0;    // groupe UMP (0..15)
+constexpr uint8_t  MIDI2_NRPN_BANK       = 0;    // banque Assignable Controller ; index = FADER_CC[i]
+constexpr uint32_t MIDI2_LINK_TIMEOUT_MS = 3000; // sans nouvelles du pont → repli MIDI 1.0
+constexpr uint8_t  UMP_SLIP_TAG          = 'U';  // 1er octet des trames SLIP UMP
+
+// emplacements de l'ordonnanceur de sortie : locaux, + ceux des modules sur le hub
+constexpr uint8_t  MIDI_FADER_SLOTS = MODLINK_ROLE == MODLINK_HUB ? MAX_FADERS : NUM_FADERS;
+constexpr uint8_t  MIDI_ENC_SLOTS   = MODLINK_ROLE == MODLINK_HUB ? ENC_MAX : ENC_COUNT;
+
+enum MidiProtocol : uint8_t { MIDI_PROTO_1 = 1, MIDI_PROTO_2 = 2 };
+
+extern uint32_t midi_out_interval_us; // réglable à chaud (défaut MIDI_OUT_INTERVAL_US)
+extern uint8_t  midi_channel;         // réglable à chaud (défaut MIDI_CHANNEL)
+extern uint8_t  midi_fader_cc[MAX_FADERS]; // réglable à chaud (défaut FADER_CC)
+extern uint8_t  midi_enc_cc[ENC_MAX];      // réglable à chaud (défaut ENC_CC)
+
+// ===================== API =====================
+void MIDIIO_begin();  // init USB MIDI (Control_Surface)
+void MIDIIO_loop();   // à appeler à chaque tick (lecture USB)
+
+// Consigne reçue pour le fader i → refOut (0..ADC_MAX). Rend true si MAJ.
+bool MIDIIO_getTargetIfUpdated(uint8_t i, uint16_t &refOut);
+
+// Indique s'il y a eu du RX récent (pour badge OLED)
+bool MIDIIO_hasRecentRX(uint32_t window_ms = MIDI_RX_BADGE_MS);
+
+// Mémorise la position courante du fader i (0..ADC_MAX) ; l'envoi se fait dans MIDIIO_flush()
+void MIDIIO_sendPositionFromADC(uint8_t i, uint16_t adc);
+
+// Ajoute steps pas (signés, accélération comprise) à l'encodeur e ; l'envoi se fait dans MIDIIO_flush()
+void MIDIIO_sendEncoderDelta(uint8_t e, int32_t steps);
+
+// Émet les valeurs en attente (1 transfert USB). Rend le nb de messages envoyés.
+uint8_t MIDIIO_flush(uint32_t now_us);
+
+// CC reçu (USB, RTP-MIDI, ...) : devient une consigne si l'adresse est celle d'un fader
+void MIDIIO_onNetworkCC(uint8_t ch, uint8_t cc, uint8_t value);
+// Consigne pleine résolution (0..ADC_MAX) reçue hors MIDI (OSC, ...)
+void MIDIIO_onNetworkTarget(uint8_t i, uint16_t adc);
+
+// Envoie un SysEx complet (F0..F7) sur le port USB MIDI 1.0
+void MIDIIO_sendSysEx(const uint8_t* data, uint16_t len);
+
+// Note On (velocity > 0) / Note Off (velocity 0), canal 1..16, sur le port USB MIDI 1.0
+// quel que soit le protocole négocié (clavier, key_matrix.h) ; part au MIDIIO_sendNow() suivant
+void MIDIIO_sendNote(uint8_t ch, uint8_t note, uint8_t velocity);
+void MIDIIO_sendNow();   // pousse les messages en attente en 1 transfert USB
+
+// Protocole de sortie courant (MIDI 1.0 par défaut, 2.0 si négocié avec le pont UMP)
+MidiProtocol MIDIIO_protocol();
+
+// Conversions ADC (0..ADC_MAX) <-> CC (0..127)
+uint8_t  adcToCC(uint16_t adc);
+uint16_t ccToAdc(uint8_t cc);
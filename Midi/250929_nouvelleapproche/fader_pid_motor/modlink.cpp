@@ -0,0 +1,323 @@
+#include "modlink.h"
+#include <cstring>
+#include "crc16.h"
+
+// ===================== Trames =====================
+namespace {
+
+constexpr uint8_t SLIP_END = 0xC0, SLIP_ESC = 0xDB, SLIP_ESC_END = 0xDC, SLIP_ESC_ESC = 0xDD;
+constexpr size_t  FADER_ITEM = 7, TARGET_ITEM = 4, ENC_ITEM = 7, NOTE_ITEM = 7;
+constexpr uint32_t T24_MASK = 0xFFFFFF;
+
+inline void put16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+inline uint16_t get16(const uint8_t* p)   { return (uint16_t)(p[0] | p[1] << 8); }
+inline void put24(uint8_t* p, uint32_t v) { put16(p, (uint16_t)v); p[2] = (uint8_t)(v >> 16); }
+inline uint32_t get24(const uint8_t* p)   { return get16(p) | (uint32_t)p[2] << 16; }
+inline void put32(uint8_t* p, uint32_t v) { put16(p, (uint16_t)v); put16(p + 2, (uint16_t)(v >> 16)); }
+inline uint32_t get32(const uint8_t* p)   { return get16(p) | (uint32_t)get16(p + 2) << 16; }
+inline uint8_t  bit(uint8_t ch)           { return (uint8_t)(1u << ch); }
+inline uint8_t  lowMask(uint8_t n)        { return (uint8_t)((1u << n) - 1); }
+
+// CRC + SLIP (même encodage que slipEncode / le protocole hôte) puis envoi d'un bloc
+void sendFrame(ModLinkLeaf::SendFn send, void* ctx, uint8_t* f, size_t len) {
+  put16(f + len, crc16_ccitt(f, len));
+  len += 2;
+  uint8_t out[MODLINK_SLIP_MAX];
+  uint8_t* o = out;
+  *o++ = SLIP_END;                               // aussi en tête : resynchro après un parasite
+  for (size_t k = 0; k < len; ++k) {
+    const uint8_t b = f[k];
+    if (b == SLIP_END)      { *o++ = SLIP_ESC; *o++ = SLIP_ESC_END; }
+    else if (b == SLIP_ESC) { *o++ = SLIP_ESC; *o++ = SLIP_ESC_ESC; }
+    else                    *o++ = b;
+  }
+  *o++ = SLIP_END;
+  if (send) send(ctx, out, (size_t)(o - out));
+}
+
+// instant 24 bits (horloge du hub) → 32 bits, d'après un instant proche ref (± 8 s)
+inline uint32_t unwrap24(uint32_t t24, uint32_t ref) {
+  int32_t d = (int32_t)((ref - t24) & T24_MASK);
+  if (d > (int32_t)(T24_MASK >> 1)) d -= (int32_t)(T24_MASK + 1);   // léger "futur" : erreur de synchro
+  return ref - (uint32_t)d;
+}
+
+// 1 élément à p (fin = end) → it ; rend sa taille, 0 si tag inconnu ou tronqué
+// ref : instant de réception (horloge du hub) pour reconstituer les instants 24 bits
+size_t parseItem(const uint8_t* p, const uint8_t* end, uint32_t ref, ModLinkItem& it) {
+  const size_t left = (size_t)(end - p);
+  it = ModLinkItem{ p[0], 0, 0, 0, 0 };
+  switch (p[0]) {
+    case ML_IT_FADER:
+      if (left < FADER_ITEM) return 0;
+      it.index = p[1] & 0x7F; it.arg = p[1] >> 7; it.value = get16(p + 2); it.tUs = unwrap24(get24(p + 4), ref);
+      return FADER_ITEM;
+    case ML_IT_TARGET:
+      if (left < TARGET_ITEM) return 0;
+      it.index = p[1]; it.value = get16(p + 2);
+      return TARGET_ITEM;
+    case ML_IT_ENC:
+      if (left < ENC_ITEM) return 0;
+      it.index = p[1]; it.value = (int16_t)get16(p + 2); it.tUs = unwrap24(get24(p + 4), ref);
+      return ENC_ITEM;
+    case ML_IT_NOTE:
+      if (left < NOTE_ITEM) return 0;
+      it.index = p[1]; it.arg = p[2]; it.value = p[3]; it.tUs = unwrap24(get24(p + 4), ref);
+      return NOTE_ITEM;
+  }
+  return 0;
+}
+
+}  // namespace
+
+// ===================== Décodeur SLIP =====================
+bool ModLinkSlip::feed(uint8_t b) {
+  if (b == SLIP_END) {
+    const size_t len = n;
+    const bool   bad = overflow || esc;
+    n = 0; esc = false; overflow = false;
+    if (!len) return false;                      // END de tête / entre trames
+    if (bad || len < MODLINK_HDR + 2 || crc16_ccitt(buf, len - 2) != get16(buf + len - 2)) {
+      ++errors;
+      return false;
+    }
+    flen = len - 2;
+    return true;
+  }
+  if (esc) {
+    esc = false;
+    if (b == SLIP_ESC_END)      b = SLIP_END;
+    else if (b == SLIP_ESC_ESC) b = SLIP_ESC;
+    else                        overflow = true; // séquence invalide : trame rejetée au END
+  } else if (b == SLIP_ESC) {
+    esc = true;
+    return false;
+  }
+  if (n < sizeof buf) buf[n++] = b;
+  else                overflow = true;
+  return false;
+}
+
+// ===================== MODULE =====================
+void ModLinkLeaf::begin(uint8_t a, uint8_t nf, SendFn s, ItemFn it, ClockFn clk, void* c) {
+  addr    = a;
+  nFaders = nf > MODLINK_MAX_FADERS ? MODLINK_MAX_FADERS : nf;
+  send    = s;
+  onItem  = it;
+  clock   = clk;
+  ctx     = c;
+  sync.reset();
+  xValid  = false;
+}
+
+void ModLinkLeaf::onBytes(const uint8_t* buf, size_t n) {
+  for (size_t k = 0; k < n; ++k) {
+    if (!slip.feed(buf[k])) continue;
+    const uint32_t t2 = stamped ? stamp : now();  // début de trame, sinon instant du décodage
+    stamped = false;
+    handlePoll(slip.frame(), slip.len(), t2);
+  }
+}
+
+void ModLinkLeaf::setFader(uint8_t ch, uint16_t p) {
+  if (ch >= nFaders || pos[ch] == p) return;
+  pos[ch]   = p;
+  posUs[ch] = now();
+  dirty |= bit(ch);
+}
+
+void ModLinkLeaf::setTouch(uint8_t ch, bool on) {
+  if (ch >= nFaders || (bool)(touch & bit(ch)) == on) return;
+  touch ^= bit(ch);
+  posUs[ch] = now();
+  dirty |= bit(ch);
+}
+
+void ModLinkLeaf::addEncoder(uint8_t e, int32_t steps) {
+  if (e >= MODLINK_MAX_ENC || !steps) return;
+  encAcc[e] += steps;
+  encUs[e]   = now();
+}
+
+bool ModLinkLeaf::pushNote(uint8_t ch, uint8_t note, uint8_t velocity) {
+  if ((uint8_t)(nHead - nTail) >= MODLINK_NOTE_QUEUE) { ++notesDropped; return false; }
+  notes[nHead++ & (MODLINK_NOTE_QUEUE - 1)] = Note{ ch, note, velocity, now() };
+  return true;
+}
+
+// Nouveau lot fiable : encodeurs (pas cumulés) puis notes dans l'ordre, dans budget octets ;
+// instants convertis à l'horloge du hub maintenant (le lot est figé jusqu'à l'acquittement)
+void ModLinkLeaf::buildBatch(size_t budget) {
+  size_t k = 0;
+  for (uint8_t e = 0; e < MODLINK_MAX_ENC && k + ENC_ITEM <= budget; ++e) {
+    if (!encAcc[e]) continue;
+    const int32_t step = encAcc[e] > 32767 ? 32767 : encAcc[e] < -32768 ? -32768 : encAcc[e];
+    rel[k] = ML_IT_ENC; rel[k + 1] = e; put16(rel + k + 2, (uint16_t)(int16_t)step);
+    put24(rel + k + 4, sync.toMaster(encUs[e]));
+    encAcc[e] -= step;                           // le reste part au lot suivant
+    k += ENC_ITEM;
+  }
+  for (; nTail != nHead && k + NOTE_ITEM <= budget; k += NOTE_ITEM) {
+    const Note& nt = notes[nTail++ & (MODLINK_NOTE_QUEUE - 1)];
+    rel[k] = ML_IT_NOTE; rel[k + 1] = nt.ch; rel[k + 2] = nt.note; rel[k + 3] = nt.vel;
+    put24(rel + k + 4, sync.toMaster(nt.tUs));
+  }
+  if (!k) return;
+  relLen = k;
+  if (++relSeq == 0) relSeq = 1;                 // 0 = "pas de lot"
+}
+
+void ModLinkLeaf::handlePoll(const uint8_t* p, size_t len, uint32_t t2) {
+  if (p[0] != ML_POLL || p[1] != addr) return;   // POLL d'un autre module
+  if (len < MODLINK_POLL_HDR) return;
+  ++polls;
+
+  // horloge : le hub a reçu notre réponse précédente (t4) → échange complet
+  if (xValid && p[3] == txSeq) sync.sample(xT1, xT2, xT3, get32(p + 9));
+  xT1 = get32(p + 5);
+  xT2 = t2;
+
+  // acquittements : notre réponse précédente est-elle arrivée ?
+  if (inflight) {
+    if (p[3] != txSeq) { dirty |= inflight; ++stateResent; }   // renvoyé avec la dernière valeur
+    inflight = 0;
+  }
+  if (relLen) {
+    if (p[4] == relSeq) relLen = 0;
+    else                ++batchResent;
+  }
+
+  // consignes du hub
+  ModLinkItem it;
+  for (const uint8_t *q = p + MODLINK_POLL_HDR, *end = p + len; q < end;) {
+    const size_t sz = parseItem(q, end, 0, it);
+    if (!sz) break;
+    if (it.tag == ML_IT_TARGET && onItem) onItem(ctx, addr, it);
+    q += sz;
+  }
+
+  // réponse : faders (priorité) puis lot fiable (figé ou nouveau)
+  uint8_t f[MODLINK_MAX_FRAME];
+  size_t  k = MODLINK_HDR;
+  for (uint8_t ch = 0; ch < nFaders; ++ch) {
+    if (!(dirty & bit(ch))) continue;
+    f[k] = ML_IT_FADER; f[k + 1] = (uint8_t)(ch | (touch & bit(ch) ? 0x80 : 0)); put16(f + k + 2, pos[ch]);
+    put24(f + k + 4, sync.toMaster(posUs[ch]));
+    k += FADER_ITEM;
+  }
+  inflight = dirty;
+  dirty    = 0;
+  if (!relLen) buildBatch(MODLINK_MAX_PAYLOAD - FADER_ITEM * nFaders);
+  memcpy(f + k, rel, relLen);
+  k += relLen;
+
+  f[0] = ML_EVENTS;
+  f[1] = addr;
+  f[2] = ++txSeq;
+  f[3] = relLen ? relSeq : 0;
+  f[4] = nFaders;
+  xT3    = now();                               // t3 : émission de la réponse
+  xValid = true;
+  sendFrame(send, ctx, f, k);
+  ++replies;
+}
+
+// ===================== HUB =====================
+void ModLinkHub::begin(uint8_t n, SendFn s, ItemFn it, ClockFn clk, void* c) {
+  nLeaves = n > MODLINK_MAX_LEAVES ? MODLINK_MAX_LEAVES : n;
+  send    = s;
+  onItem  = it;
+  clock   = clk;
+  ctx     = c;
+}
+
+void ModLinkHub::setTarget(uint8_t ch, uint16_t p) {
+  if (ch >= MODLINK_MAX_FADERS) return;
+  target[ch] = p;
+  targetValid |= bit(ch);
+  for (uint8_t l = 0; l < nLeaves; ++l)
+    if (ch < leaf[l].nFaders) leaf[l].dirty |= bit(ch);
+}
+
+void ModLinkHub::onBytes(const uint8_t* buf, size_t n) {
+  for (size_t k = 0; k < n; ++k) {
+    if (!slip.feed(buf[k])) continue;
+    const uint32_t t4 = stamped ? stamp : now();  // début de la réponse, sinon instant du décodage
+    stamped = false;
+    handleEvents(slip.frame(), slip.len(), t4);
+  }
+}
+
+void ModLinkHub::poll() {
+  if (!nLeaves) return;
+  if (waiting) {
+    if ((uint32_t)(now() - pollUs) < MODLINK_SLOT_US) return;
+    Leaf& l = leaf[cur];                         // silence : consignes à renvoyer
+    ++l.st.timeouts;
+    l.dirty   |= l.inflight;
+    l.inflight = 0;
+    waiting    = false;
+    cur        = (uint8_t)((cur + 1) % nLeaves);
+  }
+  sendPoll();
+}
+
+void ModLinkHub::sendPoll() {
+  Leaf& l = leaf[cur];
+  uint8_t f[MODLINK_MAX_FRAME];
+  size_t  k = MODLINK_POLL_HDR;
+  for (uint8_t ch = 0; ch < l.nFaders; ++ch) {
+    if (!(l.dirty & bit(ch))) continue;
+    f[k] = ML_IT_TARGET; f[k + 1] = ch; put16(f + k + 2, target[ch]);
+    k += TARGET_ITEM;
+  }
+  l.inflight |= l.dirty;
+  l.dirty     = 0;
+
+  f[0] = ML_POLL;
+  f[1] = (uint8_t)(cur + 1);
+  f[2] = ++txSeq;
+  f[3] = l.lastSeq;
+  f[4] = l.lastRel;
+  pollUs = now();                               // t1 : émission du POLL
+  put32(f + 5, pollUs);
+  put32(f + 9, l.lastT4);
+  sendFrame(send, ctx, f, k);
+  ++l.st.polls;
+  waiting = true;
+}
+
+void ModLinkHub::handleEvents(const uint8_t* p, size_t len, uint32_t t4) {
+  if (!waiting || p[0] != ML_EVENTS || p[1] != cur + 1) return;   // réponse tardive / autre module
+  Leaf& l = leaf[cur];
+
+  const uint8_t nf = p[4] > MODLINK_MAX_FADERS ? MODLINK_MAX_FADERS : p[4];
+  if (nf != l.nFaders) {                        // module (re)découvert : consignes connues
+    l.nFaders = nf;
+    l.dirty   = (uint8_t)((l.dirty | targetValid) & lowMask(nf));
+  }
+  l.inflight = 0;                               // le module a reçu le POLL et ses consignes
+  l.lastSeq  = p[2];
+  l.lastT4   = t4;                              // renvoyé au module avec lastSeq au POLL suivant
+
+  const uint8_t relSeq = p[3];
+  const bool    fresh  = relSeq && relSeq != l.lastRel;
+  if (relSeq && !fresh) ++l.st.duplicates;      // notre acquittement s'est perdu
+  if (fresh) l.lastRel = relSeq;
+
+  ModLinkItem it;
+  for (const uint8_t *q = p + MODLINK_HDR, *end = p + len; q < end;) {
+    const size_t sz = parseItem(q, end, t4, it);
+    if (!sz) break;
+    q += sz;
+    if (it.tag == ML_IT_TARGET) continue;
+    if (it.tag != ML_IT_FADER && !fresh) continue;
+    if (onItem) onItem(ctx, (uint8_t)(cur + 1), it);
+  }
+
+  const uint32_t rtt = t4 - pollUs;
+  if (rtt > l.st.rttMaxUs) l.st.rttMaxUs = rtt;
+  ++l.st.replies;
+  waiting = false;
+  cur     = (uint8_t)((cur + 1) % nLeaves);
+}
@@ -0,0 +1,217 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "clock_sync.h"
+
+/*
+  Liaison inter-modules (surface en 3 Pico : faders / clavier / encodeurs, README)
+  Code portable (pas d'Arduino) : le transport est fourni par l'appelant
+  (modlink_uart.cpp : UART + DMA ; host/modlink_loopback.cpp : bus simulé sur Linux).
+
+  Topologie : 1 hub (le module qui porte l'USB MIDI / l'Ethernet) + MODLINK_MAX_LEAVES
+  modules au plus, sur un bus série maître / esclaves :
+    - TX du hub → RX de tous les modules
+    - TX des modules réunis par diodes (1N4148) sur un rappel au 3V3 → RX du hub
+      (ET câblé : repos = 1 comme l'UART, un module qui émet tire la ligne à 0)
+    - le hub interroge les modules à tour de rôle (POLL) ; seul le module interrogé
+      répond (EVENTS) → aucune collision, latence bornée :
+        événement → hub ≤ nb de modules × (MODLINK_SLOT_US + période de la tâche du hub)
+
+  Trame = SLIP (END C0 / ESC DB, comme le protocole hôte) de :
+    [0] type ML_POLL / ML_EVENTS   [1] adresse du module (1..MODLINK_MAX_LEAVES)   [2] seq
+    POLL   (hub → module) : [3] seq de la dernière trame EVENTS reçue   [4] relSeq du dernier lot fiable reçu
+                            [5] t1 u32 : émission de ce POLL   [9] t4 u32 : réception de la dernière réponse
+    EVENTS (module → hub) : [3] relSeq du lot fiable (0 = aucun)        [4] nb de faders du module
+    [5 / 13..] éléments   [fin] CRC-16/CCITT (LE, crc16.h) sur tout ce qui précède
+
+  Horloge commune (clock_sync.h) : le hub est le maître ; chaque POLL donne au module
+  l'échange précédent complet (t1, t4 du hub ; t2 = début de réception du POLL, t3 =
+  émission de la réponse, horloge du module) → décalage + dérive. Les instants de
+  réception viennent de rxStamp() (RP2040 : front de départ de la trame, HALUart),
+  à défaut de l'horloge au décodage (moins précis : écarté par le filtre ClockSync).
+  Chaque événement remonté porte son instant dans l'horloge du hub (24 bits de poids
+  faible, 16,7 s), reconstitué par le hub d'après sa réception.
+
+  Éléments (tag + données LE), par ordre de priorité dans une trame EVENTS :
+    ML_IT_FADER   ch | tactile << 7, position u16, t u24   état : dernière valeur (coalescée)
+    ML_IT_ENC     e, pas i16, t u24                        fiable : pas cumulés depuis le lot précédent
+    ML_IT_NOTE    canal 1..16, note, vélocité, t u24       fiable : file, lots de notes
+  et dans une trame POLL :
+    ML_IT_TARGET  ch, position u16                         état : consigne DAW pour un fader du module
+
+  Fiabilité (CRC faux, trame perdue, réponse hors délai) :
+    - état (faders, consignes) : marqué "en vol" à l'émission ; s'il n'est pas acquitté
+      (seq renvoyé dans le POLL suivant / réponse du module), il repart avec la
+      DERNIÈRE valeur — jamais de valeur intermédiaire en file
+    - fiable (encodeurs, notes) : le lot est figé sous un relSeq et réémis tel quel
+      jusqu'à l'acquittement ; le hub écarte un relSeq déjà reçu (doublon)
+  Budget d'une trame : MODLINK_MAX_PAYLOAD octets d'éléments ; les faders (7 o chacun)
+  passent d'abord, le lot fiable a le reste (encodeurs puis notes)
+  - pas d'allocation : tampons de taille fixe
+*/
+
+// ===================== RÉGLAGES =====================
+constexpr uint8_t  MODLINK_MAX_LEAVES  = 4;
+constexpr uint8_t  MODLINK_MAX_FADERS  = 4;      // faders par module (4 entrées ADC)
+constexpr uint8_t  MODLINK_MAX_ENC     = 8;      // encodeurs par module
+constexpr uint8_t  MODLINK_NOTE_QUEUE  = 64;     // notes en attente dans un module (puissance de 2)
+constexpr size_t   MODLINK_MAX_PAYLOAD = 64;     // octets d'éléments par trame
+constexpr uint32_t MODLINK_SLOT_US     = 1000;   // hub : attente maximale d'une réponse
+
+constexpr size_t   MODLINK_HDR         = 5;
+constexpr size_t   MODLINK_POLL_HDR    = MODLINK_HDR + 8;   // + t1, t4
+constexpr size_t   MODLINK_MAX_FRAME   = MODLINK_POLL_HDR + MODLINK_MAX_PAYLOAD + 2;
+constexpr size_t   MODLINK_SLIP_MAX    = 2 * MODLINK_MAX_FRAME + 2;   // pire cas : tout échappé
+
+static_assert((MODLINK_NOTE_QUEUE & (MODLINK_NOTE_QUEUE - 1)) == 0, "MODLINK_NOTE_QUEUE : puissance de 2");
+static_assert(MODLINK_MAX_FADERS * 7 + 2 * 7 <= MODLINK_MAX_PAYLOAD, "il faut de la place pour le lot fiable");
+
+enum ModLinkType : uint8_t { ML_POLL = 'P', ML_EVENTS = 'E' };
+enum ModLinkTag  : uint8_t { ML_IT_FADER = 1, ML_IT_TARGET = 2, ML_IT_ENC = 3, ML_IT_NOTE = 4 };
+
+// Élément décodé, remis au callback
+struct ModLinkItem {
+  uint8_t  tag;      // ModLinkTag
+  uint8_t  index;    // voie (FADER / TARGET), encodeur (ENC), canal 1..16 (NOTE)
+  uint8_t  arg;      // FADER : tactile ; NOTE : note
+  int32_t  value;    // FADER / TARGET : position ; ENC : pas ; NOTE : vélocité (0 = Note Off)
+  uint32_t tUs;      // FADER / ENC / NOTE : instant de l'événement, horloge du hub
+};
+
+// Décodeur SLIP d'une trame (hub et modules)
+class ModLinkSlip {
+ public:
+  // true quand une trame complète (CRC vérifié, ≥ en-tête) est prête dans frame() / len()
+  // (len() sans le CRC) ; valable jusqu'au feed() suivant
+  bool feed(uint8_t b);
+  const uint8_t* frame() const { return buf; }
+  size_t len() const { return flen; }
+  bool idle() const { return n == 0 && !esc; }   // entre deux trames
+  uint32_t errors = 0;   // CRC faux, trame trop longue ou trop courte
+
+ private:
+  uint8_t buf[MODLINK_MAX_FRAME];
+  size_t  n = 0, flen = 0;
+  bool    esc = false;
+  bool    overflow = false;
+};
+
+// ===================== MODULE (esclave) =====================
+class ModLinkLeaf {
+ public:
+  typedef void (*SendFn)(void* ctx, const uint8_t* buf, size_t len);
+  typedef void (*ItemFn)(void* ctx, uint8_t addr, const ModLinkItem& it);
+  typedef uint32_t (*ClockFn)(void* ctx);    // horloge locale, µs
+
+  // nFaders : faders annoncés au hub (0 = module sans fader) ; onItem reçoit les consignes
+  void begin(uint8_t addr, uint8_t nFaders, SendFn send, ItemFn onItem, ClockFn clock, void* ctx);
+  void onBytes(const uint8_t* buf, size_t n);   // POLL pour nous → réponse
+  void rxStamp(uint32_t t) { stamp = t; stamped = true; }   // début de la prochaine trame reçue
+  bool rxIdle() const { return slip.idle(); }
+
+  // Événements locaux, horodatés à l'appel (mis de côté jusqu'au POLL suivant)
+  void setFader(uint8_t ch, uint16_t pos);
+  void setTouch(uint8_t ch, bool on);
+  void addEncoder(uint8_t e, int32_t steps);
+  bool pushNote(uint8_t ch, uint8_t note, uint8_t velocity);   // false : file pleine
+
+  // Horloge du hub vue d'ici
+  uint32_t toMaster(uint32_t local) const { return sync.toMaster(local); }
+  const ClockSync& clockSync() const { return sync; }
+
+  // Statistiques
+  uint32_t polls = 0, replies = 0, stateResent = 0, batchResent = 0, notesDropped = 0;
+  const ModLinkSlip& rx() const { return slip; }
+
+ private:
+  struct Note { uint8_t ch, note, vel; uint32_t tUs; };
+
+  void handlePoll(const uint8_t* p, size_t len, uint32_t t2);
+  void buildBatch(size_t budget);
+  uint32_t now() const { return clock ? clock(ctx) : 0; }
+
+  uint8_t  addr = 0, nFaders = 0;
+  SendFn   send = nullptr;
+  ItemFn   onItem = nullptr;
+  ClockFn  clock = nullptr;
+  void*    ctx = nullptr;
+  ModLinkSlip slip;
+  uint32_t stamp = 0;
+  bool     stamped = false;
+
+  // horloge : échange en cours (t1 du hub, t2 / t3 locaux)
+  ClockSync sync;
+  uint32_t xT1 = 0, xT2 = 0, xT3 = 0;
+  bool     xValid = false;
+
+  // état : faders
+  uint16_t pos[MODLINK_MAX_FADERS] = {0};
+  uint32_t posUs[MODLINK_MAX_FADERS] = {0};   // instant du dernier changement (local)
+  uint8_t  touch = 0;                 // bit ch
+  uint8_t  dirty = 0, inflight = 0;   // bits ch
+  uint8_t  txSeq = 0;
+
+  // fiable : encodeurs + notes → lot figé jusqu'à l'acquittement
+  int32_t  encAcc[MODLINK_MAX_ENC] = {0};
+  uint32_t encUs[MODLINK_MAX_ENC] = {0};      // dernier pas reçu (local)
+  Note     notes[MODLINK_NOTE_QUEUE];
+  uint8_t  nHead = 0, nTail = 0;
+  uint8_t  relSeq = 0;
+  uint8_t  rel[MODLINK_MAX_PAYLOAD];
+  size_t   relLen = 0;
+};
+
+// ===================== HUB (maître) =====================
+class ModLinkHub {
+ public:
+  typedef ModLinkLeaf::SendFn  SendFn;
+  typedef ModLinkLeaf::ItemFn  ItemFn;
+  typedef ModLinkLeaf::ClockFn ClockFn;
+
+  struct LeafStats {
+    uint32_t polls = 0, replies = 0, timeouts = 0, duplicates = 0;
+    uint32_t rttMaxUs = 0;            // POLL émis → réponse complète
+  };
+
+  // modules interrogés : adresses 1..nLeaves ; onItem reçoit faders, encodeurs, notes ;
+  // clock = horloge maître (celle que les modules suivent)
+  void begin(uint8_t nLeaves, SendFn send, ItemFn onItem, ClockFn clock, void* ctx);
+  void onBytes(const uint8_t* buf, size_t n);
+  void rxStamp(uint32_t t) { stamp = t; stamped = true; }   // début de la prochaine réponse
+  void poll();                        // réponse reçue ou délai écoulé → module suivant
+  void setTarget(uint8_t ch, uint16_t pos);   // → modules qui annoncent ce fader
+
+  uint8_t leafFaders(uint8_t addr) const { return addr >= 1 && addr <= nLeaves ? leaf[addr - 1].nFaders : 0; }
+  const LeafStats& stats(uint8_t addr) const { return leaf[addr - 1].st; }
+  const ModLinkSlip& rx() const { return slip; }
+
+ private:
+  struct Leaf {
+    uint8_t   nFaders = 0;
+    uint8_t   lastSeq = 0, lastRel = 0;
+    uint32_t  lastT4 = 0;                // réception de la dernière réponse (→ t4 du POLL suivant)
+    uint8_t   dirty = 0, inflight = 0;   // consignes à envoyer / envoyées, non acquittées
+    LeafStats st;
+  };
+
+  void handleEvents(const uint8_t* p, size_t len, uint32_t t4);
+  void sendPoll();
+  uint32_t now() const { return clock ? clock(ctx) : 0; }
+
+  uint8_t  nLeaves = 0;
+  SendFn   send = nullptr;
+  ItemFn   onItem = nullptr;
+  ClockFn  clock = nullptr;
+  void*    ctx = nullptr;
+  ModLinkSlip slip;
+  uint32_t stamp = 0;
+  bool     stamped = false;
+
+  Leaf     leaf[MODLINK_MAX_LEAVES];
+  uint16_t target[MODLINK_MAX_FADERS] = {0};
+  uint8_t  targetValid = 0;           // bits ch : consigne déjà reçue du DAW
+  uint8_t  cur = 0;                   // module interrogé (index)
+  bool     waiting = false;
+  uint32_t pollUs = 0;
+  uint8_t  txSeq = 0;
+};
@@ -0,0 +1,94 @@
+#include <Arduino.h>
+#include "hal.h"
+#include "modlink_uart.h"
+#include "modlink.h"
+#include "midi_io.h"
+#include "fader_bank.h"        // gBank.touched[]
+
+static_assert(MODLINK_SLIP_MAX <= HAL_UART_TX_MAX, "trame SLIP > tampon DMA de HALUart");
+static_assert(MODLINK_ADDR <= MODLINK_MAX_LEAVES && MODLINK_LEAVES <= MODLINK_MAX_LEAVES, "MODLINK_MAX_LEAVES");
+static_assert(MODLINK_LEAF_FADERS <= NUM_FADERS && NUM_FADERS <= MODLINK_MAX_FADERS, "faders annoncés");
+static_assert(ENC_MAX <= MODLINK_MAX_ENC, "encodeurs par module");
+
+// ===================== ÉTAT =====================
+static ModLinkHub  hub;
+static ModLinkLeaf leaf;
+static bool        active       = false;
+static bool        notesPending = false;   // hub : notes reçues, à pousser en 1 transfert USB
+
+// ===================== Callbacks =====================
+static void uartSend(void*, const uint8_t* buf, size_t len) {
+  if (MODLINK_ROLE == MODLINK_HUB) HALUart::stampArm();   // t4 : début de la réponse
+  HALUart::write(buf, len);                // occupé : trame perdue, réémise au POLL suivant
+}
+
+static uint32_t clockUs(void*) { return HALTime::micros(); }
+
+// hub : événements des modules → emplacements après les locaux (midi_io.h)
+// le tactile d'un fader distant reste au module (coupure de son moteur)
+static void onHubItem(void*, uint8_t, const ModLinkItem& it) {
+  switch (it.tag) {
+    case ML_IT_FADER: MIDIIO_sendPositionFromADC((uint8_t)(NUM_FADERS + it.index), (uint16_t)it.value); break;
+    case ML_IT_ENC:   MIDIIO_sendEncoderDelta((uint8_t)(ENC_COUNT + it.index), it.value); break;
+    case ML_IT_NOTE:
+      MIDIIO_sendNote(it.index, it.arg, (uint8_t)it.value);
+      notesPending = true;
+      break;
+  }
+}
+
+// module : consigne du DAW relayée par le hub
+static void onLeafItem(void*, uint8_t, const ModLinkItem& it) {
+  if (it.tag == ML_IT_TARGET) MIDIIO_onNetworkTarget(it.index, (uint16_t)it.value);
+}
+
+// ===================== SETUP / BOUCLE =====================
+bool setupModLink() {
+  if (MODLINK_ROLE == MODLINK_OFF) return false;
+  if (!HALUart::begin(MODLINK_PIN_TX, MODLINK_PIN_RX, MODLINK_BAUD)) return false;
+  if (MODLINK_ROLE == MODLINK_HUB) hub.begin(MODLINK_LEAVES, uartSend, onHubItem, clockUs, nullptr);
+  else                             leaf.begin(MODLINK_ADDR, MODLINK_LEAF_FADERS, uartSend, onLeafItem, clockUs, nullptr);
+  HALUart::stampArm();
+  active = true;
+  return true;
+}
+
+void loopModLink(uint32_t) {
+  if (!active) return;
+  uint8_t  buf[64];
+  size_t   n;
+  uint32_t t;
+
+  if (MODLINK_ROLE == MODLINK_LEAF) {
+    for (uint8_t i = 0; i < MODLINK_LEAF_FADERS; ++i) leaf.setTouch(i, gBank.touched[i]);
+    if (HALUart::stamp(t)) leaf.rxStamp(t);                 // t2 : début du POLL
+    while ((n = HALUart::read(buf, sizeof buf)) > 0) leaf.onBytes(buf, n);   // POLL → réponse
+    if (leaf.rxIdle()) HALUart::stampArm();                 // entre 2 trames : front suivant
+    return;
+  }
+
+  if (HALUart::stamp(t)) hub.rxStamp(t);
+  while ((n = HALUart::read(buf, sizeof buf)) > 0) hub.onBytes(buf, n);
+  if (notesPending) { MIDIIO_sendNow(); notesPending = false; }
+  for (uint8_t s = NUM_FADERS; s < MIDI_FADER_SLOTS; ++s) {
+    uint16_t v;
+    if (MIDIIO_getTargetIfUpdated(s, v)) hub.setTarget((uint8_t)(s - NUM_FADERS), v);
+  }
+  hub.poll();
+}
+
+uint32_t modLinkSharedUs(uint32_t local_us) {
+  return MODLINK_ROLE == MODLINK_LEAF && active ? leaf.toMaster(local_us) : local_us;
+}
+
+bool modLinkSynced() {
+  return MODLINK_ROLE != MODLINK_LEAF || (active && leaf.clockSync().locked());
+}
+
+// ===================== Module → hub =====================
+void modLinkFader(uint8_t i, uint16_t adc)  { if (active) leaf.setFader(i, adc); }
+void modLinkEncoder(uint8_t e, int32_t steps) { if (active) leaf.addEncoder(e, steps); }
+
+void modLinkNote(uint8_t ch, uint8_t note, uint8_t velocity) {
+  if (active) leaf.pushNote(ch, note, velocity);
+}
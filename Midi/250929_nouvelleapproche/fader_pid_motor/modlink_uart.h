@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include "hal.h"                  // HAL_UART_TX_MAX
+#include "pin_int.h"              // PicoBoard::LINK_TX / LINK_RX
+#include "fader_filtre_adc.h"     // NUM_FADERS
+#include "encoders.h"             // ENC_COUNT / ENC_PINS (broches)
+
+/*
+  Liaison inter-modules sur UART + DMA (HALUart) — protocole : modlink.h
+  Surface en 3 Pico (README) : le hub porte l'USB MIDI / l'Ethernet, les modules lui
+  remontent leurs événements ; côté DAW il n'y a qu'UN appareil MIDI / réseau.
+
+  Rôle (MODLINK_ROLE, un par firmware) :
+    MODLINK_OFF   un seul Pico fait tout (prototype actuel)
+    MODLINK_HUB   interroge MODLINK_LEAVES modules ; leurs faders / encodeurs passent par
+                  l'ordonnanceur de midi_io après les locaux (MIDI_FADER_SLOTS / MIDI_ENC_SLOTS),
+                  leurs notes partent telles quelles ; les consignes DAW des faders distants
+                  repartent vers le module
+    MODLINK_LEAF  adresse MODLINK_ADDR ; midi_io envoie au hub au lieu de l'USB, les
+                  consignes reçues deviennent des consignes réseau (MIDIIO_onNetworkTarget)
+  Tâche "link" (MODLINK_TASK_US, juste après "control") : anneau DMA → décodeur SLIP →
+  réponse (module) ou POLL suivant (hub). Latence événement → hub, 2 modules, sans
+  erreur : ≤ 2 × (MODLINK_SLOT_US + MODLINK_TASK_US) + MODLINK_TASK_US ≈ 2,75 ms ;
+  mesuré par host/modlink_loopback (notes : ~1 ms en moyenne)
+
+  Horloge commune (clock_sync.h) : l'horloge du hub fait référence ; chaque module la suit
+  via les échanges POLL / réponse, horodatés au bit de start (HALUart::stampArm / stamp).
+  modLinkSharedUs() convertit un instant local (télémétrie : journaux de plusieurs Pico
+  alignés) ; les événements remontés au hub portent déjà leur instant commun (modlink.h).
+
+  Câblage (2 fils + masse, modlink.h) : TX hub → RX des modules ; TX de chaque module →
+  cathode d'une 1N4148, anodes réunies sur RX hub + rappel 1 kΩ au 3V3 (front montant
+  assez raide pour 2 Mbauds).
+*/
+
+// ===================== RÉGLAGES (tout en haut) =====================
+enum ModLinkRole : uint8_t { MODLINK_OFF, MODLINK_HUB, MODLINK_LEAF };
+constexpr ModLinkRole MODLINK_ROLE     = MODLINK_OFF;
+constexpr uint8_t  MODLINK_ADDR        = 1;            // module : adresse 1..MODLINK_MAX_LEAVES
+constexpr uint8_t  MODLINK_LEAVES      = 2;            // hub : modules interrogés (clavier, encodeurs)
+constexpr uint8_t  MODLINK_LEAF_FADERS = NUM_FADERS;   // module : faders annoncés (0 = sans fader)
+constexpr uint32_t MODLINK_BAUD        = 2000000;
+constexpr uint32_t MODLINK_TASK_US     = 250;          // période de la tâche "link"
+constexpr uint8_t  MODLINK_PIN_TX      = PicoBoard::LINK_TX;
+constexpr uint8_t  MODLINK_PIN_RX      = PicoBoard::LINK_RX;
+
+namespace ModLinkCheck {
+// broches de la liaison libres : hors voies fader utilisées et hors encodeurs câblés
+constexpr bool pinsFree() {
+  for (uint8_t i = 0; i < NUM_FADERS; ++i) {
+    for (uint8_t p : { PicoBoard::ADC_PINS[i], PicoBoard::TOUCH_PINS[i],
+                       PicoBoard::MOTOR_PINS[i][0], PicoBoard::MOTOR_PINS[i][1] })
+      if (p == MODLINK_PIN_TX || p == MODLINK_PIN_RX) return false;
+  }
+  for (uint8_t p : PicoBoard::SHARED_PINS)
+    if (p == MODLINK_PIN_TX || p == MODLINK_PIN_RX) return false;
+  for (uint8_t e = 0; e < ENC_COUNT; ++e) {
+    const uint8_t a = PicoBoard::ENC_PINS[e];
+    for (uint8_t p : { a, (uint8_t)(a + 1) })
+      if (p == MODLINK_PIN_TX || p == MODLINK_PIN_RX) return false;
+  }
+  return true;
+}
+}  // namespace ModLinkCheck
+
+static_assert(MODLINK_ROLE == MODLINK_OFF || ModLinkCheck::pinsFree(),
+              "liaison sur une broche déjà prise : baisser ENC_COUNT / NUM_FADERS ou changer LINK_TX");
+static_assert((MODLINK_PIN_TX & 3) == 0 && MODLINK_PIN_RX == MODLINK_PIN_TX + 1, "UART : TX ∈ {0, 4, 8, ...}, RX = TX + 1");
+static_assert(MODLINK_ADDR >= 1 && MODLINK_LEAVES >= 1, "adresses des modules : 1..");
+
+// ===================== API =====================
+bool setupModLink();                         // UART + DMA selon MODLINK_ROLE ; false si OFF / absent
+void loopModLink(uint32_t now_us);           // tâche "link"
+
+// Horloge commune : instant local (HALTime::micros) → horloge du hub (identité hors module)
+uint32_t modLinkSharedUs(uint32_t local_us);
+bool     modLinkSynced();                    // module : synchro verrouillée ; sinon toujours vrai
+
+// Module : événements locaux → hub (appelés par midi_io à la place de l'USB)
+void modLinkFader(uint8_t i, uint16_t adc);
+void modLinkEncoder(uint8_t e, int32_t steps);
+void modLinkNote(uint8_t ch, uint8_t note, uint8_t velocity);
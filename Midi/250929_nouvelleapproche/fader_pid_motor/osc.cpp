@@ -0,0 +1,247 @@
+#include "osc.h"
+#include <cstring>
+
+static inline uint32_t rd32(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+static inline size_t pad4(size_t n) { return (n + 3) & ~(size_t)3; }
+
+static uint32_t fnv1a(const char* s) {
+  uint32_t h = 2166136261u;
+  while (*s) { h ^= (uint8_t)*s++; h *= 16777619u; }
+  return h;
+}
+
+// ===================== Écriture =====================
+bool OscWriter::put(const void* p, size_t n) {
+  if (!ok_ || len_ + n > cap_) { ok_ = false; return false; }
+  memcpy(buf_ + len_, p, n);
+  len_ += n;
+  return true;
+}
+
+bool OscWriter::put32(uint32_t v) {
+  const uint8_t b[4] = { (uint8_t)(v >> 24), (uint8_t)(v >> 16), (uint8_t)(v >> 8), (uint8_t)v };
+  return put(b, 4);
+}
+
+bool OscWriter::putPadded(const char* s) {
+  const size_t n = strlen(s) + 1;
+  static const uint8_t zero[4] = { 0, 0, 0, 0 };
+  return put(s, n) && put(zero, pad4(n) - n);
+}
+
+void OscWriter::beginBundle(uint64_t timetag) {
+  reset();
+  bundle_ = true;
+  putPadded("#bundle");
+  put32((uint32_t)(timetag >> 32));
+  put32((uint32_t)timetag);
+}
+
+bool OscWriter::begin(const char* addr, const char* tags, size_t& sizeAt) {
+  sizeAt = len_;
+  if (bundle_) put32(0);                 // taille de l'élément, complétée par end()
+  return putPadded(addr) && putPadded(tags);
+}
+
+void OscWriter::end(size_t sizeAt) {
+  if (!ok_) return;
+  if (bundle_) {
+    const uint32_t n = (uint32_t)(len_ - sizeAt - 4);
+    buf_[sizeAt]     = (uint8_t)(n >> 24);
+    buf_[sizeAt + 1] = (uint8_t)(n >> 16);
+    buf_[sizeAt + 2] = (uint8_t)(n >> 8);
+    buf_[sizeAt + 3] = (uint8_t)n;
+  }
+  ++count_;
+}
+
+bool OscWriter::message(const char* addr, float v) {
+  if (!bundle_ && count_) return ok_ = false;   // 1 seul message hors bundle
+  size_t at;
+  uint32_t bits;
+  memcpy(&bits, &v, 4);
+  if (!begin(addr, ",f", at) || !put32(bits)) return false;
+  end(at);
+  return true;
+}
+
+bool OscWriter::message(const char* addr, int32_t v) {
+  if (!bundle_ && count_) return ok_ = false;
+  size_t at;
+  if (!begin(addr, ",i", at) || !put32((uint32_t)v)) return false;
+  end(at);
+  return true;
+}
+
+// ===================== Lecture =====================
+// chaîne OSC bornée : rend l'octet suivant (aligné) ou nullptr
+static const uint8_t* readString(const uint8_t* p, const uint8_t* end) {
+  const uint8_t* z = (const uint8_t*)memchr(p, 0, (size_t)(end - p));
+  if (!z) return nullptr;
+  const uint8_t* next = p + pad4((size_t)(z - p) + 1);
+  return next <= end ? next : nullptr;
+}
+
+static bool parseElement(const uint8_t* p, size_t len, OscMessageFn fn, void* ctx, uint8_t depth) {
+  const uint8_t* end = p + len;
+  if (len < 4 || (len & 3)) return false;
+
+  if (p[0] == '#') {                                  // bundle
+    if (len < 16 || memcmp(p, "#bundle", 8) != 0 || depth > 4) return false;
+    const uint8_t* q = p + 16;                        // timetag ignoré (exécution immédiate)
+    while (q + 4 <= end) {
+      const uint32_t n = rd32(q);
+      q += 4;
+      if (n > (size_t)(end - q) || !parseElement(q, n, fn, ctx, (uint8_t)(depth + 1))) return false;
+      q += n;
+    }
+    return q == end;
+  }
+
+  if (p[0] != '/') return false;                      // message
+  const uint8_t* t = readString(p, end);
+  if (!t) return false;
+  OscMessage m{ (const char*)p, "", t, end };
+  if (t < end && t[0] == ',') {
+    const uint8_t* a = readString(t, end);
+    if (!a) return false;
+    m.types = (const char*)t + 1;
+    m.args  = a;
+  }
+  fn(ctx, m);
+  return true;
+}
+
+bool oscParse(const uint8_t* buf, size_t len, OscMessageFn fn, void* ctx) {
+  return parseElement(buf, len, fn, ctx, 0);
+}
+
+bool oscArgFloat(const OscMessage& m, uint8_t k, float& out) {
+  const uint8_t* a = m.args;
+  for (uint8_t j = 0; m.types[j]; ++j) {
+    const char t = m.types[j];
+    size_t sz = 0;
+    if (t == 'i' || t == 'f' || t == 'c' || t == 'r' || t == 'm') sz = 4;
+    else if (t == 'd' || t == 'h' || t == 't') sz = 8;
+    else if (t == 's' || t == 'S') { const uint8_t* n = readString(a, m.end); if (!n) return false; sz = (size_t)(n - a); }
+    else if (t == 'b') { if (a + 4 > m.end) return false; sz = 4 + pad4(rd32(a)); }
+    if (a + sz > m.end) return false;
+
+    if (j == k) {
+      if (t == 'f') { const uint32_t b = rd32(a); memcpy(&out, &b, 4); return true; }
+      if (t == 'i') { out = (float)(int32_t)rd32(a); return true; }
+      if (t == 'd') {
+        const uint64_t b = ((uint64_t)rd32(a) << 32) | rd32(a + 4);
+        double d; memcpy(&d, &b, 8); out = (float)d; return true;
+      }
+      if (t == 'T') { out = 1.0f; return true; }
+      if (t == 'F') { out = 0.0f; return true; }
+      return false;
+    }
+    a += sz;
+  }
+  return false;
+}
+
+// ===================== Motifs =====================
+// [..] : rend la position après ']' et met à jour hit
+static const char* matchClass(const char* p, char c, bool& hit) {
+  bool neg = false;
+  if (*p == '!') { neg = true; ++p; }
+  bool in = false;
+  while (*p && *p != ']') {
+    if (p[1] == '-' && p[2] && p[2] != ']') {
+      if (c >= p[0] && c <= p[2]) in = true;
+      p += 3;
+    } else {
+      if (c == *p) in = true;
+      ++p;
+    }
+  }
+  hit = (in != neg);
+  return *p ? p + 1 : p;
+}
+
+bool oscMatch(const char* p, const char* a) {
+  while (*p) {
+    switch (*p) {
+      case '?':
+        if (!*a || *a == '/') return false;
+        ++p; ++a;
+        break;
+      case '*': {
+        while (*p == '*') ++p;
+        for (const char* s = a;; ++s) {            // essaie toutes les longueurs (sans '/')
+          if (oscMatch(p, s)) return true;
+          if (!*s || *s == '/') return false;
+        }
+      }
+      case '[': {
+        if (!*a || *a == '/') return false;
+        bool hit;
+        p = matchClass(p + 1, *a, hit);
+        if (!hit) return false;
+        ++a;
+        break;
+      }
+      case '{': {                                  // {alt1,alt2}
+        const char* close = strchr(p, '}');
+        if (!close) return false;
+        const char* alt = p + 1;
+        while (alt <= close) {
+          const char* sep = alt;
+          while (sep < close && *sep != ',') ++sep;
+          const size_t n = (size_t)(sep - alt);
+          if (strncmp(alt, a, n) == 0 && oscMatch(close + 1, a + n)) return true;
+          alt = sep + 1;
+        }
+        return false;
+      }
+      default:
+        if (*p != *a) return false;
+        ++p; ++a;
+    }
+  }
+  return *a == 0;
+}
+
+// ===================== Table d'adresses =====================
+int8_t OscAddressTable::add(const char* addr) {
+  if (n_ >= OSC_MAX_ADDR || strlen(addr) >= OSC_ADDR_LEN) return -1;
+  const uint8_t id = n_++;
+  strcpy(addr_[id], addr);
+  for (uint8_t k = 0, h = (uint8_t)(fnv1a(addr) & (OSC_HASH_SLOTS - 1)); k < OSC_HASH_SLOTS;
+       ++k, h = (uint8_t)((h + 1) & (OSC_HASH_SLOTS - 1))) {
+    if (!slot_[h]) { slot_[h] = (uint8_t)(id + 1); break; }
+  }
+  cNext_ = 0;                                          // la table a changé : cache vidé
+  memset(cPat_, 0, sizeof cPat_);
+  return (int8_t)id;
+}
+
+uint32_t OscAddressTable::resolve(const char* pattern) {
+  if (!strpbrk(pattern, "*?[{")) {                     // adresse exacte : hachage
+    for (uint8_t k = 0, h = (uint8_t)(fnv1a(pattern) & (OSC_HASH_SLOTS - 1)); k < OSC_HASH_SLOTS;
+         ++k, h = (uint8_t)((h + 1) & (OSC_HASH_SLOTS - 1))) {
+      if (!slot_[h]) return 0;
+      if (strcmp(addr_[slot_[h] - 1], pattern) == 0) return 1UL << (slot_[h] - 1);
+    }
+    return 0;
+  }
+
+  for (uint8_t c = 0; c < OSC_PATTERN_CACHE; ++c) {    // motif déjà vu ?
+    if (cPat_[c][0] && strcmp(cPat_[c], pattern) == 0) return cMask_[c];
+  }
+  uint32_t mask = 0;
+  for (uint8_t id = 0; id < n_; ++id) {
+    if (oscMatch(pattern, addr_[id])) mask |= 1UL << id;
+  }
+  if (strlen(pattern) < OSC_ADDR_LEN) {
+    strcpy(cPat_[cNext_], pattern);
+    cMask_[cNext_] = mask;
+    cNext_ = (uint8_t)((cNext_ + 1) % OSC_PATTERN_CACHE);
+  }
+  return mask;
+}
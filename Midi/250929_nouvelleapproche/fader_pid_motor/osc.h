@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+/*
+  OSC 1.0 (Open Sound Control) — codage/décodage sans allocation
+  Code portable (pas d'Arduino) : osc_eth.cpp (W5500) et host/osc_peer.cpp (Linux)
+
+  Écriture : OscWriter sur un tampon fixe
+    - message seul : w.message("/fader/1", 0.5f)
+    - bundle       : w.beginBundle(); w.message(...); w.message(...); → 1 datagramme
+  Lecture : oscParse() déroule les bundles (récursifs) et appelle le callback par message
+
+  Table d'adresses (OscAddressTable) : l'espace d'adresses est figé au démarrage
+    - adresse exacte → table de hachage (FNV-1a, sondage linéaire) : O(1), sans strcmp en boucle
+    - motif OSC (* ? [a-z] [!..] {a,b}) → comparé UNE fois à toutes les adresses,
+      le masque obtenu est mis en cache (OSC_PATTERN_CACHE derniers motifs)
+*/
+
+// ===================== RÉGLAGES =====================
+constexpr size_t  OSC_MAX_PACKET    = 512;
+constexpr uint8_t OSC_MAX_ADDR      = 32;  // entrées de la table (masque 32 bits)
+constexpr uint8_t OSC_ADDR_LEN      = 24;  // "/fader/12/touch" + marge
+constexpr uint8_t OSC_HASH_SLOTS    = 64;  // puissance de 2, ≥ 2 × OSC_MAX_ADDR
+constexpr uint8_t OSC_PATTERN_CACHE = 4;
+
+// ===================== Écriture =====================
+class OscWriter {
+ public:
+  OscWriter(uint8_t* buf, size_t cap) : buf_(buf), cap_(cap) {}
+
+  void beginBundle(uint64_t timetag = 1);          // 1 = "immédiat"
+  bool message(const char* addr, float v);         // ,f
+  bool message(const char* addr, int32_t v);       // ,i
+  bool ok() const    { return ok_; }
+  size_t size() const { return ok_ ? len_ : 0; }
+  uint8_t count() const { return count_; }         // messages écrits
+  void reset() { len_ = 0; count_ = 0; bundle_ = false; ok_ = true; }
+
+ private:
+  bool put(const void* p, size_t n);
+  bool putPadded(const char* s);                   // chaîne + '\0' + bourrage à 4
+  bool put32(uint32_t v);
+  bool begin(const char* addr, const char* tags, size_t& sizeAt);
+  void end(size_t sizeAt);
+
+  uint8_t* buf_;
+  size_t   cap_;
+  size_t   len_ = 0;
+  uint8_t  count_ = 0;
+  bool     bundle_ = false;
+  bool     ok_ = true;
+};
+
+// ===================== Lecture =====================
+struct OscMessage {
+  const char*    addr;
+  const char*    types;     // sans la ','
+  const uint8_t* args;
+  const uint8_t* end;
+};
+
+typedef void (*OscMessageFn)(void* ctx, const OscMessage& m);
+
+// Rend false si le paquet est mal formé (les messages valides déjà vus sont livrés)
+bool oscParse(const uint8_t* buf, size_t len, OscMessageFn fn, void* ctx);
+
+// Argument k converti en float (f, i, d, T, F) ; false si absent / autre type
+bool oscArgFloat(const OscMessage& m, uint8_t k, float& out);
+
+// Motif OSC 1.0 contre une adresse ('*' ne traverse pas '/')
+bool oscMatch(const char* pattern, const char* addr);
+
+// ===================== Table d'adresses =====================
+class OscAddressTable {
+ public:
+  // Ajoute une adresse ; rend son identifiant (0..OSC_MAX_ADDR-1) ou -1 si pleine
+  int8_t add(const char* addr);
+  // Adresse exacte ou motif → masque des identifiants concernés (0 = aucun)
+  uint32_t resolve(const char* pattern);
+  const char* name(uint8_t id) const { return addr_[id]; }
+  uint8_t size() const { return n_; }
+
+ private:
+  char     addr_[OSC_MAX_ADDR][OSC_ADDR_LEN] = {};
+  uint8_t  n_ = 0;
+  uint8_t  slot_[OSC_HASH_SLOTS] = {};             // id + 1 (0 = vide)
+  // cache des motifs récents
+  char     cPat_[OSC_PATTERN_CACHE][OSC_ADDR_LEN] = {};
+  uint32_t cMask_[OSC_PATTERN_CACHE] = {};
+  uint8_t  cNext_ = 0;
+};
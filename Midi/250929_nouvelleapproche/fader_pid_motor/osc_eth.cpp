@@ -0,0 +1,85 @@
+#include <Arduino.h>
+#include <cstdio>
+#include <Ethernet.h>
+#include <EthernetUdp.h>
+#include "osc_eth.h"
+#include "osc.h"
+#include "rtpmidi_eth.h"       // setupEthernet()
+#include "midi_io.h"           // MIDIIO_onNetworkTarget
+#include "fader_bank.h"        // gBank.touched[]
+
+// ===================== ÉTAT =====================
+static EthernetUDP     udp;
+static bool            oscUp = false;
+static IPAddress       clientIp;
+static bool            clientKnown = false;
+
+static OscAddressTable addrTable;            // id 2i = /fader/N, 2i+1 = /fader/N/touch
+static uint8_t         rxBuf[OSC_MAX_PACKET];
+static uint8_t         txBuf[OSC_MAX_PACKET];
+static OscWriter       tx(txBuf, sizeof txBuf);
+static bool            touchSent[MAX_FADERS] = {false};
+
+// ===================== Réception =====================
+static void onOscMessage(void*, const OscMessage& m) {
+  uint32_t mask = addrTable.resolve(m.addr) & 0x55555555UL;  // /fader/N seulement
+  float v;
+  if (!mask || !oscArgFloat(m, 0, v)) return;
+  if (v < 0.0f) v = 0.0f;
+  if (v > 1.0f) v = 1.0f;
+  const uint16_t adc = (uint16_t)(v * ADC_MAX + 0.5f);
+  while (mask) {
+    const uint8_t id = (uint8_t)__builtin_ctzl(mask);
+    mask &= mask - 1;
+    MIDIIO_onNetworkTarget((uint8_t)(id / 2), adc);
+  }
+}
+
+// ===================== SETUP/LOOP =====================
+void setupOsc() {
+  if (!OSC_ENABLE || !setupEthernet()) return;
+  char a[OSC_ADDR_LEN];
+  for (uint8_t i = 0; i < NUM_FADERS; ++i) {
+    snprintf(a, sizeof a, "/fader/%u", i + 1);
+    addrTable.add(a);
+    snprintf(a, sizeof a, "/fader/%u/touch", i + 1);
+    addrTable.add(a);
+  }
+  udp.begin(OSC_LOCAL_PORT);
+  oscUp = true;
+}
+
+void loopOsc() {
+  if (!oscUp) return;
+  int n;
+  while ((n = udp.parsePacket()) > 0) {
+    clientIp    = udp.remoteIP();
+    clientKnown = true;
+    const int len = udp.read(rxBuf, sizeof rxBuf);
+    if (len > 0) oscParse(rxBuf, (size_t)len, onOscMessage, nullptr);
+  }
+}
+
+bool oscActive() { return oscUp && clientKnown; }
+
+// ===================== Émission groupée =====================
+void oscBeginBundle() {
+  if (oscActive()) tx.beginBundle();
+}
+
+void oscAddFader(uint8_t i, uint16_t adc) {
+  if (!oscActive() || i >= NUM_FADERS) return;
+  tx.message(addrTable.name((uint8_t)(2 * i)), (float)adc / (float)ADC_MAX);
+}
+
+void oscEndBundle() {
+  if (!oscActive()) return;
+  for (uint8_t i = 0; i < NUM_FADERS; ++i) {
+    if (gBank.touched[i] == touchSent[i]) continue;
+    if (tx.message(addrTable.name((uint8_t)(2 * i + 1)), (int32_t)gBank.touched[i])) touchSent[i] = gBank.touched[i];
+  }
+  if (!tx.count() || !tx.ok()) return;
+  udp.beginPacket(clientIp, OSC_REMOTE_PORT);
+  udp.write(txBuf, tx.size());
+  udp.endPacket();
+}
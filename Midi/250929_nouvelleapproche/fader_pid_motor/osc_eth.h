@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+
+/*
+  Surface OSC sur UDP (W5500, même Ethernet que rtpmidi_eth.h)
+  Protocole : osc.h (bundles, table d'adresses précompilée)
+
+  Espace d'adresses (N = 1..NUM_FADERS) :
+    /fader/N         float 0..1 (pleine résolution ADC, pas de limite 7 bits)
+    /fader/N/touch   int 0/1 (sortie seulement)
+  Réception : /fader/N f|i|d → consigne ; les motifs OSC sont acceptés (ex. /fader/{1,2} 0.5)
+  Émission  : 1 bundle par tick (MIDIIO_flush) avec tous les faders changés + les
+              changements tactiles → 1 datagramme UDP vers le dernier client vu,
+              port OSC_REMOTE_PORT (convention TouchOSC 8000/9000)
+*/
+
+// ===================== RÉGLAGES (tout en haut) =====================
+constexpr bool     OSC_ENABLE      = true;   // actif seulement si ETH_ENABLE
+constexpr uint16_t OSC_LOCAL_PORT  = 8000;   // on écoute ici
+constexpr uint16_t OSC_REMOTE_PORT = 9000;   // on répond au client sur ce port
+
+// ===================== API =====================
+void setupOsc();
+void loopOsc();                              // lit les datagrammes → consignes
+bool oscActive();                            // un client OSC est connu
+void oscBeginBundle();                       // appelés par MIDIIO_flush()
+void oscAddFader(uint8_t i, uint16_t adc);
+void oscEndBundle();                         // + changements tactiles, puis envoi
@@ -2,15 +2,11 @@
 #pragma once
 #include <cstdint>
 #include <cmath>
-#include "motor.h"
-#include "fader_filtre_adc.h"
 
 //==================== DBUG+MODE TEST =====================
 
 // ===================== "données défini dans d'autre fichier " =====================
-// uint16_t gFaderADC[NUM_MOTOR]  // positions réelles => fader_filtre_adc.h
-// uint16_t setPosition[NUM_MOTOR]; // consignes => fader+pid+motor.ino
-// int16_t  Dirmotor[NUM_MOTOR];    // sortie PID signée => motor.h
+// Une instance PID par fader, avec consignes (setpoint) et sorties (drive) : gBank (fader_bank.h)
 // uint8_t bash_test_pid; // active ou non com scrypte python =>has_serial.h
 
 // ===================== PID instances =====================
@@ -78,7 +74,7 @@ class PID {
         int32_t newIntegral = integral + int32_t(error);
 
         // PID (P + I + D)
-        float u = kp * error + ki_Ts * float(integral) + kd_Ts * diff;
+        float u = kp * error + ki_Ts * float(integral) + iHeld + kd_Ts * diff;
 
         // saturation + anti-windup simple
         if (u >  maxOutput) u =  maxOutput;
@@ -88,10 +84,33 @@ class PID {
         return u; // [-maxOutput .. +maxOutput]
     }
 
+    // gains changés en marche (séquencement, gain_schedule.h) : le terme I ne saute pas
+    // (transfert sans à-coup) :
+    //   Ki > 0 → Ki' > 0  intégrale remise à l'échelle Ki / Ki'
+    //   Ki > 0 → 0        terme I figé dans iHeld (constant), intégrale remise à 0
+    //   0 → Ki' > 0       iHeld repris dans l'intégrale (iHeld / Ki'), puis 0
+    void setGainsBumpless(float kpNew, float kiNew, float kdNew) {
+        const float kiTs = kiNew * Ts;
+        if (kiTs <= 0) {
+            if (ki_Ts > 0) iHeld += ki_Ts * float(integral);
+            integral = 0;
+        } else if (kiTs != ki_Ts || iHeld != 0) {
+            const float lim = maxOutput / kiTs;         // au-delà, le terme I seul sature
+            float v = (ki_Ts > 0 ? ki_Ts * float(integral) : 0.0f) + iHeld;
+            v /= kiTs;
+            v = v > lim ? lim : (v < -lim ? -lim : v);
+            integral = int32_t(v >= 0 ? v + 0.5f : v - 0.5f);
+            iHeld = 0;
+        }
+        kp    = kpNew;
+        ki_Ts = kiTs;
+        setKd(kdNew);
+    }
+
     // options utiles
     void setMaxOutput(float m) { maxOutput = m; }
     float getMaxOutput() const { return maxOutput; }
-    void resetIntegral() { integral = 0; }
+    void resetIntegral() { integral = 0; iHeld = 0; }
     void resetActivityCounter() { activityCount = 0; }
     void setActivityTimeout(float s) {
         activityThres = (s <= 0) ? 0 : (uint16_t)(s / Ts);
@@ -117,14 +136,13 @@ class PID {
     // état
     float    prevInput     = 0.0f;
     int32_t  integral      = 0;
+    float    iHeld         = 0.0f;   // terme I figé (passage à Ki = 0, setGainsBumpless)
     uint16_t setpoint      = 0;
     uint16_t activityCount = 0;
     uint16_t activityThres = 0;
     uint8_t  errThres      = 1;
     };
 
-extern PID* gPid[NUM_MOTOR];
-
 // ======================= Constantes PID ====================
 
    // Valeurs par défaut
@@ -140,15 +158,10 @@ extern float kp, ki, kd, ts, fc;
     // Valeurs injectable par python
 extern float kp_python, ki_python, kd_python, ts_python, fc_python;
 
-// ======================= constantes externes =====================
-extern int16_t Dirmotor[NUM_MOTOR] ;    // sortie PID signée => motor.h
-extern uint16_t setPosition[NUM_MOTOR]; // consignes => fader+pid+motor.ino
-
 // ====================== API =====================
 void initial_PIDv(bool use_python); // choisit défaut/python et (re)crée les PID
 void pidBegin();                    // (re)crée les PID avec kp/ki/kd/ts/fc courants
-void loopPID(uint8_t i);            // met à jour 1 PID (remplit Dirmotor[i])
-void pidEnd();                     // détruit les PID (libère la mémoire)
+void loopPID(uint8_t i);            // met à jour 1 PID (remplit gBank.drive[i])
 
 
 
@@ -1,4 +1,58 @@
-/*  
-    partie à faire récupérer tout les pin du pico 
-    uttilsier pour centraliser toute les données
+#pragma once
+#include <cstdint>
+
+/*
+    Toutes les broches du Pico au même endroit (numéros GPIO RP2040)
+    PicoBoard sert de Config à FaderBank (fader_bank.h) : les tables par voie y sont
+    vérifiées à la compilation (broches distinctes, ADC sur GP26..29, pas de conflit
+    avec l'OLED, le W5500 ou le bouton de scène).
+
+    Voie i (fader i) : curseur → ADC_PINS[i], piste tactile → TOUCH_PINS[i],
+                       pont en H → MOTOR_PINS[i] = { IN1, IN2 }
+    Matrice de touches (key_matrix.h) : 2× 74HC595 → rangées, 2× 74HC165 → colonnes ;
+    KEY_CLK et KEY_LATCH consécutives (side-set du programme PIO, HALKeyScan)
+    Encodeur e (encoders.h) : A → ENC_PINS[e], B → ENC_PINS[e] + 1 (paire lue par PIO) ;
+    pris sur les broches des voies 1..3 (libres avec NUM_FADERS = 1), vérifié dans encoders.h
+    Liaison inter-modules (modlink_uart.h) : UART0 sur LINK_TX / LINK_RX (voies 2..3) ;
+    hors rôle MODLINK_OFF, vérifié dans modlink_uart.h contre faders et encodeurs
 */
+
+struct PicoBoard {
+  static constexpr uint8_t NUM_GPIO     = 30;
+  static constexpr uint8_t MAX_CHANNELS = 4;     // 4 entrées ADC sur le RP2040
+
+  // ---- par voie ----
+  static constexpr uint8_t ADC_PINS[MAX_CHANNELS]      = { 26, 27, 28, 29 };  // A0..A3
+  static constexpr uint8_t TOUCH_PINS[MAX_CHANNELS]    = { 2, 3, 6, 7 };      // 1 MΩ → 3V3
+  static constexpr uint8_t MOTOR_PINS[MAX_CHANNELS][2] = {
+    { 18, 17 },   // M1
+    { 16, 15 },   // M2
+    { 14, 13 },   // M3
+    { 12, 11 },   // M4
+  };
+
+  // ---- périphériques partagés ----
+  static constexpr uint8_t OLED_SDA  = 4;
+  static constexpr uint8_t OLED_SCL  = 5;
+  static constexpr uint8_t SCENE_BTN = 8;        // bouton scène suivante (à la masse)
+  static constexpr uint8_t ETH_MOSI  = 19;       // W5500 sur SPI0
+  static constexpr uint8_t ETH_MISO  = 20;
+  static constexpr uint8_t ETH_CS    = 21;
+  static constexpr uint8_t ETH_SCK   = 22;
+  static constexpr uint8_t KEY_SER   = 0;        // → SER du 1er 595 (rangées)
+  static constexpr uint8_t KEY_QH    = 1;        // ← QH du 165 de tête (colonnes), rappel interne
+  static constexpr uint8_t KEY_CLK   = 9;        // SRCLK des 595 + CLK des 165
+  static constexpr uint8_t KEY_LATCH = 10;       // RCLK des 595 + /PL des 165 (= KEY_CLK + 1)
+
+  static constexpr uint8_t SHARED_PINS[] = { OLED_SDA, OLED_SCL, SCENE_BTN, ETH_MOSI, ETH_MISO, ETH_CS, ETH_SCK,
+                                             KEY_SER, KEY_QH, KEY_CLK, KEY_LATCH };
+  // ---- encodeurs (broches des voies 1..3 : touches 6/7, ponts 11..16, curseurs 27/28) ----
+  static constexpr uint8_t ENC_PINS[] = { 11, 13, 6, 15, 27 };
+  // ---- liaison inter-modules (UART0 : TX ∈ {0, 12, 16, 28}, RX = TX + 1) ----
+  static constexpr uint8_t LINK_TX = 12;
+  static constexpr uint8_t LINK_RX = 13;
+
+  static_assert(KEY_LATCH == KEY_CLK + 1, "side-set PIO : KEY_CLK et KEY_LATCH consécutives");
+
+  static constexpr bool isAdcPin(uint8_t pin) { return pin >= 26 && pin <= 29; }
+};
@@ -1,8 +1,17 @@
 # SLIP.py – mini-wrapper sans dépendances
 # Fournit: write_slip(ser, payload: bytes), read_slip(ser) -> list|bytes|None
+#          SlipReader(ser).read_frame() -> bytes|None (lecture par blocs, binaire)
+#          decode_telemetry(payload) -> dict (trames 'T' de telemetry.h, v1 brute / v2 delta)
+#          decode_step(payload) -> dict (trames 'R' de step_metrics.h, 1 par mouvement)
+#          open_port(nom, baud, timeout) -> port série, ou UdpPort si nom = "udp:IP[:port]"
+#          (lien hôte UDP du module PoE, host_link.h)
 # Encodage SLIP minimal: encode bytes et termine par END (0xC0).
 # read_slip lit jusqu’à END et tente de parser en champs tabulés.
 
+import socket
+import struct
+import time
+
 END = 0xC0
 ESC = 0xDB
 ESC_END = 0xDC
@@ -75,4 +84,203 @@ def read_slip(ser):
             return decoded
         else:
             buf.append(b[0])
-            
\ No newline at end of file
+            
+
+# ---------------------------------------------------------------------------
+# Lien hôte en UDP (host_link.h) : même surface que serial.Serial pour ce module
+# ---------------------------------------------------------------------------
+HOSTLINK_UDP_PORT = 9100
+
+class UdpPort:
+    """read / write / in_waiting / reset_input_buffer / timeout comme serial.Serial.
+    Le Pico répond au dernier émetteur vu : on se signale dès l'ouverture (END seul,
+    ignoré par le décodeur SLIP). Un datagramme perdu = trame perdue (CRC / seq)."""
+
+    def __init__(self, host, port=HOSTLINK_UDP_PORT, timeout=None):
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.connect((host, port))
+        self.timeout = timeout
+        self.buf = bytearray()
+        self.write(bytes([END]))
+
+    def _pull(self, wait):
+        self.sock.settimeout(wait)
+        try:
+            while True:
+                self.buf += self.sock.recv(2048)
+                self.sock.settimeout(0)        # le reste sans attendre
+        except (BlockingIOError, socket.timeout, ConnectionRefusedError):
+            pass
+
+    @property
+    def in_waiting(self):
+        self._pull(0)
+        return len(self.buf)
+
+    def read(self, n=1):
+        deadline = None if self.timeout is None else time.monotonic() + self.timeout
+        while len(self.buf) < n:
+            left = None if deadline is None else deadline - time.monotonic()
+            if left is not None and left <= 0:
+                break
+            self._pull(left)
+        out = bytes(self.buf[:n])
+        del self.buf[:n]
+        return out
+
+    def write(self, data):
+        try:
+            return self.sock.send(data)
+        except ConnectionRefusedError:         # ICMP d'un envoi précédent : rien n'écoute
+            return 0
+
+    def reset_input_buffer(self):
+        self._pull(0)
+        self.buf.clear()
+
+    def close(self):
+        self.sock.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+def open_port(name, baud=1_000_000, timeout=None):
+    """'udp:192.168.1.50[:9100]' → UdpPort ; sinon port série (pyserial)."""
+    if name.startswith('udp:'):
+        host, _, port = name[4:].partition(':')
+        return UdpPort(host, int(port) if port else HOSTLINK_UDP_PORT, timeout)
+    from serial import Serial
+    return Serial(name, baud, timeout=timeout)
+
+
+# ---------------------------------------------------------------------------
+# Lecture binaire par blocs (télémétrie haut débit)
+# ---------------------------------------------------------------------------
+class SlipReader:
+    """Lit le port par blocs (in_waiting) et découpe les trames SLIP.
+    read_frame() rend la prochaine trame décodée (bytes) ou None si timeout."""
+
+    def __init__(self, ser):
+        self.ser = ser
+        self.buf = bytearray()
+        self.frames = []
+
+    def read_frame(self):
+        while not self.frames:
+            chunk = self.ser.read(max(1, self.ser.in_waiting))
+            if not chunk:
+                return None
+            self.buf += chunk
+            *done, rest = self.buf.split(bytes([END]))
+            self.buf = bytearray(rest)
+            self.frames += [_decode_slip(f) for f in done if f]
+        return self.frames.pop(0)
+
+
+TELEM_TAG = ord('T')
+TELEM_HEADER = 16
+TELEM_V_RAW, TELEM_V_DELTA = 1, 2
+TELEM_F_CRC = 0x80
+
+def crc16_ccitt(data: bytes, crc: int = 0xFFFF) -> int:
+    """CRC-16/CCITT-FALSE — même calcul que crc16.h"""
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+def _read_varint(buf, pos):
+    u = shift = 0
+    while True:
+        b = buf[pos]
+        pos += 1
+        u |= (b & 0x7F) << shift
+        if not b & 0x80:
+            return u, pos
+        shift += 7
+
+def _unzigzag(u):
+    return (u >> 1) ^ -(u & 1)
+
+def _wrap16(v):
+    return ((v + 0x8000) & 0xFFFF) - 0x8000
+
+def decode_telemetry(payload: bytes):
+    """Trame 'T' (telemetry.h, v1 brute ou v2 delta — telemetry_codec.h) → dict :
+       seq, mask, faders (liste d'index), t0_us, period_us, dropped, version,
+       samples = [(t_us, {fader: (consigne, mesure, commande)}), ...]
+       None si ce n'est pas une trame de télémétrie valide (ou CRC faux)."""
+    if len(payload) < TELEM_HEADER or payload[0] != TELEM_TAG:
+        return None
+    version = payload[1] & ~TELEM_F_CRC
+    if version not in (TELEM_V_RAW, TELEM_V_DELTA):
+        return None
+    if payload[1] & TELEM_F_CRC:
+        if len(payload) < TELEM_HEADER + 2:
+            return None
+        if crc16_ccitt(payload[:-2]) != struct.unpack_from('<H', payload, len(payload) - 2)[0]:
+            return None
+        payload = payload[:-2]
+    seq, mask, n, nf, t0, period, dropped = struct.unpack_from('<HHBBIHH', payload, 2)
+    faders = [i for i in range(16) if mask & (1 << i)]
+    stride = len(faders) * nf
+    if n == 0 or stride == 0:
+        return None
+    if version == TELEM_V_RAW:
+        if len(payload) != TELEM_HEADER + 2 * n * stride:
+            return None
+        vals = struct.unpack_from('<%dh' % (n * stride), payload, TELEM_HEADER)
+        rows = [vals[k * stride:(k + 1) * stride] for k in range(n)]
+    else:
+        try:
+            row = list(struct.unpack_from('<%dh' % stride, payload, TELEM_HEADER))
+            pos = TELEM_HEADER + 2 * stride
+            bm_len = (stride + 7) // 8
+            rows = [tuple(row)]
+            for _ in range(1, n):
+                bm = payload[pos:pos + bm_len]
+                if len(bm) != bm_len:
+                    return None
+                pos += bm_len
+                for j in range(stride):
+                    if bm[j >> 3] & (1 << (j & 7)):
+                        u, pos = _read_varint(payload, pos)
+                        row[j] = _wrap16(row[j] + _unzigzag(u))
+                rows.append(tuple(row))
+        except (IndexError, struct.error):
+            return None
+        if pos != len(payload):
+            return None
+    samples = []
+    for k, row in enumerate(rows):
+        samples.append(((t0 + k * period) & 0xFFFFFFFF,
+                        {f: tuple(row[j * nf:(j + 1) * nf]) for j, f in enumerate(faders)}))
+    return dict(seq=seq, mask=mask, faders=faders, t0_us=t0, period_us=period,
+                dropped=dropped, version=version, samples=samples)
+
+
+STEP_TAG = ord('R')
+STEP_VERSION = 1
+STEP_NONE = 0xFFFFFFFF
+STEP_FLAGS = {0x01: 'etabli', 0x02: 'timeout', 0x04: 'interrompu', 0x08: 'annule'}
+
+def decode_step(payload: bytes):
+    """Trame 'R' (step_metrics.h) → dict : fader, flags (liste de noms), seq, lost, t0_us,
+       from_, to, band, reversals, rise_us / settle_us / duration_us (None = non atteint),
+       overshoot, ss_error, iae, energy. None si ce n'en est pas une (ou CRC faux)."""
+    if len(payload) != 48 or payload[0] != STEP_TAG or payload[1] != STEP_VERSION:
+        return None
+    if crc16_ccitt(payload[:-2]) != struct.unpack_from('<H', payload, 46)[0]:
+        return None
+    (fader, flags, seq, lost, t0, frm, to, band, rev, rise, settle, dur, over,
+     ss, iae, energy) = struct.unpack_from('<BBHHIHHHHIIIHfff', payload, 2)
+    opt = lambda v: None if v == STEP_NONE else v
+    return dict(fader=fader, flags=[n for b, n in STEP_FLAGS.items() if flags & b], seq=seq,
+                lost=lost, t0_us=t0, from_=frm, to=to, band=band, reversals=rev,
+                rise_us=opt(rise), settle_us=opt(settle), duration_us=dur, overshoot=over,
+                ss_error=ss, iae=iae, energy=energy)
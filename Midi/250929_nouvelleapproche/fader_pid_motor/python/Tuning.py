@@ -3,6 +3,7 @@ Tuning.py — lance automatiquement les essais PID (Pico) et sauvegarde la figur
 - Envoie Kp/Ki/Kd/Ts/fc au Pico via SLIP pour **un fader choisi globalement** (fader_idx)
 - Envoie 's<i>' pour démarrer l'essai du fader i (speed_div)
 - Log les données dans ./data/*.tsv
+  (capture par host/telemetry_capture si le binaire est compilé : ./data/*.fpcap, voir capture.py)
 - Trace 1 figure avec 4 sous-graphiques et SAUVEGARDE en .svg et .png
 """
 
@@ -17,15 +18,23 @@ from os import chdir, makedirs
 from pathlib import Path
 from datetime import datetime
 from serial.tools import list_ports
-import glob, sys
-from SLIP import read_slip, write_slip
+import glob, os, sys, subprocess
+from SLIP import read_slip, write_slip, SlipReader, decode_telemetry, open_port
+from hostproto import HostLink, ProtocolError
+from capture import load_capture, write_tsv
 
 # ------------------ Réglages ------------------
 BAUDRATE = 1_000_000
 TIMEOUT  = 0.5
 
 def autodetect_port() -> str | None:
-    """Détection auto du port (macOS/Linux/Windows). Préférence RP2040 (VID 0x2E8A)."""
+    """Détection auto du port (macOS/Linux/Windows). Préférence RP2040 (VID 0x2E8A).
+    FADER_PORT (variable d'environnement) l'impose, ex. le pty du simulateur host/sim :
+    FADER_PORT=/tmp/fader0 python Tuning.py
+    ou le lien UDP d'un module PoE (host_link.h) : FADER_PORT=udp:192.168.1.50 python Tuning.py"""
+    forced = os.environ.get('FADER_PORT')
+    if forced:
+        return forced
     # Essais rapides via glob
     cands = sorted(
         glob.glob('/dev/tty.usbmodem*') +
@@ -100,35 +109,79 @@ def get_readable_name(tuning: tuple):
         name += ' (SMA)'
     return name
 
-def set_tuning(ser: Serial, tuning: tuple):
-    """Envoie Kp, Ki, Kd, Ts, Fc pour l'index choisi en SLIP.
-    Format Pico: b'<key><idx>' + float32 LE, keys = ('p','i','d','t','c').
+CALIB_PARAMS = ('usable_min', 'usable_max', 'snap_low', 'snap_high', 'deadband')
+
+def set_tuning(ser: Serial, tuning: tuple) -> dict:
+    """Envoie Kp, Ki, Kd, Ts, Fc pour l'index choisi.
+    Protocole binaire (hostproto.py) : rafale de SET, chaque valeur acquittée (ACK/NACK).
+    Repli sur l'ancien format b'<key><idx>' + float32 LE si le firmware ne répond pas au HELLO.
+    Rend les métadonnées de l'essai (réglages, calibration et version firmware si connues).
     """
     idx, Kp, Ki, Kd, Ts, Fc = parse_tuning(tuning)
+    meta = dict(fader_idx=idx, kp=Kp, ki=Ki, kd=Kd, ts=Ts, fc=Fc, speed_div=speed_div, sma=int(sma))
+    link = HostLink(ser)
+    try:
+        hello = link.hello()
+        # ts recrée les PID avec les gains "python" → on l'envoie en premier
+        link.set_many([('ts', 0, Ts), ('kp', idx, Kp), ('ki', idx, Ki), ('kd', idx, Kd),
+                       ('fc', 0, Fc), ('fader_idx', 0, idx)])
+        fw = hello['fw']
+        meta['firmware'] = f"{fw >> 16}.{(fw >> 8) & 0xFF}.{fw & 0xFF}"
+        for name in CALIB_PARAMS:
+            meta[name] = link.get(name)
+        return meta
+    except ProtocolError as e:
+        print(f"[WARN] protocole binaire indisponible ({e}) → ancien format")
     keys = ('p', 'i', 'd', 't', 'c')
     values = (Kp, Ki, Kd, Ts, Fc)
     for key, value in zip(keys, values):
         payload = (key + str(idx)).encode() + struct.pack('<f', float(value))
         write_slip(ser, payload)
         sleep(0.01)
+    return meta
 
 def start(ser: Serial, tuning: tuple):
     idx, *_ = parse_tuning(tuning)
+    try:
+        HostLink(ser).start(idx, speed_div)
+        return
+    except ProtocolError:
+        pass
     msg = ('s' + str(idx)).encode() + struct.pack('<f', speed_div)
     write_slip(ser, msg)
 
+def capture_with_daemon(filename: Path, f, meta: dict) -> bool:
+    """Lecture déléguée à host/telemetry_capture (C++, lectures par blocs, fichier .fpcap mmap
+    avec les réglages en métadonnées) : s'arrête après 8 s sans trame comme la boucle Python,
+    puis écrit le .tsv habituel dans f."""
+    cap_path = filename.with_suffix('.fpcap')
+    args = [str(CAPTURE_BIN), '-d', SERIAL_PORT, '-o', str(cap_path), '-I', '8']
+    for k, v in meta.items():
+        args += ['-m', f'{k}={v}']
+    res = subprocess.run(args)
+    if res.returncode != 0:
+        print(f"[WARN] telemetry_capture a échoué (code {res.returncode})")
+        return False
+    cap = load_capture(cap_path)
+    if fader_idx not in cap['faders']:
+        print(f"[WARN] fader {fader_idx} absent de la capture {cap['faders']}")
+        return False
+    write_tsv(cap, fader_idx, f)
+    return True
+
 # ------------------ Script principal ------------------
 root = Path(__file__).parent
 chdir(root)
 DATA_DIR    = root / 'data'
 RESULTS_DIR = root / 'results'
+CAPTURE_BIN = root.parent / 'host' / 'telemetry_capture'   # g++ … (voir l'en-tête du .cpp)
 DATA_DIR.mkdir(exist_ok=True)
 RESULTS_DIR.mkdir(exist_ok=True)
 
 fig, axs = plt.subplots(len(tunings), 1, sharex='all', sharey='all',
                         figsize=(12, 8), squeeze=False)
 
-with Serial(SERIAL_PORT, BAUDRATE, timeout=TIMEOUT) as ser:
+with open_port(SERIAL_PORT, BAUDRATE, timeout=TIMEOUT) as ser:
     for i, tuning in enumerate(tunings):
         print(get_readable_name(tuning))
         filename = DATA_DIR / ('data' + get_tuning_name(tuning) + '.tsv')
@@ -137,23 +190,48 @@ with Serial(SERIAL_PORT, BAUDRATE, timeout=TIMEOUT) as ser:
             ser.reset_input_buffer()
 
             # Applique les PID
-            set_tuning(ser, tuning)
+            meta = set_tuning(ser, tuning)
             ser.reset_input_buffer()
 
             # Démarre automatiquement l'expérience (pas d'attente longue)
             start(ser, tuning)
+            captured = CAPTURE_BIN.exists() and capture_with_daemon(filename, f, meta)
 
             # Lecture des frames, on fige le nb de colonnes sur la 1re ligne valide
             target_cols = None
             silent_loops = 0
             MAX_SILENT_LOOPS = int(8 / TIMEOUT)  # ~8 s sans trame -> on arrête proprement
-
-            while True:
-                data = read_slip(ser)  # None si timeout
+            reader = SlipReader(ser)
+            t_first = None    # 1er horodatage µs des trames 'T'
+            last_seq = None
+            lost = 0
+
+            while not captured:
+                data = reader.read_frame()  # None si timeout
+                tele = decode_telemetry(data) if data else None
+                if tele is not None:
+                    # trame 'T' : TELEM_SAMPLES lignes [t, consigne, mesure, commande]
+                    silent_loops = 0
+                    if last_seq is not None:
+                        lost += (tele['seq'] - last_seq - 1) & 0xFFFF
+                    last_seq = tele['seq']
+                    for t_us, per_fader in tele['samples']:
+                        if fader_idx not in per_fader:
+                            continue
+                        if t_first is None:
+                            t_first = t_us
+                        setp, meas, u = per_fader[fader_idx]
+                        t = ((t_us - t_first) & 0xFFFFFFFF) * 1e-6
+                        f.write(f'{t:.6f}\t{setp}\t{meas}\t{u}\n')
+                    continue
+                if data is not None and '\t' in data.decode('utf-8', errors='ignore'):
+                    data = [x for x in data.decode('utf-8', errors='ignore').strip().split('\t')]
                 if data is None:
                     silent_loops += 1
                     if silent_loops >= MAX_SILENT_LOOPS:
                         print("[WARN] Aucun paquet depuis ~8s, on stoppe cet essai.")
+                        if lost:
+                            print(f"[WARN] {lost} trame(s) de télémétrie perdue(s)")
                         break
                     continue
 
@@ -0,0 +1,163 @@
+"""
+bench_hotpath.py — micro-benchmarks des chemins chauds (hotpath_bench.h) et suivi des
+régressions d'un commit à l'autre.
+
+- carte (ou simulateur) : message BENCH du protocole hôte → une trame SLIP 'H' par cas
+  (cycles SysTick, pile consommée), puis ACK
+- hôte : lance host/hotpath_bench (même suite compilée pour Linux, ticks = ns)
+- chaque essai est rangé dans results/bench/<date>-<commit>-<cible>.json puis comparé
+  au précédent de la même cible (ou à --baseline) : REGRESSION si la moyenne monte de
+  plus de --seuil % (code de sortie 1)
+
+Dépendance: pip install pyserial (carte seulement)
+Usage:
+  python bench_hotpath.py --port /dev/ttyACM0 [-n 1000]
+  python bench_hotpath.py --host ../_gate_build/hotpath_bench [-n 5000]
+  python bench_hotpath.py --compare results/bench/a.json results/bench/b.json
+"""
+
+import argparse
+import glob
+import json
+import os
+import struct
+import subprocess
+import sys
+import time
+
+HOTPATH_TAG = ord('H')
+HOTPATH_VERSION = 1
+RESULTS_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'results', 'bench')
+FIELDS = ('iters', 'min', 'avg', 'max', 'stack', 'ticks_per_s')
+
+
+def parse_frame(frame: bytes):
+    """Trame 'H' (sans SLIP) → dict, ou None si ce n'en est pas une."""
+    from SLIP import crc16_ccitt
+    if len(frame) < 31 or frame[0] != HOTPATH_TAG or frame[1] != HOTPATH_VERSION:
+        return None
+    if crc16_ccitt(frame[:-2]) != struct.unpack_from('<H', frame, len(frame) - 2)[0]:
+        return None
+    rank, count = frame[2], frame[3]
+    vals = struct.unpack_from('<6I', frame, 4)
+    name = frame[28:-2].split(b'\0', 1)[0].decode()
+    return dict(rank=rank, count=count, name=name, **dict(zip(FIELDS, vals)))
+
+
+def run_device(port, iters):
+    from SLIP import open_port
+    from hostproto import HostLink, BENCH, ACK
+    with open_port(port, 1_000_000, timeout=0.1) as ser:
+        time.sleep(0.2)
+        ser.reset_input_buffer()
+        link = HostLink(ser, timeout=10.0)      # le banc bloque la carte quelques secondes
+        link.hello()
+        link.other_frames.clear()
+        link._check(link.transact(BENCH, struct.pack('<H', iters)), ACK)
+        cases = [c for c in map(parse_frame, link.other_frames) if c]
+    cases.sort(key=lambda c: c['rank'])
+    if not cases or len(cases) != cases[0]['count']:
+        sys.exit(f"[ERREUR] {len(cases)} trame(s) 'H' reçue(s) sur {cases[0]['count'] if cases else '?'}")
+    return cases
+
+
+def run_host(binary, iters):
+    out = subprocess.run([binary, '-n', str(iters)], check=True, capture_output=True, text=True).stdout
+    cases = []
+    for line in out.splitlines():
+        if not line or line.startswith('#'):
+            continue
+        name, *vals = line.split('\t')
+        cases.append(dict(name=name, **dict(zip(FIELDS, map(int, vals)))))
+    return cases
+
+
+def git_commit():
+    here = os.path.dirname(os.path.abspath(__file__))
+    try:
+        sha = subprocess.run(['git', 'rev-parse', '--short', 'HEAD'], cwd=here, check=True,
+                             capture_output=True, text=True).stdout.strip()
+        dirty = subprocess.run(['git', 'status', '--porcelain', '-uno', '--', '..'], cwd=here,
+                               capture_output=True, text=True).stdout.strip()
+        return sha + ('+' if dirty else '')
+    except (OSError, subprocess.CalledProcessError):
+        return 'inconnu'
+
+
+def to_ns(c, key):
+    return c[key] * 1e9 / c['ticks_per_s'] if c['ticks_per_s'] else 0.0
+
+
+def save(target, iters, cases):
+    os.makedirs(RESULTS_DIR, exist_ok=True)
+    commit = git_commit()
+    run = dict(target=target, commit=commit, date=time.strftime('%Y-%m-%d %H:%M:%S'),
+               iters=iters, cases=cases)
+    path = os.path.join(RESULTS_DIR, f"{time.strftime('%Y%m%d-%H%M%S')}-{commit}-{target}.json")
+    with open(path, 'w') as f:
+        json.dump(run, f, indent=1)
+    return path
+
+
+def previous(target, exclude):
+    runs = sorted(p for p in glob.glob(os.path.join(RESULTS_DIR, f'*-{target}.json')) if p != exclude)
+    return runs[-1] if runs else None
+
+
+def report(run, base, threshold):
+    """Tableau ns/appel + pile ; avec base : écart de la moyenne. → nb de régressions."""
+    prev = {c['name']: c for c in base['cases']} if base else {}
+    if base:
+        print(f"[INFO] référence : {base['commit']} ({base['date']})")
+    print(f"{'cas':<16}{'min ns':>10}{'moy ns':>10}{'max ns':>10}{'cycles':>9}{'pile':>7}   écart")
+    regressions = 0
+    for c in run['cases']:
+        avg = to_ns(c, 'avg')
+        cycles = c['avg'] if c['ticks_per_s'] != 1_000_000_000 else ''
+        line = (f"{c['name']:<16}{to_ns(c, 'min'):>10.0f}{avg:>10.0f}{to_ns(c, 'max'):>10.0f}"
+                f"{cycles:>9}{c['stack']:>7}")
+        p = prev.get(c['name'])
+        if p and to_ns(p, 'avg') > 0:
+            d = 100.0 * (avg - to_ns(p, 'avg')) / to_ns(p, 'avg')
+            flag = '  REGRESSION' if d > threshold else ''
+            regressions += bool(flag)
+            line += f"   {d:+6.1f} %{flag}"
+        print(line)
+    return regressions
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    src = ap.add_mutually_exclusive_group(required=True)
+    src.add_argument('--port', help='port série de la carte, pty du simulateur ou udp:IP[:port]')
+    src.add_argument('--host', metavar='BIN', help='binaire host/hotpath_bench')
+    src.add_argument('--compare', nargs=2, metavar=('REF', 'NOUVEAU'))
+    ap.add_argument('-n', '--iters', type=int, default=1000)
+    ap.add_argument('--target', default=None, help='nom de la cible (défaut : carte / hote)')
+    ap.add_argument('--baseline', default=None, help='fichier de référence (défaut : essai précédent)')
+    ap.add_argument('--seuil', type=float, default=10.0, help='régression au-delà de +x %% (défaut 10)')
+    args = ap.parse_args()
+
+    if args.compare:
+        with open(args.compare[0]) as f:
+            base = json.load(f)
+        with open(args.compare[1]) as f:
+            run = json.load(f)
+        sys.exit(1 if report(run, base, args.seuil) else 0)
+
+    target = args.target or ('carte' if args.port else 'hote')
+    cases = run_device(args.port, args.iters) if args.port else run_host(args.host, args.iters)
+    path = save(target, args.iters, cases)
+    print(f"[INFO] résultats : {path}")
+    with open(path) as f:
+        run = json.load(f)
+    base_path = args.baseline or previous(target, path)
+    base = None
+    if base_path:
+        with open(base_path) as f:
+            base = json.load(f)
+    sys.exit(1 if report(run, base, args.seuil) else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,188 @@
+"""
+capture.py — lecture des fichiers de capture colonnaires .fpcap (host/capture_file.h)
+écrits par host/telemetry_capture et host/capture_convert (archives .tsv).
+
+    cap = load_capture('data/essai.fpcap')
+    cap['meta']['kp'], cap['t'], cap['columns']['f0.mesure']
+    cap['values'][:, j, 1]                  # mesure du j-ième fader capturé (télémétrie)
+
+    runs = load_many('data/*.fpcap')        # comparaison d'essais : réglages dans cap['meta']
+    capture_meta(path)                      # en-tête + métadonnées seulement (pas de données)
+
+    python capture.py essai.fpcap [--tsv sortie.tsv]   → tracé par fader / colonne
+
+Lecture par numpy.memmap : chaque colonne est une vue sur le fichier (sans copie) tant
+que la capture tient dans un bloc, sinon les blocs sont concaténés. Une capture en cours
+peut être relue : seuls les blocs déjà complets sont visibles.
+"""
+
+import glob
+import struct
+import sys
+import numpy as np
+
+CAP_MAGIC = b'FPMCAP\0\0'
+CAP_VERSION = 2
+CAP_HEADER = struct.Struct('<8sIIIIHHIIB3xQQQI60x')
+CAP_COLUMN = np.dtype([('name', 'S24'), ('type', 'u1'), ('fader', 'u1'), ('field', 'u1'), ('pad', 'V5')])
+CAP_INDEX = np.dtype([('offset', '<u8'), ('rows', '<u4'), ('pad', '<u4'), ('t_first', '<u8'), ('t_last', '<u8')])
+CAP_TYPES = {1: np.dtype('<u8'), 2: np.dtype('<i2'), 3: np.dtype('<i4'), 4: np.dtype('<f4'), 5: np.dtype('<f8')}
+CAP_NO_FADER = 0xFF
+FIELD_NAMES = ('consigne', 'mesure', 'commande')
+
+
+def _parse_meta(text):
+    meta = {}
+    for line in text.splitlines():
+        key, sep, val = line.partition('=')
+        if not sep:
+            continue
+        try:
+            meta[key] = int(val)
+        except ValueError:
+            try:
+                meta[key] = float(val)
+            except ValueError:
+                meta[key] = val
+    return meta
+
+
+def _read_header(buf, path):
+    if len(buf) < CAP_HEADER.size:
+        raise ValueError(f'{path}: en-tête tronqué')
+    (magic, version, header_size, chunk_rows, chunk_bytes, ncols, mask, meta_size, period_us,
+     fields, rows, start_unix_us, index_offset, index_count) = CAP_HEADER.unpack_from(buf)
+    if magic != CAP_MAGIC or version != CAP_VERSION:
+        raise ValueError(f'{path}: pas un fichier .fpcap v{CAP_VERSION}')
+    cols = np.frombuffer(buf, CAP_COLUMN, ncols, CAP_HEADER.size)
+    meta_off = CAP_HEADER.size + ncols * CAP_COLUMN.itemsize
+    meta = _parse_meta(bytes(buf[meta_off:meta_off + meta_size]).decode('utf-8', errors='replace'))
+    return dict(header_size=header_size, chunk_rows=chunk_rows, chunk_bytes=chunk_bytes,
+                mask=mask, period_us=period_us, fields=fields, rows=rows,
+                start_unix_us=start_unix_us, index_offset=index_offset, index_count=index_count,
+                cols=cols, meta=meta)
+
+
+def capture_meta(path):
+    """En-tête + métadonnées (lit quelques centaines d'octets) : rows, period_us, meta, columns…"""
+    with open(path, 'rb') as f:
+        head = f.read(CAP_HEADER.size)
+        ncols = struct.unpack_from('<H', head, 24)[0] if len(head) >= 26 else 0
+        meta_size = struct.unpack_from('<I', head, 28)[0] if len(head) >= 32 else 0
+        head += f.read(ncols * CAP_COLUMN.itemsize + meta_size)
+    h = _read_header(head, path)
+    h['columns'] = [c.decode() for c in h.pop('cols')['name']]
+    h['path'] = str(path)
+    return h
+
+
+def load_capture(path):
+    """→ dict : meta (réglages, calibration, version firmware…), mask, faders, fields,
+       period_us, start_unix_us, columns {nom: tableau typé}, t_us (uint64, µs),
+       t (float, s depuis le 1er échantillon), values (int16 [lignes, faders, champs],
+       seulement si les colonnes sont des champs de faders, ex. telemetry_capture)."""
+    mm = np.memmap(path, dtype=np.uint8, mode='r')
+    h = _read_header(mm, path)
+    cols = h['cols']
+
+    col_off, off = [], 0
+    for c in cols:
+        dt = CAP_TYPES.get(int(c['type']))
+        if dt is None:
+            raise ValueError(f'{path}: type de colonne inconnu ({c["type"]})')
+        col_off.append(off)
+        off += (h['chunk_rows'] * dt.itemsize + 7) & ~7
+
+    if h['index_count']:                               # fichier fermé : index en fin de fichier
+        index = np.frombuffer(mm, CAP_INDEX, h['index_count'], h['index_offset'])
+        chunks = [(int(e['offset']), int(e['rows'])) for e in index]
+    else:                                              # capture en cours
+        chunks = []
+        for r in range(0, h['rows'], h['chunk_rows']):
+            o = h['header_size'] + (r // h['chunk_rows']) * h['chunk_bytes']
+            if o + h['chunk_bytes'] > len(mm):
+                break
+            chunks.append((o, min(h['chunk_rows'], h['rows'] - r)))
+
+    columns = {}
+    for c, co in zip(cols, col_off):
+        dt = CAP_TYPES[int(c['type'])]
+        parts = [mm[o + co:o + co + n * dt.itemsize].view(dt) for o, n in chunks]
+        columns[c['name'].decode()] = (parts[0] if len(parts) == 1 else
+                                       np.concatenate(parts) if parts else np.zeros(0, dt))
+
+    t_us = columns[cols[0]['name'].decode()]
+    fader_cols = [(int(c['fader']), int(c['field']), c['name'].decode())
+                  for c in cols[1:] if c['fader'] != CAP_NO_FADER]
+    faders = sorted({f for f, _, _ in fader_cols})
+    if not faders:
+        faders = [i for i in range(16) if h['mask'] & (1 << i)]
+    cap = dict(meta=h['meta'], mask=h['mask'], faders=faders, fields=h['fields'],
+               period_us=h['period_us'], start_unix_us=h['start_unix_us'], columns=columns,
+               t_us=t_us, t=(t_us - t_us[0]) * 1e-6 if len(t_us) else np.zeros(0))
+    if fader_cols and h['fields'] and len(fader_cols) == len(faders) * h['fields']:
+        ordered = [name for _, _, name in sorted(fader_cols)]
+        cap['values'] = np.stack([columns[n] for n in ordered], axis=1).reshape(
+            -1, len(faders), h['fields'])
+    return cap
+
+
+def load_many(pattern):
+    """Charge tous les .fpcap d'un motif glob (ou d'une liste) → liste de captures,
+       chacune avec 'path' ; à trier/filtrer sur cap['meta'] (kp, ki, kd, fc…)."""
+    paths = sorted(glob.glob(pattern)) if isinstance(pattern, str) else list(pattern)
+    caps = []
+    for p in paths:
+        cap = load_capture(p)
+        cap['path'] = str(p)
+        caps.append(cap)
+    return caps
+
+
+def fader_columns(cap, fader):
+    """Tableau [lignes, 1 + champs] (t en s, consigne, mesure, commande) d'un fader
+       — même disposition que les .tsv de Tuning.py."""
+    j = cap['faders'].index(fader)
+    return np.column_stack([cap['t'], cap['values'][:, j, :]])
+
+
+def write_tsv(cap, fader, path):
+    np.savetxt(path, fader_columns(cap, fader), delimiter='\t',
+               fmt=['%.6f'] + ['%d'] * cap['fields'])
+
+
+if __name__ == '__main__':
+    import argparse
+    import matplotlib.pyplot as plt
+
+    ap = argparse.ArgumentParser(description='Trace un fichier de capture .fpcap')
+    ap.add_argument('file')
+    ap.add_argument('--tsv', help='exporte aussi le 1er fader en .tsv')
+    args = ap.parse_args()
+
+    cap = load_capture(args.file)
+    if not len(cap['t']):
+        sys.exit('capture vide')
+    print(f"{len(cap['t'])} échantillons, {cap['period_us']} µs, colonnes {list(cap['columns'])}")
+    for k, v in cap['meta'].items():
+        print(f'  {k} = {v}')
+    if args.tsv:
+        write_tsv(cap, cap['faders'][0], args.tsv)
+
+    if 'values' in cap:
+        fig, axs = plt.subplots(len(cap['faders']), 1, sharex='all', squeeze=False, figsize=(12, 8))
+        for j, fader in enumerate(cap['faders']):
+            for k in range(cap['fields']):
+                axs[j][0].plot(cap['t'], cap['values'][:, j, k], linewidth=1,
+                               label=FIELD_NAMES[k] if k < len(FIELD_NAMES) else f'champ {k}')
+            axs[j][0].set_title(f'fader {fader}')
+            axs[j][0].axhline(0, linewidth=0.5, color='k')
+    else:
+        names = list(cap['columns'])[1:]
+        fig, axs = plt.subplots(1, 1, squeeze=False, figsize=(12, 6))
+        for n in names:
+            axs[0][0].plot(cap['t'], cap['columns'][n], linewidth=1, label=n)
+        axs[0][0].set_title(cap['meta'].get('source', args.file))
+    axs[0][0].legend()
+    plt.tight_layout()
+    plt.show()
@@ -0,0 +1,173 @@
+"""
+fit_plant.py — ajustement du modèle de fader du simulateur (host/sim/fader_plant.h) sur
+les essais enregistrés du banc (old project/250924-calibration fader, 1 kHz,
+colonnes consigne / mesure 10 bits / commande, gains dans le nom de fichier
+datap<kp>i<ki>d<kd>c<fc>…tsv).
+
+- rejoue chaque essai en boucle fermée : PID + commande moteur du banc
+  (Motor-Controller-Pico : u ±1000, PWM = |u|·255/1000, plancher 30, zone morte 15)
+  sur le modèle par unité de masse, d = rapport cyclique signé :
+      a = A·d − Be·v (circuit fermé) − Bv·v − C·signe(v)      adhérence tant que |force| ≤ C
+- Nelder-Mead sur [A, Be, Bv, C] (écart RMS sur la mesure, comptes 10 bits)
+- conversion en constantes SI avec Kf = Ke = K, alimentation --volts, R fixé (--ohms) :
+      K = Be·V / A      m = K·V / (A·R)      b = Bv·m      Fc = C·m
+  (sans inductance, seul le produit m·R est identifiable)
+
+Dépendance: pip install numpy
+Usage:
+  python fit_plant.py                       (dossier de données par défaut, 1 essai sur 8)
+  python fit_plant.py --data DOSSIER --pas 4 --iter 200
+  python fit_plant.py --eval 188.5 40.1 1.93 45.6      (RMS par essai pour ces paramètres)
+"""
+
+import argparse
+import glob
+import math
+import os
+import re
+import sys
+
+import numpy as np
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+DATA_DIR = os.path.join(HERE, '..', '..', '..', 'old project ', '250924-calibration fader ',
+                        'python', 'calibration', 'data')
+TRAVEL_M = 0.1                       # course (FADER_TRAVEL_MM)
+COUNTS = 1023                        # mesure 10 bits du banc
+TS = 1e-3
+GAINS_RE = re.compile(r'datap([\d.]+)i([\d.]+)d([\d.]+)c([\d.]+)')
+
+
+def load(path):
+    """Essai sans les lignes vides du début (avant la première consigne / mesure)."""
+    a = np.loadtxt(path)
+    nz = np.where((a != 0).any(axis=1))[0]
+    return a[nz[0]:] if len(nz) else a
+
+
+def gains(path):
+    return [float(g.rstrip('.')) for g in GAINS_RE.search(os.path.basename(path)).groups()]
+
+
+def duty(u):
+    """Commande ±1000 → rapport cyclique signé (motor.hpp du banc)."""
+    p = math.floor(min(abs(u), 1000) * 255 / 1000)
+    if 0 < p < 30:
+        p = 30
+    if abs(u) < 15:
+        p = 0
+    return math.copysign(p / 255, u)
+
+
+def replay(trace, g, P, sub=5):
+    """Mesure simulée (comptes 10 bits) de l'essai trace avec les gains g du banc."""
+    A, Be, Bv, C = P
+    kp, ki, kd, fc = g
+    rc = 1 / (2 * math.pi * fc)
+    a1 = min(max(rc / (rc + TS), 0.0), 0.9999)
+    mm = TRAVEL_M / COUNTS
+    x, v, iacc, dprev = trace[0, 1] * mm, 0.0, 0.0, 0.0
+    out = np.empty(len(trace))
+    dt = TS / sub
+    for k, ref in enumerate(trace[:, 0]):
+        y = min(max(int(round(x / mm)), 0), COUNTS)
+        out[k] = y
+        # PID du banc (pid.cpp) : intégrale ×100, "dérivée" = EMA de −mesure ×0,01
+        e = ref - y
+        iacc = min(max(iacc + ki * e * TS * 100, -1000), 1000)
+        dprev = a1 * dprev + (1 - a1) * (-y)
+        d = duty(int(min(max(kp * e + iacc + kd * dprev * 0.01, -1000), 1000)))
+        for _ in range(sub):
+            f = A * d - (Be if d != 0 else 0) * v - Bv * v
+            if abs(v) < 1e-4:
+                if abs(f) <= C:
+                    v = 0.0
+                    continue
+                f -= math.copysign(C, f)
+            else:
+                f -= math.copysign(C, v)
+            v1 = v + f * dt
+            v = 0.0 if (v != 0 and (v1 > 0) != (v > 0)) else v1
+            x += v * dt
+            if x < 0:
+                x, v = 0.0, max(v, 0.0)
+            if x > TRAVEL_M:
+                x, v = TRAVEL_M, min(v, 0.0)
+    return out
+
+
+def rms(runs, P, verbose=False):
+    tot, n = 0.0, 0
+    for trace, g, path in runs:
+        e = replay(trace, g, P) - trace[:, 1]
+        tot += float(np.sum(e ** 2))
+        n += len(e)
+        if verbose:
+            print(f"  {os.path.basename(path):<40} RMS {math.sqrt(float(np.mean(e ** 2))):6.1f}")
+    return math.sqrt(tot / n)
+
+
+def nelder_mead(f, x0, step, iters):
+    pts = [np.array(x0, float)] + [np.array(x0, float) + np.eye(len(x0))[i] * step[i] for i in range(len(x0))]
+    vals = [f(p) for p in pts]
+    for k in range(iters):
+        order = np.argsort(vals)
+        pts, vals = [pts[i] for i in order], [vals[i] for i in order]
+        c = np.mean(pts[:-1], axis=0)
+        xr = c + (c - pts[-1])
+        fr = f(xr)
+        if fr < vals[0]:
+            xe = c + 2 * (c - pts[-1])
+            fe = f(xe)
+            pts[-1], vals[-1] = (xe, fe) if fe < fr else (xr, fr)
+        elif fr < vals[-2]:
+            pts[-1], vals[-1] = xr, fr
+        else:
+            xc = c + 0.5 * (pts[-1] - c)
+            fcv = f(xc)
+            if fcv < vals[-1]:
+                pts[-1], vals[-1] = xc, fcv
+            else:
+                pts = [pts[0]] + [pts[0] + 0.5 * (p - pts[0]) for p in pts[1:]]
+                vals = [vals[0]] + [f(p) for p in pts[1:]]
+        if k % 10 == 0:
+            print(f"[{k:4}] RMS {vals[0]:7.2f}  A, Be, Bv, C = {np.round(pts[0], 2)}", flush=True)
+    i = int(np.argmin(vals))
+    return pts[i], vals[i]
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--data', default=DATA_DIR, help='dossier des essais datap*.tsv')
+    ap.add_argument('--pas', type=int, default=8, help='1 essai sur N (temps de calcul)')
+    ap.add_argument('--iter', type=int, default=120)
+    ap.add_argument('--volts', type=float, default=12.0, help='alimentation du pont (FADER_SUPPLY_V)')
+    ap.add_argument('--ohms', type=float, default=12.0, help='R imposée (FADER_R_OHM)')
+    ap.add_argument('--eval', type=float, nargs=4, metavar=('A', 'BE', 'BV', 'C'))
+    args = ap.parse_args()
+
+    paths = [p for p in sorted(glob.glob(os.path.join(args.data, 'datap*.tsv'))) if GAINS_RE.search(os.path.basename(p))]
+    if not paths:
+        sys.exit(f"[ERREUR] aucun essai datap*.tsv dans {args.data}")
+    runs = [(load(p), gains(p), p) for p in paths[::args.pas]]
+    print(f"[INFO] {len(runs)} essai(s) sur {len(paths)}")
+
+    if args.eval:
+        print(f"[INFO] RMS total {rms(runs, args.eval, verbose=True):.2f} comptes (10 bits)")
+        return
+    # départ : ajustement en boucle ouverte des sauts à pleine commande (ordre de grandeur)
+    P, err = nelder_mead(lambda p: 1e9 if min(p) < 0 else rms(runs, p), [67, 12, 2, 24], [20, 6, 2, 6], args.iter)
+    A, Be, Bv, C = P
+    k = Be * args.volts / A
+    m = k * args.volts / (A * args.ohms)
+    print(f"[INFO] RMS {err:.2f} comptes (10 bits) : A {A:.1f}  Be {Be:.2f}  Bv {Bv:.2f}  C {C:.2f}")
+    print("fader_plant.h :")
+    print(f"  FADER_R_OHM     = {args.ohms:.1f}f")
+    print(f"  FADER_KF_N_A    = {k:.3f}f   (= FADER_KE_V_MS)")
+    print(f"  FADER_MASS_KG   = {m:.4f}f")
+    print(f"  FADER_VISCOUS   = {Bv * m:.4f}f")
+    print(f"  FADER_COULOMB_N = {C * m:.3f}f   (décollage à {C / A:.0%} de PWM)")
+
+
+if __name__ == '__main__':
+    main()
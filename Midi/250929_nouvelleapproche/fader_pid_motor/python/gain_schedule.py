@@ -0,0 +1,175 @@
+"""
+gain_schedule.py — table de séquencement de gains du PID (gain_schedule.h) :
+lecture, chargement, évaluation cellule par cellule.
+
+Cellule = sens (0 montée, 1 descente) × taille du mouvement × zone de position ;
+le firmware interpole entre cellules voisines (taille au saut de consigne, position en course).
+
+- --dump [fichier.json] : table du (des) fader(s) → écran ou JSON
+- --load fichier.json   : envoie les cellules du JSON puis gain_schedule = 1
+                          (format de --dump ; un réglage auto/balayage écrit le même fichier)
+- --eval                : pour chaque cellule, --reps mouvements de sa taille qui finissent
+                          dans sa zone (départ placé d'abord, hors mesure) ; mesures de la carte
+                          (step_metrics.h) : établissement, dépassement, inversions (médianes)
+                          --csv : un enregistrement par ligne avec la cellule, pour un auto-tuner
+- --off                 : gain_schedule = 0 (gains d'avant le séquencement)
+
+Dépendance: pip install pyserial (carte seulement)
+Usage:
+  python gain_schedule.py --port /dev/ttyACM0 --dump table.json
+  python gain_schedule.py --port /dev/ttyACM0 --load table.json --eval [--reps 5] [--csv eval.csv]
+  FADER_PORT=/tmp/fader0 python gain_schedule.py -f 0 --eval     (simulateur : fader_sim -l /tmp/fader0)
+"""
+
+import argparse
+import csv
+import json
+import os
+import statistics
+import sys
+import time
+
+from SLIP import open_port
+from hostproto import HostLink
+from step_soak import wait_record, FIELDS
+
+ADC_MAX = 4095
+STEP_MIN_MOVE = 16          # step_metrics.h
+
+
+def dump(link, faders, path):
+    tables = {str(f): [{k: c[k] for k in ('cell', 'dir', 'size', 'pos', 'kp', 'ki', 'kd')}
+                       for c in link.gs_table(f)] for f in faders}
+    if path:
+        with open(path, 'w') as fh:
+            json.dump(tables, fh, indent=1)
+        print(f"[INFO] {sum(len(t) for t in tables.values())} cellule(s) → {path}")
+        return
+    for f, cells in tables.items():
+        print(f"fader {f}")
+        print(f"  {'cell':>4} {'sens':>6} {'taille':>6} {'pos':>5} {'kp':>9} {'ki':>9} {'kd':>9}")
+        for c in cells:
+            print(f"  {c['cell']:>4} {'desc' if c['dir'] else 'mont':>6} {c['size']:>6} {c['pos']:>5} "
+                  f"{c['kp']:>9.4g} {c['ki']:>9.4g} {c['kd']:>9.4g}")
+
+
+def load(link, path, faders):
+    with open(path) as fh:
+        tables = json.load(fh)
+    items = [(int(f), c['cell'], c['kp'], c['ki'], c['kd'])
+             for f, cells in tables.items() if int(f) in faders for c in cells]
+    link.gs_set_many(items)
+    link.set('gain_schedule', 0, 1)
+    print(f"[INFO] {len(items)} cellule(s) chargée(s), gain_schedule = 1")
+
+
+def place(link, fader, target):
+    """Amène le fader sur target (l'enregistrement du mouvement est jeté)."""
+    if abs(link.get('setpoint', fader) - target) < STEP_MIN_MOVE:   # pas de mouvement ouvert
+        link.set('setpoint', fader, target)
+        return
+    link.set('setpoint', fader, target)
+    wait_record(link, fader, 3.0)
+
+
+def evaluate(link, fader, reps, pause):
+    """--reps mouvements par cellule ; rend [(cellule, enregistrement), ...]"""
+    out = []
+    for c in link.gs_table(fader):
+        sign = 1 if c['dir'] == 0 else -1
+        target = c['pos']
+        start = target - sign * c['size']
+        if not 0 <= start <= ADC_MAX:          # ex. montée de 2048 vers la butée basse
+            continue
+        for _ in range(reps):
+            place(link, fader, start)            # placement, hors mesure
+            time.sleep(pause)
+            link.set('setpoint', fader, target)
+            rec = wait_record(link, fader, 3.0)
+            if rec is None:
+                print(f"[WARN] cellule {c['cell']} : pas d'enregistrement")
+                continue
+            out.append((c, rec))
+            time.sleep(pause)
+    return out
+
+
+def report(results):
+    by_cell = {}
+    for c, r in results:
+        by_cell.setdefault(c['cell'], (c, []))[1].append(r)
+    med = lambda v: statistics.median(v) if v else None
+    fmt = lambda v, f: f"{v:{f}}" if v is not None else '-'
+    print(f"{'cell':>4} {'sens':>5} {'taille':>6} {'pos':>5} {'établis':>8} {'établ. ms':>10} "
+          f"{'dépass.':>8} {'invers.':>8}")
+    for cell, (c, recs) in sorted(by_cell.items()):
+        settled = [r['settle_us'] / 1000 for r in recs if r['settle_us'] is not None]
+        print(f"{cell:>4} {'desc' if c['dir'] else 'mont':>5} {c['size']:>6} {c['pos']:>5} "
+              f"{len(settled):>4}/{len(recs):<3} {fmt(med(settled), '10.1f')} "
+              f"{fmt(med([r['overshoot'] for r in recs]), '8.0f')} "
+              f"{fmt(med([r['reversals'] for r in recs]), '8.0f')}")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--port', default=os.environ.get('FADER_PORT'),
+                    help='port série, pty du simulateur ou udp:IP[:port] (défaut $FADER_PORT)')
+    ap.add_argument('-f', '--fader', type=int, action='append',
+                    help='fader (répétable ; défaut : 0, ou tous ceux du JSON pour --load)')
+    ap.add_argument('--dump', nargs='?', const='', default=None, metavar='JSON')
+    ap.add_argument('--load', metavar='JSON')
+    ap.add_argument('--eval', action='store_true')
+    ap.add_argument('--off', action='store_true')
+    ap.add_argument('--reps', type=int, default=3)
+    ap.add_argument('--bande', type=int, default=8, help='±comptes pour l\'établissement (step_band)')
+    ap.add_argument('--pause', type=float, default=0.05)
+    ap.add_argument('--csv', default=None)
+    args = ap.parse_args()
+    if not args.port:
+        sys.exit('[ERREUR] --port ou FADER_PORT')
+    if args.dump is None and not (args.load or args.eval or args.off):
+        args.dump = ''
+
+    with open_port(args.port, 1_000_000, timeout=0.1) as ser:
+        time.sleep(0.2)
+        ser.reset_input_buffer()
+        link = HostLink(ser)
+        num = link.hello()['num_faders']
+        faders = args.fader or [0]
+        if args.load:
+            with open(args.load) as fh:
+                in_json = [int(f) for f in json.load(fh)]
+            load(link, args.load, [f for f in (args.fader or in_json) if f < num])
+        if args.off:
+            link.set('gain_schedule', 0, 0)
+            print('[INFO] gain_schedule = 0')
+        if args.dump is not None:
+            dump(link, faders, args.dump)
+        if not args.eval:
+            return
+        results = []
+        link.set_many([('telemetry', 0, 0), ('mode', 0, 2), ('step_band', 0, args.bande),
+                       ('step_metrics', 0, 1)])
+        try:
+            for f in faders:
+                link.set('fader_idx', 0, f)
+                results += evaluate(link, f, args.reps, args.pause)
+        except KeyboardInterrupt:
+            pass
+        finally:
+            link.set('step_metrics', 0, 0)
+        on = link.get('gain_schedule')
+    print(f"[INFO] séquencement {'actif' if on else 'coupé (gains de base)'}")
+    report(results)
+    if args.csv:
+        with open(args.csv, 'w', newline='') as fh:
+            w = csv.writer(fh)
+            w.writerow(('cell', 'dir', 'size', 'pos') + FIELDS)
+            for c, r in results:
+                w.writerow([c['cell'], c['dir'], c['size'], c['pos']] +
+                           ['|'.join(r[k]) if k == 'flags' else r[k] for k in FIELDS])
+        print(f"[INFO] {len(results)} enregistrement(s) → {args.csv}")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,217 @@
+"""
+hostproto.py — client du protocole hôte binaire (host_protocol.h)
+
+    from hostproto import HostLink
+    link = HostLink(ser)            # ser = serial.Serial(...)
+    link.hello()                    # poignée de main (version)
+    link.set_many([('kp', 0, 6.0), ('ki', 0, 2.0), ('ts', 0, 0.001)])  # en rafale, sans pause
+    print(link.get('position', 0))
+    print(link.describe_all())
+    for t in link.sched_stats(): print(t)    # qui prend du temps à la boucle 1 kHz ?
+    link.gs_set(0, 5, 6.0, 2.0, 0.02); link.set('gain_schedule', 0, 1)   # gain_schedule.h
+
+Chaque requête porte un seq ; le Pico répond par ACK / NACK / VALUE avec le même seq.
+set_many() envoie tout d'un coup puis apparie les réponses → plus de sleep(0.01).
+Requête sans réponse (timeout) ou NACK CRC → ré-émise (le Pico ne ré-applique pas un doublon).
+"""
+
+import struct
+import time
+
+from SLIP import write_slip, SlipReader, crc16_ccitt
+
+MAGIC = 0xA5
+VERSION = 1
+
+HELLO, GET, SET, DESCRIBE, START, PING = 0x01, 0x02, 0x03, 0x04, 0x05, 0x06
+SCHED, SCHED_RESET, BENCH, GSCHED_SET, GSCHED_GET = 0x07, 0x08, 0x09, 0x0A, 0x0B
+NACK, ACK, HELLO_REPLY, VALUE, PARAM_DESC, SCHED_STATS = 0x7F, 0x80, 0x81, 0x82, 0x84, 0x87
+GSCHED_CELL = 0x8B
+SCHED_FIELDS = ('period_us', 'budget_us', 'runs', 'min_us', 'avg_us', 'max_us',
+                'max_late_us', 'misses', 'overruns')
+
+ERRORS = {1: 'CRC', 2: 'VERSION', 3: 'UNKNOWN_MSG', 4: 'LENGTH', 5: 'BAD_PARAM',
+          6: 'BAD_INDEX', 7: 'RANGE', 8: 'READ_ONLY', 9: 'TYPE'}
+
+# id, type ('f' / 'i') — même table que host_protocol.h (DESCRIBE permet de la relire)
+PARAMS = {
+    'kp': (0x01, 'f'), 'ki': (0x02, 'f'), 'kd': (0x03, 'f'), 'fc': (0x04, 'f'), 'ts': (0x05, 'f'),
+    'max_out': (0x06, 'f'), 'setpoint': (0x07, 'i'), 'position': (0x08, 'i'), 'output': (0x09, 'i'),
+    'mode': (0x10, 'i'), 'fader_idx': (0x11, 'i'), 'telemetry': (0x12, 'i'), 'telemetry_codec': (0x13, 'i'),
+    'step_metrics': (0x14, 'i'), 'step_band': (0x15, 'i'), 'gain_schedule': (0x16, 'i'),
+    'usable_min': (0x20, 'i'), 'usable_max': (0x21, 'i'), 'snap_low': (0x22, 'i'),
+    'snap_high': (0x23, 'i'), 'deadband': (0x24, 'i'),
+    'midi_channel': (0x30, 'i'), 'fader_cc': (0x31, 'i'), 'midi_interval_us': (0x32, 'i'),
+    'heap_allocs': (0x40, 'i'),
+}
+
+
+def encode(msg: int, seq: int, payload: bytes = b'') -> bytes:
+    body = bytes([MAGIC, VERSION, msg, seq & 0xFF]) + payload
+    return body + struct.pack('<H', crc16_ccitt(body))
+
+
+def decode(frame: bytes):
+    """→ (msg, seq, payload) ou None (pas une trame protocole / CRC faux)"""
+    if len(frame) < 6 or frame[0] != MAGIC:
+        return None
+    if crc16_ccitt(frame[:-2]) != struct.unpack_from('<H', frame, len(frame) - 2)[0]:
+        return None
+    return frame[2], frame[3], frame[4:-2]
+
+
+class ProtocolError(RuntimeError):
+    pass
+
+
+class HostLink:
+    def __init__(self, ser, timeout=0.3, retries=3):
+        self.ser = ser
+        self.reader = SlipReader(ser)
+        self.timeout = timeout
+        self.retries = retries
+        self.seq = 0
+        self.other_frames = []   # trames non protocole vues pendant l'attente (télémétrie...)
+
+    # ---------------- bas niveau ----------------
+    def _next_seq(self):
+        self.seq = (self.seq + 1) & 0xFF
+        return self.seq
+
+    def transact_many(self, requests):
+        """requests = [(msg, payload), ...] → réponses [(msg, payload), ...] dans le même ordre.
+        Tout est envoyé en rafale ; les requêtes sans réponse sont ré-émises."""
+        pending = {}
+        for msg, payload in requests:
+            seq = self._next_seq()
+            frame = encode(msg, seq, payload)
+            pending[seq] = [len(pending), frame, 0]
+            write_slip(self.ser, frame)
+        out = [None] * len(pending)
+
+        while pending:
+            deadline = time.monotonic() + self.timeout
+            while pending and time.monotonic() < deadline:
+                raw = self.reader.read_frame()
+                if raw is None:
+                    continue
+                d = decode(raw)
+                if d is None:
+                    self.other_frames.append(raw)
+                    continue
+                msg, seq, payload = d
+                if seq not in pending:
+                    continue
+                if msg == NACK and len(payload) >= 2 and payload[1] == 1:   # CRC : ré-émission
+                    write_slip(self.ser, pending[seq][1])
+                    continue
+                out[pending.pop(seq)[0]] = (msg, payload)
+            for seq, entry in pending.items():                             # timeout
+                entry[2] += 1
+                if entry[2] > self.retries:
+                    raise ProtocolError(f'pas de réponse (seq {seq})')
+                write_slip(self.ser, entry[1])
+        return out
+
+    def transact(self, msg, payload=b''):
+        return self.transact_many([(msg, payload)])[0]
+
+    @staticmethod
+    def _check(resp, expect):
+        msg, payload = resp
+        if msg == NACK:
+            raise ProtocolError('NACK ' + ERRORS.get(payload[1], str(payload[1])))
+        if msg != expect:
+            raise ProtocolError(f'réponse inattendue 0x{msg:02X}')
+        return payload
+
+    # ---------------- API ----------------
+    def hello(self):
+        p = self._check(self.transact(HELLO, bytes([VERSION])), HELLO_REPLY)
+        version, num, maxf, nparams, fw = struct.unpack_from('<BBBBI', p)
+        return dict(version=version, num_faders=num, max_faders=maxf, params=nparams, fw=fw)
+
+    def ping(self):
+        self._check(self.transact(PING), ACK)
+
+    @staticmethod
+    def _set_payload(name, index, value):
+        pid, typ = PARAMS[name]
+        return bytes([pid, index, ord(typ)]) + struct.pack('<' + typ, float(value) if typ == 'f' else int(value))
+
+    def set(self, name, index, value):
+        self._check(self.transact(SET, self._set_payload(name, index, value)), ACK)
+
+    def set_many(self, items):
+        """items = [(nom, index, valeur), ...] — envoyés en rafale, lève sur le 1er NACK"""
+        resps = self.transact_many([(SET, self._set_payload(*it)) for it in items])
+        for it, r in zip(items, resps):
+            try:
+                self._check(r, ACK)
+            except ProtocolError as e:
+                raise ProtocolError(f'{it[0]}[{it[1]}] : {e}') from None
+
+    def get(self, name, index=0):
+        pid, _ = PARAMS[name]
+        p = self._check(self.transact(GET, bytes([pid, index])), VALUE)
+        typ = chr(p[2])
+        return struct.unpack_from('<' + typ, p, 3)[0]
+
+    def start(self, index, speed=0.0):
+        self._check(self.transact(START, bytes([index]) + struct.pack('<f', speed)), ACK)
+
+    def describe_all(self):
+        info = self.hello()
+        out = []
+        for r in self.transact_many([(DESCRIBE, bytes([k])) for k in range(info['params'])]):
+            p = self._check(r, PARAM_DESC)
+            pid, typ, flags = p[0], chr(p[1]), p[2]
+            lo, hi = struct.unpack_from('<ff', p, 3)
+            name = p[11:].split(b'\0', 1)[0].decode()
+            out.append(dict(id=pid, name=name, type=typ, per_fader=bool(flags & 1),
+                            read_only=bool(flags & 2), min=lo, max=hi))
+        return out
+
+    def sched_stats(self):
+        """Statistiques des tâches de l'ordonnanceur (scheduler.h), dans l'ordre de priorité."""
+        first = self._check(self.transact(SCHED, bytes([0])), SCHED_STATS)
+        resps = [first] + [self._check(r, SCHED_STATS)
+                           for r in self.transact_many([(SCHED, bytes([k])) for k in range(1, first[1])])]
+        out = []
+        for p in resps:
+            vals = struct.unpack_from('<9I', p, 2)
+            name = p[38:].split(b'\0', 1)[0].decode()
+            out.append(dict(name=name, **dict(zip(SCHED_FIELDS, vals))))
+        return out
+
+    def sched_reset(self):
+        self._check(self.transact(SCHED_RESET), ACK)
+
+    # ---------------- séquencement de gains (gain_schedule.h) ----------------
+    @staticmethod
+    def _gs_cell(p):
+        fader, cell, cells, direction, size, pos, kp, ki, kd = struct.unpack_from('<BBBBHHfff', p)
+        return dict(fader=fader, cell=cell, cells=cells, dir=direction, size=size, pos=pos,
+                    kp=kp, ki=ki, kd=kd)
+
+    def gs_get(self, fader, cell):
+        return self._gs_cell(self._check(self.transact(GSCHED_GET, bytes([fader, cell])), GSCHED_CELL))
+
+    def gs_table(self, fader):
+        """Toutes les cellules du fader : [dict(cell, dir, size, pos, kp, ki, kd), ...]"""
+        first = self.gs_get(fader, 0)
+        resps = self.transact_many([(GSCHED_GET, bytes([fader, c])) for c in range(1, first['cells'])])
+        return [first] + [self._gs_cell(self._check(r, GSCHED_CELL)) for r in resps]
+
+    def gs_set(self, fader, cell, kp, ki, kd):
+        self.gs_set_many([(fader, cell, kp, ki, kd)])
+
+    def gs_set_many(self, items):
+        """items = [(fader, cellule, kp, ki, kd), ...] — en rafale, lève sur le 1er NACK"""
+        resps = self.transact_many([(GSCHED_SET, bytes(it[:2]) + struct.pack('<fff', *it[2:]))
+                                    for it in items])
+        for it, r in zip(items, resps):
+            try:
+                self._check(r, ACK)
+            except ProtocolError as e:
+                raise ProtocolError(f'cellule {it[1]} fader {it[0]} : {e}') from None
@@ -0,0 +1,150 @@
+"""
+step_soak.py — essai d'endurance / évaluation d'un réglage PID par les mesures de réponse
+indicielle calculées sur la carte (step_metrics.h) : 1 trame 'R' par mouvement au lieu
+de tous les échantillons.
+
+- passe la carte (ou le simulateur host/sim) en mode PYTHON sur le fader choisi,
+  télémétrie coupée, step_metrics = 1
+- enchaîne N consignes tirées au hasard (sauts ≥ --min-saut), attend l'enregistrement
+  de chaque mouvement, puis résume : établis / timeouts, montée, établissement,
+  dépassement, erreur statique, IAE, énergie PWM, inversions (médiane, p95, max)
+- --csv : un enregistrement par ligne, pour comparer des réglages ou nourrir un auto-tuner
+- --banc : réglage du banc d'essai (p2.25 i0.3 c60, ±1000 par compte 10 bits → × 0,064 en
+  PWM par compte 12 bits), celui qui s'établit sur le modèle de fader ajusté par
+  fit_plant.py ; les gains par défaut du firmware (pid.h) y oscillent. --kp/--ki/--kd/--fc
+  explicites restent prioritaires
+
+Dépendance: pip install pyserial (carte seulement)
+Usage:
+  python step_soak.py --port /dev/ttyACM0 [-f 0] [-n 500] [--bande 8] [--csv soak.csv]
+  FADER_PORT=/tmp/fader0 python step_soak.py -n 100          (simulateur : fader_sim -l /tmp/fader0)
+  python step_soak.py --port udp:192.168.1.50 --kp 6 --ki 2 --kd 0.05
+  FADER_PORT=/tmp/fader0 python step_soak.py -n 30 --banc
+"""
+
+import argparse
+import csv
+import os
+import random
+import statistics
+import sys
+import time
+
+from SLIP import open_port, decode_step
+from hostproto import HostLink
+
+ADC_MAX = 4095
+REGLAGE_BANC = dict(kp=0.15, ki=2.0, kd=0.002, fc=60.0)   # --banc (voir plus haut)
+FIELDS = ('fader', 'flags', 'from_', 'to', 'rise_us', 'settle_us', 'duration_us', 'overshoot',
+          'ss_error', 'iae', 'energy', 'reversals')
+
+
+def wait_record(link, fader, timeout):
+    """Prochaine trame 'R' du fader (trames vues pendant les requêtes comprises)."""
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        raw = link.other_frames.pop(0) if link.other_frames else link.reader.read_frame()
+        rec = decode_step(raw) if raw else None
+        if rec and rec['fader'] == fader:
+            return rec
+    return None
+
+
+def pct(vals, q):
+    vals = sorted(v for v in vals if v is not None)
+    return vals[min(len(vals) - 1, int(q * len(vals)))] if vals else None
+
+
+def summary(recs):
+    n = len(recs)
+    settled = sum('etabli' in r['flags'] for r in recs)
+    print(f"[INFO] {n} mouvement(s) : {settled} établi(s), "
+          f"{sum('timeout' in r['flags'] for r in recs)} timeout(s), "
+          f"{sum('interrompu' in r['flags'] for r in recs)} interrompu(s)")
+    rows = [('montée ms', [r['rise_us'] and r['rise_us'] / 1000 for r in recs]),
+            ('établissement ms', [r['settle_us'] and r['settle_us'] / 1000 for r in recs]),
+            ('dépassement', [r['overshoot'] for r in recs]),
+            ('|erreur statique|', [abs(r['ss_error']) for r in recs if r['ss_error'] == r['ss_error']]),
+            ('IAE comptes·s', [r['iae'] for r in recs]),
+            ('énergie PWM²·s', [r['energy'] for r in recs]),
+            ('inversions', [r['reversals'] for r in recs])]
+    print(f"{'':<20}{'médiane':>10}{'p95':>10}{'max':>10}")
+    for name, vals in rows:
+        vals = [v for v in vals if v is not None]
+        if not vals:
+            print(f"{name:<20}{'-':>10}{'-':>10}{'-':>10}")
+            continue
+        print(f"{name:<20}{statistics.median(vals):>10.1f}{pct(vals, 0.95):>10.1f}{max(vals):>10.1f}")
+    return settled == n
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--port', default=os.environ.get('FADER_PORT'),
+                    help='port série, pty du simulateur ou udp:IP[:port] (défaut $FADER_PORT)')
+    ap.add_argument('-f', '--fader', type=int, default=0)
+    ap.add_argument('-n', '--moves', type=int, default=200)
+    ap.add_argument('--bande', type=int, default=8, help='±comptes pour l\'établissement (step_band)')
+    ap.add_argument('--min-saut', type=int, default=200, help='saut de consigne minimal (comptes)')
+    ap.add_argument('--pause', type=float, default=0.05, help='attente après chaque mouvement (s)')
+    ap.add_argument('--seed', type=int, default=None)
+    ap.add_argument('--kp', type=float)
+    ap.add_argument('--ki', type=float)
+    ap.add_argument('--kd', type=float)
+    ap.add_argument('--fc', type=float, help='coupure du filtre de la dérivée (Hz)')
+    ap.add_argument('--banc', action='store_true', help='réglage du banc d\'essai (REGLAGE_BANC)')
+    ap.add_argument('--csv', default=None)
+    args = ap.parse_args()
+    if not args.port:
+        sys.exit('[ERREUR] --port ou FADER_PORT')
+
+    if args.banc:
+        for k, v in REGLAGE_BANC.items():
+            if getattr(args, k) is None:
+                setattr(args, k, v)
+
+    rng = random.Random(args.seed)
+    recs = []
+    with open_port(args.port, 1_000_000, timeout=0.1) as ser:
+        time.sleep(0.2)
+        ser.reset_input_buffer()
+        link = HostLink(ser)
+        link.hello()
+        gains = [(k, args.fader, v) for k, v in (('kp', args.kp), ('ki', args.ki), ('kd', args.kd)) if v is not None]
+        if args.fc is not None:
+            gains.append(('fc', 0, args.fc))
+        link.set_many(gains + [('telemetry', 0, 0), ('fader_idx', 0, args.fader), ('mode', 0, 2),
+                               ('step_band', 0, args.bande), ('step_metrics', 0, 1)])
+        target = link.get('position', args.fader)
+        try:
+            for k in range(args.moves):
+                while True:
+                    nxt = rng.randint(0, ADC_MAX)
+                    if abs(nxt - target) >= args.min_saut:
+                        break
+                target = nxt
+                link.set('setpoint', args.fader, target)
+                rec = wait_record(link, args.fader, 3.0)
+                if rec is None:
+                    print(f"[WARN] mouvement {k} : pas d'enregistrement")
+                    continue
+                recs.append(rec)
+                time.sleep(args.pause)
+        except KeyboardInterrupt:
+            pass
+        finally:
+            link.set('step_metrics', 0, 0)
+    if recs and recs[-1]['lost']:
+        print(f"[WARN] {recs[-1]['lost']} enregistrement(s) perdu(s) côté carte (file pleine)")
+    if args.csv:
+        with open(args.csv, 'w', newline='') as f:
+            w = csv.writer(f)
+            w.writerow(FIELDS)
+            for r in recs:
+                w.writerow(['|'.join(r[k]) if k == 'flags' else r[k] for k in FIELDS])
+        print(f"[INFO] {len(recs)} enregistrement(s) → {args.csv}")
+    sys.exit(0 if recs and summary(recs) else 1)
+
+
+if __name__ == '__main__':
+    main()
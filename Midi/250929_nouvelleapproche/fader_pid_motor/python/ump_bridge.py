@@ -0,0 +1,187 @@
+"""
+ump_bridge.py — pont MIDI 2.0 (UMP) entre le Pico et Linux.
+
+Le firmware (mode NORMAL, MIDI2_ENABLE) transporte des paquets UMP dans des
+trames SLIP sur le port série USB : b'U' + mots UMP 32 bits little-endian.
+
+Ce script :
+- négocie le protocole : Endpoint Discovery + Stream Config Request (MIDI 2.0),
+  renvoyés toutes les secondes (le Pico repasse en MIDI 1.0 après 3 s sans nouvelles)
+- décode et affiche les valeurs 32 bits des faders (Assignable Controller / NRPN)
+- --ump /dev/snd/umpC1D0 : relaie les paquets vers/depuis un rawmidi UMP ALSA
+  (noyau ≥ 6.5, mots UMP en ordre natif)
+- --loopback : renvoie chaque valeur reçue comme consigne (boucle virtuelle,
+  teste RX et TX 32 bits sans DAW)
+- --set IDX VAL : envoie une consigne 32 bits (VAL en 0..1) au fader IDX
+
+Dépendance: pip install pyserial
+Usage:
+  python ump_bridge.py [--port /dev/ttyACM0] [--loopback] [--ump /dev/snd/umpC1D0]
+  (--port udp:192.168.1.50 : module PoE, lien hôte UDP — host_link.h)
+"""
+
+import argparse
+import glob
+import os
+import struct
+import sys
+import time
+
+from serial import Serial
+from serial.tools import list_ports
+from SLIP import END, _encode_slip, _decode_slip, open_port
+
+BAUDRATE = 1_000_000
+UMP_TAG  = b'U'
+
+MT_STREAM = 0xF
+MT_MIDI2  = 0x4
+ST_EP_DISCOVERY, ST_EP_INFO, ST_CFG_REQUEST, ST_CFG_NOTIFY = 0x000, 0x001, 0x005, 0x006
+M2_RPN, M2_NRPN, M2_CC = 0x2, 0x3, 0xB
+
+# doit correspondre à midi_io.h
+MIDI_CHANNEL = 1
+FADER_CC     = [16, 17, 18, 19]
+NRPN_BANK    = 0
+
+
+def autodetect_port():
+    """Détection auto du port. Préférence RP2040 (VID 0x2E8A)."""
+    for p in list_ports.comports():
+        if getattr(p, 'vid', None) == 0x2E8A:
+            return p.device
+    cands = sorted(glob.glob('/dev/ttyACM*') + glob.glob('/dev/tty.usbmodem*'))
+    return cands[0] if cands else None
+
+
+def word_count(w0: int) -> int:
+    mt = w0 >> 28
+    if mt in (0x0, 0x1, 0x2, 0x6, 0x7):
+        return 1
+    if mt in (0x3, 0x4, 0x8, 0x9, 0xA):
+        return 2
+    if mt in (0xB, 0xC):
+        return 3
+    return 4
+
+
+def stream(status: int, b2: int = 0, b3: int = 0, w1: int = 0):
+    return [(MT_STREAM << 28) | ((status & 0x3FF) << 16) | (b2 << 8) | b3, w1, 0, 0]
+
+
+def nrpn(ch: int, bank: int, index: int, value: int):
+    return [(MT_MIDI2 << 28) | (M2_NRPN << 20) | (ch << 16) | (bank << 8) | index, value & 0xFFFFFFFF]
+
+
+def send_words(ser: Serial, words):
+    ser.write(_encode_slip(UMP_TAG + struct.pack('<%dI' % len(words), *words)))
+
+
+def split_packets(words):
+    i = 0
+    while i < len(words):
+        n = word_count(words[i])
+        if i + n > len(words):
+            break
+        yield words[i:i + n]
+        i += n
+
+
+def describe(pkt) -> str:
+    mt = pkt[0] >> 28
+    if mt == MT_STREAM:
+        st = (pkt[0] >> 16) & 0x3FF
+        if st == ST_EP_INFO:
+            return f"EndpointInfo fb={(pkt[1] >> 24) & 0x7F} M2={(pkt[1] >> 9) & 1} M1={(pkt[1] >> 8) & 1}"
+        if st == ST_CFG_NOTIFY:
+            return f"StreamConfig protocol=MIDI{(pkt[0] >> 8) & 0xFF}.0"
+        return f"Stream status=0x{st:03X}"
+    if mt == MT_MIDI2:
+        st, ch = (pkt[0] >> 20) & 0xF, (pkt[0] >> 16) & 0xF
+        b1, b2 = (pkt[0] >> 8) & 0x7F, pkt[0] & 0x7F
+        if st == M2_NRPN and ch == MIDI_CHANNEL - 1 and b1 == NRPN_BANK and b2 in FADER_CC:
+            return f"fader {FADER_CC.index(b2)} = 0x{pkt[1]:08X} ({pkt[1] / 0xFFFFFFFF:.6f})"
+        return f"MIDI2 status=0x{st:X} ch={ch} {b1}/{b2} value=0x{pkt[1]:08X}"
+    return ' '.join(f"{w:08X}" for w in pkt)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--port', default=None, help="port série, ou udp:IP[:port] (module PoE)")
+    ap.add_argument('--ump', default=None, help="rawmidi UMP ALSA (ex: /dev/snd/umpC1D0)")
+    ap.add_argument('--loopback', action='store_true')
+    ap.add_argument('--set', nargs=2, metavar=('IDX', 'VAL'), default=None)
+    ap.add_argument('--quiet', action='store_true')
+    args = ap.parse_args()
+
+    port = args.port or autodetect_port()
+    if port is None:
+        sys.exit("Aucun port série détecté. Branche le Pico puis relance.")
+    print(f"[INFO] Port série utilisé : {port}")
+
+    ump_fd = None
+    if args.ump:
+        ump_fd = os.open(args.ump, os.O_RDWR | os.O_NONBLOCK)
+        print(f"[INFO] rawmidi UMP : {args.ump}")
+
+    with open_port(port, BAUDRATE, timeout=0.01) as ser:
+        ser.reset_input_buffer()
+        buf = bytearray()
+        t_keepalive = 0.0
+        stats = {'frames': 0, 'values': 0}
+
+        while True:
+            now = time.monotonic()
+            if now - t_keepalive >= 1.0:
+                t_keepalive = now
+                send_words(ser, stream(ST_EP_DISCOVERY, 1, 1, 0x1F) + stream(ST_CFG_REQUEST, 0x02))
+                if args.set:
+                    idx, val = int(args.set[0]), float(args.set[1])
+                    send_words(ser, nrpn(MIDI_CHANNEL - 1, NRPN_BANK, FADER_CC[idx],
+                                         int(max(0.0, min(1.0, val)) * 0xFFFFFFFF)))
+
+            # ALSA → Pico (consignes MIDI 2.0 uniquement)
+            if ump_fd is not None:
+                try:
+                    raw = os.read(ump_fd, 256)
+                    words = list(struct.unpack('=%dI' % (len(raw) // 4), raw[:len(raw) // 4 * 4]))
+                    fwd = [w for p in split_packets(words) if p[0] >> 28 == MT_MIDI2 for w in p]
+                    if fwd:
+                        send_words(ser, fwd)
+                except BlockingIOError:
+                    pass
+
+            # Pico → hôte
+            chunk = ser.read(ser.in_waiting or 1)
+            if not chunk:
+                continue
+            buf += chunk
+            while True:
+                k = buf.find(bytes([END]))
+                if k < 0:
+                    break
+                frame, buf = _decode_slip(bytes(buf[:k])), buf[k + 1:]
+                if len(frame) < 5 or frame[:1] != UMP_TAG:
+                    continue
+                stats['frames'] += 1
+                words = list(struct.unpack('<%dI' % ((len(frame) - 1) // 4), frame[1:1 + (len(frame) - 1) // 4 * 4]))
+                echo = []
+                for pkt in split_packets(words):
+                    if not args.quiet:
+                        print(describe(pkt))
+                    if pkt[0] >> 28 == MT_MIDI2:
+                        stats['values'] += 1
+                        echo += pkt
+                if echo and ump_fd is not None:
+                    os.write(ump_fd, struct.pack('=%dI' % len(echo), *echo))
+                if echo and args.loopback:
+                    send_words(ser, echo)
+                if args.quiet and stats['frames'] % 500 == 0:
+                    print(f"[STAT] trames={stats['frames']} valeurs={stats['values']}")
+
+
+if __name__ == '__main__':
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
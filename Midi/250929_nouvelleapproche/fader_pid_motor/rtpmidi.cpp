@@ -0,0 +1,320 @@
+#include "rtpmidi.h"
+#include <string.h>
+
+// ===================== Octets big-endian =====================
+static inline uint16_t rd16(const uint8_t* p) { return (uint16_t)((p[0] << 8) | p[1]); }
+static inline uint32_t rd32(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+static inline uint8_t* wr16(uint8_t* p, uint16_t v) { p[0] = v >> 8; p[1] = v & 0xFF; return p + 2; }
+static inline uint8_t* wr32(uint8_t* p, uint32_t v) {
+  p[0] = v >> 24; p[1] = (v >> 16) & 0xFF; p[2] = (v >> 8) & 0xFF; p[3] = v & 0xFF; return p + 4;
+}
+static inline uint8_t* wr64(uint8_t* p, uint64_t v) {
+  return wr32(wr32(p, (uint32_t)(v >> 32)), (uint32_t)v);
+}
+
+// horloge de session : 10 kHz (unités de 100 µs), étendue à 64 bits
+static uint64_t clock10k(uint32_t now_us) {
+  static uint32_t last  = 0;
+  static uint64_t highUs = 0;
+  if (now_us < last) highUs += (1ULL << 32);   // micros() a rebouclé
+  last = now_us;
+  return (highUs + now_us) / 100;
+}
+
+// longueur d'un message MIDI d'après son statut (0 = SysEx / inconnu)
+static uint8_t midiLen(uint8_t st) {
+  if (st < 0xF0) {
+    const uint8_t hi = st & 0xF0;
+    return (hi == 0xC0 || hi == 0xD0) ? 2 : 3;
+  }
+  switch (st) {
+    case 0xF1: case 0xF3: return 2;
+    case 0xF2:            return 3;
+    case 0xF0:            return 0;
+    default:              return 1;
+  }
+}
+
+// ===================== API =====================
+void RtpMidiSession::begin(const char* n, uint32_t s, uint8_t ch, SendFn sf, CCFn cf, void* c) {
+  strncpy(name, n, RTPMIDI_NAME_LEN - 1);
+  ssrc = s; journalCh = ch & 0x0F;
+  send = sf; onCC = cf; ctx = c;
+  state = ST_IDLE;
+  initiator = false;
+  resetJournal();
+}
+
+void RtpMidiSession::invite(uint32_t now_us) {
+  static const uint8_t IN[2] = { 'I', 'N' };
+  initiator = true;
+  token = ssrc ^ now_us;
+  state = ST_INVITING;
+  lastTxCtrlUs = lastSyncUs = now_us;
+  sendInvitation(false, IN, token);
+}
+
+void RtpMidiSession::resetJournal() {
+  for (uint8_t k = 0; k < 128; ++k) jValid[k] = false;
+  checkpointSeq = txSeq;
+  rxSeqValid = false;
+}
+
+void RtpMidiSession::onPacket(bool dataPort, const uint8_t* buf, size_t len, uint32_t now_us) {
+  if (len >= 4 && buf[0] == 0xFF && buf[1] == 0xFF) handleControl(dataPort, buf, len, now_us);
+  else if (dataPort && state == ST_CONNECTED)        handleRtp(buf, len);
+}
+
+void RtpMidiSession::poll(uint32_t now_us) {
+  if (state == ST_IDLE) return;
+  if (initiator && (uint32_t)(now_us - lastTxCtrlUs) > (state == ST_CONNECTED ? RTPMIDI_CK_PERIOD_US
+                                                                            : RTPMIDI_INVITE_US)) {
+    static const uint8_t IN[2] = { 'I', 'N' };
+    lastTxCtrlUs = now_us;
+    if (state == ST_CONNECTED) sendSync(true, 0, nullptr, now_us);
+    else                       sendInvitation(state == ST_CTRL_OK, IN, token);
+  }
+  if ((uint32_t)(now_us - lastSyncUs) > RTPMIDI_TIMEOUT_US) { state = ST_IDLE; return; }
+  if (state == ST_CONNECTED && rxSeqValid && (uint32_t)(now_us - lastRsUs) > RTPMIDI_RS_PERIOD_US) {
+    lastRsUs = now_us;
+    sendFeedback();
+  }
+}
+
+// ===================== Session AppleMIDI =====================
+void RtpMidiSession::sendInvitation(bool dataPort, const uint8_t* cmd, uint32_t tok) {
+  uint8_t out[16 + RTPMIDI_NAME_LEN];
+  uint8_t* p = out;
+  *p++ = 0xFF; *p++ = 0xFF; *p++ = cmd[0]; *p++ = cmd[1];
+  p = wr32(p, 2);            // version protocole
+  p = wr32(p, tok);
+  p = wr32(p, ssrc);
+  const size_t nl = strlen(name) + 1;
+  memcpy(p, name, nl);
+  send(ctx, dataPort, out, (size_t)(p - out) + nl);
+}
+
+void RtpMidiSession::sendFeedback() {
+  uint8_t out[12] = { 0xFF, 0xFF, 'R', 'S' };
+  wr32(wr32(out + 4, ssrc), (uint32_t)rxSeq << 16);
+  send(ctx, false, out, sizeof out);
+}
+
+// CK (port données en général) : count 0 (initiateur), 1 (réponse), 2 (fin) ; ts[count] = notre horloge
+void RtpMidiSession::sendSync(bool dataPort, uint8_t count, const uint8_t* prev, uint32_t now_us) {
+  uint8_t out[36] = { 0xFF, 0xFF, 'C', 'K' };
+  if (prev) memcpy(out, prev, 36);
+  wr32(out + 4, ssrc);
+  out[8] = count;
+  wr64(out + 12 + 8 * count, clock10k(now_us));
+  send(ctx, dataPort, out, sizeof out);
+}
+
+void RtpMidiSession::handleControl(bool dataPort, const uint8_t* p, size_t len, uint32_t now_us) {
+  const uint8_t c0 = p[2], c1 = p[3];
+
+  if (c0 == 'I' && c1 == 'N' && len >= 16) {           // invitation
+    static const uint8_t OK[2] = { 'O', 'K' };
+    sendInvitation(dataPort, OK, rd32(p + 8));
+    initiator = false;
+    if (!dataPort) {
+      state = ST_CTRL_OK;
+    } else {
+      state = ST_CONNECTED;
+      peerSsrc = rd32(p + 12);
+      resetJournal();
+    }
+    lastSyncUs = now_us;
+  } else if (c0 == 'O' && c1 == 'K' && len >= 16 && initiator && rd32(p + 8) == token) {
+    static const uint8_t IN[2] = { 'I', 'N' };
+    lastSyncUs = lastTxCtrlUs = now_us;
+    if (!dataPort && state == ST_INVITING) {          // contrôle accepté → port données
+      state = ST_CTRL_OK;
+      sendInvitation(true, IN, token);
+    } else if (dataPort && state == ST_CTRL_OK) {     // session ouverte → 1re synchro
+      state = ST_CONNECTED;
+      peerSsrc = rd32(p + 12);
+      resetJournal();
+      sendSync(true, 0, nullptr, now_us);
+    }
+  } else if (c0 == 'N' && c1 == 'O' && initiator) {   // invitation refusée
+    state = ST_IDLE;
+  } else if (c0 == 'B' && c1 == 'Y') {                  // fin de session
+    state = ST_IDLE;
+  } else if (c0 == 'C' && c1 == 'K' && len >= 36) {     // synchro horloge
+    lastSyncUs = now_us;
+    if (p[8] == 0)                   sendSync(dataPort, 1, p, now_us);  // responder : CK1
+    else if (p[8] == 1 && initiator) sendSync(dataPort, 2, p, now_us);  // initiateur : CK2
+  } else if (c0 == 'R' && c1 == 'S' && len >= 12) {     // checkpoint acquitté
+    const uint16_t acked = (uint16_t)(rd32(p + 8) >> 16);
+    for (uint8_t k = 0; k < 128; ++k) {
+      if (jValid[k] && (int16_t)(jSeq[k] - acked) <= 0) jValid[k] = false;
+    }
+    checkpointSeq = (uint16_t)(acked + 1);
+  }
+}
+
+// ===================== Réception RTP-MIDI =====================
+void RtpMidiSession::handleRtp(const uint8_t* p, size_t len) {
+  if (len < 13 || (p[0] & 0xC0) != 0x80 || (p[1] & 0x7F) != 0x61) return;
+  const uint16_t seq = rd16(p + 2);
+  ++rxPackets;
+
+  bool gap = false;
+  if (rxSeqValid) {
+    const int16_t d = (int16_t)(seq - rxSeq);
+    if (d <= 0) return;                     // doublon / hors ordre : ignoré
+    if (d > 1) { gap = true; rxLost += (uint32_t)(d - 1); }
+  }
+  rxSeq = seq;
+  rxSeqValid = true;
+
+  // section commandes MIDI
+  const uint8_t* q = p + 12;
+  const uint8_t hdr = q[0];
+  size_t listLen = hdr & 0x0F;
+  size_t hdrLen = 1;
+  if (hdr & 0x80) {                         // B : longueur sur 12 bits
+    if (len < 14) return;
+    listLen = (listLen << 8) | q[1];
+    hdrLen = 2;
+  }
+  const uint8_t* cmd = q + hdrLen;
+  const uint8_t* end = cmd + listLen;
+  if (end > p + len) return;
+
+  // trou de séquence : on rattrape d'abord l'état via le journal
+  if (gap && (hdr & 0x40)) parseJournal(end, (size_t)(p + len - end));
+
+  bool first = true;
+  uint8_t running = 0;
+  while (cmd < end) {
+    if (!first || (hdr & 0x20)) {           // delta-time (varint)
+      uint8_t k = 0;
+      while (cmd < end && (*cmd & 0x80) && k++ < 3) ++cmd;
+      ++cmd;
+    }
+    first = false;
+    if (cmd >= end) break;
+
+    uint8_t st = *cmd;
+    if (st & 0x80) ++cmd; else st = running;
+    if (st == 0xF0 || st == 0xF7 || st == 0xF4) {      // SysEx (segments) : sauté
+      while (cmd < end && *cmd != 0xF7 && *cmd != 0xF0 && *cmd != 0xF4) ++cmd;
+      if (cmd < end) ++cmd;
+      continue;
+    }
+    if (st < 0x80) break;                               // pas de statut courant
+    if (st < 0xF0) running = st;
+    const uint8_t n = midiLen(st);
+    if (cmd + (n - 1) > end) break;
+    if ((st & 0xF0) == 0xB0 && onCC) onCC(ctx, st & 0x0F, cmd[0] & 0x7F, cmd[1] & 0x7F);
+    cmd += n - 1;
+  }
+}
+
+void RtpMidiSession::parseJournal(const uint8_t* p, size_t len) {
+  if (len < 3) return;
+  const uint8_t jh = p[0];
+  const uint8_t totChan = (uint8_t)((jh & 0x0F) + 1);
+  const uint8_t* q = p + 3;
+  const uint8_t* end = p + len;
+
+  if (jh & 0x40) {                          // Y : journal système (sauté)
+    if (q + 2 > end) return;
+    q += ((q[0] & 0x03) << 8) | q[1];
+  }
+  if (!(jh & 0x20)) return;                 // A : pas de journaux canaux
+
+  for (uint8_t c = 0; c < totChan && q + 3 <= end; ++c) {
+    const uint8_t ch = (q[0] >> 3) & 0x0F;
+    const size_t  cl = ((size_t)(q[0] & 0x03) << 8) | q[1];
+    const uint8_t chapters = q[2];
+    const uint8_t* next = q + cl;
+    if (cl < 3 || next > end) return;
+
+    const uint8_t* r = q + 3;
+    if (chapters & 0x80) r += 3;            // chapitre P (program change)
+    if ((chapters & 0x40) && r < next) {    // chapitre C (control change)
+      const uint8_t n = (uint8_t)((r[0] & 0x7F) + 1);
+      ++r;
+      for (uint8_t k = 0; k < n && r + 2 <= next; ++k, r += 2) {
+        if (r[1] & 0x80) continue;          // forme "alternate" : non gérée
+        if (onCC) onCC(ctx, ch, r[0] & 0x7F, r[1] & 0x7F);
+        ++rxRecovered;
+      }
+    }
+    q = next;
+  }
+}
+
+// ===================== Émission groupée =====================
+void RtpMidiSession::beginPacket() { nCmds = 0; }
+
+void RtpMidiSession::addCC(uint8_t ch, uint8_t cc, uint8_t value, bool journal) {
+  if (nCmds >= RTPMIDI_MAX_CMDS) return;
+  cmds[nCmds][0] = (uint8_t)(0xB0 | (ch & 0x0F));
+  cmds[nCmds][1] = cc & 0x7F;
+  cmds[nCmds][2] = value & 0x7F;
+  cmdJournal[nCmds] = journal;
+  ++nCmds;
+}
+
+void RtpMidiSession::endPacket(uint32_t now_us) {
+  if (nCmds == 0 || state != ST_CONNECTED) { nCmds = 0; return; }
+
+  uint8_t out[RTPMIDI_MAX_PACKET];
+  uint8_t* p = out;
+  const uint16_t seq = txSeq++;
+
+  // en-tête RTP (V=2, PT=0x61)
+  *p++ = 0x80; *p++ = 0x61;
+  p = wr16(p, seq);
+  p = wr32(p, (uint32_t)clock10k(now_us));
+  p = wr32(p, ssrc);
+
+  // journal présent ? (état non acquitté par le pair)
+  uint8_t nj = 0;
+  for (uint8_t k = 0; k < 128; ++k) nj += jValid[k];
+
+  // section commandes : 1er sans delta, puis delta 0 + commande
+  const size_t listLen = 3 + 4u * (nCmds - 1);
+  const uint8_t flags = nj ? 0x40 : 0x00;  // J
+  if (listLen > 15) { *p++ = (uint8_t)(0x80 | flags | (listLen >> 8)); *p++ = (uint8_t)listLen; }
+  else              { *p++ = (uint8_t)(flags | listLen); }
+  for (uint8_t k = 0; k < nCmds; ++k) {
+    if (k) *p++ = 0x00;
+    memcpy(p, cmds[k], 3);
+    p += 3;
+  }
+
+  // journal de récupération : 1 canal, chapitre C
+  if (nj) {
+    *p++ = 0x20;                             // S=0 Y=0 A=1 H=0 TOTCHAN=0
+    p = wr16(p, checkpointSeq);
+    const uint16_t cl = (uint16_t)(3 + 1 + 2 * nj);
+    *p++ = (uint8_t)((journalCh << 3) | ((cl >> 8) & 0x03));
+    *p++ = (uint8_t)(cl & 0xFF);
+    *p++ = 0x40;                             // chapitre C seul
+    *p++ = (uint8_t)(nj - 1);
+    for (uint8_t k = 0; k < 128; ++k) {
+      if (!jValid[k]) continue;
+      *p++ = k;
+      *p++ = jValue[k];
+    }
+  }
+  send(ctx, true, out, (size_t)(p - out));
+  ++txPackets;
+
+  // les commandes de ce paquet entrent dans le journal des suivants (CC absolus seulement)
+  for (uint8_t k = 0; k < nCmds; ++k) {
+    if (!cmdJournal[k] || (cmds[k][0] & 0x0F) != journalCh) continue;
+    const uint8_t cc = cmds[k][1];
+    jValid[cc] = true;
+    jValue[cc] = cmds[k][2];
+    jSeq[cc]   = seq;
+  }
+  nCmds = 0;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+/*
+  RTP-MIDI (RFC 6295) + protocole de session AppleMIDI — "responder" ou "initiator"
+  Code portable (pas d'Arduino) : le transport UDP est fourni par l'appelant
+  (rtpmidi_eth.cpp sur W5500, host/rtpmidi_peer.cpp sur Linux).
+
+  Session AppleMIDI (1 seul pair, ex. iPad) :
+    - IN (invitation) sur le port contrôle puis sur le port données → OK
+    - CK (synchro 3 temps, horloge 10 kHz) : on répond au CK0 par CK1
+    - BY : fin de session ; RS : accusé de réception (checkpoint du journal)
+    - pas de CK pendant RTPMIDI_TIMEOUT_US → session fermée
+    - invite() : on devient initiateur (IN répété jusqu'au OK, CK0 périodique)
+
+  Paquets RTP-MIDI :
+    - émission groupée : beginPacket() / addCC() ... / endPacket() → 1 datagramme
+    - journal de récupération (chapitre C, canal journalCh) : dernière valeur de
+      chaque CC émis depuis le dernier checkpoint acquitté par RS ; addCC(..., false)
+      pour un CC relatif (encodeur) : rejouer sa dernière valeur ajouterait un pas
+    - réception : CC → callback ; trou de séquence → valeurs du journal appliquées
+    - pas d'allocation : tampons de taille fixe
+*/
+
+// ===================== RÉGLAGES =====================
+constexpr uint16_t RTPMIDI_CTRL_PORT    = 5004;       // port données = contrôle + 1
+constexpr uint32_t RTPMIDI_TIMEOUT_US   = 60000000UL; // 60 s sans CK → fin de session
+constexpr uint32_t RTPMIDI_RS_PERIOD_US = 1000000UL;  // RS vers le pair toutes les 1 s
+constexpr uint32_t RTPMIDI_INVITE_US    = 1000000UL;  // initiateur : IN répété toutes les 1 s
+constexpr uint32_t RTPMIDI_CK_PERIOD_US = 10000000UL; // initiateur : CK0 toutes les 10 s
+constexpr size_t   RTPMIDI_MAX_PACKET   = 512;
+constexpr uint8_t  RTPMIDI_MAX_CMDS     = 32;         // CC par paquet émis
+constexpr uint8_t  RTPMIDI_NAME_LEN     = 24;
+
+class RtpMidiSession {
+ public:
+  typedef void (*SendFn)(void* ctx, bool dataPort, const uint8_t* buf, size_t len);
+  typedef void (*CCFn)(void* ctx, uint8_t ch, uint8_t cc, uint8_t value);
+
+  void begin(const char* name, uint32_t ssrc, uint8_t journalCh,
+             SendFn send, CCFn onCC, void* ctx);
+
+  // Datagramme reçu (dataPort = port contrôle + 1)
+  void onPacket(bool dataPort, const uint8_t* buf, size_t len, uint32_t now_us);
+  void poll(uint32_t now_us);            // RS/CK/IN périodiques + timeout de session
+  void invite(uint32_t now_us);          // ouvre la session vers le pair (SendFn)
+  bool connected() const { return state == ST_CONNECTED; }
+
+  // Émission groupée : tous les CC d'un tick dans un seul paquet RTP
+  void beginPacket();
+  void addCC(uint8_t ch, uint8_t cc, uint8_t value, bool journal = true);
+  void endPacket(uint32_t now_us);
+
+  // Statistiques
+  uint32_t rxPackets = 0, rxLost = 0, rxRecovered = 0, txPackets = 0;
+
+ private:
+  enum State : uint8_t { ST_IDLE, ST_INVITING, ST_CTRL_OK, ST_CONNECTED };
+
+  void handleControl(bool dataPort, const uint8_t* p, size_t len, uint32_t now_us);
+  void handleRtp(const uint8_t* p, size_t len);
+  void parseJournal(const uint8_t* p, size_t len);
+  void sendInvitation(bool dataPort, const uint8_t* cmd, uint32_t token);
+  void sendSync(bool dataPort, uint8_t count, const uint8_t* prev, uint32_t now_us);
+  void sendFeedback();
+  void resetJournal();
+
+  // identité
+  char     name[RTPMIDI_NAME_LEN] = {0};
+  uint32_t ssrc = 0;
+  uint8_t  journalCh = 0;
+  SendFn   send = nullptr;
+  CCFn     onCC = nullptr;
+  void*    ctx  = nullptr;
+
+  // session
+  State    state = ST_IDLE;
+  uint32_t peerSsrc = 0;
+  uint32_t lastSyncUs = 0;
+  uint32_t lastRsUs = 0;
+  bool     initiator = false;
+  uint32_t token = 0;
+  uint32_t lastTxCtrlUs = 0;             // initiateur : dernier IN / CK0
+
+  // réception
+  bool     rxSeqValid = false;
+  uint16_t rxSeq = 0;
+
+  // émission
+  uint16_t txSeq = 0;
+  uint8_t  nCmds = 0;
+  uint8_t  cmds[RTPMIDI_MAX_CMDS][3];
+  bool     cmdJournal[RTPMIDI_MAX_CMDS];
+
+  // journal (chapitre C) : valeur + seq d'émission par n° de CC
+  uint16_t checkpointSeq = 0;
+  bool     jValid[128] = {false};
+  uint8_t  jValue[128] = {0};
+  uint16_t jSeq[128]   = {0};
+};
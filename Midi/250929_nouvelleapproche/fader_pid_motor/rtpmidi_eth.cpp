@@ -0,0 +1,86 @@
+#include <Arduino.h>
+#include "hal.h"
+#include <SPI.h>
+#include <Ethernet.h>          // lib Arduino Ethernet (W5100/W5200/W5500)
+#include <EthernetUdp.h>
+#include "rtpmidi_eth.h"
+#include "rtpmidi.h"
+#include "midi_io.h"           // midi_channel, MIDIIO_onNetworkCC
+#include "debug.h"
+
+// ===================== ÉTAT =====================
+static EthernetUDP    udpCtrl, udpData;
+static RtpMidiSession rtp;
+static bool           ethUp = false;
+
+// adresse du pair (dernier datagramme reçu sur chaque port)
+static IPAddress peerIp[2];
+static uint16_t  peerPort[2] = {0, 0};
+static uint8_t   rxBuf[RTPMIDI_MAX_PACKET];
+
+// ===================== Callbacks session =====================
+static void udpSend(void*, bool dataPort, const uint8_t* buf, size_t len) {
+  EthernetUDP &u = dataPort ? udpData : udpCtrl;
+  const uint8_t k = dataPort ? 1 : 0;
+  if (!peerPort[k]) return;
+  u.beginPacket(peerIp[k], peerPort[k]);
+  u.write(buf, len);
+  u.endPacket();
+}
+
+static void onRtpCC(void*, uint8_t ch, uint8_t cc, uint8_t value) {
+  MIDIIO_onNetworkCC(ch, cc, value);
+}
+
+static void pollSocket(EthernetUDP &u, bool dataPort) {
+  const uint8_t k = dataPort ? 1 : 0;
+  int n;
+  while ((n = u.parsePacket()) > 0) {
+    peerIp[k]   = u.remoteIP();
+    peerPort[k] = u.remotePort();
+    const int len = u.read(rxBuf, sizeof rxBuf);
+    if (len > 0) rtp.onPacket(dataPort, rxBuf, (size_t)len, HALTime::micros());
+  }
+}
+
+// ===================== SETUP/LOOP =====================
+bool setupEthernet() {
+  static int8_t hw = -1;                // -1 = pas encore initialisé
+  if (!ETH_ENABLE) return false;
+  if (hw >= 0) return hw;
+  HALSpi::pins(ETH_PIN_MISO, ETH_PIN_MOSI, ETH_PIN_SCK);
+  Ethernet.init(ETH_PIN_CS);
+
+  uint8_t mac[6];
+  memcpy(mac, ETH_MAC, sizeof mac);
+  if (!ETH_USE_DHCP || Ethernet.begin(mac, 2000, 1000) == 0) {
+    Ethernet.begin(mac, IPAddress(ETH_IP[0], ETH_IP[1], ETH_IP[2], ETH_IP[3]));
+  }
+  hw = (Ethernet.hardwareStatus() != EthernetNoHardware);
+  if (!hw && on_debug && on_debug_monitorarduino) Serial.println("[ETH] W5500 absent");
+  return hw;
+}
+
+void setupRtpMidi() {
+  if (!setupEthernet()) return;
+  udpCtrl.begin(RTPMIDI_CTRL_PORT);
+  udpData.begin(RTPMIDI_CTRL_PORT + 1);
+  rtp.begin(RTPMIDI_NAME, HALTime::micros() ^ 0x52544D31UL, midi_channel - 1,
+            udpSend, onRtpCC, nullptr);
+  ethUp = true;
+}
+
+void loopRtpMidi() {
+  if (!ethUp) return;
+  pollSocket(udpCtrl, false);
+  pollSocket(udpData, true);
+  rtp.poll(HALTime::micros());
+}
+
+bool rtpMidiConnected() { return ethUp && rtp.connected(); }
+
+void rtpMidiBeginPacket()                                 { if (ethUp) rtp.beginPacket(); }
+void rtpMidiAddCC(uint8_t ch, uint8_t cc, uint8_t value, bool journal) {
+  if (ethUp) rtp.addCC(ch, cc, value, journal);
+}
+void rtpMidiEndPacket()                                   { if (ethUp) rtp.endPacket(HALTime::micros()); }
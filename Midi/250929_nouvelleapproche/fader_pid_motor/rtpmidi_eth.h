@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include "pin_int.h"          // PicoBoard::ETH_*
+
+/*
+  RTP-MIDI sur Ethernet (module PoE) — W5500 / W5100 via la lib Arduino Ethernet
+  Protocole : rtpmidi.h (session AppleMIDI + journal de récupération)
+
+  - partage la table d'adresses (FADER_CC / MIDI_CHANNEL) et l'ordonnanceur de
+    sortie de midi_io : MIDIIO_flush() met les CC du tick dans UN paquet RTP
+  - les CC reçus de l'iPad deviennent des consignes comme ceux de l'USB
+  - l'iPad (ou tout initiateur AppleMIDI) se connecte à RTPMIDI_NAME sur le port 5004
+
+  Câblage W5500 (SPI0, hors broches moteurs 11..18) :
+    MISO GP20 / CS GP21 / SCK GP22 / MOSI GP19
+*/
+
+// ===================== RÉGLAGES (tout en haut) =====================
+constexpr bool    ETH_ENABLE     = false;       // true si le module W5500 est câblé
+constexpr uint8_t ETH_PIN_MISO   = PicoBoard::ETH_MISO;
+constexpr uint8_t ETH_PIN_CS     = PicoBoard::ETH_CS;
+constexpr uint8_t ETH_PIN_SCK    = PicoBoard::ETH_SCK;
+constexpr uint8_t ETH_PIN_MOSI   = PicoBoard::ETH_MOSI;
+constexpr uint8_t ETH_MAC[6]     = { 0x02, 0x52, 0x4F, 0x55, 0x4C, 0x01 }; // adresse locale
+constexpr uint8_t ETH_IP[4]      = { 192, 168, 1, 50 };                    // si pas de DHCP
+constexpr bool    ETH_USE_DHCP   = true;
+constexpr const char* RTPMIDI_NAME = "Roulante Faders";
+
+// ===================== API =====================
+bool setupEthernet();                                   // W5500 + adresse (1 seule fois) ; false si absent
+void setupRtpMidi();                                    // Ethernet + sockets UDP
+void loopRtpMidi();                                     // lit les datagrammes, RS, timeout
+bool rtpMidiConnected();
+void rtpMidiBeginPacket();                              // appelé par MIDIIO_flush()
+void rtpMidiAddCC(uint8_t ch, uint8_t cc, uint8_t value, bool journal = true);  // false : CC relatif
+void rtpMidiEndPacket();
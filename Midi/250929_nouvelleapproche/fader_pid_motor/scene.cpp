@@ -0,0 +1,166 @@
+#include <Arduino.h>
+#include "hal.h"
+#include <EEPROM.h>            // émulation EEPROM en flash (core RP2040)
+#include "scene.h"
+#include "fader_bank.h"        // gBank : positions, consignes, PID
+#include "debug.h"
+
+static_assert(SCENE_RECALL_MS > (uint32_t)SCENE_STAGGER_MS * MAX_FADERS,
+              "SCENE_RECALL_MS doit couvrir le décalage de tous les faders");
+
+// ===================== Table en flash =====================
+static constexpr uint32_t SCENE_MAGIC = 0x53434E31; // "SCN1"
+
+struct SceneTable {
+  uint32_t magic;
+  uint32_t validMask;                       // bit n = scène n mémorisée
+  uint16_t pos[SCENE_COUNT][MAX_FADERS];    // positions 0..ADC_MAX
+};
+static SceneTable table;
+static constexpr size_t SCENE_EEPROM_SIZE = 256;   // émulation EEPROM : multiple de 256
+static_assert(sizeof(SceneTable) <= SCENE_EEPROM_SIZE, "SceneTable ne tient plus dans SCENE_EEPROM_SIZE");
+
+// mémorisation : table en RAM tout de suite, flash plus tard (sceneFlush)
+static bool     flashDirty   = false;
+static uint32_t flashDirtyMs = 0;
+
+// ===================== Trajectoires =====================
+struct SceneTraj {
+  uint16_t start  = 0;
+  uint16_t target = 0;
+  uint32_t t0     = 0;     // départ (ms, décalé par fader)
+  uint16_t dur    = 0;     // durée propre (ms) → arrivée commune
+  bool     active = false;
+};
+static SceneTraj traj[MAX_FADERS];
+static bool     recalling   = false;
+static uint8_t  lastScene   = 0;
+
+// bouton (anti-rebond)
+static bool     btnPrev     = true;
+static uint32_t btnChangeMs = 0;
+
+// profil "minimum jerk" : s(0)=0, s(1)=1, vitesses/accélérations nulles aux bords
+static inline float minJerk(float tau) {
+  const float t3 = tau * tau * tau;
+  return t3 * (10.0f + tau * (-15.0f + 6.0f * tau));
+}
+
+// ===================== SETUP =====================
+void setupScene() {
+  EEPROM.begin(SCENE_EEPROM_SIZE);
+  EEPROM.get(0, table);
+  if (table.magic != SCENE_MAGIC) { // flash vierge ou format inconnu
+    memset(&table, 0, sizeof table);
+    table.magic = SCENE_MAGIC;
+  }
+  HALGpio::mode(SCENE_BTN_PIN, HALGpio::InputPullup);
+}
+
+// ===================== API =====================
+bool sceneStore(uint8_t n) {
+  if (n >= SCENE_COUNT) return false;
+  for (uint8_t i = 0; i < MAX_FADERS; ++i) {
+    table.pos[n][i] = (i < NUM_FADERS) ? gBank.position[i] : 0;
+  }
+  table.validMask |= (1UL << n);
+  if (!flashDirty) flashDirtyMs = HALTime::millis();
+  flashDirty = true;                // écriture flash différée : sceneFlush()
+  if (on_debug && on_debug_monitorarduino) {
+    Serial.print("[SCENE] store "); Serial.println(n);
+  }
+  return true;
+}
+
+bool sceneRecall(uint8_t n) {
+  if (n >= SCENE_COUNT || !(table.validMask & (1UL << n))) return false;
+  const uint32_t now = HALTime::millis();
+  for (uint8_t i = 0; i < NUM_FADERS; ++i) {
+    SceneTraj &t = traj[i];
+    t.start  = gBank.position[i];        // part de la position réelle
+    t.target = table.pos[n][i];
+    t.t0     = now + (uint32_t)i * SCENE_STAGGER_MS;
+    t.dur    = (uint16_t)(SCENE_RECALL_MS - (uint32_t)i * SCENE_STAGGER_MS);
+    t.active = true;
+    gBank.setpoint[i] = t.start;       // pas de saut de consigne avant le départ
+  }
+  recalling = true;
+  lastScene = n;
+  return true;
+}
+
+void sceneCancel(uint8_t i) {
+  if (i >= NUM_FADERS || !traj[i].active) return;
+  traj[i].active = false;
+  gBank.pid[i].setMaxOutput(255.0f);
+}
+
+bool sceneActive() { return recalling; }
+
+bool sceneFlush(uint32_t nowMs) {
+  if (!flashDirty) return false;
+  bool idle = !recalling;
+  for (uint8_t i = 0; i < NUM_FADERS; ++i) idle = idle && gBank.drive[i] == 0;
+  if (!idle) {
+    if ((uint32_t)(nowMs - flashDirtyMs) < SCENE_FLUSH_MAX_MS) return false;
+    // jamais au repos (fader tenu, consigne qui bouge) : moteurs coupés pendant l'écriture
+    for (uint8_t i = 0; i < NUM_FADERS; ++i) { gBank.drive[i] = 0; gBank.actuate(i); }
+  }
+  EEPROM.put(0, table);
+  EEPROM.commit();                  // effacement + programmation flash : plusieurs ms
+  flashDirty = false;
+  return true;
+}
+
+void sceneHandleSysEx(const uint8_t* data, uint16_t len) {
+  if (len && data[0] == 0xF0) { ++data; --len; }
+  if (len < 3 || data[0] != SCENE_SYSEX_ID) return;
+  if      (data[1] == 0x01) sceneRecall(data[2]);
+  else if (data[1] == 0x02) sceneStore(data[2]);
+}
+
+// ===================== LOOP =====================
+static void loopSceneButton(uint32_t now) {
+  const bool level = HALGpio::read(SCENE_BTN_PIN);
+  if (level == btnPrev || (uint32_t)(now - btnChangeMs) < 30) return;
+  btnChangeMs = now;
+  btnPrev     = level;
+  if (level) return;                // front descendant seulement (appui)
+  for (uint8_t k = 1; k <= SCENE_COUNT; ++k) {
+    const uint8_t n = (uint8_t)((lastScene + k) % SCENE_COUNT);
+    if (sceneRecall(n)) break;      // scène valide suivante
+  }
+}
+
+bool loopScene() {
+  const uint32_t now = HALTime::millis();
+  loopSceneButton(now);
+  if (!recalling) return false;
+
+  bool any = false;
+  for (uint8_t i = 0; i < NUM_FADERS; ++i) {
+    SceneTraj &t = traj[i];
+    if (!t.active) continue;
+    any = true;
+
+    const int32_t dt = (int32_t)(now - t.t0);
+    if (dt < 0) continue;           // départ décalé pas encore atteint
+
+    if (dt >= t.dur) {              // arrivée (commune à tous les faders)
+      gBank.setpoint[i] = t.target;
+      sceneCancel(i);
+      continue;
+    }
+
+    const float s = minJerk((float)dt / (float)t.dur);
+    gBank.setpoint[i] = (uint16_t)((float)t.start + ((float)t.target - (float)t.start) * s + 0.5f);
+
+    // limite PWM progressive au départ → appel de courant étalé
+    const float lim = (dt < SCENE_RAMP_MS)
+        ? SCENE_PWM_START + (255.0f - SCENE_PWM_START) * (float)dt / SCENE_RAMP_MS
+        : 255.0f;
+    gBank.pid[i].setMaxOutput(lim);
+  }
+  recalling = any;
+  return recalling;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include "fader_filtre_adc.h" // MAX_FADERS / NUM_FADERS / ADC_MAX
+#include "pin_int.h"          // PicoBoard::SCENE_BTN
+
+/*
+  Scènes : instantanés de toutes les positions de faders, stockés en flash
+  (émulation EEPROM du core RP2040), rappel coordonné.
+
+  Rappel d'une scène (1 seul message) :
+    - Program Change n (canal MIDI_CHANNEL)          → rappel scène n
+    - SysEx F0 7D 01 n F7 / F0 7D 02 n F7            → rappel / mémorisation scène n
+    - bouton SCENE_BTN_PIN (à la masse)              → scène valide suivante
+
+  Trajectoires :
+    - tous les faders arrivent ENSEMBLE, SCENE_RECALL_MS après la commande
+      (durée fixe → temps de chargement prévisible, quel que soit l'écart)
+    - profil "minimum jerk" (vitesse et accélération nulles au départ/arrivée)
+    - départs décalés de SCENE_STAGGER_MS par fader + limite PWM qui monte de
+      SCENE_PWM_START à 255 en SCENE_RAMP_MS → pic de courant alim borné
+    - un fader touché ou qui reçoit un CC sort du rappel (sceneCancel)
+
+  Mémorisation : la table en RAM est à jour tout de suite (rappel possible aussitôt) ;
+  l'écriture flash (EEPROM.commit, plusieurs ms : la boucle 1 kHz s'arrête) est différée
+  à la tâche de fond sceneFlush(), faite quand tous les moteurs sont au repos (drive = 0,
+  pas de rappel) ou, au plus tard, SCENE_FLUSH_MAX_MS après, moteurs coupés.
+*/
+
+// ===================== RÉGLAGES (tout en haut) =====================
+constexpr uint8_t  SCENE_COUNT      = 16;    // nb d'instantanés en flash
+constexpr uint16_t SCENE_RECALL_MS  = 600;   // durée totale d'un rappel
+constexpr uint16_t SCENE_STAGGER_MS = 12;    // décalage de départ entre faders
+constexpr uint16_t SCENE_RAMP_MS    = 80;    // montée de la limite PWM au départ
+constexpr float    SCENE_PWM_START  = 80.0f; // limite PWM au démarrage d'un fader
+constexpr uint8_t  SCENE_SYSEX_ID   = 0x7D;  // ID "non commercial" (F0 7D ...)
+constexpr uint8_t  SCENE_BTN_PIN    = PicoBoard::SCENE_BTN;   // bouton scène suivante (INPUT_PULLUP)
+constexpr uint16_t SCENE_FLUSH_HZ   = 10;    // tâche d'écriture flash différée
+constexpr uint32_t SCENE_FLUSH_MAX_MS = 5000; // écriture forcée (moteurs coupés) après ce délai
+
+// ===================== API =====================
+void setupScene();                // charge la table depuis la flash, init bouton
+bool sceneStore(uint8_t n);       // positions actuelles → scène n (RAM ; flash : sceneFlush)
+bool sceneRecall(uint8_t n);      // lance le rappel coordonné de la scène n
+void sceneCancel(uint8_t i);      // le fader i quitte le rappel en cours
+bool sceneActive();               // un rappel est-il en cours ?
+bool sceneFlush(uint32_t nowMs);  // tâche de fond : écrit la table en flash si moteurs au repos
+bool loopScene();                 // à chaque tick : met à jour gBank.setpoint[] ; true si rappel en cours
+void sceneHandleSysEx(const uint8_t* data, uint16_t len); // F0 7D <cmd> <n> F7
@@ -0,0 +1,82 @@
+#include <Arduino.h>
+#include "hal.h"
+#include "scheduler.h"
+
+// ===================== ÉTAT =====================
+static SchedTask tasks[SCHED_MAX_TASKS];
+static uint8_t   nTasks = 0;
+
+static void clearStats(SchedStats& s) {
+  s = SchedStats{};
+  s.minUs = UINT32_MAX;
+}
+
+// ===================== DÉCLARATION =====================
+int8_t schedAdd(const char* name, SchedFn fn, uint32_t periodUs, uint32_t budgetUs) {
+  if (nTasks >= SCHED_MAX_TASKS || !fn) return -1;
+  SchedTask& t = tasks[nTasks];
+  t.name     = name;
+  t.fn       = fn;
+  t.periodUs = periodUs;
+  t.budgetUs = budgetUs;
+  t.nextUs   = HALTime::micros() + periodUs;
+  clearStats(t.stats);
+  return (int8_t)nTasks++;
+}
+
+// prend effet au relâchement suivant (appelable depuis la tâche elle-même)
+void schedSetPeriod(int8_t id, uint32_t periodUs) {
+  if (id < 0 || id >= nTasks) return;
+  tasks[id].periodUs = periodUs;
+}
+
+// ===================== EXÉCUTION =====================
+static void runTask(SchedTask& t, uint32_t start) {
+  t.fn(start);
+  const uint32_t end = HALTime::micros();
+  const uint32_t dt  = end - start;
+
+  SchedStats& s = t.stats;
+  ++s.runs;
+  s.sumUs += dt;
+  if (dt < s.minUs) s.minUs = dt;
+  if (dt > s.maxUs) s.maxUs = dt;
+  if (t.budgetUs && dt > t.budgetUs) ++s.overruns;
+  if (!t.periodUs) return;
+
+  // retard au démarrage, échéance = relâchement + période
+  const uint32_t late = start - t.nextUs;
+  if (late > s.maxLateUs) s.maxLateUs = late;
+  if ((int32_t)(end - (t.nextUs + t.periodUs)) > 0) ++s.misses;
+
+  // relâchement suivant ; relâchements déjà dépassés = échéances sautées, puis recalage
+  t.nextUs += t.periodUs;
+  if ((int32_t)(end - t.nextUs) >= (int32_t)t.periodUs) {
+    const uint32_t skipped = (end - t.nextUs) / t.periodUs;
+    s.misses += skipped;
+    t.nextUs += skipped * t.periodUs;
+  }
+}
+
+void schedRun() {
+  const uint32_t now = HALTime::micros();
+  for (uint8_t k = 0; k < nTasks; ++k) {
+    SchedTask& t = tasks[k];
+    if (t.periodUs && (int32_t)(now - t.nextUs) >= 0) { runTask(t, now); return; }
+  }
+  for (uint8_t k = 0; k < nTasks; ++k) {
+    if (!tasks[k].periodUs) runTask(tasks[k], HALTime::micros());
+  }
+}
+
+// ===================== STATISTIQUES =====================
+void schedResetStats() {
+  for (uint8_t k = 0; k < nTasks; ++k) clearStats(tasks[k].stats);
+}
+
+uint8_t          schedCount()          { return nTasks; }
+const SchedTask& schedTask(uint8_t id) { return tasks[id]; }
+
+uint32_t schedAvgUs(const SchedStats& s) {
+  return s.runs ? (uint32_t)(s.sumUs / s.runs) : 0;
+}
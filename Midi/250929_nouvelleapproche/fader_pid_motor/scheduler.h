@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+
+/*
+  Ordonnanceur coopératif à groupes de fréquence (remplace les "static uint32_t last_us")
+
+  - tâches déclarées une fois dans setup() : nom, période, budget ; l'ordre de
+    déclaration = la priorité (fréquence la plus haute en premier)
+  - schedRun() à chaque loop() : exécute la tâche périodique prête la plus prioritaire
+    (une seule par passage → la boucle 1 kHz n'attend jamais plus d'une tâche) ;
+    si aucune n'est prête, toutes les tâches de fond (période 0) passent
+  - donc aucun budget ne doit dépasser la période de la tâche la plus rapide : un
+    travail long (trame OLED…) est découpé en morceaux sur plusieurs passages
+  - relâchement à date fixe (next += période) : pas de dérive ; si la tâche a pris
+    plus d'une période de retard, les échéances sautées sont comptées puis on recale
+  - statistiques par tâche : exécutions, durée min / moy / max, retard au démarrage
+    max, échéances manquées (fin après relâchement + période), dépassements de budget
+    → lues par le protocole hôte (HP_SCHED, host_protocol.h), remises à zéro par HP_SCHED_RESET
+*/
+
+// ===================== RÉGLAGES =====================
+constexpr uint8_t SCHED_MAX_TASKS = 14;
+constexpr uint8_t SCHED_NAME_MAX  = 11;   // + '\0' : tient dans une trame hôte
+
+typedef void (*SchedFn)(uint32_t now_us);
+
+struct SchedStats {
+  uint32_t runs;
+  uint32_t minUs, maxUs;
+  uint64_t sumUs;
+  uint32_t maxLateUs;    // démarrage après relâchement
+  uint32_t misses;       // échéances manquées
+  uint32_t overruns;     // durée > budget
+};
+
+struct SchedTask {
+  const char* name;
+  SchedFn     fn;
+  uint32_t    periodUs;  // 0 = tâche de fond
+  uint32_t    budgetUs;
+  uint32_t    nextUs;
+  SchedStats  stats;
+};
+
+// ===================== API =====================
+int8_t           schedAdd(const char* name, SchedFn fn, uint32_t periodUs, uint32_t budgetUs); // → id, -1 si plein
+void             schedSetPeriod(int8_t id, uint32_t periodUs);
+void             schedRun();
+void             schedResetStats();
+uint8_t          schedCount();
+const SchedTask& schedTask(uint8_t id);
+uint32_t         schedAvgUs(const SchedStats& s);
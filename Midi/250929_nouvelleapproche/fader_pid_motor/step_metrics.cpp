@@ -0,0 +1,172 @@
+#include <Arduino.h>
+#include <cmath>           // NAN
+#include "hal.h"
+#include "step_metrics.h"
+#include "fader_bank.h"        // gBank.setpoint[] / position[] / drive[]
+#include "crc16.h"
+#include "telemetry.h"         // slipEncode()
+#include "modlink_uart.h"      // modLinkSharedUs()
+#include "host_link.h"         // HostLink : CDC USB ou UDP
+
+// ===================== Analyse =====================
+void StepAnalyzer::start(uint32_t now_us, uint16_t setpoint, uint16_t position) {
+  active_    = true;
+  target_    = setpoint;
+  from_      = position;
+  dir_       = setpoint >= position ? 1 : -1;
+  t0_ = prev_ = now_us;
+  t10_ = t90_ = STEP_NONE;
+  peak_      = 0;
+  inBand_    = false;
+  holdErr_   = 0;
+  holdN_     = 0;
+  iae_ = energy_ = 0;
+  lastSign_  = 0;
+  reversals_ = 0;
+}
+
+void StepAnalyzer::finish(uint32_t now_us, uint8_t flags, StepRecord& r) {
+  r.flags      = flags;
+  r.from       = from_;
+  r.to         = target_;
+  r.band       = band_;
+  r.reversals  = reversals_;
+  r.overshoot  = (uint16_t)peak_;
+  r.t0Us       = t0_;
+  r.riseUs     = (t10_ != STEP_NONE && t90_ != STEP_NONE) ? t90_ - t10_ : STEP_NONE;
+  r.settleUs   = (flags & STEP_F_SETTLED) ? bandSince_ - t0_ : STEP_NONE;
+  r.durationUs = now_us - t0_;
+  r.ssError    = holdN_ ? (float)holdErr_ / holdN_ : NAN;
+  r.iae        = (float)iae_ * 1e-6f;
+  r.energy     = (float)energy_ * 1e-6f;
+  active_ = false;
+}
+
+bool StepAnalyzer::sample(uint32_t now_us, uint16_t setpoint, uint16_t position, int16_t drive,
+                          uint16_t band, StepRecord& out) {
+  const int32_t jump = (int32_t)setpoint - (int32_t)target_;
+  if (!active_) {
+    target_ = setpoint;
+    if (jump >= STEP_MIN_MOVE || jump <= -(int32_t)STEP_MIN_MOVE) {
+      band_ = band;
+      start(now_us, setpoint, position);
+    }
+    return false;
+  }
+  bool done = false;
+  if (jump >= STEP_MIN_MOVE || jump <= -(int32_t)STEP_MIN_MOVE) {   // nouveau saut : on repart
+    finish(now_us, STEP_F_INTERRUPTED, out);
+    band_ = band;
+    start(now_us, setpoint, position);
+    return true;
+  }
+  target_ = setpoint;
+
+  const uint32_t dt = now_us - prev_;
+  prev_ = now_us;
+  const int32_t err = (int32_t)target_ - (int32_t)position;
+  iae_    += (uint64_t)(err < 0 ? -err : err) * dt;
+  energy_ += (uint64_t)((int32_t)drive * drive) * dt;
+  const int8_t s = drive > 0 ? 1 : (drive < 0 ? -1 : 0);
+  if (s) {
+    if (lastSign_ && s != lastSign_) ++reversals_;
+    lastSign_ = s;
+  }
+
+  // montée 10 → 90 % et dépassement, dans le sens du mouvement
+  const int32_t amp = ((int32_t)target_ - (int32_t)from_) * dir_;
+  const int32_t prog = ((int32_t)position - (int32_t)from_) * dir_;
+  if (t10_ == STEP_NONE && 10 * prog >= amp) t10_ = now_us;
+  if (t90_ == STEP_NONE && 10 * prog >= 9 * amp) t90_ = now_us;
+  const int32_t over = -err * dir_;
+  if (over > peak_) peak_ = over;
+
+  // établissement : STEP_HOLD_US d'affilée dans la bande
+  if (err <= (int32_t)band_ && err >= -(int32_t)band_) {
+    if (!inBand_) { inBand_ = true; bandSince_ = now_us; holdErr_ = 0; holdN_ = 0; }
+    holdErr_ += err;
+    if (holdN_ < 0xFFFF) ++holdN_;
+    if (now_us - bandSince_ >= STEP_HOLD_US) { finish(now_us, STEP_F_SETTLED, out); done = true; }
+  } else {
+    inBand_ = false;
+  }
+  if (!done && now_us - t0_ >= STEP_TIMEOUT_US) { finish(now_us, STEP_F_TIMEOUT, out); done = true; }
+  return done;
+}
+
+bool StepAnalyzer::cancel(uint32_t now_us, uint16_t setpoint, StepRecord& out) {
+  const bool was = active_;
+  if (was) finish(now_us, STEP_F_CANCELLED, out);   // cible commandée, pas celle du doigt
+  target_ = setpoint;
+  return was;
+}
+
+// ===================== ÉTAT =====================
+static StepAnalyzer analyzers[NUM_FADERS];
+static StepRecord   queue[STEP_QUEUE_LEN];
+static uint8_t      qHead = 0, qTail = 0;    // qHead - qTail = enregistrements en attente
+static uint16_t     seq = 0, lost = 0;
+static bool         enabled = false;
+static uint16_t     band = STEP_BAND_DEFAULT;
+
+static void push(uint8_t i, StepRecord& r) {
+  if ((uint8_t)(qHead - qTail) >= STEP_QUEUE_LEN) { ++lost; return; }
+  r.fader = i;
+  queue[qHead++ & (STEP_QUEUE_LEN - 1)] = r;
+}
+
+// ===================== API =====================
+void stepSetEnabled(bool on) {
+  if (on && !enabled) {                      // repart de l'état courant : pas de faux saut
+    Faders::each([](auto i) { StepRecord r; analyzers[i].cancel(HALTime::micros(), gBank.setpoint[i], r); });
+  }
+  enabled = on;
+}
+
+bool     stepEnabled()               { return enabled; }
+void     stepSetBand(uint16_t b)     { band = b; }
+uint16_t stepBand()                  { return band; }
+
+void stepSample(uint8_t i, uint32_t now_us) {
+  if (!enabled) return;
+  StepRecord r;
+  if (analyzers[i].sample(now_us, gBank.setpoint[i], gBank.position[i], gBank.drive[i], band, r)) push(i, r);
+}
+
+void stepCancel(uint8_t i, uint32_t now_us) {
+  if (!enabled) return;
+  StepRecord r;
+  if (analyzers[i].cancel(now_us, gBank.setpoint[i], r)) push(i, r);
+}
+
+static inline void put16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static inline void put32(uint8_t* p, uint32_t v) { put16(p, (uint16_t)v); put16(p + 2, (uint16_t)(v >> 16)); }
+
+void stepPoll() {
+  if (qHead == qTail || telemSending()) return;   // jamais au milieu d'une trame 'T'
+  const StepRecord& r = queue[qTail & (STEP_QUEUE_LEN - 1)];
+  uint8_t f[STEP_FRAME_LEN];
+  f[0] = STEP_TAG; f[1] = STEP_VERSION; f[2] = r.fader; f[3] = r.flags;
+  put16(f + 4, seq);
+  put16(f + 6, lost);
+  put32(f + 8, modLinkSharedUs(r.t0Us));
+  put16(f + 12, r.from);
+  put16(f + 14, r.to);
+  put16(f + 16, r.band);
+  put16(f + 18, r.reversals);
+  put32(f + 20, r.riseUs);
+  put32(f + 24, r.settleUs);
+  put32(f + 28, r.durationUs);
+  put16(f + 32, r.overshoot);
+  memcpy(f + 34, &r.ssError, 4);             // RP2040 = little-endian
+  memcpy(f + 38, &r.iae, 4);
+  memcpy(f + 42, &r.energy, 4);
+  put16(f + STEP_FRAME_LEN - 2, crc16_ccitt(f, STEP_FRAME_LEN - 2));
+
+  uint8_t slip[2 * STEP_FRAME_LEN + 2];
+  const size_t n = slipEncode(f, STEP_FRAME_LEN, slip);
+  if (HostLink::availableForWrite() < (int)n) return;   // trame entière ou rien, au passage suivant
+  HostLink::write(slip, n);
+  ++seq;
+  ++qTail;
+}
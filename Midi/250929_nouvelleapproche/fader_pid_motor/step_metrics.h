@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include "fader_filtre_adc.h" // NUM_FADERS
+
+/*
+  Mesures de réponse indicielle calculées sur la carte, 1 enregistrement par mouvement
+  (au lieu de streamer chaque échantillon vers Tuning.py) — hôte : python/step_soak.py,
+  décodeur python/SLIP.py (decode_step)
+
+  Mouvement : la consigne saute d'au moins STEP_MIN_MOVE comptes (DAW, scène, Tuning.py,
+  profil local) ; les petites variations (rampe de scène, consigne qui suit le doigt)
+  déplacent la cible sans ouvrir de mouvement. Analyse à chaque tick de régulation
+  (stepSample, tâche "control"), sans tableau d'échantillons :
+    montée          10 % → 90 % du saut (µs)
+    dépassement     excursion max au-delà de la cible, dans le sens du mouvement (comptes)
+    établissement   entrée définitive dans ±step_band autour de la cible (µs) ; définitive =
+                    restée STEP_HOLD_US dans la bande (exact si l'oscillation résiduelle a une
+                    demi-période ≤ STEP_HOLD_US, soit ≥ 10 Hz ; plus lente, elle peut être
+                    déclarée établie une alternance trop tôt)
+    erreur statique cible − mesure, moyenne sur ces STEP_HOLD_US (comptes)
+    IAE             ∫|cible − mesure| dt (comptes·s)
+    énergie PWM     ∫commande² dt (PWM²·s, ∝ énergie moteur à tension fixe)
+    inversions      changements de signe de la commande (pompage)
+  Fin : établi, STEP_TIMEOUT_US, nouveau saut (interrompu) ou doigt sur le fader (annulé)
+
+  Trame (SLIP, little-endian), file de STEP_QUEUE_LEN, vidée par stepPoll() quand le lien
+  a la place (jamais bloquant ; file pleine → perdu, compté) :
+    [0] 'R'  [1] STEP_VERSION  [2] fader  [3] drapeaux STEP_F_*
+    [4] seq u16  [6] perdus (cumul) u16  [8] t0 µs u32 (horloge commune, modLinkSharedUs)
+    [12] départ u16  [14] cible u16  [16] bande u16  [18] inversions u16
+    [20] montée µs u32  [24] établissement µs u32  [28] durée µs u32   (STEP_NONE : non atteint)
+    [32] dépassement u16  [34] erreur statique f32  [38] IAE f32  [42] énergie f32
+    [46] CRC-16/CCITT
+*/
+
+// ===================== RÉGLAGES =====================
+constexpr uint8_t  STEP_TAG          = 'R';
+constexpr uint8_t  STEP_VERSION      = 1;
+constexpr uint16_t STEP_MIN_MOVE     = 16;       // saut de consigne qui ouvre un mouvement (comptes)
+constexpr uint16_t STEP_BAND_DEFAULT = 8;        // ±comptes (réglable à chaud : step_band)
+constexpr uint32_t STEP_HOLD_US      = 50000;    // dans la bande aussi longtemps → établi
+constexpr uint32_t STEP_TIMEOUT_US   = 2000000;  // mouvement clos sans établissement
+constexpr uint8_t  STEP_QUEUE_LEN    = 8;        // puissance de 2
+constexpr uint32_t STEP_NONE         = 0xFFFFFFFFUL;
+constexpr uint8_t  STEP_FRAME_LEN    = 48;
+
+static_assert((STEP_QUEUE_LEN & (STEP_QUEUE_LEN - 1)) == 0, "STEP_QUEUE_LEN : puissance de 2");
+
+enum StepFlags : uint8_t {
+  STEP_F_SETTLED     = 0x01,
+  STEP_F_TIMEOUT     = 0x02,
+  STEP_F_INTERRUPTED = 0x04,   // nouveau saut avant la fin
+  STEP_F_CANCELLED   = 0x08,   // doigt sur le fader
+};
+
+struct StepRecord {
+  uint8_t  fader, flags;
+  uint16_t from, to, band, reversals, overshoot;
+  uint32_t t0Us, riseUs, settleUs, durationUs;
+  float    ssError, iae, energy;
+};
+
+// ===================== Analyse (1 par fader) =====================
+class StepAnalyzer {
+ public:
+  // 1 tick de régulation ; rend true et remplit out quand un mouvement se termine
+  bool sample(uint32_t now_us, uint16_t setpoint, uint16_t position, int16_t drive,
+              uint16_t band, StepRecord& out);
+  // doigt sur le fader : mouvement en cours annulé, la cible suit la consigne
+  bool cancel(uint32_t now_us, uint16_t setpoint, StepRecord& out);
+  bool active() const { return active_; }
+
+ private:
+  void start(uint32_t now_us, uint16_t setpoint, uint16_t position);
+  void finish(uint32_t now_us, uint8_t flags, StepRecord& out);
+
+  bool     active_ = false;
+  uint16_t target_ = 0;          // cible courante (aussi hors mouvement)
+  uint16_t from_ = 0, band_ = 0;
+  int8_t   dir_ = 0;             // +1 / -1
+  uint32_t t0_ = 0, prev_ = 0;
+  uint32_t t10_ = STEP_NONE, t90_ = STEP_NONE;
+  int32_t  peak_ = 0;            // dépassement max (comptes)
+  bool     inBand_ = false;
+  uint32_t bandSince_ = 0;
+  int32_t  holdErr_ = 0;         // Σ erreur dans la bande
+  uint16_t holdN_ = 0;
+  uint64_t iae_ = 0;             // comptes·µs
+  uint64_t energy_ = 0;          // PWM²·µs
+  int8_t   lastSign_ = 0;
+  uint16_t reversals_ = 0;
+};
+
+// ===================== API (firmware) =====================
+void     stepSetEnabled(bool on);      // paramètre hôte step_metrics
+bool     stepEnabled();
+void     stepSetBand(uint16_t band);   // paramètre hôte step_band
+uint16_t stepBand();
+void     stepSample(uint8_t i, uint32_t now_us);   // après loopPID(i)
+void     stepCancel(uint8_t i, uint32_t now_us);   // doigt sur le fader i
+void     stepPoll();                               // file → lien hôte (tâche "telem")
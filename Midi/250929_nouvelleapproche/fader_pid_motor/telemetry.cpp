@@ -0,0 +1,164 @@
+#include <Arduino.h>
+#include "hal.h"
+#include "telemetry.h"
+#include "fader_bank.h"        // gBank.setpoint[], gBank.drive[]
+#include "crc16.h"
+#include "modlink_uart.h"      // modLinkSharedUs()
+#include "host_link.h"         // HostLink : CDC USB ou UDP
+
+// ===================== ÉTAT =====================
+static uint8_t  raw[TELEM_RAW_MAX];        // trame en remplissage
+static uint8_t  slipBuf[TELEM_SLIP_MAX];   // trame précédente, échappée, en cours d'envoi
+static uint8_t  nSamples  = 0;
+static size_t   rawLen    = TELEM_HEADER;
+static uint16_t mask      = 0;
+static uint16_t seq       = 0;
+static uint16_t dropped   = 0;
+static size_t   txLen     = 0;       // trame SLIP en cours d'envoi
+static size_t   txOff     = 0;
+static uint8_t  codec     = TELEM_CODEC_DEFAULT;
+static uint8_t  txq[TELEM_TXQ_LEN];        // autres trames, échappées, en attente de la fin du 'T'
+static size_t   qLen      = 0;
+static size_t   qOff      = 0;
+static uint16_t qDropped  = 0;
+static uint8_t  frameCodec = TELEM_CODEC_DEFAULT; // codec de la trame en remplissage
+static int16_t  prevVal[MAX_FADERS * TELEM_FIELDS]; // échantillon précédent (deltas v2)
+
+static inline void put16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static inline void put32(uint8_t* p, uint32_t v) { put16(p, (uint16_t)v); put16(p + 2, (uint16_t)(v >> 16)); }
+
+size_t slipEncode(const uint8_t* in, size_t n, uint8_t* out) {
+  uint8_t* o = out;
+  *o++ = 0xC0;                                   // SLIP_END (aussi en tête : resynchro)
+  for (size_t k = 0; k < n; ++k) {
+    const uint8_t b = in[k];
+    if (b == 0xC0)      { *o++ = 0xDB; *o++ = 0xDC; }
+    else if (b == 0xDB) { *o++ = 0xDB; *o++ = 0xDD; }
+    else                *o++ = b;
+  }
+  *o++ = 0xC0;
+  return (size_t)(o - out);
+}
+
+// ===================== API =====================
+void telemBegin(uint16_t faderMask) {
+  mask     = faderMask & (uint16_t)((1UL << NUM_FADERS) - 1);
+  nSamples = 0;
+  rawLen   = TELEM_HEADER;
+  seq      = 0;
+  dropped  = 0;
+}
+
+uint16_t telemDropped() { return dropped; }
+
+bool telemSending() { return txOff < txLen || qOff < qLen; }
+
+uint16_t telemFrameDrops() { return qDropped; }
+
+bool telemWriteFrame(const uint8_t* frame, size_t n) {
+  if (!telemSending()) {                          // lien libre : d'un bloc (la file sert de tampon)
+    if (2 * n + 2 > TELEM_TXQ_LEN) { ++qDropped; return false; }
+    HostLink::write(txq, slipEncode(frame, n, txq));
+    return true;
+  }
+  if (qLen + 2 * n + 2 > TELEM_TXQ_LEN) {         // pire cas (tout échappé) : pas la place
+    ++qDropped;
+    return false;
+  }
+  qLen += slipEncode(frame, n, txq + qLen);
+  return true;
+}
+
+void telemFlush() {
+  const uint32_t t0 = HALTime::micros();
+  while (telemSending() && HALTime::micros() - t0 < TELEM_FLUSH_US) telemPoll();
+}
+
+bool telemSetCodec(uint8_t version) {
+  if (version != TELEM_V_RAW && version != TELEM_V_DELTA) return false;
+  codec = version;
+  return true;
+}
+
+uint8_t telemCodec() { return codec; }
+
+// ordre : fin de la trame 'T' entamée, puis la file, puis la trame 'T' suivante
+static bool sendSome(const uint8_t* buf, size_t len, size_t& off) {
+  const int room = HostLink::availableForWrite();
+  if (room <= 0) return false;
+  size_t n = len - off;
+  if (n > (size_t)room) n = (size_t)room;
+  off += HostLink::write(buf + off, n);
+  return off >= len;
+}
+
+void telemPoll() {
+  if (txOff > 0 && txOff < txLen && !sendSome(slipBuf, txLen, txOff)) return;
+  if (qOff < qLen) {
+    if (!sendSome(txq, qLen, qOff)) return;
+    qLen = qOff = 0;
+  }
+  if (txOff < txLen) sendSome(slipBuf, txLen, txOff);
+}
+
+static void closeFrame() {
+  uint8_t* f = raw;
+  f[0] = TELEM_TAG;
+  f[1] = (uint8_t)(frameCodec | TELEM_F_CRC);
+  put16(f + 2, seq++);
+  put16(f + 4, mask);
+  f[6] = nSamples;
+  f[7] = TELEM_FIELDS;
+  // f[8..11] (t0) posé au 1er échantillon
+  put16(f + 12, TELEM_PERIOD_US);
+  put16(f + 14, dropped);
+  put16(f + rawLen, crc16_ccitt(f, rawLen));
+  rawLen += 2;
+
+  if (txOff < txLen) {                           // lien encore occupé : trame perdue
+    ++dropped;
+  } else {
+    txLen = slipEncode(f, rawLen, slipBuf);
+    txOff = 0;
+    telemPoll();
+  }
+  nSamples = 0;
+  rawLen   = TELEM_HEADER;
+}
+
+void telemSample(uint32_t now_us) {
+  if (!mask) return;
+  uint8_t* f = raw;
+  if (nSamples == 0) {
+    put32(f + 8, modLinkSharedUs(now_us));       // horloge commune : journaux de modules alignés
+    frameCodec = codec;
+  }
+
+  // relevé des champs (ordre fader puis champ)
+  int16_t cur[MAX_FADERS * TELEM_FIELDS];
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < NUM_FADERS; ++i) {
+    if (!(mask & (1u << i))) continue;
+    cur[n++] = (int16_t)gBank.setpoint[i];
+    cur[n++] = (int16_t)gBank.position[i];
+    cur[n++] = gBank.drive[i];
+  }
+
+  if (frameCodec == TELEM_V_RAW || nSamples == 0) {          // v1 ou image clé
+    for (uint8_t j = 0; j < n; ++j, rawLen += 2) put16(f + rawLen, (uint16_t)cur[j]);
+  } else {                                                   // v2 : bitmap + deltas
+    uint8_t* bm = f + rawLen;
+    const uint8_t bmLen = (uint8_t)((n + 7) / 8);
+    memset(bm, 0, bmLen);
+    uint8_t* q = bm + bmLen;
+    for (uint8_t j = 0; j < n; ++j) {
+      const int32_t d = (int32_t)cur[j] - (int32_t)prevVal[j];
+      if (!d) continue;
+      bm[j >> 3] |= (uint8_t)(1u << (j & 7));
+      q = telemPutVarint(q, telemZigzag(d));
+    }
+    rawLen = (size_t)(q - f);
+  }
+  memcpy(prevVal, cur, n * sizeof cur[0]);
+  if (++nSamples >= TELEM_SAMPLES) closeFrame();
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "fader_filtre_adc.h" // MAX_FADERS
+#include "telemetry_codec.h"  // versions de trame, varint zig-zag
+
+/*
+  Télémétrie SLIP par blocs (remplace 1 trame float32 par échantillon)
+  Décodeur : python/SLIP.py (decode_telemetry) — Tuning.py l'utilise directement
+
+  - telemSample() relève gBank.setpoint / position / drive des faders du masque
+    dans un tampon préalloué ; TELEM_SAMPLES échantillons = 1 trame
+  - la trame est échappée SLIP d'un bloc puis confiée à Serial.write(buf, len)
+    par morceaux de la place libre (availableForWrite) → jamais bloquant
+  - double tampon : la trame suivante se remplit pendant que la précédente (échappée)
+    part ; si l'USB est encore occupé quand une trame est pleine, elle est perdue et
+    comptée (champ "perdues" + trou de seq côté hôte)
+  - les autres trames du lien (réponses du protocole hôte, UMP 'U', banc 'H', ...) passent
+    par telemWriteFrame() : envoyées d'un bloc si le lien est libre, sinon mises en file
+    entières (TELEM_TXQ_LEN) et vidées par telemPoll() avant la trame 'T' suivante →
+    jamais insérées au milieu d'une trame 'T' morcelée
+
+  Trame (little-endian, avant SLIP) :
+    [0]  'T'                [1] version : TELEM_V_RAW (1) ou TELEM_V_DELTA (2, telemetry_codec.h)
+    [2]  seq uint16         [4] masque faders uint16 (bit i = fader i)
+    [6]  nb échantillons    [7] champs par fader (TELEM_FIELDS)
+    [8]  t0 µs uint32 (1er échantillon, horloge commune : modLinkSharedUs)   [12] période µs uint16
+    [14] trames perdues (cumul) uint16
+    [16] v1 : N × popcount(masque) × { consigne, mesure, commande } int16
+         v2 : image clé int16 puis deltas (bitmap + varints zig-zag), voir telemetry_codec.h
+    [fin] CRC-16/CCITT (version | TELEM_F_CRC)
+
+  Débit v1 : 11 faders × 3 × 2 o × 1 kHz ≈ 66 ko/s + ~1 % d'en-tête/échappement
+  Débit v2 : image clé 66 o / trame + 5 o de bitmap par échantillon + ~1 o par champ qui
+             bouge → ~12 ko/s au repos, ~45 ko/s tous faders en mouvement
+*/
+
+// ===================== RÉGLAGES =====================
+constexpr uint8_t  TELEM_TAG        = 'T';
+constexpr uint8_t  TELEM_CODEC_DEFAULT = TELEM_V_DELTA;  // ou TELEM_V_RAW (réglable à chaud)
+constexpr uint8_t  TELEM_FIELDS     = 3;     // consigne, mesure, commande
+constexpr uint8_t  TELEM_SAMPLES    = 10;    // échantillons par trame (10 ms à 1 kHz)
+constexpr uint16_t TELEM_PERIOD_US  = 1000;  // 1 kHz
+constexpr size_t   TELEM_HEADER     = TELEM_HDR_LEN;
+constexpr size_t   TELEM_RAW_MAX    = telemMaxFrame(TELEM_SAMPLES, MAX_FADERS, TELEM_FIELDS);
+constexpr size_t   TELEM_SLIP_MAX   = 2 * TELEM_RAW_MAX + 2;   // pire cas : tout échappé
+
+constexpr size_t   TELEM_TXQ_LEN    = 1024;  // file des autres trames (échappées) pendant un envoi 'T'
+constexpr uint32_t TELEM_FLUSH_US   = 100000; // telemFlush() : attente max
+
+static_assert(MAX_FADERS <= 16, "masque télémétrie sur 16 bits");
+
+// ===================== API =====================
+void     telemBegin(uint16_t faderMask);   // masque des faders relevés (0 = arrêt)
+void     telemSample(uint32_t now_us);     // 1 échantillon (à appeler à TELEM_PERIOD_US)
+void     telemPoll();                      // continue l'envoi en cours (à chaque loop)
+uint16_t telemDropped();                   // trames perdues depuis telemBegin()
+bool     telemSending();                   // trame 'T' partielle ou file non vide (autres trames : attendre)
+bool     telemWriteFrame(const uint8_t* frame, size_t n);   // trame brute → SLIP, entière ; false : file pleine, perdue
+void     telemFlush();                     // bloquant (≤ TELEM_FLUSH_US) : trame 'T' et file envoyées
+uint16_t telemFrameDrops();                // trames de telemWriteFrame() perdues (file pleine)
+bool     telemSetCodec(uint8_t version);   // TELEM_V_RAW / TELEM_V_DELTA (appliqué à la trame suivante)
+uint8_t  telemCodec();
+
+// Encodage SLIP en bloc : rend la longueur écrite dans out (≥ 2n + 2 octets)
+size_t   slipEncode(const uint8_t* in, size_t n, uint8_t* out);
@@ -0,0 +1,71 @@
+#include "telemetry_codec.h"
+#include "crc16.h"
+
+static inline uint16_t rd16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+bool telemParseHeader(const uint8_t* p, size_t len, TelemHeader& h) {
+  if (len < TELEM_HDR_LEN || p[0] != 'T') return false;
+  h.version   = p[1] & (uint8_t)~TELEM_F_CRC;
+  h.crc       = (p[1] & TELEM_F_CRC) != 0;
+  h.seq       = rd16(p + 2);
+  h.mask      = rd16(p + 4);
+  h.samples   = p[6];
+  h.fields    = p[7];
+  h.t0_us     = (uint32_t)rd16(p + 8) | ((uint32_t)rd16(p + 10) << 16);
+  h.period_us = rd16(p + 12);
+  h.dropped   = rd16(p + 14);
+  h.faders    = 0;
+  for (uint16_t m = h.mask; m; m &= (uint16_t)(m - 1)) ++h.faders;
+  return (h.version == TELEM_V_RAW || h.version == TELEM_V_DELTA) && h.fields > 0;
+}
+
+uint8_t telemDecode(const uint8_t* p, size_t len, TelemHeader& h, int16_t* out, size_t outCap,
+                    bool* crcError) {
+  if (crcError) *crcError = false;
+  if (!telemParseHeader(p, len, h)) return 0;
+  if (h.crc) {
+    if (len < TELEM_HDR_LEN + 2) return 0;
+    len -= 2;
+    if (crc16_ccitt(p, len) != (uint16_t)(p[len] | (p[len + 1] << 8))) {
+      if (crcError) *crcError = true;
+      return 0;
+    }
+  }
+  const size_t stride = (size_t)h.faders * h.fields;
+  if (h.samples == 0 || (size_t)h.samples * stride > outCap) return 0;
+  const uint8_t* q   = p + TELEM_HDR_LEN;
+  const uint8_t* end = p + len;
+
+  if (h.version == TELEM_V_RAW) {
+    if ((size_t)(end - q) != 2 * stride * h.samples) return 0;
+    for (size_t k = 0; k < stride * h.samples; ++k, q += 2) out[k] = (int16_t)rd16(q);
+    return h.samples;
+  }
+
+  // v2 : image clé puis bitmap + deltas
+  if ((size_t)(end - q) < 2 * stride) return 0;
+  for (size_t k = 0; k < stride; ++k, q += 2) out[k] = (int16_t)rd16(q);
+  const size_t bmLen = (stride + 7) / 8;
+
+  for (uint8_t s = 1; s < h.samples; ++s) {
+    int16_t*       cur  = out + (size_t)s * stride;
+    const int16_t* prev = cur - stride;
+    if ((size_t)(end - q) < bmLen) return 0;
+    const uint8_t* bm = q;
+    q += bmLen;
+    for (size_t j = 0; j < stride; ++j) {
+      if (!(bm[j >> 3] & (1u << (j & 7)))) { cur[j] = prev[j]; continue; }
+      uint32_t u = 0;
+      uint8_t  shift = 0;
+      for (;;) {
+        if (q >= end || shift > 28) return 0;
+        const uint8_t b = *q++;
+        u |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) break;
+        shift = (uint8_t)(shift + 7);
+      }
+      cur[j] = (int16_t)(prev[j] + telemUnzigzag(u));
+    }
+  }
+  return q == end ? h.samples : 0;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+/*
+  Codec des trames de télémétrie 'T' (telemetry.h) — code portable (firmware + hôte)
+  Décodeurs : telemDecode() ici (C++, host/), decode_telemetry() dans python/SLIP.py
+
+  En-tête commun (16 o, LE) : 'T' version seq masque n F t0_us période perdues
+  version | TELEM_F_CRC : la trame se termine par un CRC-16/CCITT (crc16.h) sur tout ce
+  qui précède → l'hôte distingue une trame corrompue d'une trame perdue
+  Version 1 (TELEM_V_RAW)   : n × faders × F int16
+  Version 2 (TELEM_V_DELTA) :
+    - 1er échantillon = image clé : faders × F int16 (chaque trame se décode seule)
+    - échantillons suivants : bitmap des champs qui ont changé (ceil(faders×F / 8) octets,
+      bit j = champ j, ordre fader puis champ) puis, pour chaque bit à 1, le delta
+      par rapport à l'échantillon précédent en varint zig-zag (LEB128)
+    - au repos : bitmap nul seul → 5 o / échantillon pour 11 faders (au lieu de 66)
+*/
+
+constexpr uint8_t TELEM_V_RAW   = 1;
+constexpr uint8_t TELEM_V_DELTA = 2;
+constexpr uint8_t TELEM_F_CRC   = 0x80;   // bit de l'octet version : CRC-16 en fin de trame
+constexpr size_t  TELEM_HDR_LEN = 16;
+
+struct TelemHeader {
+  uint8_t  version;     // sans TELEM_F_CRC
+  bool     crc;
+  uint16_t seq;
+  uint16_t mask;
+  uint8_t  samples;
+  uint8_t  fields;
+  uint32_t t0_us;
+  uint16_t period_us;
+  uint16_t dropped;
+  uint8_t  faders;      // popcount(mask)
+};
+
+// ===================== Primitives =====================
+inline uint32_t telemZigzag(int32_t v)    { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+inline int32_t  telemUnzigzag(uint32_t u) { return (int32_t)(u >> 1) ^ -(int32_t)(u & 1); }
+
+inline uint8_t* telemPutVarint(uint8_t* p, uint32_t v) {
+  while (v >= 0x80) { *p++ = (uint8_t)(v | 0x80); v >>= 7; }
+  *p++ = (uint8_t)v;
+  return p;
+}
+
+// Pire cas d'une trame (octets, avant SLIP)
+constexpr size_t telemMaxFrame(size_t samples, size_t faders, size_t fields) {
+  return TELEM_HDR_LEN + faders * fields * 2                            // image clé / v1
+       + (samples - 1) * ((faders * fields + 7) / 8 + faders * fields * 3)  // bitmap + varints ≤ 3 o
+       + 2;                                                                 // CRC
+}
+
+// ===================== Décodage =====================
+bool telemParseHeader(const uint8_t* p, size_t len, TelemHeader& h);
+
+// Trame v1 ou v2 → out[échantillon][fader du masque][champ] ; rend le nb d'échantillons
+// (0 si trame invalide, CRC faux — crcError = true — ou si out est trop petit)
+uint8_t telemDecode(const uint8_t* p, size_t len, TelemHeader& h, int16_t* out, size_t outCap,
+                    bool* crcError = nullptr);
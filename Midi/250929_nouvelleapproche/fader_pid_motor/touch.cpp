@@ -0,0 +1,18 @@
+#include <Arduino.h>
+#include "touch.h"
+#include "fader_bank.h"
+
+// Mesure RC, baseline et hystérésis : FaderBank::beginTouch / touch / trackTouchBaseline
+
+// ===================== SETUP/LOOP =====================
+void setupTouch() {
+  gBank.beginTouch();   // baseline = moyenne de 40 mesures, doigt éloigné
+}
+
+bool loopTouch(uint8_t i) {
+  return gBank.touch(i);
+}
+
+void loopTouchBaseline(uint8_t i) {
+  gBank.trackTouchBaseline(i);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <Arduino.h>
+#include "fader_filtre_adc.h" // MAX_FADERS / NUM_FADERS
+
+/*
+  Détection tactile capacitive (RC) — une pin par fader
+  (repris de 250926-intégration MIDI/touch.hpp, passé en multi-faders)
+
+  Câblage requis (par fader) :
+    - 1 MΩ entre PicoBoard::TOUCH_PINS[i] et 3V3
+    - (optionnel) 22–100 nF entre PicoBoard::TOUCH_PINS[i] et GND
+    - Pad tactile (piste du fader) relié au même nœud que la pin
+
+  Principe :
+    1) On décharge la pin (sortie LOW quelques µs)
+    2) On libère la pin (entrée), elle remonte via la 1 MΩ
+    3) On mesure le temps jusqu’à HIGH ; le doigt ↑ capacité → temps ↑
+*/
+
+// ===================== RÉGLAGES (tout en haut) =====================
+// Broches tactiles : PicoBoard::TOUCH_PINS (pin_int.h) ; état : gBank.touched[i] (fader_bank.h)
+
+constexpr uint16_t TOUCH_DISCHARGE_US   = 20;     // force une vraie décharge
+constexpr uint16_t TOUCH_TIMEOUT_US     = 5000;   // garde-fou si ça ne monte jamais
+constexpr uint8_t  TOUCH_BASELINE_HZ    = 50;     // suivi de la baseline (tâche touch_bl)
+constexpr float    TOUCH_BASELINE_ALPHA = 0.04f;  // EMA lente (drift) à 50 Hz, τ ≈ 0,5 s
+constexpr uint16_t TOUCH_MIN_BASELINE   = 15;     // évite baseline nulle
+constexpr uint16_t TOUCH_DELTA_ON       = 40;     // seuil +µs pour "touch"
+constexpr uint16_t TOUCH_DELTA_OFF      = 25;     // seuil +µs pour "release"
+
+// ===================== API =====================
+void setupTouch();            // calibre la baseline (ne pas toucher les faders)
+bool loopTouch(uint8_t i);    // mesure + hystérésis, met à jour gBank.touched[i]
+void loopTouchBaseline(uint8_t i);  // suivi lent de la baseline (TOUCH_BASELINE_HZ)
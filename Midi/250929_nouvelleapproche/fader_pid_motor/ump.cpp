@@ -0,0 +1,137 @@
+#include "ump.h"
+
+// ===================== Mise à l'échelle =====================
+uint32_t umpScaleUp(uint32_t v, uint8_t srcBits, uint8_t dstBits) {
+  if (srcBits >= dstBits) return v;
+  const uint8_t  scaleBits  = dstBits - srcBits;
+  uint32_t       bitShifted = v << scaleBits;
+  const uint32_t srcCenter  = 1u << (srcBits - 1);
+  if (v <= srcCenter) return bitShifted;
+
+  // au-dessus du centre : on répète les bits de poids faible pour atteindre le max
+  const uint8_t  repeatBits = srcBits - 1;
+  const uint32_t repeatMask = (1u << repeatBits) - 1;
+  uint32_t repeatValue = v & repeatMask;
+  if (scaleBits > repeatBits) repeatValue <<= scaleBits - repeatBits;
+  else                        repeatValue >>= repeatBits - scaleBits;
+  while (repeatValue != 0) {
+    bitShifted  |= repeatValue;
+    repeatValue >>= repeatBits;
+  }
+  return bitShifted;
+}
+
+uint8_t umpWordCount(uint32_t word0) {
+  switch (word0 >> 28) {
+    case 0x0: case 0x1: case 0x2: case 0x6: case 0x7: return 1;
+    case 0x3: case 0x4: case 0x8: case 0x9: case 0xA: return 2;
+    case 0xB: case 0xC:                               return 3;
+    default:                                          return 4; // 0x5, 0xD, 0xE, 0xF
+  }
+}
+
+// ===================== MIDI 2.0 Channel Voice (MT=4) =====================
+static inline uint32_t m2Header(uint8_t group, uint8_t status, uint8_t ch, uint8_t b1, uint8_t b2) {
+  return ((uint32_t)UMP_MT_MIDI2 << 28) | ((uint32_t)(group & 0xF) << 24) |
+         ((uint32_t)(status & 0xF) << 20) | ((uint32_t)(ch & 0xF) << 16) |
+         ((uint32_t)(b1 & 0x7F) << 8) | (uint32_t)(b2 & 0x7F);
+}
+
+void umpMidi2NRPN(uint32_t w[2], uint8_t group, uint8_t ch, uint8_t bank, uint8_t index, uint32_t value) {
+  w[0] = m2Header(group, UMP_M2_NRPN, ch, bank, index);
+  w[1] = value;
+}
+
+void umpMidi2RelNRPN(uint32_t w[2], uint8_t group, uint8_t ch, uint8_t bank, uint8_t index, int32_t delta) {
+  w[0] = m2Header(group, UMP_M2_REL_NRPN, ch, bank, index);
+  w[1] = (uint32_t)delta;                 // complément à 2
+}
+
+bool umpParseController(const uint32_t* w, UmpController& out) {
+  if ((w[0] >> 28) != UMP_MT_MIDI2) return false;
+  out.status  = (uint8_t)((w[0] >> 20) & 0xF);
+  out.group   = (uint8_t)((w[0] >> 24) & 0xF);
+  out.channel = (uint8_t)((w[0] >> 16) & 0xF);
+  out.value   = w[1];
+  switch (out.status) {
+    case UMP_M2_CC:
+      out.bank  = 0;
+      out.index = (uint8_t)((w[0] >> 8) & 0x7F);
+      return true;
+    case UMP_M2_RPN:
+    case UMP_M2_NRPN:
+      out.bank  = (uint8_t)((w[0] >> 8) & 0x7F);
+      out.index = (uint8_t)(w[0] & 0x7F);
+      return true;
+    default:
+      return false;
+  }
+}
+
+// ===================== UMP Stream (MT=F) =====================
+static inline uint32_t streamHeader(uint16_t status, uint8_t b2, uint8_t b3) {
+  // format = 0 (message complet en un paquet)
+  return ((uint32_t)UMP_MT_STREAM << 28) | ((uint32_t)(status & 0x3FF) << 16) |
+         ((uint32_t)b2 << 8) | b3;
+}
+
+void umpStreamEndpointInfo(uint32_t w[4], uint8_t numFunctionBlocks, bool midi2, bool midi1) {
+  w[0] = streamHeader(UMP_STREAM_EP_INFO, 1, 1);      // UMP v1.1
+  w[1] = (1u << 31)                                   // function blocks statiques
+       | ((uint32_t)(numFunctionBlocks & 0x7F) << 24)
+       | (midi2 ? (1u << 9) : 0) | (midi1 ? (1u << 8) : 0);
+  w[2] = w[3] = 0;
+}
+
+void umpStreamConfig(uint32_t w[4], uint16_t status, uint8_t protocol) {
+  w[0] = streamHeader(status, protocol, 0);           // pas de JR timestamps
+  w[1] = w[2] = w[3] = 0;
+}
+
+// ===================== MIDI-CI Discovery =====================
+static inline uint8_t* put7(uint8_t* p, uint32_t v, uint8_t n) {
+  for (uint8_t k = 0; k < n; ++k) { *p++ = (uint8_t)(v & 0x7F); v >>= 7; }
+  return p;
+}
+
+static inline uint32_t get7(const uint8_t* p, uint8_t n) {
+  uint32_t v = 0;
+  for (uint8_t k = 0; k < n; ++k) v |= (uint32_t)(p[k] & 0x7F) << (7 * k);
+  return v;
+}
+
+static size_t ciBuild(uint8_t* out, size_t cap, uint8_t subId, const MidiCiIdentity& id,
+                      uint32_t dstMuid, bool reply) {
+  const size_t len = reply ? 33 : 32;
+  if (cap < len) return 0;
+  uint8_t* p = out;
+  *p++ = 0xF0; *p++ = 0x7E; *p++ = 0x7F; *p++ = 0x0D; *p++ = subId; *p++ = MIDICI_VERSION;
+  p = put7(p, id.muid, 4);
+  p = put7(p, dstMuid, 4);
+  *p++ = id.manufacturer[0]; *p++ = id.manufacturer[1]; *p++ = id.manufacturer[2];
+  p = put7(p, id.family, 2);
+  p = put7(p, id.model, 2);
+  p = put7(p, id.version, 4);
+  *p++ = 0x00;                 // catégories CI : Discovery seulement
+  p = put7(p, id.maxSysEx, 4);
+  *p++ = 0x00;                 // output path id
+  if (reply) *p++ = 0x00;      // function block 0
+  *p++ = 0xF7;
+  return (size_t)(p - out);
+}
+
+size_t midiCiDiscovery(uint8_t* out, size_t cap, const MidiCiIdentity& id) {
+  return ciBuild(out, cap, MIDICI_DISCOVERY, id, MIDICI_MUID_BCAST, false);
+}
+
+size_t midiCiDiscoveryReply(uint8_t* out, size_t cap, const MidiCiIdentity& id, uint32_t dstMuid) {
+  return ciBuild(out, cap, MIDICI_DISCOVERY_REP, id, dstMuid, true);
+}
+
+uint8_t midiCiParse(const uint8_t* data, size_t len, uint32_t& srcMuid) {
+  if (len && data[0] == 0xF0) { ++data; --len; }
+  // 7E <dev> 0D <subId2> <ver> <src MUID x4> ...
+  if (len < 9 || data[0] != 0x7E || data[2] != 0x0D) return 0;
+  srcMuid = get7(data + 5, 4);
+  return data[3];
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+/*
+  MIDI 2.0 — Universal MIDI Packet (UMP) + MIDI-CI Discovery
+  Code portable (pas d'Arduino) : compilable tel quel sur Linux.
+
+  Messages utilisés :
+    - MT=0x4 (MIDI 2.0 Channel Voice, 64 bits) : émis, Assignable Controller (NRPN,
+      valeur 32 bits, faders) et Relative Assignable Controller (encodeurs) ; reçus,
+      Control Change ou RPN/NRPN (umpParseController)
+    - MT=0xF (UMP Stream, 128 bits) : Endpoint Discovery reçue → Endpoint Info,
+      Stream Configuration Request / Notification (choix MIDI 1.0 ↔ 2.0)
+    - MIDI-CI (SysEx universel 7E .. 0D) : Discovery (0x70) / Reply (0x71)
+
+  Mot UMP = uint32_t en ordre natif ; l'octet de poids fort porte le MT.
+*/
+
+// ===================== Constantes UMP =====================
+constexpr uint8_t UMP_MT_STREAM  = 0xF;
+constexpr uint8_t UMP_MT_MIDI2   = 0x4;
+
+constexpr uint8_t UMP_M2_RPN     = 0x2; // Registered Controller
+constexpr uint8_t UMP_M2_NRPN    = 0x3; // Assignable Controller
+constexpr uint8_t UMP_M2_REL_NRPN = 0x5; // Relative Assignable Controller (valeur signée)
+constexpr uint8_t UMP_M2_CC      = 0xB; // Control Change
+
+constexpr uint16_t UMP_STREAM_EP_DISCOVERY   = 0x000;
+constexpr uint16_t UMP_STREAM_EP_INFO        = 0x001;
+constexpr uint16_t UMP_STREAM_CONFIG_REQUEST = 0x005;
+constexpr uint16_t UMP_STREAM_CONFIG_NOTIFY  = 0x006;
+
+constexpr uint8_t UMP_PROTOCOL_MIDI1 = 0x01;
+constexpr uint8_t UMP_PROTOCOL_MIDI2 = 0x02;
+
+// ===================== Mise à l'échelle =====================
+// Montée en résolution "min-centre-max" de la spec MIDI 2.0 (0 → 0, centre → centre,
+// max → 0xFFFFFFFF). srcBits ≤ dstBits ≤ 32.
+uint32_t umpScaleUp(uint32_t v, uint8_t srcBits, uint8_t dstBits);
+// Descente en résolution (simple décalage)
+inline uint32_t umpScaleDown(uint32_t v, uint8_t srcBits, uint8_t dstBits) {
+  return v >> (srcBits - dstBits);
+}
+
+// Nombre de mots d'un paquet d'après son MT (1, 2, 3 ou 4)
+uint8_t umpWordCount(uint32_t word0);
+
+// ===================== MIDI 2.0 Channel Voice (MT=4) =====================
+// Remplit w[2]. ch = 0..15, group = 0..15
+void umpMidi2NRPN(uint32_t w[2], uint8_t group, uint8_t ch, uint8_t bank, uint8_t index, uint32_t value);
+void umpMidi2RelNRPN(uint32_t w[2], uint8_t group, uint8_t ch, uint8_t bank, uint8_t index, int32_t delta);
+
+struct UmpController {
+  uint8_t  status;  // UMP_M2_CC / UMP_M2_RPN / UMP_M2_NRPN
+  uint8_t  group, channel;
+  uint8_t  bank;    // 0 pour CC
+  uint8_t  index;   // n° de CC ou index RPN/NRPN
+  uint32_t value;
+};
+// Décode un MT=4 contrôleur. Rend false si ce n'en est pas un.
+bool umpParseController(const uint32_t* w, UmpController& out);
+
+// ===================== UMP Stream (MT=F) =====================
+// Remplit w[4]
+void umpStreamEndpointInfo(uint32_t w[4], uint8_t numFunctionBlocks, bool midi2, bool midi1);
+void umpStreamConfig(uint32_t w[4], uint16_t status, uint8_t protocol);
+inline uint16_t umpStreamStatus(const uint32_t* w) { return (uint16_t)((w[0] >> 16) & 0x3FF); }
+inline uint8_t  umpStreamProtocol(const uint32_t* w) { return (uint8_t)((w[0] >> 8) & 0xFF); }
+
+// ===================== MIDI-CI Discovery =====================
+constexpr uint8_t  MIDICI_VERSION       = 0x02;       // MIDI-CI 1.2
+constexpr uint8_t  MIDICI_DISCOVERY     = 0x70;
+constexpr uint8_t  MIDICI_DISCOVERY_REP = 0x71;
+constexpr uint32_t MIDICI_MUID_BCAST    = 0x0FFFFFFF;
+
+struct MidiCiIdentity {
+  uint32_t muid;          // 28 bits, tiré au boot
+  uint8_t  manufacturer[3];
+  uint16_t family, model;
+  uint32_t version;
+  uint32_t maxSysEx;
+};
+
+// Construit un SysEx complet (F0..F7). Rend la longueur (0 si buffer trop petit).
+size_t midiCiDiscovery(uint8_t* out, size_t cap, const MidiCiIdentity& id);
+size_t midiCiDiscoveryReply(uint8_t* out, size_t cap, const MidiCiIdentity& id, uint32_t dstMuid);
+
+// Analyse un SysEx MIDI-CI (avec ou sans F0/F7). Rend le sub-ID#2 (0x70, 0x71, …)
+// ou 0 si ce n'est pas du MIDI-CI ; srcMuid reçoit le MUID de l'émetteur.
+uint8_t midiCiParse(const uint8_t* data, size_t len, uint32_t& srcMuid);